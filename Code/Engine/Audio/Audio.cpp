@@ -2,6 +2,7 @@
 #include "Engine/Audio/Audio.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Input/Console.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
 #include "../Core/StringUtils.hpp"
 
 AudioSystem* AudioSystem::instance = nullptr;
@@ -229,6 +230,7 @@ void AudioSystem::ReleaseRawSong(RawSoundHandle songHandle)
 //---------------------------------------------------------------------------
 SoundID AudioSystem::CreateOrGetSound( const std::string& soundFileName )
 {
+    MemoryTagScope tagScope(MEMTAG_AUDIO);
     std::map<std::string, SoundID>::iterator found = m_registeredSoundIDs.find( soundFileName );
     if( found != m_registeredSoundIDs.end() )
     {
@@ -253,6 +255,7 @@ SoundID AudioSystem::CreateOrGetSound( const std::string& soundFileName )
 //-----------------------------------------------------------------------------------
 SoundID AudioSystem::CreateOrGetSound(const std::wstring& wideSoundFileName)
 {
+    MemoryTagScope tagScope(MEMTAG_AUDIO);
     char fileName[MAX_PATH * 8];
     WideCharToMultiByte(CP_UTF8, 0, wideSoundFileName.c_str(), -1, fileName, sizeof(fileName), NULL, NULL);
 
@@ -316,6 +319,7 @@ void AudioSystem::SetLooping(SoundID soundID, bool isLooping)
 //---------------------------------------------------------------------------
 void AudioSystem::Update( float deltaSeconds )
 {
+    MemoryTagScope tagScope(MEMTAG_AUDIO);
     FMOD_RESULT result = m_fmodSystem->update();
     ValidateResult( result );
     //Unused
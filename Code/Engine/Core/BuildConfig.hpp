@@ -29,9 +29,19 @@
 */
 #define LOG_LEVEL_THRESHOLD 4
 
-//Maximum number of log files to keep. Adding another log over this amount will delete the oldest log.
+//Channel log calls below this level are compiled out entirely, so their arguments are never evaluated. Same numbering as above.
+#define LOG_COMPILE_TIME_MIN_LEVEL 0
+
+//Maximum number of log files to keep, rotated files included. Adding another log over this amount will delete the oldest log.
 #define MAX_LOG_HISTORY 5
 
+//Starts a new log file once the current one would grow past this many bytes, or has been open this many seconds. 0 turns either check off.
+#define LOG_ROTATION_SIZE_BYTES (16 * 1024 * 1024)
+#define LOG_ROTATION_INTERVAL_SECONDS (60 * 60)
+
+//How often the logging thread flushes the log file to disk. Severe messages get flushed as soon as they're written.
+#define LOG_FLUSH_INTERVAL_MS 1000
+
 //Forwards log messages to the output window after logging them.
 #define FORWARD_LOG_TO_OUTPUT_WINDOW
 
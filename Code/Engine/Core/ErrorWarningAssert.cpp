@@ -17,6 +17,14 @@
 #include <iostream>
 
 
+static RecoverableWarningHandler* g_recoverableWarningHandler = nullptr;
+
+//-----------------------------------------------------------------------------------------------
+void SetRecoverableWarningHandler( RecoverableWarningHandler* handler )
+{
+	g_recoverableWarningHandler = handler;
+}
+
 //-----------------------------------------------------------------------------------------------
 bool IsDebuggerAvailable()
 {
@@ -286,6 +294,12 @@ void RecoverableWarning( const char* filePath, const char* functionName, int lin
 	DebuggerPrintf( "%s(%d): %s\n", filePath, lineNum, errorMessage.c_str() ); // Use this specific format so Visual Studio users can double-click to jump to file-and-line of error
 	DebuggerPrintf( "------------------------------------------------------------------------------\n\n" );
 
+	if( g_recoverableWarningHandler )
+	{
+		g_recoverableWarningHandler( errorMessage );
+		return;
+	}
+
 	if( isDebuggerPresent )
 	{
 		int answerCode = SystemDialogue_YesNoCancel( fullMessageTitle, fullMessageText, SEVERITY_WARNING );
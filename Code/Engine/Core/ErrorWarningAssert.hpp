@@ -36,6 +36,9 @@ void DebuggerPrintf( const char* messageFormat, ... );
 bool IsDebuggerAvailable();
 __declspec( noreturn ) void FatalError( const char* filePath, const char* functionName, int lineNum, const std::string& reasonForError, const char* conditionText=nullptr );
 void RecoverableWarning( const char* filePath, const char* functionName, int lineNum, const std::string& reasonForWarning, const char* conditionText=nullptr );
+//Lets something other than a dialogue box take recoverable warnings, like a test runner that counts them. Pass nullptr to go back to the dialogue.
+typedef void (RecoverableWarningHandler)( const std::string& warningMessage );
+void SetRecoverableWarningHandler( RecoverableWarningHandler* handler );
 void SystemDialogue_Okay( const std::string& messageTitle, const std::string& messageText, SeverityLevel severity );
 bool SystemDialogue_OkayCancel( const std::string& messageTitle, const std::string& messageText, SeverityLevel severity );
 bool SystemDialogue_YesNo( const std::string& messageTitle, const std::string& messageText, SeverityLevel severity );
@@ -1,33 +1,36 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
+#include <cstring>
 #include "Engine\Core\Memory\UntrackedAllocator.hpp"
 
+//Subscriptions are stored by value in one array, and Trigger calls each one through a single function pointer.
+//Registering or unregistering from inside a callback is safe: removals take effect immediately but the array isn't compacted
+//until the outermost Trigger finishes, and anything registered during a Trigger waits until the next one.
 template <typename ...Args>
 class Event
 {
 public:
-    struct Subscription;
+    struct Delegate;
     //TYPEDEFS/////////////////////////////////////////////////////////////////////
-    typedef void(SubscriptionCallback)(Subscription* sub, Args...);
+    typedef void(DelegateStub)(const Delegate* delegate, Args...);
     typedef void(FunctionCallback)(Args...);
-    typedef void(EventCallback)(Subscription* sub, Args...);
+    //Knows what's actually stored in m_callbackData, so two delegates with the same stub can be compared as their real type.
+    typedef bool(CallbackComparer)(const Delegate& first, const Delegate& second);
 
     //STRUCTS/////////////////////////////////////////////////////////////////////
-    template <typename CALLBACKTYPE>
-    struct SubscriptionType
+    struct Delegate
     {
-        SubscriptionCallback* utilityCallback; // This is the C style function the trigger actually calls
-        void* argument;         // Additional data that goes with the subscription (optional)
+        DelegateStub* m_stub;   // The C style function Trigger actually calls. nullptr once it's been unregistered mid-trigger.
+        void* m_object;         // The object a method gets called on (optional)
 
         union {
-            CALLBACKTYPE callback;         // Is the callback registered by the user
-            char callback_data[16];
+            char m_callbackData[16];  // Member function pointers can be up to 16 bytes with MSVC. First, so = {} zeroes all of it.
+            FunctionCallback* m_function;
         };
     };
 
-    struct Subscription : public SubscriptionType<void*> {};
-
     //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
     Event() {};
 
@@ -38,100 +41,216 @@ public:
     }
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
-    void RegisterFunction(FunctionCallback* cb)
+    //Registering the same callback twice is ignored, and returns false.
+    bool RegisterFunction(FunctionCallback* cb)
     {
-        RegisterSubscription(&EventFunctionCallback, cb, nullptr);
+        Delegate delegate = {};
+        delegate.m_stub = &FunctionStub;
+        delegate.m_function = cb;
+        return AddDelegate(delegate, &IsSameFunction);
     }
 
     //-----------------------------------------------------------------------------------
-    void UnregisterFunction(FunctionCallback* cb)
+    bool UnregisterFunction(FunctionCallback* cb)
     {
-        UnregisterSubscription(&EventFunctionCallback, cb, nullptr);
+        Delegate delegate = {};
+        delegate.m_stub = &FunctionStub;
+        delegate.m_function = cb;
+        return RemoveDelegate(delegate, &IsSameFunction);
     }
 
     //-----------------------------------------------------------------------------------
     template <typename T>
-    void RegisterMethod(T* object, void (T::*methodCallback)(Args...))
+    bool RegisterMethod(T* object, void (T::*methodCallback)(Args...))
     {
-        RegisterSubscription(&MethodCallback<T, decltype(methodCallback)>, methodCallback, object);
+        return AddDelegate(MakeMethodDelegate(object, methodCallback), &IsSameMethod<decltype(methodCallback)>);
     }
 
     //-----------------------------------------------------------------------------------
     template <typename T>
-    void UnregisterMethod(T* object, void (T::*methodCallback)(Args...))
+    bool UnregisterMethod(T* object, void (T::*methodCallback)(Args...))
     {
-        UnregisterSubscription(&MethodCallback<T, decltype(methodCallback)>, methodCallback, object);
+        return RemoveDelegate(MakeMethodDelegate(object, methodCallback), &IsSameMethod<decltype(methodCallback)>);
+    }
+
+    //-----------------------------------------------------------------------------------
+    //Same as RegisterMethod, but the method is baked into the stub so the call skips the member pointer and can be inlined.
+    //Use as RegisterMethod<NetSession, &NetSession::OnNetTick>(this)
+    template <typename T, void (T::*METHOD)(Args...)>
+    bool RegisterMethod(T* object)
+    {
+        Delegate delegate = {};
+        delegate.m_stub = &BoundMethodStub<T, METHOD>;
+        delegate.m_object = object;
+        return AddDelegate(delegate, &HasNoCallback);
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <typename T, void (T::*METHOD)(Args...)>
+    bool UnregisterMethod(T* object)
+    {
+        Delegate delegate = {};
+        delegate.m_stub = &BoundMethodStub<T, METHOD>;
+        delegate.m_object = object;
+        return RemoveDelegate(delegate, &HasNoCallback);
     }
 
     //-----------------------------------------------------------------------------------
     void UnregisterAllSubscriptions()
     {
-        m_subscriptions.clear();
+        if (m_triggerDepth == 0)
+        {
+            m_delegates.clear();
+            return;
+        }
+        for (Delegate& delegate : m_delegates)
+        {
+            delegate.m_stub = nullptr;
+        }
+        m_hasRemovedDelegates = true;
     }
 
     //-----------------------------------------------------------------------------------
     void Trigger(Args... args)
     {
-        unsigned int size = m_subscriptions.size();
-        for (unsigned int i = 0; i < size; ++i)
+        ++m_triggerDepth;
+        const size_t numDelegates = m_delegates.size();
+        for (size_t i = 0; i < numDelegates; ++i)
         {
-            auto& sub = m_subscriptions[i];
-            sub.utilityCallback(&sub, args...);
-            if (m_subscriptions.size() < size)
+            //Registering from inside the callback can move the array, so the stubs read everything they need before calling it.
+            const Delegate* delegate = &m_delegates[i];
+            if (delegate->m_stub)
             {
-                size = m_subscriptions.size();
-                --i;
+                delegate->m_stub(delegate, args...);
             }
         }
+        --m_triggerDepth;
+
+        if (m_triggerDepth == 0 && m_hasRemovedDelegates)
+        {
+            m_delegates.erase(std::remove_if(m_delegates.begin(), m_delegates.end(), [](const Delegate& delegate) { return delegate.m_stub == nullptr; }), m_delegates.end());
+            m_hasRemovedDelegates = false;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    unsigned int GetNumSubscriptions() const
+    {
+        unsigned int numSubscriptions = 0;
+        for (const Delegate& delegate : m_delegates)
+        {
+            numSubscriptions += delegate.m_stub ? 1 : 0;
+        }
+        return numSubscriptions;
     }
 
     //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
     template <typename T, typename METHODTYPE>
-    static void MethodCallback(SubscriptionType<METHODTYPE>* sub, Args... args)
+    static void MethodStub(const Delegate* delegate, Args... args)
     {
-        METHODTYPE mcb = sub->callback;
-        T* objectPtr = (T*)sub->argument;
+        //Copied out rather than cast in place, the char buffer isn't guaranteed to be aligned for a member pointer.
+        METHODTYPE mcb;
+        memcpy(&mcb, delegate->m_callbackData, sizeof(METHODTYPE));
+        T* objectPtr = static_cast<T*>(delegate->m_object);
         (objectPtr->*mcb)(args...);
     }
 
     //-----------------------------------------------------------------------------------
-    static void EventFunctionCallback(Subscription* sub, Args... args)
+    template <typename T, void (T::*METHOD)(Args...)>
+    static void BoundMethodStub(const Delegate* delegate, Args... args)
     {
-        FunctionCallback* cb = (FunctionCallback*)(sub->callback);
-        cb(args...);
+        (static_cast<T*>(delegate->m_object)->*METHOD)(args...);
+    }
+
+    //-----------------------------------------------------------------------------------
+    static void FunctionStub(const Delegate* delegate, Args... args)
+    {
+        delegate->m_function(args...);
     }
 
 private:
     //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
-    template <typename CBTYPE>
-    void RegisterSubscription(void* utilityCallback, CBTYPE actualCallback, void* data)
+    template <typename T, typename METHODTYPE>
+    static Delegate MakeMethodDelegate(T* object, METHODTYPE methodCallback)
+    {
+        static_assert(sizeof(METHODTYPE) <= sizeof(Delegate::m_callbackData), "Member function pointer is too big to store in a delegate.");
+        Delegate delegate = {};
+        delegate.m_stub = &MethodStub<T, METHODTYPE>;
+        delegate.m_object = object;
+        memcpy(delegate.m_callbackData, &methodCallback, sizeof(METHODTYPE));
+        return delegate;
+    }
+
+    //-----------------------------------------------------------------------------------
+    //Compared as member pointers rather than bytes, since MSVC's can have padding in them that isn't guaranteed to match.
+    template <typename METHODTYPE>
+    static bool IsSameMethod(const Delegate& first, const Delegate& second)
+    {
+        METHODTYPE firstMethod;
+        METHODTYPE secondMethod;
+        memcpy(&firstMethod, first.m_callbackData, sizeof(METHODTYPE));
+        memcpy(&secondMethod, second.m_callbackData, sizeof(METHODTYPE));
+        return firstMethod == secondMethod;
+    }
+
+    //-----------------------------------------------------------------------------------
+    static bool IsSameFunction(const Delegate& first, const Delegate& second)
+    {
+        return first.m_function == second.m_function;
+    }
+
+    //-----------------------------------------------------------------------------------
+    //Bound methods live in the stub, so there's nothing else to compare.
+    static bool HasNoCallback(const Delegate&, const Delegate&)
     {
-        SubscriptionType<CBTYPE> sub;
-        sub.utilityCallback = (SubscriptionCallback*)utilityCallback;
-        sub.callback = actualCallback;
-        sub.argument = data;
+        return true;
+    }
 
-        Subscription subConv;
-        subConv = *(Subscription*)&sub;
+    //-----------------------------------------------------------------------------------
+    //A matching stub means both delegates store the same kind of callback, so the comparer for one works for the other.
+    static bool IsSameDelegate(const Delegate& first, const Delegate& second, CallbackComparer* isSameCallback)
+    {
+        return first.m_stub == second.m_stub && first.m_object == second.m_object && isSameCallback(first, second);
+    }
 
-        m_subscriptions.push_back(subConv);
+    //-----------------------------------------------------------------------------------
+    bool AddDelegate(const Delegate& delegate, CallbackComparer* isSameCallback)
+    {
+        for (const Delegate& existingDelegate : m_delegates)
+        {
+            if (IsSameDelegate(existingDelegate, delegate, isSameCallback))
+            {
+                return false;
+            }
+        }
+        m_delegates.push_back(delegate);
+        return true;
     }
 
     //-----------------------------------------------------------------------------------
-    template <typename CBTYPE>
-    void UnregisterSubscription(void* utilityCallback, CBTYPE actualCallback, void* data)
+    bool RemoveDelegate(const Delegate& delegate, CallbackComparer* isSameCallback)
     {
-        for (auto subIter = m_subscriptions.begin(); subIter != m_subscriptions.end(); ++subIter)
+        for (auto delegateIter = m_delegates.begin(); delegateIter != m_delegates.end(); ++delegateIter)
         {
-            SubscriptionType<CBTYPE> *sub = (SubscriptionType<CBTYPE>*) &(*subIter);
-            if (sub->callback == actualCallback && sub->utilityCallback == utilityCallback && sub->argument == data)
+            if (IsSameDelegate(*delegateIter, delegate, isSameCallback))
             {
-                m_subscriptions.erase(subIter);
-                break;
+                if (m_triggerDepth > 0)
+                {
+                    delegateIter->m_stub = nullptr;
+                    m_hasRemovedDelegates = true;
+                }
+                else
+                {
+                    m_delegates.erase(delegateIter);
+                }
+                return true;
             }
         }
+        return false;
     }
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
-    std::vector<Subscription, UntrackedAllocator<Subscription>> m_subscriptions;
-};
\ No newline at end of file
+    std::vector<Delegate, UntrackedAllocator<Delegate>> m_delegates;
+    unsigned int m_triggerDepth = 0;
+    bool m_hasRemovedDelegates = false;
+};
@@ -0,0 +1,229 @@
+#include "Engine/Core/Events/EventQueue.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <algorithm>
+
+EventQueue* EventQueue::instance = nullptr;
+const char* const EVENT_PAYLOAD_PROPERTY_NAME = "Payload";
+const char* const EVENT_PAYLOAD_SIZE_PROPERTY_NAME = "PayloadSize";
+
+//-----------------------------------------------------------------------------------
+EventQueue::EventQueue(unsigned int maxQueuedEvents, size_t payloadBytesPerFrame)
+    : m_slots(nullptr)
+    , m_slotMask(maxQueuedEvents - 1)
+    , m_enqueuePosition(0)
+    , m_dequeuePosition(0)
+    , m_currentArenaIndex(0)
+    , m_numDroppedEvents(0)
+    , m_isDispatching(false)
+{
+    ASSERT_OR_DIE(maxQueuedEvents > 0 && (maxQueuedEvents & (maxQueuedEvents - 1)) == 0, "The event queue's size needs to be a power of two.");
+    m_slots = new QueuedEventSlot[maxQueuedEvents];
+    for (unsigned int i = 0; i < maxQueuedEvents; ++i)
+    {
+        m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+    for (EventPayloadArena& arena : m_arenas)
+    {
+        arena.m_data = new byte[payloadBytesPerFrame];
+        arena.m_capacity = payloadBytesPerFrame;
+        arena.m_numBytesUsed.store(0, std::memory_order_relaxed);
+        arena.m_numWriters.store(0, std::memory_order_relaxed);
+    }
+    m_batch.reserve(maxQueuedEvents);
+
+    //Every queued event gets fired with the same properties, we just point them at the next payload.
+    m_dispatchProperties.Set(EVENT_PAYLOAD_PROPERTY_NAME, (const void*)nullptr);
+    m_dispatchProperties.Set(EVENT_PAYLOAD_SIZE_PROPERTY_NAME, (size_t)0);
+}
+
+//-----------------------------------------------------------------------------------
+EventQueue::~EventQueue()
+{
+    delete[] m_slots;
+    for (EventPayloadArena& arena : m_arenas)
+    {
+        delete[] arena.m_data;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool EventQueue::Post(EventId eventId, const void* payload, size_t payloadSize)
+{
+    //Pin the current arena so dispatch can't recycle it under us. If dispatch flipped arenas between the load and the add, back out and pin the new one.
+    EventPayloadArena* arena = nullptr;
+    for (;;)
+    {
+        unsigned int arenaIndex = m_currentArenaIndex.load();
+        arena = &m_arenas[arenaIndex];
+        arena->m_numWriters.fetch_add(1);
+        if (m_currentArenaIndex.load() == arenaIndex)
+        {
+            break;
+        }
+        arena->m_numWriters.fetch_sub(1);
+    }
+
+    bool wasPosted = PostToArena(*arena, eventId, payload, payloadSize);
+    arena->m_numWriters.fetch_sub(1, std::memory_order_release);
+    if (!wasPosted)
+    {
+        m_numDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+    return wasPosted;
+}
+
+//-----------------------------------------------------------------------------------
+//Claims the next slot in the ring the same way a bounded MPMC queue does, except we know there's only ever one consumer.
+bool EventQueue::PostToArena(EventPayloadArena& arena, EventId eventId, const void* payload, size_t payloadSize)
+{
+    const void* payloadCopy = nullptr;
+    if (payloadSize > 0)
+    {
+        size_t alignedSize = (payloadSize + PAYLOAD_ALIGNMENT - 1) & ~(PAYLOAD_ALIGNMENT - 1);
+        size_t offset = arena.m_numBytesUsed.fetch_add(alignedSize, std::memory_order_relaxed);
+        if (offset + alignedSize > arena.m_capacity)
+        {
+            return false;
+        }
+        memcpy(arena.m_data + offset, payload, payloadSize);
+        payloadCopy = arena.m_data + offset;
+    }
+
+    size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    QueuedEventSlot* slot = nullptr;
+    for (;;)
+    {
+        slot = &m_slots[position & m_slotMask];
+        size_t sequence = slot->m_sequence.load(std::memory_order_acquire);
+        ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+        if (difference == 0)
+        {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            //The main thread hasn't gotten around to this slot since last time around the ring.
+            return false;
+        }
+        else
+        {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->m_id = eventId;
+    slot->m_payload = payloadCopy;
+    slot->m_payloadSize = payloadSize;
+    slot->m_sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int EventQueue::DispatchQueuedEvents()
+{
+    ASSERT_OR_DIE(!m_isDispatching, "Queued events can't be dispatched from inside a queued event.");
+    m_isDispatching = true;
+
+    //Flip arenas and wait out anyone still posting into the old one. After that, every event with a payload in there has claimed a slot before endPosition.
+    unsigned int oldArenaIndex = m_currentArenaIndex.load();
+    m_currentArenaIndex.store(1 - oldArenaIndex);
+    EventPayloadArena& oldArena = m_arenas[oldArenaIndex];
+    while (oldArena.m_numWriters.load() > 0)
+    {
+        SwitchToThread();
+    }
+    size_t endPosition = m_enqueuePosition.load(std::memory_order_acquire);
+
+    //Copy the batch out first, so callbacks posting more events have the whole ring to work with. Those fire next dispatch.
+    m_batch.clear();
+    for (; m_dequeuePosition != endPosition; ++m_dequeuePosition)
+    {
+        QueuedEventSlot& slot = m_slots[m_dequeuePosition & m_slotMask];
+        //A claimed slot can still be a couple instructions away from being published.
+        while (slot.m_sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+        {
+            SwitchToThread();
+        }
+        BatchedEvent batchedEvent;
+        batchedEvent.m_id = slot.m_id;
+        batchedEvent.m_payload = slot.m_payload;
+        batchedEvent.m_payloadSize = slot.m_payloadSize;
+        batchedEvent.m_isSuperseded = false;
+        m_batch.push_back(batchedEvent);
+        slot.m_sequence.store(m_dequeuePosition + m_slotMask + 1, std::memory_order_release);
+    }
+    MarkSupersededEvents();
+
+    unsigned int numEventsFired = 0;
+    const NamedPropertyKey payloadKey(EVENT_PAYLOAD_PROPERTY_NAME);
+    const NamedPropertyKey payloadSizeKey(EVENT_PAYLOAD_SIZE_PROPERTY_NAME);
+    for (const BatchedEvent& batchedEvent : m_batch)
+    {
+        if (batchedEvent.m_isSuperseded)
+        {
+            continue;
+        }
+        //Both already exist as these types, so this is just a couple of stores into the properties.
+        m_dispatchProperties.Set(payloadKey, batchedEvent.m_payload);
+        m_dispatchProperties.Set(payloadSizeKey, batchedEvent.m_payloadSize);
+        EventSystem::FireEvent(batchedEvent.m_id, m_dispatchProperties);
+        ++numEventsFired;
+    }
+
+    //Nothing can still be pointing into the old arena now.
+    oldArena.m_numBytesUsed.store(0, std::memory_order_relaxed);
+    m_isDispatching = false;
+    return numEventsFired;
+}
+
+//-----------------------------------------------------------------------------------
+//Walks the batch backwards so the first post we see of a coalesced event is the one that gets to fire.
+void EventQueue::MarkSupersededEvents()
+{
+    if (m_coalescedEventIds.empty())
+    {
+        return;
+    }
+    m_seenCoalescedEventIds.clear();
+    for (auto iter = m_batch.rbegin(); iter != m_batch.rend(); ++iter)
+    {
+        if (!IsCoalesced(iter->m_id))
+        {
+            continue;
+        }
+        if (std::find(m_seenCoalescedEventIds.begin(), m_seenCoalescedEventIds.end(), iter->m_id) != m_seenCoalescedEventIds.end())
+        {
+            iter->m_isSuperseded = true;
+        }
+        else
+        {
+            m_seenCoalescedEventIds.push_back(iter->m_id);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void EventQueue::SetCoalesced(EventId eventId, bool isCoalesced)
+{
+    auto iter = std::lower_bound(m_coalescedEventIds.begin(), m_coalescedEventIds.end(), eventId);
+    bool wasCoalesced = iter != m_coalescedEventIds.end() && *iter == eventId;
+    if (isCoalesced && !wasCoalesced)
+    {
+        m_coalescedEventIds.insert(iter, eventId);
+    }
+    else if (!isCoalesced && wasCoalesced)
+    {
+        m_coalescedEventIds.erase(iter);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool EventQueue::IsCoalesced(EventId eventId) const
+{
+    return std::binary_search(m_coalescedEventIds.begin(), m_coalescedEventIds.end(), eventId);
+}
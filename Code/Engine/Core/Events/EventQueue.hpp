@@ -0,0 +1,114 @@
+#pragma once
+#include "Engine/Core/Events/EventSystem.hpp"
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+typedef unsigned char byte;
+
+//Names of the properties queued events are fired with. Only valid for the duration of the callback.
+extern const char* const EVENT_PAYLOAD_PROPERTY_NAME;
+extern const char* const EVENT_PAYLOAD_SIZE_PROPERTY_NAME;
+
+//-----------------------------------------------------------------------------------
+struct QueuedEventSlot
+{
+    std::atomic<size_t> m_sequence; //position + 1 once the slot's been published, position + slot count once it's free again
+    EventId m_id;
+    const void* m_payload;
+    size_t m_payloadSize;
+};
+
+//-----------------------------------------------------------------------------------
+//One half of the double buffered payload memory. Posting threads bump allocate out of it with an atomic add.
+struct EventPayloadArena
+{
+    byte* m_data;
+    size_t m_capacity;
+    std::atomic<size_t> m_numBytesUsed;
+    std::atomic<unsigned int> m_numWriters; //Posts that might still be writing into this arena
+};
+
+//-----------------------------------------------------------------------------------
+struct BatchedEvent
+{
+    EventId m_id;
+    const void* m_payload;
+    size_t m_payloadSize;
+    bool m_isSuperseded; //A coalesced event with a newer post later in the same batch
+};
+
+//-----------------------------------------------------------------------------------
+//Any thread can post events here without locking, and they get fired through the EventSystem on the main thread when it calls DispatchQueuedEvents.
+//Events fire in the order their posts claimed a slot, so each thread's events always come out in the order it posted them.
+//Payloads are copied into a frame arena, so they have to be trivially copyable. The arena is recycled after the dispatch that fires them.
+class EventQueue
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    EventQueue(unsigned int maxQueuedEvents = DEFAULT_MAX_QUEUED_EVENTS, size_t payloadBytesPerFrame = DEFAULT_PAYLOAD_BYTES_PER_FRAME);
+    ~EventQueue();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    //Returns false and drops the event if the queue or this frame's payload arena is full.
+    bool Post(EventId eventId, const void* payload = nullptr, size_t payloadSize = 0);
+    //Main thread only, once a frame. Returns how many events were fired.
+    unsigned int DispatchQueuedEvents();
+    //Coalesced events only fire their most recent post each dispatch. Main thread only.
+    void SetCoalesced(EventId eventId, bool isCoalesced);
+    bool IsCoalesced(EventId eventId) const;
+    inline unsigned int GetNumDroppedEvents() const { return m_numDroppedEvents.load(std::memory_order_relaxed); };
+
+    //-----------------------------------------------------------------------------------
+    template<typename T>
+    bool Post(EventId eventId, const T& payload)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Queued event payloads get memcpy'd into a frame arena, so they need to be trivially copyable.");
+        return Post(eventId, &payload, sizeof(T));
+    }
+
+    //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
+    static EventQueue* instance;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int DEFAULT_MAX_QUEUED_EVENTS = 4096;
+    static const size_t DEFAULT_PAYLOAD_BYTES_PER_FRAME = 256 * 1024;
+    static const size_t PAYLOAD_ALIGNMENT = 16;
+
+private:
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool PostToArena(EventPayloadArena& arena, EventId eventId, const void* payload, size_t payloadSize);
+    void MarkSupersededEvents();
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    QueuedEventSlot* m_slots;
+    size_t m_slotMask;
+    std::atomic<size_t> m_enqueuePosition;
+    size_t m_dequeuePosition; //Main thread only
+    EventPayloadArena m_arenas[2];
+    std::atomic<unsigned int> m_currentArenaIndex;
+    std::atomic<unsigned int> m_numDroppedEvents;
+    std::vector<BatchedEvent, UntrackedAllocator<BatchedEvent>> m_batch;
+    std::vector<EventId, UntrackedAllocator<EventId>> m_coalescedEventIds; //Sorted
+    std::vector<EventId, UntrackedAllocator<EventId>> m_seenCoalescedEventIds;
+    NamedProperties m_dispatchProperties;
+    bool m_isDispatching;
+};
+
+//-----------------------------------------------------------------------------------
+//For subscribers to queued events. Returns nullptr if the event wasn't posted with a T.
+template<typename T>
+const T* GetQueuedEventPayload(const NamedProperties& params)
+{
+    const void* payload = nullptr;
+    size_t payloadSize = 0;
+    if (params.Get(EVENT_PAYLOAD_PROPERTY_NAME, payload) != PGR_SUCCESS || params.Get(EVENT_PAYLOAD_SIZE_PROPERTY_NAME, payloadSize) != PGR_SUCCESS || payloadSize != sizeof(T))
+    {
+        return nullptr;
+    }
+    return static_cast<const T*>(payload);
+}
@@ -1,47 +1,220 @@
 #include "Engine/Core/Events/EventSystem.hpp"
+#include <algorithm>
 
-std::map<std::string, std::vector<RegisteredObjectBase*>, std::less<std::string>, UntrackedAllocator<std::pair<std::string, std::vector<RegisteredObjectBase*>>>>EventSystem::s_registeredFunctions;
+std::vector<EventSubscriberList, UntrackedAllocator<EventSubscriberList>> EventSystem::s_events;
+std::vector<std::pair<std::string, RegisteredObjectBase*>, UntrackedAllocator<std::pair<std::string, RegisteredObjectBase*>>> EventSystem::s_pendingRegistrations;
+std::vector<RegisteredObjectBase*, UntrackedAllocator<RegisteredObjectBase*>> EventSystem::s_pendingDeletes;
+unsigned int EventSystem::s_dispatchDepth = 0;
 
 //-----------------------------------------------------------------------------------
-void EventSystem::FireEvent(const char* name, NamedProperties& namedProperties)
+void EventSystem::FireEvent(EventId eventId, NamedProperties& namedProperties)
 {
-    std::vector<RegisteredObjectBase*> functions = EventSystem::s_registeredFunctions[std::string(name)];
-    for (RegisteredObjectBase* callee : functions)
+    EventSubscriberList* eventList = FindEvent(eventId);
+    if (!eventList)
+    {
+        return;
+    }
+
+    //Nothing can add to or shuffle either array until we're done, so walking by index is safe. Unregistered slots just go null.
+    ++s_dispatchDepth;
+    size_t numSubscribers = eventList->m_subscribers.size();
+    for (size_t i = 0; i < numSubscribers; ++i)
+    {
+        RegisteredObjectBase* callee = eventList->m_subscribers[i];
+        if (callee)
+        {
+            callee->Execute(namedProperties);
+        }
+    }
+    --s_dispatchDepth;
+
+    if (s_dispatchDepth == 0 && (!s_pendingRegistrations.empty() || !s_pendingDeletes.empty()))
     {
-        callee->Execute(namedProperties);
+        ApplyDeferredChanges();
     }
 }
 
+//-----------------------------------------------------------------------------------
+void EventSystem::FireEvent(const char* name, NamedProperties& namedProperties)
+{
+    FireEvent(HashEventName(name), namedProperties);
+}
+
 //-----------------------------------------------------------------------------------
 void EventSystem::FireEvent(const std::string& name, NamedProperties& namedProperties)
 {
-    std::vector<RegisteredObjectBase*> functions = EventSystem::s_registeredFunctions[name];
-    for (RegisteredObjectBase* callee : functions)
+    FireEvent(HashEventName(name.c_str()), namedProperties);
+}
+
+//-----------------------------------------------------------------------------------
+EventSubscriberList* EventSystem::FindEvent(EventId eventId)
+{
+    auto iter = std::lower_bound(s_events.begin(), s_events.end(), eventId, [](const EventSubscriberList& eventList, EventId id) { return eventList.m_id < id; });
+    if (iter == s_events.end() || iter->m_id != eventId)
+    {
+        return nullptr;
+    }
+    return &(*iter);
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int EventSystem::GetNumSubscribers(EventId eventId)
+{
+    EventSubscriberList* eventList = FindEvent(eventId);
+    if (!eventList)
+    {
+        return 0;
+    }
+    return (unsigned int)std::count_if(eventList->m_subscribers.begin(), eventList->m_subscribers.end(), [](RegisteredObjectBase* subscriber) { return subscriber != nullptr; });
+}
+
+//-----------------------------------------------------------------------------------
+void EventSystem::AddSubscriber(const std::string& eventName, RegisteredObjectBase* subscriber)
+{
+    if (s_dispatchDepth > 0)
+    {
+        s_pendingRegistrations.emplace_back(eventName, subscriber);
+        return;
+    }
+    AddSubscriberNow(eventName, subscriber);
+}
+
+//-----------------------------------------------------------------------------------
+void EventSystem::AddSubscriberNow(const std::string& eventName, RegisteredObjectBase* subscriber)
+{
+    EventId eventId = HashEventName(eventName.c_str());
+    auto iter = std::lower_bound(s_events.begin(), s_events.end(), eventId, [](const EventSubscriberList& eventList, EventId id) { return eventList.m_id < id; });
+    if (iter == s_events.end() || iter->m_id != eventId)
+    {
+        EventSubscriberList newEvent;
+        newEvent.m_id = eventId;
+        newEvent.m_name = eventName;
+        iter = s_events.insert(iter, std::move(newEvent));
+    }
+    ASSERT_OR_DIE(iter->m_name == eventName, Stringf("Events '%s' and '%s' hash to the same id, one of them needs a new name.", iter->m_name.c_str(), eventName.c_str()));
+    iter->m_subscribers.push_back(subscriber);
+}
+
+//-----------------------------------------------------------------------------------
+//Subscribers aren't deleted until no dispatch is running, since one could be unregistering itself from inside its own callback.
+void EventSystem::RemoveOwnerFromList(EventSubscriberList& eventList, void* owningObject)
+{
+    for (RegisteredObjectBase*& subscriber : eventList.m_subscribers)
+    {
+        if (subscriber && subscriber->GetOwningObject() == owningObject)
+        {
+            s_pendingDeletes.push_back(subscriber);
+            subscriber = nullptr;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void EventSystem::UnregisterOwnerFromEvent(EventId eventId, void* owningObject)
+{
+    EventSubscriberList* eventList = FindEvent(eventId);
+    if (eventList)
+    {
+        RemoveOwnerFromList(*eventList, owningObject);
+    }
+    //Also catch anything that registered during this dispatch and hasn't been added yet.
+    for (auto iter = s_pendingRegistrations.begin(); iter != s_pendingRegistrations.end();)
     {
-        callee->Execute(namedProperties);
+        if (HashEventName(iter->first.c_str()) == eventId && iter->second->GetOwningObject() == owningObject)
+        {
+            s_pendingDeletes.push_back(iter->second);
+            iter = s_pendingRegistrations.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+    if (s_dispatchDepth == 0)
+    {
+        ApplyDeferredChanges();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void EventSystem::UnregisterOwnerFromAllEvents(void* owningObject)
+{
+    for (EventSubscriberList& eventList : s_events)
+    {
+        RemoveOwnerFromList(eventList, owningObject);
+    }
+    for (auto iter = s_pendingRegistrations.begin(); iter != s_pendingRegistrations.end();)
+    {
+        if (iter->second->GetOwningObject() == owningObject)
+        {
+            s_pendingDeletes.push_back(iter->second);
+            iter = s_pendingRegistrations.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+    if (s_dispatchDepth == 0)
+    {
+        ApplyDeferredChanges();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Only ever runs with no dispatch on the stack.
+void EventSystem::ApplyDeferredChanges()
+{
+    if (!s_pendingDeletes.empty())
+    {
+        for (EventSubscriberList& eventList : s_events)
+        {
+            auto& subscribers = eventList.m_subscribers;
+            subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), nullptr), subscribers.end());
+        }
+        for (RegisteredObjectBase* subscriber : s_pendingDeletes)
+        {
+            delete subscriber;
+        }
+        s_pendingDeletes.clear();
+    }
+
+    //Swap out first, in case registering something somehow registers something else.
+    std::vector<std::pair<std::string, RegisteredObjectBase*>, UntrackedAllocator<std::pair<std::string, RegisteredObjectBase*>>> pendingRegistrations;
+    pendingRegistrations.swap(s_pendingRegistrations);
+    for (auto& registration : pendingRegistrations)
+    {
+        AddSubscriberNow(registration.first, registration.second);
     }
 }
 
 //-----------------------------------------------------------------------------------
 void EventSystem::CleanUpEventRegistry()
 {
-    for (auto eventPair : s_registeredFunctions)
+    ASSERT_OR_DIE(s_dispatchDepth == 0, "Can't clean up the event registry in the middle of firing an event.");
+    for (EventSubscriberList& eventList : s_events)
     {
-        std::vector<RegisteredObjectBase*>& subscribers = eventPair.second;
-        for (auto iter = subscribers.begin(); iter != subscribers.end();)
+        for (RegisteredObjectBase* subscriber : eventList.m_subscribers)
         {
-            RegisteredObjectBase* rob = *iter;
-            iter = subscribers.erase(iter);
-            delete rob;
+            delete subscriber;
         }
-        subscribers.clear();
     }
-    s_registeredFunctions.clear();
+    for (auto& registration : s_pendingRegistrations)
+    {
+        delete registration.second;
+    }
+    for (RegisteredObjectBase* subscriber : s_pendingDeletes)
+    {
+        delete subscriber;
+    }
+    s_events.clear();
+    s_pendingRegistrations.clear();
+    s_pendingDeletes.clear();
 }
 
 //-----------------------------------------------------------------------------------
 void EventSystem::RegisterEventCallback(const std::string& eventName, EventCallbackFunction* m_function, const char* usage)
 {
     RegisteredFunction* rom = new RegisteredFunction(m_function, usage);
-    s_registeredFunctions[eventName].push_back(rom);
-}
\ No newline at end of file
+    AddSubscriber(eventName, rom);
+}
@@ -6,6 +6,14 @@
 #include "../Memory/UntrackedAllocator.hpp"
 
 typedef void (EventCallbackFunction)(NamedProperties& params);
+typedef size_t EventId;
+
+//-----------------------------------------------------------------------------------
+//FNV-1a, same as the profiler's sample ids. Hash a name once into a static const EventId and fire that instead of building a string every time.
+constexpr EventId HashEventName(const char* name, EventId hash = 2166136261U)
+{
+    return *name ? HashEventName(name + 1, (hash ^ (unsigned char)*name) * 16777619U) : hash;
+}
 
 //-----------------------------------------------------------------------------------
 struct RegisteredObjectBase
@@ -49,44 +57,41 @@ struct RegisteredObjectMethod : public RegisteredObjectBase
 };
 
 //-----------------------------------------------------------------------------------
+struct EventSubscriberList
+{
+    EventId m_id;
+    std::string m_name; //Only kept around to catch two names hashing to the same id
+    std::vector<RegisteredObjectBase*, UntrackedAllocator<RegisteredObjectBase*>> m_subscribers; //Unregistered slots are left null until the outermost dispatch finishes
+};
+
+//-----------------------------------------------------------------------------------
+//Events live in one flat array sorted by id, and each event's subscribers are a flat array of their own.
+//Registering or unregistering from inside a callback is deferred until the outermost FireEvent returns, so dispatch never sees the arrays move.
 class EventSystem
 {
 public:
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     static void RegisterEventCallback(const std::string& eventName, EventCallbackFunction* m_function, const char* usage = nullptr);
+    static void FireEvent(EventId eventId, NamedProperties& namedProperties = NamedProperties::NONE);
     static void FireEvent(const std::string& name, NamedProperties& namedProperties = NamedProperties::NONE);
     static void FireEvent(const char* name, NamedProperties& namedProperties = NamedProperties::NONE);
+    static void UnregisterOwnerFromEvent(EventId eventId, void* owningObject);
+    static void UnregisterOwnerFromAllEvents(void* owningObject);
+    static unsigned int GetNumSubscribers(EventId eventId);
     static void CleanUpEventRegistry();
 
     //-----------------------------------------------------------------------------------
     template<typename T_ObjectType>
     static void UnregisterFromEvent(const std::string& eventName, T_ObjectType object)
     {
-        std::vector<RegisteredObjectBase*>& subscribers = s_registeredFunctions[eventName];
-        for (auto iter = subscribers.begin(); iter != subscribers.end();)
-        {
-            RegisteredObjectBase* rob = *iter;
-            void* owningObject = rob->GetOwningObject();
-            if (static_cast<void*>(object) == owningObject)
-            {
-                iter = subscribers.erase(iter);
-                delete rob;
-            }
-            else
-            {
-                ++iter;
-            }
-        }
+        UnregisterOwnerFromEvent(HashEventName(eventName.c_str()), static_cast<void*>(object));
     }
 
     //-----------------------------------------------------------------------------------
     template<typename T_ObjectType>
     static void UnregisterFromAllEvents(T_ObjectType object)
     {
-        for (auto eventPair : s_registeredFunctions)
-        {
-            UnregisterFromEvent<T_ObjectType>(eventPair.first, object);
-        }
+        UnregisterOwnerFromAllEvents(static_cast<void*>(object));
     }
 
     //-----------------------------------------------------------------------------------
@@ -94,9 +99,20 @@ public:
     static void RegisterObjectForEvent(const std::string& eventName, T_ObjectType object, T_MethodType method, const char* usage = nullptr)
     {
         RegisteredObjectMethod<T_ObjectType, T_MethodType>* rom = new RegisteredObjectMethod<T_ObjectType, T_MethodType>(object, method, usage);
-        s_registeredFunctions[eventName].push_back(rom);
+        AddSubscriber(eventName, rom);
     }
 
-    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
-    static std::map<std::string, std::vector<RegisteredObjectBase*>, std::less<std::string>, UntrackedAllocator<std::pair<std::string, std::vector<RegisteredObjectBase*>>>> s_registeredFunctions;
+private:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void AddSubscriber(const std::string& eventName, RegisteredObjectBase* subscriber);
+    static void AddSubscriberNow(const std::string& eventName, RegisteredObjectBase* subscriber);
+    static EventSubscriberList* FindEvent(EventId eventId);
+    static void RemoveOwnerFromList(EventSubscriberList& eventList, void* owningObject);
+    static void ApplyDeferredChanges();
+
+    //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
+    static std::vector<EventSubscriberList, UntrackedAllocator<EventSubscriberList>> s_events;
+    static std::vector<std::pair<std::string, RegisteredObjectBase*>, UntrackedAllocator<std::pair<std::string, RegisteredObjectBase*>>> s_pendingRegistrations;
+    static std::vector<RegisteredObjectBase*, UntrackedAllocator<RegisteredObjectBase*>> s_pendingDeletes;
+    static unsigned int s_dispatchDepth;
 };
@@ -3,87 +3,153 @@
 NamedProperties NamedProperties::NONE;
 
 //-----------------------------------------------------------------------------------
-NamedProperties::NamedProperties()
+NamedProperty::NamedProperty()
+    : m_nameHash(0)
+    , m_type(nullptr)
 {
 
 }
 
 //-----------------------------------------------------------------------------------
-NamedProperties::~NamedProperties()
+NamedProperty::NamedProperty(const NamedProperty& other)
+    : m_nameHash(other.m_nameHash)
+    , m_type(other.m_type)
+    , m_name(other.m_name)
 {
-    for (auto keyValuePair : m_properties)
+    if (m_type)
     {
-        delete keyValuePair.second;
+        m_type->m_copyValue(m_storage, other.m_storage);
     }
-    m_properties.clear();
 }
 
 //-----------------------------------------------------------------------------------
-PropertySetResult NamedProperties::Set(const std::string& propertyName, std::string propertyValue, bool changeTypeIfDifferent)
+//Heap values just change hands, inline ones get copied and the original is destroyed along with other.
+NamedProperty::NamedProperty(NamedProperty&& other) noexcept
+    : m_nameHash(other.m_nameHash)
+    , m_type(other.m_type)
+    , m_name(std::move(other.m_name))
 {
-    PropertySetResult result = PSR_SUCCESS;
-    auto foundPair = m_properties.find(propertyName);
-    if (foundPair != m_properties.end())
+    if (!m_type)
+    {
+        return;
+    }
+    if (m_type->m_isStoredInline)
+    {
+        m_type->m_copyValue(m_storage, other.m_storage);
+    }
+    else
     {
-        NamedPropertyBase* property = foundPair->second;
-        TypedNameProperty<std::string>* foundProperty = dynamic_cast<TypedNameProperty<std::string>*>(property);
-        bool typesMatch = foundProperty && typeid(propertyValue) == typeid(foundProperty->m_data);
+        memcpy(m_storage, other.m_storage, sizeof(void*));
+        other.m_type = nullptr;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+NamedProperty::~NamedProperty()
+{
+    DestroyValue();
+}
 
-        if (!typesMatch)
+//-----------------------------------------------------------------------------------
+NamedProperty& NamedProperty::operator=(const NamedProperty& other)
+{
+    if (this != &other)
+    {
+        DestroyValue();
+        m_nameHash = other.m_nameHash;
+        m_name = other.m_name;
+        m_type = other.m_type;
+        if (m_type)
         {
-            if (m_neverChangeTypeIfDifferent || !changeTypeIfDifferent)
-            {
-                result = PSR_FAILED_DIFF_TYPE;
-                ERROR_RECOVERABLE(Stringf("Attempted to set '%s' to a different type when it wasn't allowed.", propertyName.c_str()));
-                return result;
-            }
+            m_type->m_copyValue(m_storage, other.m_storage);
         }
-
-        result = PSR_SUCCESS_EXISTED;
-        delete foundProperty;
     }
-    m_properties[propertyName] = static_cast<NamedPropertyBase*>(new TypedNameProperty<std::string>(propertyValue));
-    return result;
+    return *this;
 }
 
 //-----------------------------------------------------------------------------------
-PropertyGetResult NamedProperties::Get(const std::string& propertyName, std::string& outPropertyValue)
+NamedProperty& NamedProperty::operator=(NamedProperty&& other) noexcept
 {
-    if (m_properties.size() == 0)
+    if (this != &other)
     {
-        return PropertyGetResult::PGR_FAILED_NO_PROPERTIES;
-    }
-    auto result = m_properties.find(propertyName);
-    if (result == m_properties.end())
-    {
-        return PropertyGetResult::PGR_FAILED_NO_SUCH_PROPERTY;
+        DestroyValue();
+        m_nameHash = other.m_nameHash;
+        m_name = std::move(other.m_name);
+        m_type = other.m_type;
+        if (!m_type)
+        {
+            return *this;
+        }
+        if (m_type->m_isStoredInline)
+        {
+            m_type->m_copyValue(m_storage, other.m_storage);
+        }
+        else
+        {
+            memcpy(m_storage, other.m_storage, sizeof(void*));
+            other.m_type = nullptr;
+        }
     }
+    return *this;
+}
 
-    NamedPropertyBase* property = result->second;
-    TypedNameProperty<std::string>* typedProperty = dynamic_cast<TypedNameProperty<std::string>*>(property);
-    if (!typedProperty)
+//-----------------------------------------------------------------------------------
+void NamedProperty::DestroyValue()
+{
+    if (m_type)
     {
-        return PropertyGetResult::PGR_FAILED_WRONG_TYPE;
+        m_type->m_destroyValue(m_storage);
+        m_type = nullptr;
     }
-    outPropertyValue = std::string(typedProperty->m_data);
+}
+
+//-----------------------------------------------------------------------------------
+NamedProperties::NamedProperties()
+{
+
+}
+
+//-----------------------------------------------------------------------------------
+NamedProperties::~NamedProperties()
+{
+    m_properties.clear();
+}
 
-    return PropertyGetResult::PGR_SUCCESS;
+//-----------------------------------------------------------------------------------
+PropertySetResult NamedProperties::Set(const NamedPropertyKey& propertyName, std::string propertyValue, bool changeTypeIfDifferent)
+{
+    return Set<std::string>(propertyName, propertyValue, changeTypeIfDifferent);
+}
 
+//-----------------------------------------------------------------------------------
+PropertyGetResult NamedProperties::Get(const NamedPropertyKey& propertyName, std::string& outPropertyValue) const
+{
+    return Get<std::string>(propertyName, outPropertyValue);
 }
 
 //-----------------------------------------------------------------------------------
-bool NamedProperties::Remove(const std::string& propertyName)
+//Order doesn't mean anything, so the last property fills the hole instead of shifting everything down.
+bool NamedProperties::Remove(const NamedPropertyKey& propertyName)
 {
-    auto foundPair = m_properties.find(propertyName);
-    if (foundPair != m_properties.end())
+    NamedProperty* property = FindProperty(propertyName);
+    if (!property)
     {
-        delete foundPair->second;
-        m_properties.erase(foundPair);
-        return true;
+        return false;
     }
-    else
+    if (property != &m_properties.back())
     {
-        return false;
+        *property = std::move(m_properties.back());
     }
+    m_properties.pop_back();
+    return true;
 }
 
+//-----------------------------------------------------------------------------------
+NamedProperty& NamedProperties::AddProperty(const NamedPropertyKey& propertyName)
+{
+    m_properties.emplace_back();
+    NamedProperty& property = m_properties.back();
+    property.m_nameHash = propertyName.m_hash;
+    property.m_name.assign(propertyName.m_name, propertyName.m_length);
+    return property;
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include <string>
-#include <map>
+#include <cstring>
+#include <vector>
+#include <new>
+#include <type_traits>
 #include "Engine\Core\ErrorWarningAssert.hpp"
 #include "Engine\Core\StringUtils.hpp"
 #include "Engine\Core\Memory\UntrackedAllocator.hpp"
@@ -25,28 +28,128 @@ enum PropertySetResult
     PSR_NUM_RESULTS
 };
 
+//Values this small get stored right in the property instead of on the heap.
+const size_t NAMED_PROPERTY_INLINE_BYTES = 16;
+
 //-----------------------------------------------------------------------------------
-struct NamedPropertyBase
+//FNV-1a over the name, same as HashEventName. Only lives as long as the string it was made from, so don't hold onto one.
+struct NamedPropertyKey
 {
-    virtual ~NamedPropertyBase() {};
+    NamedPropertyKey(const char* name)
+        : m_name(name)
+        , m_length(strlen(name))
+        , m_hash(HashName(name, m_length))
+    {
+    }
+
+    NamedPropertyKey(const std::string& name)
+        : m_name(name.c_str())
+        , m_length(name.size())
+        , m_hash(HashName(name.c_str(), m_length))
+    {
+    }
+
+    static inline size_t HashName(const char* name, size_t length)
+    {
+        size_t hash = 2166136261U;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash = (hash ^ (unsigned char)name[i]) * 16777619U;
+        }
+        return hash;
+    }
+
+    const char* m_name;
+    size_t m_length;
+    size_t m_hash;
+};
+
+//-----------------------------------------------------------------------------------
+//One of these exists per stored type, and its address is the type tag we compare against instead of using RTTI.
+//They're deliberately not const, so the linker can't fold two types with identical functions into one tag.
+struct NamedPropertyType
+{
+    void(*m_copyValue)(void* destinationStorage, const void* sourceStorage);
+    void(*m_destroyValue)(void* storage);
+    bool m_isStoredInline;
 };
 
 //-----------------------------------------------------------------------------------
 template<typename T>
-struct TypedNameProperty : public NamedPropertyBase
+struct NamedPropertyTypeOf
 {
-    TypedNameProperty(const T& data)
-        : m_data(data)
+    static const bool IS_STORED_INLINE = sizeof(T) <= NAMED_PROPERTY_INLINE_BYTES && alignof(T) <= alignof(double);
+
+    //-----------------------------------------------------------------------------------
+    static void ConstructValue(void* storage, const T& value)
     {
-        //If you get an "array initialization" compile error pointing here, you probably forgot to put <std::string> when using the string Set
+        if (IS_STORED_INLINE)
+        {
+            new (storage) T(value);
+        }
+        else
+        {
+            *static_cast<T**>(storage) = new T(value);
+        }
     }
 
-    virtual ~TypedNameProperty() {};
+    //-----------------------------------------------------------------------------------
+    static void CopyValue(void* destinationStorage, const void* sourceStorage)
+    {
+        ConstructValue(destinationStorage, *GetValue(sourceStorage));
+    }
 
-    T m_data;
+    //-----------------------------------------------------------------------------------
+    static void DestroyValue(void* storage)
+    {
+        if (IS_STORED_INLINE)
+        {
+            static_cast<T*>(storage)->~T();
+        }
+        else
+        {
+            delete *static_cast<T**>(storage);
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    static inline const T* GetValue(const void* storage)
+    {
+        return IS_STORED_INLINE ? static_cast<const T*>(storage) : *static_cast<const T* const*>(storage);
+    }
+
+    static NamedPropertyType s_type;
 };
 
+template<typename T>
+NamedPropertyType NamedPropertyTypeOf<T>::s_type = { &NamedPropertyTypeOf<T>::CopyValue, &NamedPropertyTypeOf<T>::DestroyValue, NamedPropertyTypeOf<T>::IS_STORED_INLINE };
+
 //-----------------------------------------------------------------------------------
+struct NamedProperty
+{
+    NamedProperty();
+    NamedProperty(const NamedProperty& other);
+    NamedProperty(NamedProperty&& other) noexcept;
+    ~NamedProperty();
+    NamedProperty& operator=(const NamedProperty& other);
+    NamedProperty& operator=(NamedProperty&& other) noexcept;
+
+    void DestroyValue();
+    inline bool HasName(const NamedPropertyKey& key) const { return m_nameHash == key.m_hash && m_name.size() == key.m_length && memcmp(m_name.data(), key.m_name, key.m_length) == 0; };
+
+    size_t m_nameHash;
+    const NamedPropertyType* m_type; //nullptr until a value's been constructed
+    std::string m_name;
+    union
+    {
+        unsigned char m_storage[NAMED_PROPERTY_INLINE_BYTES];
+        double m_alignment;
+    };
+};
+
+//-----------------------------------------------------------------------------------
+//A flat array of properties, searched by name hash. Setting a property that already exists as the same type never allocates,
+//and neither does setting a new one that fits inline once the array has room for it.
 class NamedProperties
 {
 public:
@@ -56,23 +159,25 @@ public:
 
     //-----------------------------------------------------------------------------------
     template<typename T>
-    NamedProperties(const std::string& propertyName1, const T& propertyValue1)
+    NamedProperties(const NamedPropertyKey& propertyName1, const T& propertyValue1)
     {
         Set(propertyName1, propertyValue1);
     }
 
     //-----------------------------------------------------------------------------------
     template<typename T, typename U>
-    NamedProperties(const std::string& propertyName1, const T& propertyValue1, const std::string& propertyName2, const U& propertyValue2)
+    NamedProperties(const NamedPropertyKey& propertyName1, const T& propertyValue1, const NamedPropertyKey& propertyName2, const U& propertyValue2)
     {
+        m_properties.reserve(2);
         Set(propertyName1, propertyValue1);
         Set(propertyName2, propertyValue2);
     }
 
     //-----------------------------------------------------------------------------------
     template<typename T, typename U, typename V>
-    NamedProperties(const std::string& propertyName1, const T& propertyValue1, const std::string& propertyName2, const U& propertyValue2, const std::string& propertyName3, const V& propertyValue3)
+    NamedProperties(const NamedPropertyKey& propertyName1, const T& propertyValue1, const NamedPropertyKey& propertyName2, const U& propertyValue2, const NamedPropertyKey& propertyName3, const V& propertyValue3)
     {
+        m_properties.reserve(3);
         Set(propertyName1, propertyValue1);
         Set(propertyName2, propertyValue2);
         Set(propertyName3, propertyValue3);
@@ -81,78 +186,100 @@ public:
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     //-----------------------------------------------------------------------------------
     template<typename T>
-    PropertyGetResult Get(const std::string& propertyName, T& outPropertyValue)
+    PropertyGetResult Get(const NamedPropertyKey& propertyName, T& outPropertyValue) const
     {
         if (m_properties.size() == 0)
         {
             return PropertyGetResult::PGR_FAILED_NO_PROPERTIES;
         }
-        auto result = m_properties.find(propertyName);
-        if (result == m_properties.end())
+        const NamedProperty* property = FindProperty(propertyName);
+        if (!property)
         {
             return PropertyGetResult::PGR_FAILED_NO_SUCH_PROPERTY;
         }
-
-        NamedPropertyBase* property = result->second;
-        TypedNameProperty<T>* typedProperty = dynamic_cast<TypedNameProperty<T>*>(property);
-        if (!typedProperty || (typeid(outPropertyValue) != typeid(typedProperty->m_data)))
+        if (property->m_type != &NamedPropertyTypeOf<T>::s_type)
         {
             return PropertyGetResult::PGR_FAILED_WRONG_TYPE;
         }
-        outPropertyValue = typedProperty->m_data;
+        outPropertyValue = *NamedPropertyTypeOf<T>::GetValue(property->m_storage);
 
         return PropertyGetResult::PGR_SUCCESS;
     };
 
     //-----------------------------------------------------------------------------------
     template<typename T>
-    T Get(const std::string& propertyName)
+    T Get(const NamedPropertyKey& propertyName) const
     {
         T returnVal;
         PropertyGetResult result = Get<T>(propertyName, returnVal);
         if (result != PGR_SUCCESS)
         {
-            ERROR_RECOVERABLE(Stringf("Property %s wasn't found.", propertyName.c_str()));
+            ERROR_RECOVERABLE(Stringf("Property %s wasn't found.", propertyName.m_name));
         }
         return returnVal;
     }
 
     //-----------------------------------------------------------------------------------
     template<typename T>
-    PropertySetResult Set(const std::string& propertyName, const T& propertyValue, bool changeTypeIfDifferent = true)
+    PropertySetResult Set(const NamedPropertyKey& propertyName, const T& propertyValue, bool changeTypeIfDifferent = true)
     {
-        PropertySetResult result = PSR_SUCCESS;
-        auto foundPair = m_properties.find(propertyName);
+        static_assert(!std::is_array<T>::value, "Arrays can't be stored as properties. You probably forgot to put <std::string> when using the string Set.");
+        NamedProperty* property = FindProperty(propertyName);
+        if (!property)
+        {
+            property = &AddProperty(propertyName);
+            NamedPropertyTypeOf<T>::ConstructValue(property->m_storage, propertyValue);
+            property->m_type = &NamedPropertyTypeOf<T>::s_type;
+            return PSR_SUCCESS;
+        }
 
-        if (foundPair != m_properties.end())
+        if (property->m_type == &NamedPropertyTypeOf<T>::s_type)
         {
-            NamedPropertyBase* property = foundPair->second;
-            TypedNameProperty<T>* foundProperty = dynamic_cast<TypedNameProperty<T>*>(property);
-            bool typesMatch = foundProperty && typeid(propertyValue) == typeid(foundProperty->m_data);
+            *const_cast<T*>(NamedPropertyTypeOf<T>::GetValue(property->m_storage)) = propertyValue;
+            return PSR_SUCCESS_EXISTED;
+        }
 
-            if (!typesMatch)
+        if (m_neverChangeTypeIfDifferent || !changeTypeIfDifferent)
+        {
+            ERROR_RECOVERABLE(Stringf("Attempted to set '%s' to a different type when it wasn't allowed.", propertyName.m_name));
+            return PSR_FAILED_DIFF_TYPE;
+        }
+        property->DestroyValue();
+        NamedPropertyTypeOf<T>::ConstructValue(property->m_storage, propertyValue);
+        property->m_type = &NamedPropertyTypeOf<T>::s_type;
+        return PSR_SUCCESS_EXISTED;
+    };
+
+    //-----------------------------------------------------------------------------------
+    inline NamedProperty* FindProperty(const NamedPropertyKey& propertyName)
+    {
+        for (NamedProperty& property : m_properties)
+        {
+            if (property.HasName(propertyName))
             {
-                if(m_neverChangeTypeIfDifferent || !changeTypeIfDifferent)
-                {
-                    result = PSR_FAILED_DIFF_TYPE;
-                    ERROR_RECOVERABLE(Stringf("Attempted to set '%s' to a different type when it wasn't allowed.", propertyName.c_str()));
-                    return result;
-                }
+                return &property;
             }
-
-            result = PSR_SUCCESS_EXISTED;
-            delete foundProperty;
         }
-        m_properties[propertyName] = static_cast<NamedPropertyBase*>(new TypedNameProperty<T>(propertyValue));
-        return result;
-    };
+        return nullptr;
+    }
+
+    //-----------------------------------------------------------------------------------
+    inline const NamedProperty* FindProperty(const NamedPropertyKey& propertyName) const
+    {
+        return const_cast<NamedProperties*>(this)->FindProperty(propertyName);
+    }
 
-    PropertySetResult Set(const std::string& propertyName, std::string propertyValue, bool changeTypeIfDifferent = true);
-    PropertyGetResult Get(const std::string& propertyName, std::string& outPropertyValue);
-    bool Remove(const std::string& propertyName);
+    PropertySetResult Set(const NamedPropertyKey& propertyName, std::string propertyValue, bool changeTypeIfDifferent = true);
+    PropertyGetResult Get(const NamedPropertyKey& propertyName, std::string& outPropertyValue) const;
+    bool Remove(const NamedPropertyKey& propertyName);
+    inline unsigned int GetNumProperties() const { return (unsigned int)m_properties.size(); };
 
     //VARIABLES/////////////////////////////////////////////////////////////////////
-    std::map<std::string, NamedPropertyBase*, std::less<std::string>, UntrackedAllocator<std::pair<std::string, NamedPropertyBase*>>> m_properties;
     bool m_neverChangeTypeIfDifferent = false;
     static NamedProperties NONE;
+
+private:
+    NamedProperty& AddProperty(const NamedPropertyKey& propertyName);
+
+    std::vector<NamedProperty, UntrackedAllocator<NamedProperty>> m_properties;
 };
@@ -0,0 +1,274 @@
+#include "Engine/Core/FrameBudgetGovernor.hpp"
+#include "Engine/Core/ProfilingHistory.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#include <string.h>
+
+FrameBudgetGovernor* FrameBudgetGovernor::instance = nullptr;
+const float FrameBudgetGovernor::DEFAULT_TARGET_FRAME_TIME_MS = 16.6f;
+
+//Defaults leave a wide dead zone so a knob we just turned down doesn't immediately look like headroom.
+static const float DEFAULT_OVER_BUDGET_RATIO = 1.05f;
+static const float DEFAULT_UNDER_BUDGET_RATIO = 0.8f;
+
+//-----------------------------------------------------------------------------------
+FrameBudgetGovernor::FrameBudgetGovernor(float targetFrameTimeMs, unsigned int numFramesInWindow)
+    : m_targetFrameTimeMs(targetFrameTimeMs)
+    , m_overBudgetRatio(DEFAULT_OVER_BUDGET_RATIO)
+    , m_underBudgetRatio(DEFAULT_UNDER_BUDGET_RATIO)
+    , m_cooldownFrames(DEFAULT_COOLDOWN_FRAMES)
+    , m_isEnabled(true)
+    , m_numFramesInWindow(numFramesInWindow)
+    , m_numFramesRecorded(0)
+    , m_nextFrameIndex(0)
+    , m_framesUntilNextChange(0)
+{
+    ASSERT_OR_DIE(numFramesInWindow > 0, "Frame budget governor needs at least one frame in its window.");
+    m_frameTimesMs.assign(m_numFramesInWindow, 0.0f);
+    m_sortedFrameTimesMs.reserve(m_numFramesInWindow);
+}
+
+//-----------------------------------------------------------------------------------
+void FrameBudgetGovernor::RegisterKnob(const char* name, int* level, int minLevel, int maxLevel, int priority)
+{
+    ASSERT_OR_DIE(minLevel <= maxLevel, "Quality knob has a minimum level above its maximum.");
+    for (const QualityKnob& knob : m_knobs)
+    {
+        ASSERT_OR_DIE(knob.m_level != level, "Quality knob was registered twice.");
+    }
+
+    QualityKnob knob;
+    knob.m_name = name;
+    knob.m_level = level;
+    knob.m_minLevel = minLevel;
+    knob.m_maxLevel = maxLevel;
+    knob.m_priority = priority;
+    m_knobs.push_back(knob);
+}
+
+//-----------------------------------------------------------------------------------
+void FrameBudgetGovernor::UnregisterKnob(int* level)
+{
+    for (auto iter = m_knobs.begin(); iter != m_knobs.end(); ++iter)
+    {
+        if (iter->m_level == level)
+        {
+            m_knobs.erase(iter);
+            return;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool FrameBudgetGovernor::Update(float frameTimeMs)
+{
+    m_frameTimesMs[m_nextFrameIndex] = frameTimeMs;
+    m_nextFrameIndex = (m_nextFrameIndex + 1) % m_numFramesInWindow;
+    if (m_numFramesRecorded < m_numFramesInWindow)
+    {
+        ++m_numFramesRecorded;
+    }
+
+    if (m_framesUntilNextChange > 0)
+    {
+        --m_framesUntilNextChange;
+        return false;
+    }
+    //Only judge a full window, otherwise the first slow frame after a change would count for too much.
+    if (!m_isEnabled || m_numFramesRecorded < m_numFramesInWindow)
+    {
+        return false;
+    }
+
+    float windowFrameTimeMs = GetWindowFrameTimeMs();
+    bool changedKnob = false;
+    if (windowFrameTimeMs > m_targetFrameTimeMs * m_overBudgetRatio)
+    {
+        changedKnob = LowerQuality();
+    }
+    else if (windowFrameTimeMs < m_targetFrameTimeMs * m_underBudgetRatio)
+    {
+        changedKnob = RaiseQuality();
+    }
+
+    //Frames from before the change don't say anything about the new settings.
+    if (changedKnob)
+    {
+        m_framesUntilNextChange = m_cooldownFrames;
+        ClearWindow();
+    }
+    return changedKnob;
+}
+
+//-----------------------------------------------------------------------------------
+//Steps the lowest priority knob that still has room down a single level. Ties go to whichever registered first.
+bool FrameBudgetGovernor::LowerQuality()
+{
+    QualityKnob* knobToLower = nullptr;
+    for (QualityKnob& knob : m_knobs)
+    {
+        if (*knob.m_level > knob.m_minLevel && (!knobToLower || knob.m_priority < knobToLower->m_priority))
+        {
+            knobToLower = &knob;
+        }
+    }
+    if (!knobToLower)
+    {
+        return false;
+    }
+    --(*knobToLower->m_level);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+//Gives quality back in the reverse order we took it away.
+bool FrameBudgetGovernor::RaiseQuality()
+{
+    QualityKnob* knobToRaise = nullptr;
+    for (QualityKnob& knob : m_knobs)
+    {
+        if (*knob.m_level < knob.m_maxLevel && (!knobToRaise || knob.m_priority >= knobToRaise->m_priority))
+        {
+            knobToRaise = &knob;
+        }
+    }
+    if (!knobToRaise)
+    {
+        return false;
+    }
+    ++(*knobToRaise->m_level);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+bool FrameBudgetGovernor::SetKnobLevel(const char* name, int level)
+{
+    for (QualityKnob& knob : m_knobs)
+    {
+        if (strcmp(knob.m_name, name) == 0)
+        {
+            *knob.m_level = level < knob.m_minLevel ? knob.m_minLevel : (level > knob.m_maxLevel ? knob.m_maxLevel : level);
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------------
+void FrameBudgetGovernor::RestoreFullQuality()
+{
+    for (QualityKnob& knob : m_knobs)
+    {
+        *knob.m_level = knob.m_maxLevel;
+    }
+    m_framesUntilNextChange = 0;
+    ClearWindow();
+}
+
+//-----------------------------------------------------------------------------------
+void FrameBudgetGovernor::ClearWindow()
+{
+    m_numFramesRecorded = 0;
+    m_nextFrameIndex = 0;
+}
+
+//-----------------------------------------------------------------------------------
+//We go off the p90 rather than the average so a couple of spikes in an otherwise fast window still count.
+float FrameBudgetGovernor::GetWindowFrameTimeMs() const
+{
+    if (m_numFramesRecorded == 0)
+    {
+        return 0.0f;
+    }
+    m_sortedFrameTimesMs.assign(m_frameTimesMs.begin(), m_frameTimesMs.begin() + m_numFramesRecorded);
+    return ProfilingHistory::CalculatePercentiles(m_sortedFrameTimesMs.data(), m_numFramesRecorded).p90;
+}
+
+//-----------------------------------------------------------------------------------
+const QualityKnob* FrameBudgetGovernor::FindKnob(const char* name) const
+{
+    for (const QualityKnob& knob : m_knobs)
+    {
+        if (strcmp(knob.m_name, name) == 0)
+        {
+            return &knob;
+        }
+    }
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+void FrameBudgetGovernor::PrintStatus() const
+{
+    Console::instance->PrintLine(Stringf("Governor %s: target %.02fms, lower over %.02fms, raise under %.02fms", m_isEnabled ? "enabled" : "disabled", m_targetFrameTimeMs, m_targetFrameTimeMs * m_overBudgetRatio, m_targetFrameTimeMs * m_underBudgetRatio), RGBA::VAPORWAVE);
+    Console::instance->PrintLine(Stringf("Window p90: %.02fms over %u/%u frames, %u frames of cooldown left", GetWindowFrameTimeMs(), m_numFramesRecorded, m_numFramesInWindow, m_framesUntilNextChange), RGBA::VAPORWAVE);
+    Console::instance->PrintLine(Stringf("%-20s%10s%10s%10s%10s", "KNOB", "LEVEL", "MIN", "MAX", "PRIORITY"), RGBA::VAPORWAVE);
+    for (const QualityKnob& knob : m_knobs)
+    {
+        RGBA color = *knob.m_level < knob.m_maxLevel ? RGBA::YELLOW : RGBA::WHITE;
+        Console::instance->PrintLine(Stringf("%-20s%10i%10i%10i%10i", knob.m_name, *knob.m_level, knob.m_minLevel, knob.m_maxLevel, knob.m_priority), color);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(governor)
+{
+    UNUSED(args);
+    if (!FrameBudgetGovernor::instance)
+    {
+        Console::instance->PrintLine("There's no frame budget governor running.", RGBA::RED);
+        return;
+    }
+    FrameBudgetGovernor::instance->PrintStatus();
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(togglegovernor)
+{
+    UNUSED(args);
+    if (!FrameBudgetGovernor::instance)
+    {
+        Console::instance->PrintLine("There's no frame budget governor running.", RGBA::RED);
+        return;
+    }
+    FrameBudgetGovernor* governor = FrameBudgetGovernor::instance;
+    governor->m_isEnabled = !governor->m_isEnabled;
+    if (!governor->m_isEnabled)
+    {
+        governor->RestoreFullQuality();
+    }
+    Console::instance->PrintLine(governor->m_isEnabled ? "Governor enabled." : "Governor disabled, every knob is back at full quality.", RGBA::GBLIGHTGREEN);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(governortarget)
+{
+    if (!args.HasArgs(1) || args.GetFloatArgument(0) <= 0.0f || !FrameBudgetGovernor::instance)
+    {
+        Console::instance->PrintLine("governortarget <milliseconds per frame>", RGBA::RED);
+        return;
+    }
+    float targetMs = args.GetFloatArgument(0);
+    FrameBudgetGovernor::instance->m_targetFrameTimeMs = targetMs;
+    FrameBudgetGovernor::instance->ClearWindow();
+    Console::instance->PrintLine(Stringf("Governing frames to %.02fms.", targetMs), RGBA::GBLIGHTGREEN);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(governorknob)
+{
+    if (!args.HasArgs(2) || !FrameBudgetGovernor::instance)
+    {
+        Console::instance->PrintLine("governorknob <knob name> <level>", RGBA::RED);
+        return;
+    }
+    std::string knobName = args.GetStringArgument(0);
+    if (!FrameBudgetGovernor::instance->SetKnobLevel(knobName.c_str(), args.GetIntArgument(1)))
+    {
+        Console::instance->PrintLine(Stringf("Unknown quality knob '%s'.", knobName.c_str()), RGBA::RED);
+        return;
+    }
+    const QualityKnob* knob = FrameBudgetGovernor::instance->FindKnob(knobName.c_str());
+    Console::instance->PrintLine(Stringf("Set '%s' to level %i.", knob->m_name, *knob->m_level), RGBA::GBLIGHTGREEN);
+}
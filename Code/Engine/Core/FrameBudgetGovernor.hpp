@@ -0,0 +1,69 @@
+#pragma once
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//A quality setting the governor is allowed to turn down. The owner reads *m_level, the governor only ever writes it.
+struct QualityKnob
+{
+    const char* m_name;
+    int* m_level;
+    int m_minLevel;
+    int m_maxLevel;
+    int m_priority; //Lower priority knobs get turned down first and restored last
+};
+
+//-----------------------------------------------------------------------------------
+//Watches a rolling window of frame times and trades quality for frame rate when we're over budget, then gives it back once there's headroom.
+//There's a dead zone between the two thresholds, and every change waits out a cooldown so we don't flip a knob back and forth each frame.
+//The game owns the instance and feeds it from its main loop, so it works in builds without the profiler.
+//Systems register their own knobs, e.g. SpriteGameRenderer::RegisterQualityKnobs(), so nothing in here has to know about them.
+class FrameBudgetGovernor
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    FrameBudgetGovernor(float targetFrameTimeMs = DEFAULT_TARGET_FRAME_TIME_MS, unsigned int numFramesInWindow = DEFAULT_FRAMES_IN_WINDOW);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void RegisterKnob(const char* name, int* level, int minLevel, int maxLevel, int priority);
+    void UnregisterKnob(int* level);
+    //Call once a frame with how long the last frame took. Returns true if a knob changed.
+    bool Update(float frameTimeMs);
+    bool SetKnobLevel(const char* name, int level);
+    void RestoreFullQuality();
+    void ClearWindow();
+    void PrintStatus() const;
+    float GetWindowFrameTimeMs() const;
+    const QualityKnob* FindKnob(const char* name) const;
+    inline unsigned int GetNumKnobs() const { return (unsigned int)m_knobs.size(); };
+    inline const QualityKnob& GetKnob(unsigned int index) const { return m_knobs[index]; };
+
+    //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
+    static FrameBudgetGovernor* instance;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int DEFAULT_FRAMES_IN_WINDOW = 30;
+    static const unsigned int DEFAULT_COOLDOWN_FRAMES = 60;
+    static const float DEFAULT_TARGET_FRAME_TIME_MS;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    float m_targetFrameTimeMs;
+    float m_overBudgetRatio; //Turn quality down once the window's p90 is past target * this
+    float m_underBudgetRatio; //Turn quality back up once the window's p90 is under target * this
+    unsigned int m_cooldownFrames;
+    bool m_isEnabled;
+
+private:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool LowerQuality();
+    bool RaiseQuality();
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<QualityKnob, UntrackedAllocator<QualityKnob>> m_knobs;
+    std::vector<float, UntrackedAllocator<float>> m_frameTimesMs;
+    mutable std::vector<float, UntrackedAllocator<float>> m_sortedFrameTimesMs;
+    unsigned int m_numFramesInWindow;
+    unsigned int m_numFramesRecorded;
+    unsigned int m_nextFrameIndex;
+    unsigned int m_framesUntilNextChange;
+};
@@ -1,6 +1,9 @@
 #include "Engine/Core/JobSystem.hpp"
 #include "Engine/Time/Time.hpp"
 #include "Engine/Input/Logging.hpp"
+#include "Engine/Core/ProfilingUtils.h"
+#include "Engine/Core/ProfilingCounters.hpp"
+#include "Engine/Core/SamplingProfiler.hpp"
 #include <atomic>
 
 JobSystem* JobSystem::instance = nullptr;
@@ -9,6 +12,12 @@ std::atomic<int> gThreadNumber = 0;
 //-----------------------------------------------------------------------------------
 void GenericJobThread()
 {
+    if (ProfilingSystem::instance)
+    {
+        ProfilingSystem::instance->RegisterCurrentThread("Job Worker");
+    }
+    SamplingProfiler::RegisterCurrentThread("Job Worker");
+
     //The order we construct these in is the order we prioritize them.
     std::vector<JobType> types;
     if (++gThreadNumber % 2 == 0)
@@ -111,19 +120,24 @@ Job* JobSystem::CreateJob(JobWorkFunction* jobWorkFunction, void* data, JobCallb
     newJob->workFunction = jobWorkFunction;
     newJob->data = data;
     newJob->finishedCallback = finishedCallback;
+    newJob->memoryTag = GetCurrentMemoryTag();
     return newJob;
 }
 
 //-----------------------------------------------------------------------------------
-void JobSystem::DispatchJob(JobType jobType, Job* jobToDispatch)
+void JobSystem::DispatchJob(JobType jobType, Job* jobToDispatch, const char* profileSource /*= nullptr*/)
 {
+    if (ProfilingSystem::instance)
+    {
+        ProfilingSystem::instance->BeginFlow(jobToDispatch->profileFlow, profileSource);
+    }
     m_jobQueues[jobType]->Enqueue(jobToDispatch);
 }
 
 //-----------------------------------------------------------------------------------
-void JobSystem::CreateAndDispatchJob(JobType jobType, JobWorkFunction* jobWorkFunction, void* data, JobCallbackFunction* finishedCallback /*= nullptr*/)
+void JobSystem::CreateAndDispatchJob(JobType jobType, JobWorkFunction* jobWorkFunction, void* data, JobCallbackFunction* finishedCallback /*= nullptr*/, const char* profileSource /*= nullptr*/)
 {
-    DispatchJob(jobType, CreateJob(jobWorkFunction, data, finishedCallback));
+    DispatchJob(jobType, CreateJob(jobWorkFunction, data, finishedCallback), profileSource);
 }
 
 //-----------------------------------------------------------------------------------
@@ -201,9 +215,20 @@ void JobConsumer::ConsumeForMilliseconds(unsigned int ms)
 void Job::DoWork()
 {
     ASSERT_OR_DIE(workFunction != nullptr, "Work function was null for a job.");
+    MemoryTagScope tagScope(memoryTag);
+    PROFILE_COUNTER_INCREMENT(COUNTER_JOBS_EXECUTED);
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    if (profiler)
+    {
+        profiler->PushFlowSample("Job", profileFlow);
+    }
     workFunction(this);
     if (finishedCallback != nullptr)
     {
         finishedCallback(this);
     }
+    if (profiler)
+    {
+        profiler->PopSample("Job");
+    }
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include "Engine/DataStructures/ThreadSafeQueue.hpp"
 #include "Engine/DataStructures/ObjectPool.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Core/ProfilingUtils.h"
 #include <vector>
 #include <thread>
 
@@ -16,7 +18,7 @@ typedef void(JobCallbackFunction)(Job* job);
 struct Job
 {
     //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
-    Job() : workFunction(nullptr), data(nullptr), finishedCallback(nullptr) {};
+    Job() : workFunction(nullptr), data(nullptr), finishedCallback(nullptr), memoryTag(MEMTAG_UNTAGGED) {};
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     void DoWork();
@@ -25,6 +27,8 @@ struct Job
     JobWorkFunction* workFunction;
     JobCallbackFunction* finishedCallback;
     void* data;
+    MemoryTag memoryTag; //Tag of whoever created the job, so its allocations get attributed to them.
+    ProfileFlow profileFlow; //Filled in by DispatchJob, ties the job's samples back to whoever dispatched it.
 };
 
 
@@ -48,8 +52,9 @@ public:
     void Initialize();
     void Shutdown();
     Job* CreateJob(JobWorkFunction* jobWorkFunction, void* data, JobCallbackFunction* finishedCallback = nullptr);
-    void DispatchJob(JobType jobType, Job* jobToDispatch);
-    void CreateAndDispatchJob(JobType jobType, JobWorkFunction* jobWorkFunction, void* data, JobCallbackFunction* finishedCallback = nullptr);
+    //The profiler credits the job's time to profileSource, or to the subsystem that's running when it's dispatched if that's null.
+    void DispatchJob(JobType jobType, Job* jobToDispatch, const char* profileSource = nullptr);
+    void CreateAndDispatchJob(JobType jobType, JobWorkFunction* jobWorkFunction, void* data, JobCallbackFunction* finishedCallback = nullptr, const char* profileSource = nullptr);
     void ReleaseJob(Job* finishedJob);
 
     //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
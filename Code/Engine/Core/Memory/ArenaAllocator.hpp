@@ -0,0 +1,72 @@
+#pragma once
+#include "Engine/Core/Memory/MemoryArena.hpp"
+#include <type_traits>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Stateful allocator that points a container at a MemoryArena. Default constructed allocators use the heap.
+//Copying a container puts the copy on the heap, so copying out of a frame/level arena is always safe.
+//Moving a container takes its arena along with it.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    //TYPEDEFS//////////////////////////////////////////////////////////////////////////
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+public:
+    //convert an allocator<T> to allocator<U>
+    template<typename U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U> other;
+    };
+
+public:
+    inline ArenaAllocator() : m_arena(GetHeapArena()) {}
+    explicit inline ArenaAllocator(MemoryArena* arena) : m_arena(arena) {}
+    inline ArenaAllocator(const ArenaAllocator& other) : m_arena(other.m_arena) {}
+    template<typename U>
+    inline ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.GetArena()) {}
+
+    //memory allocation
+    inline pointer allocate(size_type cnt)
+    {
+        return (pointer)m_arena->Allocate(cnt * sizeof(T), alignof(T));
+    }
+
+    inline void deallocate(pointer p, size_type cnt)
+    {
+        m_arena->Free(p, cnt * sizeof(T));
+    }
+
+    //Containers copy-constructed from an arena container go to the heap instead of sharing the arena.
+    inline ArenaAllocator select_on_container_copy_construction() const
+    {
+        return ArenaAllocator();
+    }
+
+    inline MemoryArena* GetArena() const { return m_arena; }
+
+private:
+    MemoryArena* m_arena;
+};
+
+//-----------------------------------------------------------------------------------
+//Two allocators are interchangeable only if they hand out memory from the same arena.
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) { return lhs.GetArena() == rhs.GetArena(); }
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) { return lhs.GetArena() != rhs.GetArena(); }
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -1 +1,373 @@
-#include "Engine/Core/Memory/Buffer.hpp"
\ No newline at end of file
+#include "Engine/Core/Memory/Buffer.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <string.h>
+#include <new>
+
+//Storage is bucketed into power-of-four size classes. Anything bigger than the last class is allocated and freed directly.
+static const size_t BUFFER_SIZE_CLASSES[] = { 64, 256, 1024, 4096, 16384, 65536 };
+static const unsigned int NUM_BUFFER_SIZE_CLASSES = sizeof(BUFFER_SIZE_CLASSES) / sizeof(BUFFER_SIZE_CLASSES[0]);
+static const unsigned int UNPOOLED_SIZE_CLASS = NUM_BUFFER_SIZE_CLASSES;
+//How many freed blocks each size class keeps around before handing them back to the OS.
+static const unsigned int MAX_FREE_BUFFERS_PER_SIZE_CLASS = 64;
+
+//-----------------------------------------------------------------------------------
+struct BufferPoolNode
+{
+    BufferPoolNode* next;
+};
+
+//-----------------------------------------------------------------------------------
+struct BufferPool
+{
+    BufferPool()
+    {
+        InitializeCriticalSection(&m_criticalSection);
+        memset(m_freeLists, 0, sizeof(m_freeLists));
+        memset(m_numFree, 0, sizeof(m_numFree));
+    }
+
+    ~BufferPool()
+    {
+        DeleteCriticalSection(&m_criticalSection);
+    }
+
+    BufferPoolNode* m_freeLists[NUM_BUFFER_SIZE_CLASSES];
+    unsigned int m_numFree[NUM_BUFFER_SIZE_CLASSES];
+    CRITICAL_SECTION m_criticalSection;
+};
+
+static BufferPool g_bufferPool;
+
+//-----------------------------------------------------------------------------------
+//Goes through the tracked operator new, so storage shows up in leak reports and under the buffers tag no matter who asked for it.
+//Blocks sitting in the pool's free lists stay counted until BufferPoolShutdown hands them back.
+static void* AllocateTrackedStorageMemory(size_t numBytes)
+{
+    MemoryTagScope buffersScope(MEMTAG_BUFFERS);
+    return ::operator new(numBytes);
+}
+
+//-----------------------------------------------------------------------------------
+static unsigned int GetSizeClassForCapacity(size_t capacity)
+{
+    for (unsigned int i = 0; i < NUM_BUFFER_SIZE_CLASSES; ++i)
+    {
+        if (capacity <= BUFFER_SIZE_CLASSES[i])
+        {
+            return i;
+        }
+    }
+    return UNPOOLED_SIZE_CLASS;
+}
+
+//-----------------------------------------------------------------------------------
+BufferStorage* AllocateBufferStorage(size_t capacity)
+{
+    unsigned int sizeClass = GetSizeClassForCapacity(capacity);
+    void* memory = nullptr;
+
+    if (sizeClass != UNPOOLED_SIZE_CLASS)
+    {
+        capacity = BUFFER_SIZE_CLASSES[sizeClass];
+        EnterCriticalSection(&g_bufferPool.m_criticalSection);
+        {
+            BufferPoolNode* node = g_bufferPool.m_freeLists[sizeClass];
+            if (node)
+            {
+                g_bufferPool.m_freeLists[sizeClass] = node->next;
+                --g_bufferPool.m_numFree[sizeClass];
+                memory = node;
+            }
+        }
+        LeaveCriticalSection(&g_bufferPool.m_criticalSection);
+    }
+
+    if (!memory)
+    {
+        memory = AllocateTrackedStorageMemory(sizeof(BufferStorage) + capacity);
+    }
+
+    BufferStorage* storage = new (memory) BufferStorage();
+    storage->m_refCount.store(1, std::memory_order_relaxed);
+    storage->m_capacity = capacity;
+    storage->m_sizeClass = sizeClass;
+    return storage;
+}
+
+//-----------------------------------------------------------------------------------
+void AddBufferStorageReference(BufferStorage* storage)
+{
+    //Taking a new reference only needs to be atomic, someone else is already keeping the storage alive.
+    storage->m_refCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------
+void ReleaseBufferStorage(BufferStorage* storage)
+{
+    //acq_rel so that every write made through other references is visible before we recycle the memory.
+    if (storage->m_refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+
+    unsigned int sizeClass = storage->m_sizeClass;
+    storage->~BufferStorage();
+
+    if (sizeClass != UNPOOLED_SIZE_CLASS)
+    {
+        bool wasPooled = false;
+        EnterCriticalSection(&g_bufferPool.m_criticalSection);
+        {
+            if (g_bufferPool.m_numFree[sizeClass] < MAX_FREE_BUFFERS_PER_SIZE_CLASS)
+            {
+                BufferPoolNode* node = reinterpret_cast<BufferPoolNode*>(storage);
+                node->next = g_bufferPool.m_freeLists[sizeClass];
+                g_bufferPool.m_freeLists[sizeClass] = node;
+                ++g_bufferPool.m_numFree[sizeClass];
+                wasPooled = true;
+            }
+        }
+        LeaveCriticalSection(&g_bufferPool.m_criticalSection);
+        if (wasPooled)
+        {
+            return;
+        }
+    }
+    ::operator delete(storage);
+}
+
+//-----------------------------------------------------------------------------------
+//Called from MemoryAnalyticsShutdown so pooled blocks are gone before we report leaks.
+void BufferPoolShutdown()
+{
+    EnterCriticalSection(&g_bufferPool.m_criticalSection);
+    {
+        for (unsigned int i = 0; i < NUM_BUFFER_SIZE_CLASSES; ++i)
+        {
+            while (g_bufferPool.m_freeLists[i])
+            {
+                BufferPoolNode* node = g_bufferPool.m_freeLists[i];
+                g_bufferPool.m_freeLists[i] = node->next;
+                ::operator delete(node);
+            }
+            g_bufferPool.m_numFree[i] = 0;
+        }
+    }
+    LeaveCriticalSection(&g_bufferPool.m_criticalSection);
+}
+
+//-----------------------------------------------------------------------------------
+Buffer::Buffer()
+    : m_storage(nullptr)
+    , m_offset(0)
+    , m_size(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+Buffer::Buffer(const void* initialData, size_t size)
+    : m_storage(nullptr)
+    , m_offset(0)
+    , m_size(size)
+{
+    if (size > 0)
+    {
+        m_storage = AllocateBufferStorage(size);
+        memcpy(m_storage->GetData(), initialData, size);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+Buffer::Buffer(BufferStorage* storage, size_t offset, size_t size)
+    : m_storage(storage)
+    , m_offset(offset)
+    , m_size(size)
+{
+}
+
+//-----------------------------------------------------------------------------------
+Buffer::Buffer(const Buffer& other)
+    : m_storage(other.m_storage)
+    , m_offset(other.m_offset)
+    , m_size(other.m_size)
+{
+    if (m_storage)
+    {
+        AddBufferStorageReference(m_storage);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+Buffer::Buffer(Buffer&& other)
+    : m_storage(other.m_storage)
+    , m_offset(other.m_offset)
+    , m_size(other.m_size)
+{
+    other.m_storage = nullptr;
+    other.m_offset = 0;
+    other.m_size = 0;
+}
+
+//-----------------------------------------------------------------------------------
+Buffer::~Buffer()
+{
+    Reset();
+}
+
+//-----------------------------------------------------------------------------------
+Buffer& Buffer::operator=(const Buffer& other)
+{
+    if (this != &other)
+    {
+        //Grab the new reference first in case both buffers share the same storage.
+        if (other.m_storage)
+        {
+            AddBufferStorageReference(other.m_storage);
+        }
+        Reset();
+        m_storage = other.m_storage;
+        m_offset = other.m_offset;
+        m_size = other.m_size;
+    }
+    return *this;
+}
+
+//-----------------------------------------------------------------------------------
+Buffer& Buffer::operator=(Buffer&& other)
+{
+    if (this != &other)
+    {
+        Reset();
+        m_storage = other.m_storage;
+        m_offset = other.m_offset;
+        m_size = other.m_size;
+        other.m_storage = nullptr;
+        other.m_offset = 0;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+//-----------------------------------------------------------------------------------
+Buffer Buffer::Slice(size_t offset, size_t size) const
+{
+    ASSERT_OR_DIE(offset <= m_size && size <= m_size - offset, "Attempted to slice past the end of a Buffer.");
+    if (size == 0)
+    {
+        return Buffer();
+    }
+    AddBufferStorageReference(m_storage);
+    return Buffer(m_storage, m_offset + offset, size);
+}
+
+//-----------------------------------------------------------------------------------
+Buffer Buffer::Slice(size_t offset) const
+{
+    ASSERT_OR_DIE(offset <= m_size, "Attempted to slice past the end of a Buffer.");
+    return Slice(offset, m_size - offset);
+}
+
+//-----------------------------------------------------------------------------------
+void Buffer::Reset()
+{
+    if (m_storage)
+    {
+        ReleaseBufferStorage(m_storage);
+        m_storage = nullptr;
+    }
+    m_offset = 0;
+    m_size = 0;
+}
+
+//-----------------------------------------------------------------------------------
+int Buffer::GetRefCount() const
+{
+    return m_storage ? m_storage->m_refCount.load(std::memory_order_relaxed) : 0;
+}
+
+//-----------------------------------------------------------------------------------
+BufferBuilder::BufferBuilder(size_t initialCapacity)
+    : m_storage(nullptr)
+    , m_size(0)
+    , m_initialCapacity(initialCapacity)
+{
+}
+
+//-----------------------------------------------------------------------------------
+BufferBuilder::~BufferBuilder()
+{
+    if (m_storage)
+    {
+        ReleaseBufferStorage(m_storage);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void BufferBuilder::EnsureCapacity(size_t requiredCapacity)
+{
+    if (m_storage && requiredCapacity <= m_storage->m_capacity)
+    {
+        return;
+    }
+
+    size_t newCapacity = m_storage ? m_storage->m_capacity * 2 : m_initialCapacity;
+    if (newCapacity == 0)
+    {
+        newCapacity = requiredCapacity;
+    }
+    while (newCapacity < requiredCapacity)
+    {
+        newCapacity *= 2;
+    }
+
+    BufferStorage* newStorage = AllocateBufferStorage(newCapacity);
+    if (m_storage)
+    {
+        memcpy(newStorage->GetData(), m_storage->GetData(), m_size);
+        ReleaseBufferStorage(m_storage);
+    }
+    m_storage = newStorage;
+}
+
+//-----------------------------------------------------------------------------------
+byte* BufferBuilder::Reserve(size_t numBytes)
+{
+    EnsureCapacity(m_size + numBytes);
+    byte* bookmark = m_storage->GetData() + m_size;
+    m_size += numBytes;
+    return bookmark;
+}
+
+//-----------------------------------------------------------------------------------
+size_t BufferBuilder::WriteBytes(const void* src, const size_t numBytes)
+{
+    if (numBytes == 0)
+    {
+        return 0;
+    }
+    memcpy(Reserve(numBytes), src, numBytes);
+    return numBytes;
+}
+
+//-----------------------------------------------------------------------------------
+void BufferBuilder::Append(const Buffer& buffer)
+{
+    WriteBytes(buffer.GetData(), buffer.GetSize());
+}
+
+//-----------------------------------------------------------------------------------
+//Hands our only reference to the storage off to the Buffer. The builder starts fresh afterwards.
+Buffer BufferBuilder::Finish()
+{
+    if (m_size == 0)
+    {
+        return Buffer();
+    }
+    Buffer finishedBuffer(m_storage, 0, m_size);
+    m_storage = nullptr;
+    m_size = 0;
+    return finishedBuffer;
+}
@@ -1,11 +1,89 @@
 #pragma once
+#include <atomic>
+#include "Engine/Input/BinaryWriter.hpp"
 
+typedef unsigned char byte;
+
+//-----------------------------------------------------------------------------------
+//Header that lives in front of every pooled allocation. The bytes follow immediately after it.
+struct alignas(8) BufferStorage
+{
+    inline byte* GetData() { return reinterpret_cast<byte*>(this + 1); };
+
+    std::atomic<int> m_refCount;
+    size_t m_capacity;
+    unsigned int m_sizeClass;
+};
+
+//-----------------------------------------------------------------------------------
+//Reference counted, immutable view into a pooled allocation.
+//Copies and slices share the same storage, so passing one around never copies the bytes.
+//The refcount is atomic, so Buffers can be handed off between threads freely.
 class Buffer
 {
 public:
-    Buffer(void* initialData, size_t size);
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    Buffer();
+    Buffer(const void* initialData, size_t size);
+    Buffer(const Buffer& other);
+    Buffer(Buffer&& other);
+    ~Buffer();
+
+    //OPERATORS/////////////////////////////////////////////////////////////////////
+    Buffer& operator=(const Buffer& other);
+    Buffer& operator=(Buffer&& other);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    Buffer Slice(size_t offset, size_t size) const;
+    Buffer Slice(size_t offset) const;
+    void Reset();
+    int GetRefCount() const;
+    inline const byte* GetData() const { return m_storage ? m_storage->GetData() + m_offset : nullptr; };
+    inline size_t GetSize() const { return m_size; };
+    inline bool IsEmpty() const { return m_size == 0; };
+
+private:
+    friend class BufferBuilder;
+    //Takes ownership of one reference to the storage.
+    Buffer(BufferStorage* storage, size_t offset, size_t size);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    BufferStorage* m_storage;
+    size_t m_offset;
+    size_t m_size;
+};
+
+//-----------------------------------------------------------------------------------
+//Appends bytes into a single pooled allocation, then hands it off as an immutable Buffer with Finish().
+//Only the builder can write to the storage, and only until it's finished.
+class BufferBuilder : public IBinaryWriter
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    BufferBuilder(size_t initialCapacity = 256);
+    ~BufferBuilder();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    virtual size_t WriteBytes(const void* src, const size_t numBytes) override;
+    void Append(const Buffer& buffer);
+    byte* Reserve(size_t numBytes);
+    Buffer Finish();
+    inline size_t GetSize() const { return m_size; };
+    inline byte* GetData() { return m_storage ? m_storage->GetData() : nullptr; };
+
+private:
+    BufferBuilder(const BufferBuilder&) = delete;
+    BufferBuilder& operator=(const BufferBuilder&) = delete;
+    void EnsureCapacity(size_t requiredCapacity);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    BufferStorage* m_storage;
+    size_t m_size;
+    size_t m_initialCapacity;
+};
 
-    template <class T>
-    void Alloc<T>();
-    
-};
\ No newline at end of file
+//FUNCTIONS/////////////////////////////////////////////////////////////////////
+BufferStorage* AllocateBufferStorage(size_t capacity);
+void AddBufferStorageReference(BufferStorage* storage);
+void ReleaseBufferStorage(BufferStorage* storage);
+void BufferPoolShutdown();
@@ -7,13 +7,28 @@
 /************************************************************************/
 #include "Engine/Core/Memory/Callstack.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <new>
 
+#ifdef WIN32
+#define PLATFORM_WINDOWS
 #define WIN32_LEAN_AND_MEAN
 #define _WINSOCKAPI_
 #include <Windows.h>
 //DbgHelp.h has an annoying warning that's not my problem.
 #pragma warning(disable: 4091)
 #include <DbgHelp.h>
+#else
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <pthread.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <atomic>
+#include <chrono>
+#endif
 
 
 /************************************************************************/
@@ -22,6 +37,11 @@
 /*                                                                      */
 /************************************************************************/
 
+//Must be a power of two, we mask addresses into the table.
+static const uint INITIAL_SYMBOL_CACHE_CAPACITY = 1024;
+//How much of a paused thread's stack gets copied out for walking. Deeper than this and the walk just stops early.
+static const size_t MAX_STACK_COPY_BYTES = 256 * 1024;
+
 /************************************************************************/
 /*                                                                      */
 /* GLOBAL VARIABLES                                                     */
@@ -43,6 +63,7 @@
 /*                                                                      */
 /************************************************************************/
 
+#if defined( PLATFORM_WINDOWS )
 // SymInitialize()
 typedef BOOL (__stdcall *sym_initialize_t)( IN HANDLE hProcess, IN PSTR UserSearchPath, IN BOOL fInvadeProcess );
 typedef BOOL (__stdcall *sym_cleanup_t)( IN HANDLE hProcess );
@@ -50,12 +71,35 @@ typedef BOOL (__stdcall *sym_from_addr_t)( IN HANDLE hProcess, IN DWORD64 Addres
 
 typedef BOOL (__stdcall *sym_get_line_t)( IN HANDLE hProcess, IN DWORD64 dwAddr, OUT PDWORD pdwDisplacement, OUT PIMAGEHLP_LINE64 Symbol );
 
+typedef BOOL (__stdcall *stack_walk_t)( IN DWORD MachineType, IN HANDLE hProcess, IN HANDLE hThread, IN OUT LPSTACKFRAME64 StackFrame, IN OUT PVOID ContextRecord,
+    IN PREAD_PROCESS_MEMORY_ROUTINE64 ReadMemoryRoutine, IN PFUNCTION_TABLE_ACCESS_ROUTINE64 FunctionTableAccessRoutine, IN PGET_MODULE_BASE_ROUTINE64 GetModuleBaseRoutine, IN PTRANSLATE_ADDRESS_ROUTINE64 TranslateAddress );
+#endif
+
 /************************************************************************/
 /*                                                                      */
 /* STRUCTS                                                              */
 /*                                                                      */
 /************************************************************************/
 
+#if defined( PLATFORM_WINDOWS )
+//What a thread handle from CallstackGetCurrentThreadHandle actually points at.
+struct CapturableThread
+{
+    HANDLE handle;
+    uintptr_t stackBase; //Highest address of the stack, it grows down from here
+};
+#endif
+
+//Only the strings we actually resolved get stored, instead of a pair of full CALLSTACK_BUFFER_SIZE arrays per address.
+struct CachedSymbol
+{
+    uintptr_t address; //0 means the slot is empty
+    char* functionName;
+    char* filename;
+    uint32_t line;
+    uint32_t offset;
+};
+
 /************************************************************************/
 /*                                                                      */
 /* CLASSES                                                              */
@@ -67,18 +111,64 @@ typedef BOOL (__stdcall *sym_get_line_t)( IN HANDLE hProcess, IN DWORD64 dwAddr,
 /* LOCAL VARIABLES                                                      */
 /*                                                                      */
 /************************************************************************/
+#if defined( PLATFORM_WINDOWS )
 static HMODULE gDebugHelp;
 static HANDLE gProcess;
 static SYMBOL_INFO* gSymbol;
 
-// only called from single thread - so can use a shared buffer
-static char gFileName[MAX_FILENAME_LENGTH];
-static CallstackLine gCallstackBuffer[MAX_DEPTH];
-
 static sym_initialize_t LSymInitialize;
 static sym_cleanup_t LSymCleanup;
 static sym_from_addr_t LSymFromAddr;
 static sym_get_line_t LSymGetLineFromAddr64;
+static stack_walk_t LStackWalk64;
+static PFUNCTION_TABLE_ACCESS_ROUTINE64 LSymFunctionTableAccess64;
+static PGET_MODULE_BASE_ROUTINE64 LSymGetModuleBase64;
+
+//DbgHelp isn't thread safe, and the sampling profiler walks stacks from its own thread while symbols get resolved on another.
+static CRITICAL_SECTION gDebugHelpLock;
+
+//A paused thread's stack gets copied here, then walked after it's running again. gStackCopyLock keeps it to one capture at a time.
+static SRWLOCK gStackCopyLock = SRWLOCK_INIT;
+static byte* gStackCopy = nullptr;
+static uintptr_t gStackCopyAddress = 0;
+static size_t gStackCopySize = 0;
+static uintptr_t gStackCopyThreadBase = 0;
+#else
+//Where a signalled thread leaves its stack for CallstackCaptureThread. gSignalCaptureLock keeps it to one capture at a time.
+//Each capture gets its own generation, and a handler only writes if it claims the one that's still open for its own thread,
+//so a signal that shows up after its capture gave up can't overwrite the next one.
+static pthread_mutex_t gSignalCaptureLock = PTHREAD_MUTEX_INITIALIZER;
+static void* gSignalStack[MAX_DEPTH];
+static int gSignalStackFrameCount = 0;
+static std::atomic<unsigned int> gOpenSignalCaptureGeneration(0); //0 when nobody's waiting
+static std::atomic<uintptr_t> gSignalCaptureTarget(0);
+static std::atomic<unsigned int> gFinishedSignalCaptureGeneration(0);
+static unsigned int gNextSignalCaptureGeneration = 0;
+static bool gIsSignalHandlerInstalled = false;
+#endif
+
+static bool gIsCallstackSystemInitialized = false;
+
+//Each thread that symbolizes gets its own, the logging thread and the main thread both print callstacks.
+//Allocated on first use, since most threads never need one and it's far too big to put in every thread's TLS block.
+struct CallstackLineBuffer
+{
+    CallstackLineBuffer() : m_lines(nullptr) {};
+    ~CallstackLineBuffer() { free(m_lines); };
+    CallstackLine* m_lines;
+};
+static thread_local CallstackLineBuffer tCallstackBuffer;
+
+//Open addressed address -> symbol table. Allocated with malloc so that symbolizing never shows up in memory tracking.
+//Growing frees the old table, so every lookup has to hold gSymbolCacheLock.
+static CachedSymbol* gSymbolCache = nullptr;
+static uint gSymbolCacheCapacity = 0;
+static uint gNumCachedSymbols = 0;
+#if defined( PLATFORM_WINDOWS )
+static SRWLOCK gSymbolCacheLock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t gSymbolCacheLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /************************************************************************/
 /*                                                                      */
@@ -86,6 +176,193 @@ static sym_get_line_t LSymGetLineFromAddr64;
 /*                                                                      */
 /************************************************************************/
 
+//------------------------------------------------------------------------
+static inline void LockSymbolCache()
+{
+#if defined( PLATFORM_WINDOWS )
+    AcquireSRWLockExclusive(&gSymbolCacheLock);
+#else
+    pthread_mutex_lock(&gSymbolCacheLock);
+#endif
+}
+
+//------------------------------------------------------------------------
+static inline void UnlockSymbolCache()
+{
+#if defined( PLATFORM_WINDOWS )
+    ReleaseSRWLockExclusive(&gSymbolCacheLock);
+#else
+    pthread_mutex_unlock(&gSymbolCacheLock);
+#endif
+}
+
+//------------------------------------------------------------------------
+static char* CopySymbolString(const char* source)
+{
+    size_t length = strlen(source);
+    if (length >= CALLSTACK_BUFFER_SIZE)
+    {
+        length = CALLSTACK_BUFFER_SIZE - 1;
+    }
+    char* copy = (char*)malloc(length + 1);
+    memcpy(copy, source, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+//------------------------------------------------------------------------
+static inline uint HashAddress(uintptr_t address, uint capacity)
+{
+    //Return addresses are rarely aligned to anything useful, so mix the bits before masking.
+    uint64_t hash = (uint64_t)address * 0x9E3779B97F4A7C15ull;
+    return (uint)(hash >> 32) & (capacity - 1);
+}
+
+//------------------------------------------------------------------------
+static CachedSymbol* FindSymbolSlot(CachedSymbol* table, uint capacity, uintptr_t address)
+{
+    uint index = HashAddress(address, capacity);
+    while (table[index].address != 0 && table[index].address != address)
+    {
+        index = (index + 1) & (capacity - 1);
+    }
+    return &table[index];
+}
+
+//------------------------------------------------------------------------
+static void GrowSymbolCache()
+{
+    uint newCapacity = gSymbolCacheCapacity == 0 ? INITIAL_SYMBOL_CACHE_CAPACITY : gSymbolCacheCapacity * 2;
+    CachedSymbol* newTable = (CachedSymbol*)calloc(newCapacity, sizeof(CachedSymbol));
+    ASSERT_OR_DIE(newTable != nullptr, "Failed to allocate the callstack symbol cache.");
+
+    for (uint i = 0; i < gSymbolCacheCapacity; ++i)
+    {
+        if (gSymbolCache[i].address != 0)
+        {
+            *FindSymbolSlot(newTable, newCapacity, gSymbolCache[i].address) = gSymbolCache[i];
+        }
+    }
+    free(gSymbolCache);
+    gSymbolCache = newTable;
+    gSymbolCacheCapacity = newCapacity;
+}
+
+//------------------------------------------------------------------------
+//The only platform specific part of symbolizing. Only ever called on a cache miss.
+static void ResolveSymbol(uintptr_t address, CachedSymbol& outSymbol)
+{
+#if defined( PLATFORM_WINDOWS )
+    IMAGEHLP_LINE64 LineInfo;
+    DWORD LineDisplacement = 0; // Displacement from the beginning of the line
+    LineInfo.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+
+    DWORD64 ptr = (DWORD64)address;
+    EnterCriticalSection(&gDebugHelpLock);
+    BOOL foundSymbol = LSymFromAddr(gProcess, ptr, 0, gSymbol);
+    outSymbol.functionName = CopySymbolString(foundSymbol ? gSymbol->Name : "N/A");
+
+    BOOL bRet = LSymGetLineFromAddr64(
+        gProcess, // Process handle of the current process
+        ptr, // Address
+        &LineDisplacement, // Displacement will be stored here by the function
+        &LineInfo );         // File name / line information will be stored here
+    LeaveCriticalSection(&gDebugHelpLock);
+
+    if (bRet)
+    {
+        outSymbol.line = LineInfo.LineNumber;
+        outSymbol.filename = CopySymbolString(LineInfo.FileName);
+        outSymbol.offset = LineDisplacement;
+    }
+    else
+    {
+        outSymbol.line = 0;
+        outSymbol.offset = 0;
+        outSymbol.filename = CopySymbolString("N/A");
+    }
+#else
+    //dladdr only knows about exported symbols and can't give us lines, so report the module and offset instead.
+    Dl_info info;
+    if (dladdr((void*)address, &info) != 0)
+    {
+        const char* functionName = info.dli_sname ? info.dli_sname : "N/A";
+        int status = -1;
+        //Only mangled C++ names start with _Z, anything else would get demangled as if it were a type.
+        bool isMangled = info.dli_sname && strncmp(info.dli_sname, "_Z", 2) == 0;
+        char* demangled = isMangled ? abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status) : nullptr;
+        outSymbol.functionName = CopySymbolString(status == 0 ? demangled : functionName);
+        free(demangled);
+        outSymbol.filename = CopySymbolString(info.dli_fname ? info.dli_fname : "N/A");
+        outSymbol.offset = info.dli_saddr ? (uint32_t)(address - (uintptr_t)info.dli_saddr) : 0;
+    }
+    else
+    {
+        outSymbol.functionName = CopySymbolString("N/A");
+        outSymbol.filename = CopySymbolString("N/A");
+        outSymbol.offset = 0;
+    }
+    outSymbol.line = 0;
+#endif
+}
+
+//------------------------------------------------------------------------
+//Returns a copy, the slot itself can move as soon as we let go of the lock. The strings it points to live until the cache is cleared.
+//Lock order is gSymbolCacheLock, then gDebugHelpLock inside ResolveSymbol.
+static CachedSymbol GetOrResolveSymbol(uintptr_t address)
+{
+    LockSymbolCache();
+    //Keep the load factor under a half so probes stay short.
+    if ((gNumCachedSymbols + 1) * 2 > gSymbolCacheCapacity)
+    {
+        GrowSymbolCache();
+    }
+
+    CachedSymbol* slot = FindSymbolSlot(gSymbolCache, gSymbolCacheCapacity, address);
+    if (slot->address == 0)
+    {
+        ResolveSymbol(address, *slot);
+        slot->address = address;
+        ++gNumCachedSymbols;
+    }
+    CachedSymbol symbol = *slot;
+    UnlockSymbolCache();
+    return symbol;
+}
+
+//------------------------------------------------------------------------
+static void CopyIntoCallstackLine(const char* source, char* destination)
+{
+    size_t length = strlen(source);
+    memcpy(destination, source, length + 1);
+}
+
+#if defined( PLATFORM_WINDOWS )
+//------------------------------------------------------------------------
+//Lets StackWalk64 walk the copy instead of the live stack, which has moved on by the time we walk it.
+static BOOL __stdcall ReadCopiedStackMemory(HANDLE process, DWORD64 baseAddress, PVOID buffer, DWORD size, LPDWORD numBytesRead)
+{
+    uintptr_t address = (uintptr_t)baseAddress;
+    *numBytesRead = 0;
+    if (address >= gStackCopyAddress && address + size <= gStackCopyAddress + gStackCopySize)
+    {
+        memcpy(buffer, gStackCopy + (address - gStackCopyAddress), size);
+        *numBytesRead = size;
+        return TRUE;
+    }
+    if (address >= gStackCopyAddress && address < gStackCopyThreadBase)
+    {
+        //Stack we didn't copy. The live version is garbage by now.
+        return FALSE;
+    }
+    //Code and unwind data, which don't change under us.
+    SIZE_T numRead = 0;
+    BOOL succeeded = ReadProcessMemory(process, (LPCVOID)address, buffer, size, &numRead);
+    *numBytesRead = (DWORD)numRead;
+    return succeeded;
+}
+#endif
+
 /************************************************************************/
 /*                                                                      */
 /* EXTERNAL FUNCTIONS                                                   */
@@ -95,12 +372,17 @@ static sym_get_line_t LSymGetLineFromAddr64;
 //------------------------------------------------------------------------
 bool CallstackSystemInit()
 {
+#if defined( PLATFORM_WINDOWS )
     gDebugHelp = LoadLibraryA("dbghelp.dll");
     ASSERT_OR_DIE(gDebugHelp != nullptr, "Unable to load dbghelp.dll");
     LSymInitialize = (sym_initialize_t)GetProcAddress(gDebugHelp, "SymInitialize");
     LSymCleanup = (sym_cleanup_t)GetProcAddress(gDebugHelp, "SymCleanup");
     LSymFromAddr = (sym_from_addr_t)GetProcAddress(gDebugHelp, "SymFromAddr");
     LSymGetLineFromAddr64 = (sym_get_line_t)GetProcAddress(gDebugHelp, "SymGetLineFromAddr64");
+    LStackWalk64 = (stack_walk_t)GetProcAddress(gDebugHelp, "StackWalk64");
+    LSymFunctionTableAccess64 = (PFUNCTION_TABLE_ACCESS_ROUTINE64)GetProcAddress(gDebugHelp, "SymFunctionTableAccess64");
+    LSymGetModuleBase64 = (PGET_MODULE_BASE_ROUTINE64)GetProcAddress(gDebugHelp, "SymGetModuleBase64");
+    InitializeCriticalSection(&gDebugHelpLock);
 
     gProcess = GetCurrentProcess();
     LSymInitialize(gProcess, NULL, TRUE);
@@ -109,6 +391,15 @@ bool CallstackSystemInit()
     gSymbol->MaxNameLen = MAX_FILENAME_LENGTH;
     gSymbol->SizeOfStruct = sizeof(SYMBOL_INFO);
 
+    //Up front, since nothing can allocate while a thread is paused.
+    gStackCopy = (byte*)malloc(MAX_STACK_COPY_BYTES);
+#else
+    //backtrace() lazily loads libgcc the first time it's called, which allocates. Get that out of the way now.
+    void* warmup[1];
+    backtrace(warmup, 1);
+#endif
+
+   gIsCallstackSystemInitialized = true;
    return true;
 }
 
@@ -116,26 +407,45 @@ bool CallstackSystemInit()
 static int gCallstackCount = 0;
 void CallstackSystemDeinit()
 {
+    CallstackClearSymbolCache();
+
+#if defined( PLATFORM_WINDOWS )
     LSymCleanup(gProcess);
 
     FreeLibrary(gDebugHelp);
     gDebugHelp = NULL;
 
+    free(gSymbol);
+    DeleteCriticalSection(&gDebugHelpLock);
+
+    AcquireSRWLockExclusive(&gStackCopyLock);
+    free(gStackCopy);
+    gStackCopy = nullptr;
+    ReleaseSRWLockExclusive(&gStackCopyLock);
+#endif
+    gIsCallstackSystemInitialized = false;
+
     if (gCallstackCount != 0)
     {
         gCallstackCount = 0;
     }
-
-    free(gSymbol);
 }
 
 //------------------------------------------------------------------------
 Callstack* AllocateCallstack(uint skipFrames)
 {
     void* stack[MAX_DEPTH];
+#if defined( PLATFORM_WINDOWS )
     //Getting from the calling function (0 is this function) to the number you want to capture
     uint32_t frames = CaptureStackBackTrace(1 + skipFrames, MAX_DEPTH, stack, NULL);
-        
+#else
+    //backtrace can't skip frames for us, so capture the extras and shift them off the front.
+    int capturedFrames = backtrace(stack, MAX_DEPTH);
+    uint framesToSkip = 1 + skipFrames;
+    uint32_t frames = capturedFrames > (int)framesToSkip ? (uint32_t)capturedFrames - framesToSkip : 0;
+    memmove(stack, stack + framesToSkip, sizeof(void*) * frames);
+#endif
+
     ++gCallstackCount;
 
     size_t size = sizeof(Callstack) + sizeof(void*) * frames;
@@ -159,42 +469,240 @@ void FreeCallstack(Callstack* stackToFree)
 }
 
 //------------------------------------------------------------------------
-// Should only be called from the debug trace thread.  
-CallstackLine* CallstackGetLines(Callstack* cs) 
+CallstackLine* CallstackGetLines(Callstack* cs)
 {
-    IMAGEHLP_LINE64 LineInfo; 
-    DWORD LineDisplacement = 0; // Displacement from the beginning of the line 
-    LineInfo.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+    if (!tCallstackBuffer.m_lines)
+    {
+        tCallstackBuffer.m_lines = (CallstackLine*)malloc(sizeof(CallstackLine) * MAX_DEPTH);
+        ASSERT_OR_DIE(tCallstackBuffer.m_lines != nullptr, "Failed to allocate a callstack line buffer.");
+    }
 
     uint count = cs->frameCount;
-    for (uint i = 0; i < count; ++i) 
+    for (uint i = 0; i < count; ++i)
+    {
+        CallstackLine* line = &(tCallstackBuffer.m_lines[i]);
+        CachedSymbol symbol = GetOrResolveSymbol((uintptr_t)(cs->frames[i]));
+        CopyIntoCallstackLine(symbol.functionName, line->functionName);
+        CopyIntoCallstackLine(symbol.filename, line->filename);
+        line->line = symbol.line;
+        line->offset = symbol.offset;
+    }
+
+    return tCallstackBuffer.m_lines;
+}
+
+//------------------------------------------------------------------------
+uint CallstackGetNumCachedSymbols()
+{
+    LockSymbolCache();
+    uint numCachedSymbols = gNumCachedSymbols;
+    UnlockSymbolCache();
+    return numCachedSymbols;
+}
+
+//------------------------------------------------------------------------
+void CallstackClearSymbolCache()
+{
+    LockSymbolCache();
+    for (uint i = 0; i < gSymbolCacheCapacity; ++i)
     {
-        CallstackLine* line = &(gCallstackBuffer[i]);
-        DWORD64 ptr = (DWORD64)(cs->frames[i]);
-        LSymFromAddr(gProcess, ptr, 0, gSymbol);
+        if (gSymbolCache[i].address != 0)
+        {
+            free(gSymbolCache[i].functionName);
+            free(gSymbolCache[i].filename);
+        }
+    }
+    free(gSymbolCache);
+    gSymbolCache = nullptr;
+    gSymbolCacheCapacity = 0;
+    gNumCachedSymbols = 0;
+    UnlockSymbolCache();
+}
 
-        strcpy_s(line->functionName, CALLSTACK_BUFFER_SIZE, gSymbol->Name);
+//------------------------------------------------------------------------
+const char* CallstackGetFunctionName(void* address)
+{
+    return GetOrResolveSymbol((uintptr_t)address).functionName;
+}
+
+//------------------------------------------------------------------------
+bool CallstackSystemIsInitialized()
+{
+    return gIsCallstackSystemInitialized;
+}
 
-        BOOL bRet = LSymGetLineFromAddr64( 
-            GetCurrentProcess(), // Process handle of the current process 
-            ptr, // Address 
-            &LineDisplacement, // Displacement will be stored here by the function 
-            &LineInfo );         // File name / line information will be stored here 
+#if !defined( PLATFORM_WINDOWS )
+//------------------------------------------------------------------------
+static void CaptureStackSignalHandler(int, siginfo_t*, void* signalContext)
+{
+    unsigned int generation = gOpenSignalCaptureGeneration.load(std::memory_order_acquire);
+    if (generation == 0 || !pthread_equal(pthread_self(), (pthread_t)gSignalCaptureTarget.load(std::memory_order_relaxed))
+        || !gOpenSignalCaptureGeneration.compare_exchange_strong(generation, 0, std::memory_order_acq_rel))
+    {
+        return;
+    }
 
-        if (bRet) 
+    //Start at whatever got interrupted. How many frames the handler and trampoline take up depends on who else hooked the signal,
+    //so look for the interrupted PC and only fall back to a fixed count when we can't tell.
+    static const int SIGNAL_FRAMES_TO_SKIP = 2;
+    int capturedFrames = backtrace(gSignalStack, MAX_DEPTH);
+    int framesToSkip = SIGNAL_FRAMES_TO_SKIP;
+#if defined( __x86_64__ )
+    void* interruptedAddress = (void*)((ucontext_t*)signalContext)->uc_mcontext.gregs[REG_RIP];
+#elif defined( __aarch64__ )
+    void* interruptedAddress = (void*)((ucontext_t*)signalContext)->uc_mcontext.pc;
+#else
+    UNUSED(signalContext);
+    void* interruptedAddress = nullptr;
+#endif
+    for (int i = 0; i < capturedFrames; ++i)
+    {
+        if (gSignalStack[i] == interruptedAddress)
         {
-            line->line = LineInfo.LineNumber;
-            const char* filename = LineInfo.FileName;
-            strcpy_s(line->filename, CALLSTACK_BUFFER_SIZE, filename);
-            line->offset = LineDisplacement;
-        } 
-        else 
+            framesToSkip = i;
+            break;
+        }
+    }
+    int frames = capturedFrames > framesToSkip ? capturedFrames - framesToSkip : 0;
+    memmove(gSignalStack, gSignalStack + framesToSkip, sizeof(void*) * frames);
+    gSignalStackFrameCount = frames;
+    gFinishedSignalCaptureGeneration.store(generation, std::memory_order_release);
+}
+#endif
+
+//------------------------------------------------------------------------
+uintptr_t CallstackGetCurrentThreadHandle()
+{
+#if defined( PLATFORM_WINDOWS )
+    //GetCurrentThread() is a pseudo handle that means "me" to whoever uses it, so make a real one.
+    CapturableThread* thread = (CapturableThread*)malloc(sizeof(CapturableThread));
+    thread->handle = NULL;
+    DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &thread->handle, THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION, FALSE, 0);
+    ULONG_PTR stackLimit = 0;
+    ULONG_PTR stackBase = 0;
+    GetCurrentThreadStackLimits(&stackLimit, &stackBase);
+    thread->stackBase = (uintptr_t)stackBase;
+    return (uintptr_t)thread;
+#else
+    return (uintptr_t)pthread_self();
+#endif
+}
+
+//------------------------------------------------------------------------
+void CallstackReleaseThreadHandle(uintptr_t threadHandle)
+{
+#if defined( PLATFORM_WINDOWS )
+    CapturableThread* thread = (CapturableThread*)threadHandle;
+    CloseHandle(thread->handle);
+    free(thread);
+#else
+    UNUSED(threadHandle);
+#endif
+}
+
+//------------------------------------------------------------------------
+// The target is only paused long enough to copy its registers and stack. Nothing that takes a lock, DbgHelp included, runs until it's going again.
+uint CallstackCaptureThread(uintptr_t threadHandle, void** outFrames, uint maxFrames)
+{
+    uint numFrames = 0;
+#if defined( PLATFORM_WINDOWS )
+    CapturableThread* thread = (CapturableThread*)threadHandle;
+    AcquireSRWLockExclusive(&gStackCopyLock);
+    if (gStackCopy == nullptr || SuspendThread(thread->handle) == (DWORD)-1)
+    {
+        ReleaseSRWLockExclusive(&gStackCopyLock);
+        return 0;
+    }
+
+    CONTEXT context;
+    memset(&context, 0, sizeof(context));
+    context.ContextFlags = CONTEXT_FULL;
+    bool gotContext = GetThreadContext(thread->handle, &context) != FALSE;
+    if (gotContext)
+    {
+#if defined( _M_X64 )
+        gStackCopyAddress = (uintptr_t)context.Rsp;
+#else
+        gStackCopyAddress = (uintptr_t)context.Esp;
+#endif
+        gStackCopyThreadBase = thread->stackBase;
+        gStackCopySize = gStackCopyAddress < thread->stackBase ? thread->stackBase - gStackCopyAddress : 0;
+        gStackCopySize = gStackCopySize < MAX_STACK_COPY_BYTES ? gStackCopySize : MAX_STACK_COPY_BYTES;
+        memcpy(gStackCopy, (const void*)gStackCopyAddress, gStackCopySize);
+    }
+    ResumeThread(thread->handle);
+
+    if (gotContext)
+    {
+        STACKFRAME64 frame;
+        memset(&frame, 0, sizeof(frame));
+#if defined( _M_X64 )
+        DWORD machineType = IMAGE_FILE_MACHINE_AMD64;
+        frame.AddrPC.Offset = context.Rip;
+        frame.AddrStack.Offset = context.Rsp;
+        frame.AddrFrame.Offset = context.Rbp;
+#else
+        DWORD machineType = IMAGE_FILE_MACHINE_I386;
+        frame.AddrPC.Offset = context.Eip;
+        frame.AddrStack.Offset = context.Esp;
+        frame.AddrFrame.Offset = context.Ebp;
+#endif
+        frame.AddrPC.Mode = AddrModeFlat;
+        frame.AddrStack.Mode = AddrModeFlat;
+        frame.AddrFrame.Mode = AddrModeFlat;
+        EnterCriticalSection(&gDebugHelpLock);
+        while (numFrames < maxFrames
+            && LStackWalk64(machineType, gProcess, thread->handle, &frame, &context, ReadCopiedStackMemory, LSymFunctionTableAccess64, LSymGetModuleBase64, NULL)
+            && frame.AddrPC.Offset != 0)
         {
-            line->line = 0;
-            line->offset = 0;
-            strcpy_s(line->filename, CALLSTACK_BUFFER_SIZE, "N/A");
+            outFrames[numFrames++] = (void*)(uintptr_t)frame.AddrPC.Offset;
         }
+        LeaveCriticalSection(&gDebugHelpLock);
+    }
+    ReleaseSRWLockExclusive(&gStackCopyLock);
+#else
+    //No way to pause a thread from outside, so signal it and have it walk its own stack.
+    //Signalling a thread that's already exited is undefined, so the caller has to make sure it's still alive.
+    static const std::chrono::milliseconds SIGNAL_TIMEOUT(50);
+    pthread_mutex_lock(&gSignalCaptureLock);
+    if (!gIsSignalHandlerInstalled)
+    {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = CaptureStackSignalHandler;
+        action.sa_flags = SA_RESTART | SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, nullptr);
+        gIsSignalHandlerInstalled = true;
     }
 
-    return gCallstackBuffer;
+    gNextSignalCaptureGeneration = gNextSignalCaptureGeneration + 1 != 0 ? gNextSignalCaptureGeneration + 1 : 1;
+    const unsigned int generation = gNextSignalCaptureGeneration;
+    gSignalCaptureTarget.store(threadHandle, std::memory_order_relaxed);
+    gOpenSignalCaptureGeneration.store(generation, std::memory_order_release);
+    if (pthread_kill((pthread_t)threadHandle, SIGPROF) != 0)
+    {
+        gOpenSignalCaptureGeneration.store(0, std::memory_order_relaxed);
+        pthread_mutex_unlock(&gSignalCaptureLock);
+        return 0;
+    }
+    std::chrono::steady_clock::time_point giveUpTime = std::chrono::steady_clock::now() + SIGNAL_TIMEOUT;
+    while (gFinishedSignalCaptureGeneration.load(std::memory_order_acquire) != generation && std::chrono::steady_clock::now() < giveUpTime);
+    if (gFinishedSignalCaptureGeneration.load(std::memory_order_acquire) != generation)
+    {
+        unsigned int openGeneration = generation;
+        if (gOpenSignalCaptureGeneration.compare_exchange_strong(openGeneration, 0, std::memory_order_acq_rel))
+        {
+            //Closed before the handler got to it, so if it ever does run it'll leave gSignalStack alone.
+            pthread_mutex_unlock(&gSignalCaptureLock);
+            return 0;
+        }
+        //The handler claimed it just as we gave up. It's partway through writing, so let it finish before anyone else captures.
+        while (gFinishedSignalCaptureGeneration.load(std::memory_order_acquire) != generation);
+    }
+    numFrames = (uint)gSignalStackFrameCount < maxFrames ? (uint)gSignalStackFrameCount : maxFrames;
+    memcpy(outFrames, gSignalStack, sizeof(void*) * numFrames);
+    pthread_mutex_unlock(&gSignalCaptureLock);
+#endif
+    return numFrames;
 }
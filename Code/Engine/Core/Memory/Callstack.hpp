@@ -76,11 +76,25 @@ struct CallstackLine
 
 bool CallstackSystemInit();
 void CallstackSystemDeinit();
+
+// Only grabs the raw return addresses, nothing gets symbolized here. Cheap enough to leave on for every allocation.
 Callstack* AllocateCallstack(uint skipFrames = 1);
 void FreeCallstack(Callstack* stackToFree);
 
-// Single Threaded - only from debug output thread (if I need the string names elsewhere
-// then I need to make a "debug" job consumer)
+// Symbols are resolved lazily here and cached by address, so repeated reports only pay for new frames.
+// Safe from any thread. The returned lines belong to the calling thread and are overwritten by its next call.
 CallstackLine* CallstackGetLines(Callstack* cs);
+uint CallstackGetNumCachedSymbols();
+// Frees every cached name, so nobody can still be holding one from CallstackGetFunctionName.
+void CallstackClearSymbolCache();
+// Safe from any thread. The name is the cached one, and stays good until the cache is cleared.
+const char* CallstackGetFunctionName(void* address);
+bool CallstackSystemIsInitialized();
+
+// Capturing another thread's stack. Grab the handle on the thread itself, then anyone can capture it.
+// The handle has to be released, and never captured with again, before the thread exits.
+uintptr_t CallstackGetCurrentThreadHandle();
+void CallstackReleaseThreadHandle(uintptr_t threadHandle);
+uint CallstackCaptureThread(uintptr_t threadHandle, void** outFrames, uint maxFrames);
 
 #endif 
@@ -0,0 +1,169 @@
+#include "Engine/Core/Memory/MemoryArena.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <stdlib.h>
+#include <stdint.h>
+#include <cstddef>
+#include <new>
+
+static HeapArena g_heapArena;
+
+//-----------------------------------------------------------------------------------
+static inline byte* AlignForward(byte* ptr, size_t alignment)
+{
+    uintptr_t address = (uintptr_t)ptr;
+    return (byte*)((address + (alignment - 1)) & ~(uintptr_t)(alignment - 1));
+}
+
+//-----------------------------------------------------------------------------------
+void* HeapArena::Allocate(size_t numBytes, size_t alignment)
+{
+    //Global new already hands back memory aligned for any fundamental type.
+    ASSERT_OR_DIE(alignment <= alignof(std::max_align_t), "HeapArena can't satisfy over-aligned allocations.");
+    return ::operator new(numBytes);
+}
+
+//-----------------------------------------------------------------------------------
+void HeapArena::Free(void* ptr, size_t)
+{
+    ::operator delete(ptr);
+}
+
+//-----------------------------------------------------------------------------------
+LinearArena::LinearArena(const char* name, size_t chunkSizeInBytes)
+    : MemoryArena(name)
+    , m_firstChunk(nullptr)
+    , m_lastChunk(nullptr)
+    , m_currentChunk(nullptr)
+    , m_current(nullptr)
+    , m_end(nullptr)
+    , m_chunkSizeInBytes(chunkSizeInBytes)
+    , m_numBytesUsed(0)
+    , m_highwaterInBytes(0)
+    , m_numChunks(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+LinearArena::~LinearArena()
+{
+    ReleaseMemory();
+}
+
+//-----------------------------------------------------------------------------------
+void* LinearArena::Allocate(size_t numBytes, size_t alignment)
+{
+    byte* alignedPtr = AlignForward(m_current, alignment);
+    if (!m_current || alignedPtr + numBytes > m_end)
+    {
+        AdvanceToChunkWithCapacity(numBytes + alignment);
+        alignedPtr = AlignForward(m_current, alignment);
+    }
+    m_current = alignedPtr + numBytes;
+    m_numBytesUsed += numBytes;
+    if (m_numBytesUsed > m_highwaterInBytes)
+    {
+        m_highwaterInBytes = m_numBytesUsed;
+    }
+    return alignedPtr;
+}
+
+//-----------------------------------------------------------------------------------
+void LinearArena::Free(void*, size_t)
+{
+    //Intentionally empty, the memory comes back when the arena is reset.
+}
+
+//-----------------------------------------------------------------------------------
+//Keeps every chunk around so the next frame/level doesn't have to go back to malloc.
+void LinearArena::Reset()
+{
+    m_currentChunk = nullptr;
+    m_current = nullptr;
+    m_end = nullptr;
+    m_numBytesUsed = 0;
+}
+
+//-----------------------------------------------------------------------------------
+LinearArena::Marker LinearArena::GetMarker() const
+{
+    Marker marker;
+    marker.chunk = m_currentChunk;
+    marker.current = m_current;
+    marker.numBytesUsed = m_numBytesUsed;
+    return marker;
+}
+
+//-----------------------------------------------------------------------------------
+//Chunks we moved on to after the marker are kept for reuse, same as with Reset().
+void LinearArena::RewindToMarker(const Marker& marker)
+{
+    ASSERT_OR_DIE(marker.numBytesUsed <= m_numBytesUsed, "Rewound a LinearArena to a marker it's already gone back past.");
+    m_currentChunk = marker.chunk;
+    m_current = marker.current;
+    m_end = marker.chunk ? (byte*)(marker.chunk + 1) + marker.chunk->capacity : nullptr;
+    m_numBytesUsed = marker.numBytesUsed;
+}
+
+//-----------------------------------------------------------------------------------
+void LinearArena::ReleaseMemory()
+{
+    Chunk* chunk = m_firstChunk;
+    while (chunk)
+    {
+        Chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    m_firstChunk = nullptr;
+    m_lastChunk = nullptr;
+    m_numChunks = 0;
+    Reset();
+}
+
+//-----------------------------------------------------------------------------------
+void LinearArena::AdvanceToChunkWithCapacity(size_t minimumCapacity)
+{
+    //Reuse chunks from before the last reset first. Any that are too small just sit out until the next reset.
+    Chunk* chunk = m_currentChunk ? m_currentChunk->next : m_firstChunk;
+    while (chunk && chunk->capacity < minimumCapacity)
+    {
+        chunk = chunk->next;
+    }
+
+    if (!chunk)
+    {
+        size_t capacity = minimumCapacity > m_chunkSizeInBytes ? minimumCapacity : m_chunkSizeInBytes;
+        chunk = (Chunk*)malloc(sizeof(Chunk) + capacity);
+        ASSERT_OR_DIE(chunk != nullptr, "Failed to allocate a chunk for a LinearArena.");
+        chunk->next = nullptr;
+        chunk->capacity = capacity;
+        if (m_lastChunk)
+        {
+            m_lastChunk->next = chunk;
+        }
+        else
+        {
+            m_firstChunk = chunk;
+        }
+        m_lastChunk = chunk;
+        ++m_numChunks;
+    }
+
+    m_currentChunk = chunk;
+    m_current = (byte*)(chunk + 1);
+    m_end = m_current + chunk->capacity;
+}
+
+//-----------------------------------------------------------------------------------
+MemoryArena* GetHeapArena()
+{
+    return &g_heapArena;
+}
+
+//-----------------------------------------------------------------------------------
+LinearArena* GetFrameArena()
+{
+    static LinearArena s_frameArena("frame", 256 * 1024);
+    return &s_frameArena;
+}
+
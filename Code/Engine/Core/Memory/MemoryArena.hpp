@@ -0,0 +1,112 @@
+#pragma once
+#include <stddef.h>
+
+typedef unsigned char byte;
+
+//-----------------------------------------------------------------------------------
+//Something containers and systems can be pointed at to get their memory from.
+//Arenas are not thread safe, each one should be owned by a single thread.
+class MemoryArena
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    MemoryArena(const char* name) : m_name(name) {};
+    virtual ~MemoryArena() {};
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    virtual void* Allocate(size_t numBytes, size_t alignment) = 0;
+    virtual void Free(void* ptr, size_t numBytes) = 0;
+    inline const char* GetName() const { return m_name; };
+
+private:
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    const char* m_name;
+};
+
+//-----------------------------------------------------------------------------------
+//Goes straight to the global heap. This is what containers use if they aren't given an arena.
+class HeapArena : public MemoryArena
+{
+public:
+    HeapArena() : MemoryArena("heap") {};
+    virtual void* Allocate(size_t numBytes, size_t alignment) override;
+    virtual void Free(void* ptr, size_t numBytes) override;
+};
+
+//-----------------------------------------------------------------------------------
+//Bump allocates out of big malloc'd chunks, the same way ObjectPool does, so they stay out of memory tracking.
+//Individual frees do nothing, everything is released at once by Reset() or by rewinding to a Marker.
+//Anything still pointing into the arena after a Reset() is dangling, so only hand it to containers that die first.
+class LinearArena : public MemoryArena
+{
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        size_t capacity;
+    };
+
+public:
+    //Everything allocated after a marker was taken can be thrown away by rewinding to it.
+    struct Marker
+    {
+        Chunk* chunk;
+        byte* current;
+        size_t numBytesUsed;
+    };
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    LinearArena(const char* name, size_t chunkSizeInBytes = 64 * 1024);
+    virtual ~LinearArena();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    virtual void* Allocate(size_t numBytes, size_t alignment) override;
+    virtual void Free(void* ptr, size_t numBytes) override;
+    void Reset();
+    void ReleaseMemory();
+    Marker GetMarker() const;
+    void RewindToMarker(const Marker& marker);
+    inline size_t GetNumBytesUsed() const { return m_numBytesUsed; };
+    inline size_t GetHighwaterInBytes() const { return m_highwaterInBytes; };
+    inline unsigned int GetNumChunks() const { return m_numChunks; };
+
+private:
+    void AdvanceToChunkWithCapacity(size_t minimumCapacity);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    Chunk* m_firstChunk;
+    Chunk* m_lastChunk;
+    Chunk* m_currentChunk;
+    byte* m_current;
+    byte* m_end;
+    size_t m_chunkSizeInBytes;
+    size_t m_numBytesUsed;
+    size_t m_highwaterInBytes;
+    unsigned int m_numChunks;
+};
+
+//-----------------------------------------------------------------------------------
+//Gives back everything allocated from the arena while it was alive. Scopes nest, and have to close in the reverse order they opened.
+class LinearArenaScope
+{
+public:
+    explicit LinearArenaScope(LinearArena* arena) : m_arena(arena), m_marker(arena->GetMarker()) {};
+    ~LinearArenaScope() { m_arena->RewindToMarker(m_marker); };
+
+private:
+    LinearArenaScope(const LinearArenaScope&) = delete;
+    LinearArenaScope& operator=(const LinearArenaScope&) = delete;
+
+    LinearArena* m_arena;
+    LinearArena::Marker m_marker;
+};
+
+//FUNCTIONS/////////////////////////////////////////////////////////////////////
+MemoryArena* GetHeapArena();
+
+//Scratch memory for the main thread. Nothing resets it on its own: open a LinearArenaScope before allocating from it,
+//and declare it before any container using the arena so the container is gone before the scope rewinds.
+LinearArena* GetFrameArena();
@@ -0,0 +1,433 @@
+#include "Engine/Core/Memory/MemorySnapshot.hpp"
+#include "Engine/Core/Memory/MemoryTracking.hpp"
+#include "Engine/Core/Memory/Callstack.hpp"
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/BinaryWriter.hpp"
+#include "Engine/Input/Console.hpp"
+#include "Engine/Input/InputOutputUtils.hpp"
+#include <algorithm>
+#include <map>
+#include <string.h>
+
+static const uint32_t MEMORY_SNAPSHOT_FILE_ID = 0x504E534D; //"MSNP"
+static const uint32_t MEMORY_SNAPSHOT_FILE_VERSION = 1;
+//Two empty strings, an allocation count and a byte count.
+static const size_t MEMORY_SNAPSHOT_MIN_SITE_SIZE = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+
+//Snapshots taken from the console, by name.
+static std::map<std::string, MemorySnapshot> g_memorySnapshots;
+
+//-----------------------------------------------------------------------------------
+//Copied out of the metadata list while it's locked, so the callstacks can be freed out from under us afterwards.
+struct RawSnapshotEntry
+{
+    uint64_t callsiteHash;
+    MemoryTag tag;
+    size_t numberOfBytes;
+    unsigned int numberOfFrames;
+    void* frames[MemorySnapshot::CALLSITE_DEPTH];
+};
+
+//-----------------------------------------------------------------------------------
+static bool SortByCallsite(const RawSnapshotEntry& first, const RawSnapshotEntry& second)
+{
+    if (first.callsiteHash != second.callsiteHash)
+    {
+        return first.callsiteHash < second.callsiteHash;
+    }
+    if (first.tag != second.tag)
+    {
+        return first.tag < second.tag;
+    }
+    //Different callsites can share a hash, so the frames decide the order and keep identical sites next to each other.
+    if (first.numberOfFrames != second.numberOfFrames)
+    {
+        return first.numberOfFrames < second.numberOfFrames;
+    }
+    return memcmp(first.frames, second.frames, first.numberOfFrames * sizeof(void*)) < 0;
+}
+
+//-----------------------------------------------------------------------------------
+static bool IsSameSite(const RawSnapshotEntry& first, const RawSnapshotEntry& second)
+{
+    return first.callsiteHash == second.callsiteHash
+        && first.tag == second.tag
+        && first.numberOfFrames == second.numberOfFrames
+        && memcmp(first.frames, second.frames, first.numberOfFrames * sizeof(void*)) == 0;
+}
+
+//-----------------------------------------------------------------------------------
+static bool SortByGrowth(const MemorySnapshotDiffEntry& first, const MemorySnapshotDiffEntry& second)
+{
+    return first.m_byteDelta > second.m_byteDelta;
+}
+
+//-----------------------------------------------------------------------------------
+static std::string SymbolizeCallsite(const RawSnapshotEntry& entry)
+{
+    if (entry.numberOfFrames == 0)
+    {
+        return "N/A";
+    }
+    Callstack callstack;
+    callstack.frames = const_cast<void**>(entry.frames);
+    callstack.frameCount = entry.numberOfFrames;
+    CallstackLine* lines = CallstackGetLines(&callstack);
+
+    std::string callsite;
+    for (unsigned int i = 0; i < entry.numberOfFrames; ++i)
+    {
+        if (i != 0)
+        {
+            callsite += " <- ";
+        }
+        callsite += Stringf("%s(%u)", lines[i].functionName, lines[i].line);
+    }
+    return callsite;
+}
+
+//-----------------------------------------------------------------------------------
+MemorySnapshot::MemorySnapshot()
+    : m_numberOfAllocations(0)
+    , m_numberOfBytes(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+void MemorySnapshot::Capture()
+{
+    m_sites.clear();
+    m_numberOfAllocations = 0;
+    m_numberOfBytes = 0;
+
+#if defined(TRACK_MEMORY) && (TRACK_MEMORY > 0)
+    if (!g_memoryAnalytics.m_isInitialized)
+    {
+        return;
+    }
+
+    //Untracked so that building the snapshot doesn't show up in the snapshot.
+    std::vector<RawSnapshotEntry, UntrackedAllocator<RawSnapshotEntry>> rawEntries;
+    EnterCriticalSection(&g_memoryAnalytics.m_memoryManagerCriticalSection);
+    {
+        rawEntries.reserve(g_memoryAnalytics.m_numberOfAllocations);
+        MemoryMetadata* currentNode = g_memoryMetadataList;
+        while (currentNode)
+        {
+            RawSnapshotEntry entry;
+            entry.callsiteHash = 14695981039346656037ull;
+            entry.tag = currentNode->tag;
+            entry.numberOfBytes = currentNode->sizeOfAllocInBytes;
+            entry.numberOfFrames = 0;
+
+            //Frame 0 is always operator new, the interesting part starts with whoever called it.
+            Callstack* callstack = currentNode->callstack;
+            for (unsigned int i = 1; callstack && i < callstack->frameCount && entry.numberOfFrames < CALLSITE_DEPTH; ++i)
+            {
+                void* frame = callstack->frames[i];
+                entry.frames[entry.numberOfFrames++] = frame;
+                entry.callsiteHash = (entry.callsiteHash ^ (uint64_t)(uintptr_t)frame) * 1099511628211ull;
+            }
+            rawEntries.push_back(entry);
+
+            currentNode = currentNode->next;
+            if (currentNode == g_memoryMetadataList)
+            {
+                break;
+            }
+        }
+    }
+    LeaveCriticalSection(&g_memoryAnalytics.m_memoryManagerCriticalSection);
+
+    //Fold identical sites together, then only pay to symbolize each unique site once.
+    std::sort(rawEntries.begin(), rawEntries.end(), &SortByCallsite);
+    MemoryTagScope profilingScope(MEMTAG_PROFILING);
+    for (size_t i = 0; i < rawEntries.size(); )
+    {
+        const RawSnapshotEntry& first = rawEntries[i];
+        MemorySnapshotSite site;
+        site.m_tag = first.tag;
+        site.m_numberOfAllocations = 0;
+        site.m_numberOfBytes = 0;
+        for (; i < rawEntries.size() && IsSameSite(rawEntries[i], first); ++i)
+        {
+            ++site.m_numberOfAllocations;
+            site.m_numberOfBytes += rawEntries[i].numberOfBytes;
+        }
+        site.m_callsite = SymbolizeCallsite(first);
+        m_numberOfAllocations += site.m_numberOfAllocations;
+        m_numberOfBytes += site.m_numberOfBytes;
+        m_sites.push_back(site);
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------------
+//Tags are saved by name so that adding new tags doesn't break older snapshots.
+bool MemorySnapshot::SaveToFile(const std::string& filePath) const
+{
+    BinaryFileWriter writer;
+    if (!writer.Open(filePath.c_str()))
+    {
+        return false;
+    }
+    writer.Write<uint32_t>(MEMORY_SNAPSHOT_FILE_ID);
+    writer.Write<uint32_t>(MEMORY_SNAPSHOT_FILE_VERSION);
+    writer.Write<uint32_t>(m_sites.size());
+    for (const MemorySnapshotSite& site : m_sites)
+    {
+        writer.WriteString(GetMemoryTagName(site.m_tag));
+        writer.Write<uint32_t>(site.m_numberOfAllocations);
+        writer.Write<uint64_t>(site.m_numberOfBytes);
+        writer.WriteString(site.m_callsite.c_str());
+    }
+    writer.Close();
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+//Reads from a snapshot file without ever going past the end of it. Anything truncated or corrupt fails the whole load.
+class SnapshotFileParser
+{
+public:
+    SnapshotFileParser(const unsigned char* data, size_t size) : m_current(data), m_end(data + size) {};
+
+    size_t GetNumBytesRemaining() const { return (size_t)(m_end - m_current); };
+
+    //-----------------------------------------------------------------------------------
+    template<typename T>
+    bool Read(T& outValue)
+    {
+        if (GetNumBytesRemaining() < sizeof(T))
+        {
+            return false;
+        }
+        memcpy(&outValue, m_current, sizeof(T));
+        m_current += sizeof(T);
+        return true;
+    }
+
+    //-----------------------------------------------------------------------------------
+    bool ReadString(std::string& outString)
+    {
+        uint32_t length = 0;
+        if (!Read<uint32_t>(length) || length > GetNumBytesRemaining())
+        {
+            return false;
+        }
+        //Strings are written with their null terminator, which isn't part of the string.
+        const char* characters = (const char*)m_current;
+        outString.assign(characters, length > 0 && characters[length - 1] == '\0' ? length - 1 : length);
+        m_current += length;
+        return true;
+    }
+
+private:
+    const unsigned char* m_current;
+    const unsigned char* m_end;
+};
+
+//-----------------------------------------------------------------------------------
+bool MemorySnapshot::LoadFromFile(const std::string& filePath)
+{
+    std::vector<unsigned char> fileContents;
+    if (!LoadBufferFromBinaryFile(fileContents, filePath))
+    {
+        return false;
+    }
+    return LoadFromBytes(fileContents.data(), fileContents.size());
+}
+
+//-----------------------------------------------------------------------------------
+//Only replaces what's in this snapshot if the whole thing parses.
+bool MemorySnapshot::LoadFromBytes(const unsigned char* data, size_t size)
+{
+    SnapshotFileParser parser(data, size);
+    uint32_t fileId = 0;
+    uint32_t version = 0;
+    uint32_t numSites = 0;
+    if (!parser.Read<uint32_t>(fileId) || !parser.Read<uint32_t>(version) || !parser.Read<uint32_t>(numSites))
+    {
+        return false;
+    }
+    if (fileId != MEMORY_SNAPSHOT_FILE_ID || version != MEMORY_SNAPSHOT_FILE_VERSION)
+    {
+        return false;
+    }
+    //Don't trust the count enough to reserve for it until it's clear the file could actually hold that many sites.
+    if (numSites > parser.GetNumBytesRemaining() / MEMORY_SNAPSHOT_MIN_SITE_SIZE)
+    {
+        return false;
+    }
+
+    std::vector<MemorySnapshotSite> sites;
+    sites.reserve(numSites);
+    unsigned int totalAllocations = 0;
+    size_t totalBytes = 0;
+    std::string tagName;
+    for (uint32_t i = 0; i < numSites; ++i)
+    {
+        MemorySnapshotSite site;
+        uint32_t numberOfAllocations = 0;
+        uint64_t numberOfBytes = 0;
+        if (!parser.ReadString(tagName) || !parser.Read<uint32_t>(numberOfAllocations) || !parser.Read<uint64_t>(numberOfBytes) || !parser.ReadString(site.m_callsite))
+        {
+            return false;
+        }
+        if (!GetMemoryTagFromName(tagName.c_str(), site.m_tag))
+        {
+            site.m_tag = MEMTAG_UNTAGGED;
+        }
+        if (site.m_callsite.empty())
+        {
+            site.m_callsite = "N/A";
+        }
+        site.m_numberOfAllocations = numberOfAllocations;
+        site.m_numberOfBytes = (size_t)numberOfBytes;
+        totalAllocations += site.m_numberOfAllocations;
+        totalBytes += site.m_numberOfBytes;
+        sites.push_back(site);
+    }
+    if (parser.GetNumBytesRemaining() != 0)
+    {
+        return false;
+    }
+
+    m_sites.swap(sites);
+    m_numberOfAllocations = totalAllocations;
+    m_numberOfBytes = totalBytes;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+std::vector<MemorySnapshotDiffEntry> MemorySnapshot::Diff(const MemorySnapshot& before, const MemorySnapshot& after)
+{
+    typedef std::pair<int, std::string> SiteKey;
+    std::map<SiteKey, MemorySnapshotDiffEntry> entries;
+
+    for (const MemorySnapshotSite& site : after.m_sites)
+    {
+        MemorySnapshotDiffEntry& entry = entries[SiteKey(site.m_tag, site.m_callsite)];
+        entry.m_callsite = site.m_callsite;
+        entry.m_tag = site.m_tag;
+        entry.m_allocationDelta += site.m_numberOfAllocations;
+        entry.m_byteDelta += site.m_numberOfBytes;
+    }
+    for (const MemorySnapshotSite& site : before.m_sites)
+    {
+        MemorySnapshotDiffEntry& entry = entries[SiteKey(site.m_tag, site.m_callsite)];
+        entry.m_callsite = site.m_callsite;
+        entry.m_tag = site.m_tag;
+        entry.m_allocationDelta -= site.m_numberOfAllocations;
+        entry.m_byteDelta -= site.m_numberOfBytes;
+    }
+
+    std::vector<MemorySnapshotDiffEntry> growth;
+    for (auto& pair : entries)
+    {
+        if (pair.second.m_byteDelta > 0)
+        {
+            growth.push_back(pair.second);
+        }
+    }
+    std::sort(growth.begin(), growth.end(), &SortByGrowth);
+    return growth;
+}
+
+//-----------------------------------------------------------------------------------
+std::string MemorySnapshot::FormatDiffEntry(const MemorySnapshotDiffEntry& entry)
+{
+    return Stringf("+%lld bytes, %+d allocs [%s] %s", entry.m_byteDelta, entry.m_allocationDelta, GetMemoryTagName(entry.m_tag), entry.m_callsite.c_str());
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(memorysnapshot)
+{
+    if (!args.HasArgs(1))
+    {
+        Console::instance->PrintLine("memorysnapshot <snapshot name>", RGBA::RED);
+        return;
+    }
+    std::string name = args.GetStringArgument(0);
+    MemoryTagScope profilingScope(MEMTAG_PROFILING);
+    MemorySnapshot& snapshot = g_memorySnapshots[name];
+    snapshot.Capture();
+    Console::instance->PrintLine(Stringf("Captured snapshot '%s': %u sites, %u allocations, %u bytes.", name.c_str(), snapshot.m_sites.size(), snapshot.m_numberOfAllocations, snapshot.m_numberOfBytes), RGBA::VAPORWAVE);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(memorysnapshotsave)
+{
+    if (!args.HasArgs(2))
+    {
+        Console::instance->PrintLine("memorysnapshotsave <snapshot name> <file path>", RGBA::RED);
+        return;
+    }
+    std::string name = args.GetStringArgument(0);
+    std::string filePath = args.GetStringArgument(1);
+    auto found = g_memorySnapshots.find(name);
+    if (found == g_memorySnapshots.end())
+    {
+        Console::instance->PrintLine(Stringf("No snapshot named '%s'.", name.c_str()), RGBA::RED);
+        return;
+    }
+    if (!found->second.SaveToFile(filePath))
+    {
+        Console::instance->PrintLine(Stringf("Couldn't write '%s'.", filePath.c_str()), RGBA::RED);
+        return;
+    }
+    Console::instance->PrintLine(Stringf("Saved snapshot '%s' to '%s'.", name.c_str(), filePath.c_str()), RGBA::VAPORWAVE);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(memorysnapshotload)
+{
+    if (!args.HasArgs(2))
+    {
+        Console::instance->PrintLine("memorysnapshotload <snapshot name> <file path>", RGBA::RED);
+        return;
+    }
+    std::string name = args.GetStringArgument(0);
+    std::string filePath = args.GetStringArgument(1);
+    MemoryTagScope profilingScope(MEMTAG_PROFILING);
+    MemorySnapshot loadedSnapshot;
+    if (!loadedSnapshot.LoadFromFile(filePath))
+    {
+        Console::instance->PrintLine(Stringf("Couldn't read a memory snapshot from '%s'.", filePath.c_str()), RGBA::RED);
+        return;
+    }
+    g_memorySnapshots[name] = loadedSnapshot;
+    Console::instance->PrintLine(Stringf("Loaded '%s' as snapshot '%s'.", filePath.c_str(), name.c_str()), RGBA::VAPORWAVE);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(memorydiff)
+{
+    if (!args.HasArgs(2) && !args.HasArgs(3))
+    {
+        Console::instance->PrintLine("memorydiff <before snapshot> <after snapshot> <optional: number of sites to show>", RGBA::RED);
+        return;
+    }
+    std::string beforeName = args.GetStringArgument(0);
+    std::string afterName = args.GetStringArgument(1);
+    unsigned int maxSitesToShow = args.HasArgs(3) ? (unsigned int)args.GetIntArgument(2) : 20;
+    auto before = g_memorySnapshots.find(beforeName);
+    auto after = g_memorySnapshots.find(afterName);
+    if (before == g_memorySnapshots.end() || after == g_memorySnapshots.end())
+    {
+        Console::instance->PrintLine("Both snapshots need to be captured or loaded first.", RGBA::RED);
+        return;
+    }
+
+    MemoryTagScope profilingScope(MEMTAG_PROFILING);
+    std::vector<MemorySnapshotDiffEntry> growth = MemorySnapshot::Diff(before->second, after->second);
+    long long totalByteDelta = (long long)after->second.m_numberOfBytes - (long long)before->second.m_numberOfBytes;
+    Console::instance->PrintLine(Stringf("'%s' -> '%s': %lld bytes net, %u sites grew.", beforeName.c_str(), afterName.c_str(), totalByteDelta, growth.size()), RGBA::VAPORWAVE);
+    for (unsigned int i = 0; i < growth.size() && i < maxSitesToShow; ++i)
+    {
+        Console::instance->PrintLine(MemorySnapshot::FormatDiffEntry(growth[i]), RGBA::WHITE);
+    }
+}
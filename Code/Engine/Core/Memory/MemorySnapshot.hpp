@@ -0,0 +1,54 @@
+#pragma once
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Every live allocation made from the same callsite with the same tag, rolled up into one entry.
+struct MemorySnapshotSite
+{
+    std::string m_callsite;
+    MemoryTag m_tag;
+    unsigned int m_numberOfAllocations;
+    size_t m_numberOfBytes;
+};
+
+//-----------------------------------------------------------------------------------
+//Net change for a single site between two snapshots.
+struct MemorySnapshotDiffEntry
+{
+    std::string m_callsite;
+    MemoryTag m_tag;
+    int m_allocationDelta;
+    long long m_byteDelta;
+};
+
+//-----------------------------------------------------------------------------------
+//Point in time picture of every live tracked allocation, grouped by callsite and tag.
+//Callsites are stored symbolized so snapshots saved from two different runs can still be compared.
+class MemorySnapshot
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    MemorySnapshot();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Capture();
+    bool SaveToFile(const std::string& filePath) const;
+    bool LoadFromFile(const std::string& filePath);
+    bool LoadFromBytes(const unsigned char* data, size_t size);
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    //Sites that grew from before to after, biggest growth first.
+    static std::vector<MemorySnapshotDiffEntry> Diff(const MemorySnapshot& before, const MemorySnapshot& after);
+    static std::string FormatDiffEntry(const MemorySnapshotDiffEntry& entry);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    //How many frames of each callstack are used to tell sites apart.
+    static const unsigned int CALLSITE_DEPTH = 6;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<MemorySnapshotSite> m_sites;
+    unsigned int m_numberOfAllocations;
+    size_t m_numberOfBytes;
+};
@@ -0,0 +1,193 @@
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Console.hpp"
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+static const char* MEMORY_TAG_NAMES[NUM_MEMORY_TAGS] =
+{
+    "untagged",
+    "renderer",
+    "particles",
+    "ui",
+    "audio",
+    "networking",
+    "jobs",
+    "profiling",
+    "logging",
+    "buffers",
+    "game",
+};
+
+static MemoryTagStats g_memoryTagStats[NUM_MEMORY_TAGS];
+//Statically initialized, so it works for allocations made before main. Never held while allocating.
+static SRWLOCK g_memoryTagLock = SRWLOCK_INIT;
+static thread_local MemoryTag g_currentMemoryTag = MEMTAG_UNTAGGED;
+//Reporting a budget allocates, so we don't want that report to trigger another report.
+static thread_local bool g_isReportingMemoryBudget = false;
+
+//-----------------------------------------------------------------------------------
+MemoryTagScope::MemoryTagScope(MemoryTag tag)
+    : m_previousTag(g_currentMemoryTag)
+{
+    g_currentMemoryTag = tag;
+}
+
+//-----------------------------------------------------------------------------------
+MemoryTagScope::~MemoryTagScope()
+{
+    g_currentMemoryTag = m_previousTag;
+}
+
+//-----------------------------------------------------------------------------------
+MemoryTag GetCurrentMemoryTag()
+{
+    return g_currentMemoryTag;
+}
+
+//-----------------------------------------------------------------------------------
+const char* GetMemoryTagName(MemoryTag tag)
+{
+    return MEMORY_TAG_NAMES[tag];
+}
+
+//-----------------------------------------------------------------------------------
+MemoryTagStats GetMemoryTagStats(MemoryTag tag)
+{
+    AcquireSRWLockExclusive(&g_memoryTagLock);
+    MemoryTagStats stats = g_memoryTagStats[tag];
+    ReleaseSRWLockExclusive(&g_memoryTagLock);
+    return stats;
+}
+
+//-----------------------------------------------------------------------------------
+void SetMemoryTagBudget(MemoryTag tag, size_t softBudgetInBytes, size_t hardBudgetInBytes)
+{
+    AcquireSRWLockExclusive(&g_memoryTagLock);
+    MemoryTagStats& stats = g_memoryTagStats[tag];
+    stats.softBudgetInBytes = softBudgetInBytes;
+    stats.hardBudgetInBytes = hardBudgetInBytes;
+    stats.isOverSoftBudget = false;
+    stats.isOverHardBudget = false;
+    ReleaseSRWLockExclusive(&g_memoryTagLock);
+}
+
+//-----------------------------------------------------------------------------------
+bool TrackMemoryTagAllocation(MemoryTag tag, size_t numBytes)
+{
+    AcquireSRWLockExclusive(&g_memoryTagLock);
+    MemoryTagStats& stats = g_memoryTagStats[tag];
+    ++stats.numberOfAllocations;
+    stats.numberOfBytes += numBytes;
+    if (stats.numberOfBytes > stats.highwaterInBytes)
+    {
+        stats.highwaterInBytes = stats.numberOfBytes;
+    }
+
+    //Only report the first time we cross a budget, otherwise every allocation afterwards would warn.
+    bool crossedBudget = false;
+    if (stats.softBudgetInBytes != 0 && !stats.isOverSoftBudget && stats.numberOfBytes > stats.softBudgetInBytes)
+    {
+        stats.isOverSoftBudget = true;
+        crossedBudget = true;
+    }
+    if (stats.hardBudgetInBytes != 0 && !stats.isOverHardBudget && stats.numberOfBytes > stats.hardBudgetInBytes)
+    {
+        stats.isOverHardBudget = true;
+        crossedBudget = true;
+    }
+    ReleaseSRWLockExclusive(&g_memoryTagLock);
+    return crossedBudget;
+}
+
+//-----------------------------------------------------------------------------------
+void TrackMemoryTagFree(MemoryTag tag, size_t numBytes)
+{
+    AcquireSRWLockExclusive(&g_memoryTagLock);
+    MemoryTagStats& stats = g_memoryTagStats[tag];
+    --stats.numberOfAllocations;
+    stats.numberOfBytes -= numBytes;
+
+    //Dropping back under a budget re-arms the warning for the next time we cross it.
+    if (stats.isOverSoftBudget && stats.numberOfBytes <= stats.softBudgetInBytes)
+    {
+        stats.isOverSoftBudget = false;
+    }
+    if (stats.isOverHardBudget && stats.numberOfBytes <= stats.hardBudgetInBytes)
+    {
+        stats.isOverHardBudget = false;
+    }
+    ReleaseSRWLockExclusive(&g_memoryTagLock);
+}
+
+//-----------------------------------------------------------------------------------
+void ReportMemoryTagBudgetViolation(MemoryTag tag)
+{
+    if (g_isReportingMemoryBudget)
+    {
+        return;
+    }
+    g_isReportingMemoryBudget = true;
+    {
+        //Copy first, the warning allocates and we can't hold the lock through that.
+        const MemoryTagStats stats = GetMemoryTagStats(tag);
+        if (stats.isOverHardBudget)
+        {
+            ERROR_RECOVERABLE(Stringf("Memory tag '%s' exceeded its hard budget: %u bytes used, %u bytes allowed.", GetMemoryTagName(tag), stats.numberOfBytes, stats.hardBudgetInBytes));
+        }
+        else if (stats.isOverSoftBudget)
+        {
+            DebuggerPrintf("WARNING: Memory tag '%s' exceeded its soft budget: %u bytes used, %u bytes allowed.\n", GetMemoryTagName(tag), stats.numberOfBytes, stats.softBudgetInBytes);
+        }
+    }
+    g_isReportingMemoryBudget = false;
+}
+
+//-----------------------------------------------------------------------------------
+bool GetMemoryTagFromName(const std::string& name, MemoryTag& outTag)
+{
+    for (int i = 0; i < NUM_MEMORY_TAGS; ++i)
+    {
+        if (name == MEMORY_TAG_NAMES[i])
+        {
+            outTag = (MemoryTag)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(memorytags)
+{
+    UNUSED(args);
+    Console::instance->PrintLine(Stringf("%-12s%12s%14s%14s%14s%14s", "TAG", "NUM ALLOCS", "BYTES", "HIGHWATER", "SOFT BUDGET", "HARD BUDGET"), RGBA::VAPORWAVE);
+    for (int i = 0; i < NUM_MEMORY_TAGS; ++i)
+    {
+        const MemoryTagStats stats = GetMemoryTagStats((MemoryTag)i);
+        RGBA color = stats.isOverHardBudget ? RGBA::RED : (stats.isOverSoftBudget ? RGBA::YELLOW : RGBA::WHITE);
+        Console::instance->PrintLine(Stringf("%-12s%12u%14u%14u%14u%14u", MEMORY_TAG_NAMES[i], stats.numberOfAllocations, stats.numberOfBytes, stats.highwaterInBytes, stats.softBudgetInBytes, stats.hardBudgetInBytes), color);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(memorybudget)
+{
+    if (!args.HasArgs(3))
+    {
+        Console::instance->PrintLine("memorybudget <tag name> <soft budget KB> <hard budget KB> (0 disables a budget)", RGBA::RED);
+        return;
+    }
+    MemoryTag tag;
+    std::string tagName = args.GetStringArgument(0);
+    if (!GetMemoryTagFromName(tagName, tag))
+    {
+        Console::instance->PrintLine(Stringf("Unknown memory tag '%s'.", tagName.c_str()), RGBA::RED);
+        return;
+    }
+    size_t softBudget = (size_t)args.GetIntArgument(1) * 1024;
+    size_t hardBudget = (size_t)args.GetIntArgument(2) * 1024;
+    SetMemoryTagBudget(tag, softBudget, hardBudget);
+    Console::instance->PrintLine(Stringf("Set '%s' budget to %uKB soft, %uKB hard.", tagName.c_str(), softBudget / 1024, hardBudget / 1024), RGBA::VAPORWAVE);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+
+//-----------------------------------------------------------------------------------
+//Tags attribute tracked allocations to the subsystem that made them.
+//Add new subsystems above NUM_MEMORY_TAGS and give them a name in MemoryTags.cpp.
+enum MemoryTag
+{
+    MEMTAG_UNTAGGED = 0,
+    MEMTAG_RENDERER,
+    MEMTAG_PARTICLES,
+    MEMTAG_UI,
+    MEMTAG_AUDIO,
+    MEMTAG_NETWORKING,
+    MEMTAG_JOBS,
+    MEMTAG_PROFILING,
+    MEMTAG_LOGGING,
+    MEMTAG_BUFFERS,
+    MEMTAG_GAME,
+    NUM_MEMORY_TAGS
+};
+
+//-----------------------------------------------------------------------------------
+//Kept as plain data so the static table is zeroed before any allocation can touch it.
+struct MemoryTagStats
+{
+    unsigned int numberOfAllocations;
+    size_t numberOfBytes;
+    size_t highwaterInBytes;
+    size_t softBudgetInBytes; //0 means no budget
+    size_t hardBudgetInBytes; //0 means no budget
+    bool isOverSoftBudget;
+    bool isOverHardBudget;
+};
+
+//-----------------------------------------------------------------------------------
+//Every allocation made while this is alive is attributed to the tag, including allocations made by jobs created inside of it.
+//Scopes nest; the innermost scope wins and the previous tag is restored when it ends.
+class MemoryTagScope
+{
+public:
+    MemoryTagScope(MemoryTag tag);
+    ~MemoryTagScope();
+
+private:
+    MemoryTag m_previousTag;
+};
+
+//FUNCTIONS/////////////////////////////////////////////////////////////////////
+MemoryTag GetCurrentMemoryTag();
+const char* GetMemoryTagName(MemoryTag tag);
+bool GetMemoryTagFromName(const std::string& name, MemoryTag& outTag);
+//Returns a copy taken under the tag lock, since any thread can be allocating while we read.
+MemoryTagStats GetMemoryTagStats(MemoryTag tag);
+void SetMemoryTagBudget(MemoryTag tag, size_t softBudgetInBytes, size_t hardBudgetInBytes);
+
+//Called by MemoryAnalytics while it holds its lock, so the tag lock always nests inside that one. Returns true the first time a budget is crossed so the caller can report it once it's safe to allocate.
+bool TrackMemoryTagAllocation(MemoryTag tag, size_t numBytes);
+void TrackMemoryTagFree(MemoryTag tag, size_t numBytes);
+void ReportMemoryTagBudgetViolation(MemoryTag tag);
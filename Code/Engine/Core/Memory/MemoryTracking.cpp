@@ -1,5 +1,6 @@
 #include "Engine/Core/Memory/MemoryTracking.hpp"
 #include "Engine/Core/Memory/Callstack.hpp"
+#include "Engine/Core/Memory/Buffer.hpp"
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
@@ -40,6 +41,7 @@ void operator delete[](void *ptr)
 MemoryAnalytics::MemoryAnalytics()
     : m_isInitialized(false)
     , m_numberOfAllocations(0)
+    , m_lifetimeNumberOfAllocations(0)
     , m_numberOfBytes(0)
     , m_startupNumberOfAllocations(0)
     , m_numberOfShaderAllocations(0)
@@ -81,6 +83,7 @@ void* MemoryAnalytics::Allocate(const size_t numBytes)
     size_t* ptr = (size_t*) ::malloc(real_size);
 
     metadata->sizeOfAllocInBytes = numBytes;
+    metadata->tag = GetCurrentMemoryTag();
 
     #if (TRACK_MEMORY > 0)
     {
@@ -100,20 +103,29 @@ void* MemoryAnalytics::Allocate(const size_t numBytes)
     ++ptr;
 
     //THIS IS THE PART THAT NEEDS TO BE THREAD-SAFE
+    bool crossedTagBudget = false;
     AttemptLock();
     {
         ++m_numberOfAllocations;
+        ++m_lifetimeNumberOfAllocations;
         m_numberOfBytes += numBytes;
         if (m_numberOfBytes > m_highwaterInBytes)
         {
             m_highwaterInBytes = m_numberOfBytes;
         }
+        crossedTagBudget = TrackMemoryTagAllocation(metadata->tag, numBytes);
 #if (TRACK_MEMORY > 0)
         //Add to map
         MemoryMetadata::AddMemoryMetadataToList(metadata);
 #endif // TRACK_MEMORY > 0
     }
     AttemptLeave();
+
+    //Reporting allocates, so it has to happen once we're out of the lock and our bookkeeping is done.
+    if (crossedTagBudget)
+    {
+        ReportMemoryTagBudgetViolation(metadata->tag);
+    }
     return ptr;
     
     // BONUS MATERIAL 
@@ -137,6 +149,7 @@ void MemoryAnalytics::Free(const void* ptr)
     {
         --m_numberOfAllocations;
         m_numberOfBytes -= metadata->sizeOfAllocInBytes;
+        TrackMemoryTagFree(metadata->tag, metadata->sizeOfAllocInBytes);
 
 #if (TRACK_MEMORY > 0)
         MemoryMetadata::RemoveMemoryMetadataFromList(metadata);
@@ -157,9 +170,10 @@ MemoryMetadata::~MemoryMetadata()
 void MemoryMetadata::AddMemoryMetadataToList(MemoryMetadata* stackToAdd)
 {
 #ifdef PROFILING_ENABLED
-    if (ProfilingSystem::instance && ProfilingSystem::instance->m_activeSample)
+    ProfileSample* activeSample = ProfilingSystem::instance ? ProfilingSystem::instance->GetActiveSample() : nullptr;
+    if (activeSample)
     {
-        ProfilingSystem::instance->m_activeSample->AddAllocation(stackToAdd->sizeOfAllocInBytes);
+        activeSample->AddAllocation(stackToAdd->sizeOfAllocInBytes, stackToAdd->tag);
     }
 #endif
     if (!g_memoryMetadataList)
@@ -231,6 +245,9 @@ void MemoryAnalyticsStartup()
 //-----------------------------------------------------------------------------------
 void MemoryAnalyticsShutdown()
 {
+    //The buffer pool holds on to freed blocks for reuse, they'd all show up as leaks otherwise.
+    BufferPoolShutdown();
+
     //Walk the list of callstacks, print them all out. This is what you haven't freed
     //Can bucketize the callstacks into unique callstack hash lists, then print the # of reports you got
     if (g_memoryAnalytics.m_numberOfAllocations > g_memoryAnalytics.m_startupNumberOfAllocations)
@@ -276,7 +293,7 @@ void MemoryAnalyticsStartup()
 //-----------------------------------------------------------------------------------
 void MemoryAnalyticsShutdown()
 {
-
+    BufferPoolShutdown();
 }
 
 #endif
\ No newline at end of file
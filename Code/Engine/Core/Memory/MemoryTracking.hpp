@@ -2,6 +2,7 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
 
 //FORWARD DECLARATIONS//////////////////////////////////////////////////////////////////////////
 struct Callstack;
@@ -17,6 +18,7 @@ class MemoryMetadata
 public:
     MemoryMetadata()
         : sizeOfAllocInBytes(0)
+        , tag(MEMTAG_UNTAGGED)
         , callstack(nullptr)
         , next(nullptr)
         , prev(nullptr)
@@ -32,6 +34,7 @@ public:
 
     //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
     size_t sizeOfAllocInBytes;
+    MemoryTag tag;
     Callstack* callstack;
     MemoryMetadata* next;
     MemoryMetadata* prev;
@@ -105,6 +108,7 @@ public:
     bool m_isInitialized;
     unsigned int m_startupNumberOfAllocations;
     unsigned int m_numberOfAllocations;
+    unsigned int m_lifetimeNumberOfAllocations; //Never goes down, so the difference between two reads is how many allocations happened in between
     unsigned int m_numberOfShaderAllocations;
     unsigned int m_numberOfVAOAllocations;
     unsigned int m_numberOfRenderBufferAllocations;
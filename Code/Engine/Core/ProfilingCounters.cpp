@@ -0,0 +1,96 @@
+#include "Engine/Core/ProfilingCounters.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/Console.hpp"
+
+//-----------------------------------------------------------------------------------
+struct ProfilingCounterDescription
+{
+    const char* name;
+    ProfilingCounterType type;
+};
+
+static const ProfilingCounterDescription PROFILING_COUNTER_DESCRIPTIONS[NUM_PROFILING_COUNTERS] =
+{
+    { "jobs executed", PER_FRAME_COUNTER },
+    { "packets sent", PER_FRAME_COUNTER },
+    { "bytes sent", PER_FRAME_COUNTER },
+    { "vertices built", PER_FRAME_COUNTER },
+    { "texture bytes uploaded", PER_FRAME_COUNTER },
+    { "particles alive", GAUGE },
+};
+
+ProfilingCounterSlot g_profilingCounters[NUM_PROFILING_COUNTERS];
+//What each counter read at the end of each frame. Only touched by whoever marks the frame.
+static int64_t g_profilingCounterHistory[NUM_PROFILING_COUNTERS][PROFILING_COUNTER_HISTORY_LENGTH];
+static unsigned int g_nextCounterHistoryIndex = 0;
+static unsigned int g_numSampledCounterFrames = 0;
+
+//-----------------------------------------------------------------------------------
+const char* GetProfilingCounterName(ProfilingCounter counter)
+{
+    return PROFILING_COUNTER_DESCRIPTIONS[counter].name;
+}
+
+//-----------------------------------------------------------------------------------
+ProfilingCounterType GetProfilingCounterType(ProfilingCounter counter)
+{
+    return PROFILING_COUNTER_DESCRIPTIONS[counter].type;
+}
+
+//-----------------------------------------------------------------------------------
+//Call once at the end of every frame. Per frame counters are swapped back to 0 so nothing added mid-sample is lost.
+void SampleProfilingCounters()
+{
+    for (int i = 0; i < NUM_PROFILING_COUNTERS; ++i)
+    {
+        std::atomic<int64_t>& value = g_profilingCounters[i].m_value;
+        g_profilingCounterHistory[i][g_nextCounterHistoryIndex] = (PROFILING_COUNTER_DESCRIPTIONS[i].type == PER_FRAME_COUNTER) ? value.exchange(0, std::memory_order_relaxed) : value.load(std::memory_order_relaxed);
+    }
+    g_nextCounterHistoryIndex = (g_nextCounterHistoryIndex + 1) % PROFILING_COUNTER_HISTORY_LENGTH;
+    if (g_numSampledCounterFrames < PROFILING_COUNTER_HISTORY_LENGTH)
+    {
+        ++g_numSampledCounterFrames;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//0 frames ago is the most recently sampled frame.
+int64_t GetProfilingCounterValue(ProfilingCounter counter, unsigned int framesAgo)
+{
+    if (framesAgo >= g_numSampledCounterFrames)
+    {
+        return 0;
+    }
+    unsigned int index = (g_nextCounterHistoryIndex + PROFILING_COUNTER_HISTORY_LENGTH - 1 - framesAgo) % PROFILING_COUNTER_HISTORY_LENGTH;
+    return g_profilingCounterHistory[counter][index];
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int GetNumSampledCounterFrames()
+{
+    return g_numSampledCounterFrames;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profilecounters)
+{
+    UNUSED(args);
+    Console::instance->PrintLine(Stringf("%-25s%14s%14s%14s%14s", "COUNTER", "LAST FRAME", "AVERAGE", "MIN", "MAX"), RGBA::VAPORWAVE);
+    for (int i = 0; i < NUM_PROFILING_COUNTERS; ++i)
+    {
+        ProfilingCounter counter = (ProfilingCounter)i;
+        int64_t total = 0;
+        int64_t minValue = GetProfilingCounterValue(counter);
+        int64_t maxValue = minValue;
+        for (unsigned int framesAgo = 0; framesAgo < g_numSampledCounterFrames; ++framesAgo)
+        {
+            int64_t value = GetProfilingCounterValue(counter, framesAgo);
+            total += value;
+            minValue = value < minValue ? value : minValue;
+            maxValue = value > maxValue ? value : maxValue;
+        }
+        double average = g_numSampledCounterFrames > 0 ? (double)total / (double)g_numSampledCounterFrames : 0.0;
+        Console::instance->PrintLine(Stringf("%-25s%14lld%14.01f%14lld%14lld", GetProfilingCounterName(counter), GetProfilingCounterValue(counter), average, minValue, maxValue));
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "Engine/Core/BuildConfig.hpp"
+#include <atomic>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------
+//Every counter the engine tracks per frame. Add new ones above NUM_PROFILING_COUNTERS and describe them in ProfilingCounters.cpp.
+enum ProfilingCounter
+{
+    COUNTER_JOBS_EXECUTED = 0,
+    COUNTER_PACKETS_SENT,
+    COUNTER_BYTES_SENT,
+    COUNTER_VERTICES_BUILT,
+    COUNTER_TEXTURE_BYTES_UPLOADED,
+    COUNTER_PARTICLES_ALIVE,
+    NUM_PROFILING_COUNTERS
+};
+
+//-----------------------------------------------------------------------------------
+enum ProfilingCounterType
+{
+    PER_FRAME_COUNTER = 0, //Summed over the frame, then starts back at 0
+    GAUGE, //Holds its value across frames, like a level
+    NUM_PROFILING_COUNTER_TYPES
+};
+
+//-----------------------------------------------------------------------------------
+//Each counter gets its own cache line so threads bumping different counters don't fight over it.
+struct alignas(64) ProfilingCounterSlot
+{
+    std::atomic<int64_t> m_value;
+};
+
+//CONSTANTS/////////////////////////////////////////////////////////////////////
+static const unsigned int PROFILING_COUNTER_HISTORY_LENGTH = 600;
+
+//GLOBAL VARIABLES/////////////////////////////////////////////////////////////////////
+extern ProfilingCounterSlot g_profilingCounters[NUM_PROFILING_COUNTERS];
+
+//FUNCTIONS/////////////////////////////////////////////////////////////////////
+//Safe from any thread. Relaxed, since nobody orders other memory around a counter.
+inline void AddToProfilingCounter(ProfilingCounter counter, int64_t amount) { g_profilingCounters[counter].m_value.fetch_add(amount, std::memory_order_relaxed); };
+inline void SetProfilingCounter(ProfilingCounter counter, int64_t value) { g_profilingCounters[counter].m_value.store(value, std::memory_order_relaxed); };
+const char* GetProfilingCounterName(ProfilingCounter counter);
+ProfilingCounterType GetProfilingCounterType(ProfilingCounter counter);
+void SampleProfilingCounters();
+int64_t GetProfilingCounterValue(ProfilingCounter counter, unsigned int framesAgo = 0);
+unsigned int GetNumSampledCounterFrames();
+
+//Compiled out entirely without the profiler, so they're fine to leave in hot paths.
+#ifdef PROFILING_ENABLED
+    #define PROFILE_COUNTER_ADD(COUNTER, AMOUNT) AddToProfilingCounter(COUNTER, (int64_t)(AMOUNT))
+    #define PROFILE_COUNTER_INCREMENT(COUNTER) AddToProfilingCounter(COUNTER, 1)
+    #define PROFILE_COUNTER_SET(COUNTER, VALUE) SetProfilingCounter(COUNTER, (int64_t)(VALUE))
+#else
+    #define PROFILE_COUNTER_ADD(COUNTER, AMOUNT) ((void)0)
+    #define PROFILE_COUNTER_INCREMENT(COUNTER) ((void)0)
+    #define PROFILE_COUNTER_SET(COUNTER, VALUE) ((void)0)
+#endif // PROFILING_ENABLED
@@ -0,0 +1,410 @@
+#include "Engine/Core/ProfilingHistory.hpp"
+#include "Engine/Core/ProfilingUtils.h"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Input/Console.hpp"
+#include <algorithm>
+#include <string.h>
+
+//Anything over 2x a 60fps frame counts as a hitch by default.
+static const float DEFAULT_HITCH_THRESHOLD_MS = 33.3f;
+static const unsigned int NUM_HISTOGRAM_BUCKETS = 12;
+static const float HISTOGRAM_BUCKET_WIDTH_MS = 4.0f;
+
+//-----------------------------------------------------------------------------------
+ProfilingHistory::ProfilingHistory(unsigned int numFramesToKeep)
+    : m_hitchThresholdMs(DEFAULT_HITCH_THRESHOLD_MS)
+    , m_numHitches(0)
+    , m_numFramesToKeep(0)
+    , m_numFramesRecorded(0)
+    , m_nextFrameIndex(0)
+    , m_frameCount(0)
+{
+    SetNumFramesToKeep(numFramesToKeep);
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingHistory::SetNumFramesToKeep(unsigned int numFramesToKeep)
+{
+    ASSERT_OR_DIE(numFramesToKeep > 0, "Profiling history needs to keep at least one frame.");
+    m_numFramesToKeep = numFramesToKeep;
+    Clear();
+}
+
+//-----------------------------------------------------------------------------------
+//Throws away every recorded frame and hitch. Capacity is kept so the next frames don't reallocate.
+void ProfilingHistory::Clear()
+{
+    m_frameTimesMs.assign(m_numFramesToKeep, 0.0f);
+    m_sections.clear();
+    m_sectionIndices.clear();
+    m_sectionsThisFrame.clear();
+    for (unsigned int i = 0; i < MAX_HITCH_CAPTURES; ++i)
+    {
+        m_hitches[i].m_samples.clear();
+    }
+    m_numHitches = 0;
+    m_numFramesRecorded = 0;
+    m_nextFrameIndex = 0;
+    m_frameCount = 0;
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingHistory::RecordFrame(ProfileSample* frameRoot, int frameNumber)
+{
+    if (!frameRoot)
+    {
+        return;
+    }
+
+    float frameTimeMs = (float)frameRoot->GetDurationInSeconds() * 1000.0f;
+    m_frameTimesMs[m_nextFrameIndex] = frameTimeMs;
+    m_nextFrameIndex = (m_nextFrameIndex + 1) % m_numFramesToKeep;
+    m_numFramesRecorded = std::min(m_numFramesRecorded + 1, m_numFramesToKeep);
+    ++m_frameCount;
+
+    //Sections that show up more than once in a frame are summed, so each ring holds one entry per frame the section ran in.
+    AccumulateSections(frameRoot);
+    for (unsigned int sectionIndex : m_sectionsThisFrame)
+    {
+        ProfileSectionHistory& section = m_sections[sectionIndex];
+        section.m_durationsMs[section.m_nextIndex] = section.m_currentFrameMs;
+        section.m_nextIndex = (section.m_nextIndex + 1) % m_numFramesToKeep;
+        section.m_numRecorded = std::min(section.m_numRecorded + 1, m_numFramesToKeep);
+        section.m_currentFrameMs = 0.0f;
+        section.m_ranThisFrame = false;
+    }
+    m_sectionsThisFrame.clear();
+
+    if (m_hitchThresholdMs > 0.0f && frameTimeMs > m_hitchThresholdMs)
+    {
+        CaptureHitch(frameRoot, frameNumber, frameTimeMs);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingHistory::AccumulateSections(ProfileSample* root)
+{
+    unsigned int sectionIndex = FindOrAddSection(root->id);
+    ProfileSectionHistory& section = m_sections[sectionIndex];
+    if (!section.m_ranThisFrame)
+    {
+        section.m_ranThisFrame = true;
+        section.m_lastSeenFrame = m_frameCount;
+        m_sectionsThisFrame.push_back(sectionIndex);
+    }
+    section.m_currentFrameMs += (float)root->GetDurationInSeconds() * 1000.0f;
+
+    ProfileSample* currentChild = root->children;
+    while (currentChild != nullptr)
+    {
+        AccumulateSections(currentChild);
+        currentChild = currentChild->next;
+        if (currentChild == root->children)
+        {
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//-1 if we've never seen this id. Two ids can share a hash, so the name has to match too.
+int ProfilingHistory::FindSection(const char* id, size_t idHash) const
+{
+    auto matchingHashes = m_sectionIndices.equal_range(idHash);
+    for (auto found = matchingHashes.first; found != matchingHashes.second; ++found)
+    {
+        if (strcmp(m_sections[found->second].GetId(), id) == 0)
+        {
+            return (int)found->second;
+        }
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int ProfilingHistory::FindOrAddSection(const char* id)
+{
+    size_t idHash = HashSampleId(id);
+    int foundIndex = FindSection(id, idHash);
+    if (foundIndex >= 0)
+    {
+        return (unsigned int)foundIndex;
+    }
+
+    int evictedIndex = m_sections.size() >= MAX_SECTIONS ? FindSectionToEvict() : -1;
+    unsigned int sectionIndex = evictedIndex >= 0 ? (unsigned int)evictedIndex : (unsigned int)m_sections.size();
+    if (evictedIndex >= 0)
+    {
+        auto matchingHashes = m_sectionIndices.equal_range(m_sections[sectionIndex].m_idHash);
+        for (auto found = matchingHashes.first; found != matchingHashes.second; ++found)
+        {
+            if (found->second == sectionIndex)
+            {
+                m_sectionIndices.erase(found);
+                break;
+            }
+        }
+    }
+    else
+    {
+        m_sections.emplace_back();
+    }
+    m_sectionIndices.insert(std::pair<const size_t, unsigned int>(idHash, sectionIndex));
+
+    //An evicted section's buffers are reused as they are, they're already the right size.
+    ProfileSectionHistory& section = m_sections[sectionIndex];
+    section.m_id.assign(id, id + strlen(id) + 1);
+    section.m_idHash = idHash;
+    section.m_durationsMs.assign(m_numFramesToKeep, 0.0f);
+    section.m_nextIndex = 0;
+    section.m_numRecorded = 0;
+    section.m_lastSeenFrame = m_frameCount;
+    section.m_lastHitchNumber = 0;
+    section.m_currentFrameMs = 0.0f;
+    section.m_ranThisFrame = false;
+    section.m_isInAHitch = false;
+    return sectionIndex;
+}
+
+//-----------------------------------------------------------------------------------
+//-1 if every section is either in the current frame or one of the kept hitches.
+int ProfilingHistory::FindSectionToEvict() const
+{
+    int oldestIndex = -1;
+    for (unsigned int i = 0; i < m_sections.size(); ++i)
+    {
+        const ProfileSectionHistory& section = m_sections[i];
+        bool isInKeptHitch = section.m_isInAHitch && m_numHitches - section.m_lastHitchNumber < MAX_HITCH_CAPTURES;
+        if (section.m_ranThisFrame || isInKeptHitch)
+        {
+            continue;
+        }
+        if (oldestIndex < 0 || section.m_lastSeenFrame < m_sections[oldestIndex].m_lastSeenFrame)
+        {
+            oldestIndex = (int)i;
+        }
+    }
+    return oldestIndex;
+}
+
+//-----------------------------------------------------------------------------------
+//The sample pool gets recycled next frame, so copy the whole tree out depth first.
+void ProfilingHistory::CaptureHitch(ProfileSample* frameRoot, int frameNumber, float frameTimeMs)
+{
+    ++m_numHitches;
+    HitchCapture& capture = m_hitches[(m_numHitches - 1) % MAX_HITCH_CAPTURES];
+    capture.m_frameNumber = frameNumber;
+    capture.m_frameTimeMs = frameTimeMs;
+    capture.m_samples.clear();
+    CaptureHitchSample(capture, frameRoot, 0);
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingHistory::CaptureHitchSample(HitchCapture& capture, ProfileSample* sample, unsigned int depth)
+{
+    HitchSample hitchSample;
+    hitchSample.m_sectionIndex = FindOrAddSection(sample->id);
+    m_sections[hitchSample.m_sectionIndex].m_isInAHitch = true;
+    m_sections[hitchSample.m_sectionIndex].m_lastHitchNumber = m_numHitches;
+    hitchSample.m_depth = depth;
+    hitchSample.m_durationMs = (float)sample->GetDurationInSeconds() * 1000.0f;
+    hitchSample.m_numDrawCalls = sample->numDrawCalls;
+    hitchSample.m_numAllocs = sample->numAllocs;
+    capture.m_samples.push_back(hitchSample);
+
+    ProfileSample* currentChild = sample->children;
+    while (currentChild != nullptr)
+    {
+        CaptureHitchSample(capture, currentChild, depth + 1);
+        currentChild = currentChild->next;
+        if (currentChild == sample->children)
+        {
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+ProfilePercentiles ProfilingHistory::CalculatePercentiles(float* values, unsigned int numValues)
+{
+    ProfilePercentiles percentiles;
+    percentiles.numSamples = numValues;
+    if (numValues == 0)
+    {
+        return percentiles;
+    }
+
+    //Nearest rank: the p-th percentile is the smallest value that at least p percent of the values are less than or equal to.
+    std::sort(values, values + numValues);
+    auto nearestRank = [&](unsigned int percent) -> float
+    {
+        unsigned int rank = (percent * numValues + 99) / 100;
+        return values[std::max(rank, 1U) - 1];
+    };
+    percentiles.p50 = nearestRank(50);
+    percentiles.p90 = nearestRank(90);
+    percentiles.p99 = nearestRank(99);
+    percentiles.maximum = values[numValues - 1];
+    return percentiles;
+}
+
+//-----------------------------------------------------------------------------------
+ProfilePercentiles ProfilingHistory::GetFramePercentiles() const
+{
+    //Unused slots are at the end of the ring until it wraps, and order doesn't matter once we sort.
+    std::vector<float, UntrackedAllocator<float>> sortedTimes(m_frameTimesMs.begin(), m_frameTimesMs.begin() + m_numFramesRecorded);
+    return CalculatePercentiles(sortedTimes.data(), m_numFramesRecorded);
+}
+
+//-----------------------------------------------------------------------------------
+bool ProfilingHistory::GetSectionPercentiles(const char* id, ProfilePercentiles& outPercentiles) const
+{
+    int sectionIndex = FindSection(id, HashSampleId(id));
+    if (sectionIndex < 0)
+    {
+        return false;
+    }
+    outPercentiles = GetSectionPercentiles((unsigned int)sectionIndex);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+ProfilePercentiles ProfilingHistory::GetSectionPercentiles(unsigned int sectionIndex) const
+{
+    const ProfileSectionHistory& section = m_sections[sectionIndex];
+    std::vector<float, UntrackedAllocator<float>> sortedTimes(section.m_durationsMs.begin(), section.m_durationsMs.begin() + section.m_numRecorded);
+    return CalculatePercentiles(sortedTimes.data(), section.m_numRecorded);
+}
+
+//-----------------------------------------------------------------------------------
+const char* ProfilingHistory::GetSectionName(unsigned int sectionIndex) const
+{
+    return m_sections[sectionIndex].GetId();
+}
+
+//-----------------------------------------------------------------------------------
+const HitchCapture& ProfilingHistory::GetRecentHitch(unsigned int hitchesAgo) const
+{
+    ASSERT_OR_DIE(hitchesAgo < m_numHitches && hitchesAgo < MAX_HITCH_CAPTURES, "Asked for a hitch that isn't kept.");
+    return m_hitches[(m_numHitches - 1 - hitchesAgo) % MAX_HITCH_CAPTURES];
+}
+
+//-----------------------------------------------------------------------------------
+//The last bucket also collects everything past the end of the range.
+void ProfilingHistory::BuildFrameHistogram(unsigned int* outBucketCounts, unsigned int numBuckets, float bucketWidthMs) const
+{
+    memset(outBucketCounts, 0, sizeof(unsigned int) * numBuckets);
+    for (unsigned int i = 0; i < m_numFramesRecorded; ++i)
+    {
+        unsigned int bucket = (unsigned int)(m_frameTimesMs[i] / bucketWidthMs);
+        ++outBucketCounts[std::min(bucket, numBuckets - 1)];
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingHistory::PrintSummary(unsigned int maxSectionsToShow) const
+{
+    ProfilePercentiles framePercentiles = GetFramePercentiles();
+    Console::instance->PrintLine(Stringf("Last %u frames: p50 %.02fms, p90 %.02fms, p99 %.02fms, max %.02fms", framePercentiles.numSamples, framePercentiles.p50, framePercentiles.p90, framePercentiles.p99, framePercentiles.maximum), RGBA::VAPORWAVE);
+
+    unsigned int bucketCounts[NUM_HISTOGRAM_BUCKETS];
+    BuildFrameHistogram(bucketCounts, NUM_HISTOGRAM_BUCKETS, HISTOGRAM_BUCKET_WIDTH_MS);
+    for (unsigned int i = 0; i < NUM_HISTOGRAM_BUCKETS; ++i)
+    {
+        unsigned int barLength = m_numFramesRecorded > 0 ? (bucketCounts[i] * 50) / m_numFramesRecorded : 0;
+        std::string bucketName = (i == NUM_HISTOGRAM_BUCKETS - 1) ? Stringf("%3.0fms+", i * HISTOGRAM_BUCKET_WIDTH_MS) : Stringf("%3.0f-%3.0fms", i * HISTOGRAM_BUCKET_WIDTH_MS, (i + 1) * HISTOGRAM_BUCKET_WIDTH_MS);
+        Console::instance->PrintLine(Stringf("%-12s%6u %s", bucketName.c_str(), bucketCounts[i], std::string(barLength, '#').c_str()));
+    }
+
+    //Worst offenders first.
+    std::vector<std::pair<float, unsigned int>, UntrackedAllocator<std::pair<float, unsigned int>>> sectionsByP99;
+    std::vector<ProfilePercentiles, UntrackedAllocator<ProfilePercentiles>> sectionPercentiles;
+    for (unsigned int i = 0; i < m_sections.size(); ++i)
+    {
+        ProfilePercentiles percentiles = GetSectionPercentiles(i);
+        sectionPercentiles.push_back(percentiles);
+        sectionsByP99.push_back(std::pair<float, unsigned int>(percentiles.p99, i));
+    }
+    std::sort(sectionsByP99.begin(), sectionsByP99.end(), [](const std::pair<float, unsigned int>& first, const std::pair<float, unsigned int>& second) { return first.first > second.first; });
+
+    Console::instance->PrintLine(Stringf("%-30s%10s%12s%12s%12s%12s", "TAG", "FRAMES", "P50", "P90", "P99", "MAX"), RGBA::VAPORWAVE);
+    for (unsigned int i = 0; i < sectionsByP99.size() && i < maxSectionsToShow; ++i)
+    {
+        const ProfilePercentiles& percentiles = sectionPercentiles[sectionsByP99[i].second];
+        Console::instance->PrintLine(Stringf("%-30s%10u%10.03fms%10.03fms%10.03fms%10.03fms", m_sections[sectionsByP99[i].second].GetId(), percentiles.numSamples, percentiles.p50, percentiles.p90, percentiles.p99, percentiles.maximum));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingHistory::PrintHitches() const
+{
+    if (m_numHitches == 0)
+    {
+        Console::instance->PrintLine(Stringf("No frames over %.02fms yet.", m_hitchThresholdMs), RGBA::GBLIGHTGREEN);
+        return;
+    }
+
+    //Oldest first, so the most recent hitch ends up at the bottom of the console.
+    unsigned int numCaptures = m_numHitches < MAX_HITCH_CAPTURES ? m_numHitches : MAX_HITCH_CAPTURES;
+    for (unsigned int i = m_numHitches - numCaptures; i < m_numHitches; ++i)
+    {
+        const HitchCapture& capture = m_hitches[i % MAX_HITCH_CAPTURES];
+        Console::instance->PrintLine(Stringf("---Frame %i took %.02fms---", capture.m_frameNumber, capture.m_frameTimeMs), RGBA::RED);
+        for (const HitchSample& sample : capture.m_samples)
+        {
+            std::string tag = Stringf("%s%s", std::string(sample.m_depth, '-').c_str(), GetSectionName(sample.m_sectionIndex));
+            Console::instance->PrintLine(Stringf("%-30s%12zu%12zu%10.02fms%10.02f%%", tag.c_str(), sample.m_numDrawCalls, sample.m_numAllocs, sample.m_durationMs, (sample.m_durationMs / capture.m_frameTimeMs) * 100.0f));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profilehistory)
+{
+    if (!ProfilingSystem::IsProfilingEnabled())
+    {
+        Console::instance->PrintLine("Profiling is disabled.", RGBA::RED);
+        return;
+    }
+    unsigned int maxSectionsToShow = args.HasArgs(1) ? (unsigned int)args.GetIntArgument(0) : 20;
+    ProfilingSystem::instance->m_frameHistory.PrintSummary(maxSectionsToShow);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profilehitches)
+{
+    UNUSED(args);
+    if (!ProfilingSystem::IsProfilingEnabled())
+    {
+        Console::instance->PrintLine("Profiling is disabled.", RGBA::RED);
+        return;
+    }
+    ProfilingSystem::instance->m_frameHistory.PrintHitches();
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profilehitchthreshold)
+{
+    if (!args.HasArgs(1) || !ProfilingSystem::instance)
+    {
+        Console::instance->PrintLine("profilehitchthreshold <milliseconds> (0 disables hitch captures)", RGBA::RED);
+        return;
+    }
+    float thresholdMs = args.GetFloatArgument(0);
+    ProfilingSystem::instance->m_frameHistory.m_hitchThresholdMs = thresholdMs;
+    Console::instance->PrintLine(Stringf("Capturing any frame over %.02fms.", thresholdMs), RGBA::GBLIGHTGREEN);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profilehistorysize)
+{
+    if (!args.HasArgs(1) || args.GetIntArgument(0) <= 0 || !ProfilingSystem::instance)
+    {
+        Console::instance->PrintLine("profilehistorysize <number of frames>", RGBA::RED);
+        return;
+    }
+    unsigned int numFrames = (unsigned int)args.GetIntArgument(0);
+    ProfilingSystem::instance->m_frameHistory.SetNumFramesToKeep(numFrames);
+    Console::instance->PrintLine(Stringf("Keeping the last %u frames. History cleared.", numFrames), RGBA::GBLIGHTGREEN);
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
+#include <map>
+#include <vector>
+
+struct ProfileSample;
+
+//-----------------------------------------------------------------------------------
+struct ProfilePercentiles
+{
+    ProfilePercentiles() : p50(0.0f), p90(0.0f), p99(0.0f), maximum(0.0f), numSamples(0) {};
+
+    float p50;
+    float p90;
+    float p99;
+    float maximum;
+    unsigned int numSamples;
+};
+
+//-----------------------------------------------------------------------------------
+//Rolling window of how long a named section took, summed per frame. Only frames the section actually ran in are recorded.
+struct ProfileSectionHistory
+{
+    inline const char* GetId() const { return m_id.data(); };
+
+    std::vector<char, UntrackedAllocator<char>> m_id; //Copied, since ids can point at data (like sprite layer names) that's gone by the next frame
+    size_t m_idHash;
+    std::vector<float, UntrackedAllocator<float>> m_durationsMs;
+    unsigned int m_nextIndex;
+    unsigned int m_numRecorded;
+    unsigned int m_lastSeenFrame; //Which recorded frame this section last ran in, the least recently seen section is the first to be evicted
+    unsigned int m_lastHitchNumber; //Count of hitches as of the last one this was in. A section can't be evicted while a kept hitch still points at it
+    float m_currentFrameMs;
+    bool m_ranThisFrame;
+    bool m_isInAHitch;
+};
+
+//-----------------------------------------------------------------------------------
+//Flattened copy of one sample from a hitch frame, since the real tree gets recycled next frame.
+struct HitchSample
+{
+    unsigned int m_sectionIndex; //The section owns the copy of the name
+    unsigned int m_depth;
+    float m_durationMs;
+    size_t m_numDrawCalls;
+    size_t m_numAllocs;
+};
+
+//-----------------------------------------------------------------------------------
+struct HitchCapture
+{
+    int m_frameNumber;
+    float m_frameTimeMs;
+    std::vector<HitchSample, UntrackedAllocator<HitchSample>> m_samples;
+};
+
+//-----------------------------------------------------------------------------------
+//Keeps the last N frames around so intermittent hitches don't get lost behind the most recent frame.
+class ProfilingHistory
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    ProfilingHistory(unsigned int numFramesToKeep = 600);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void RecordFrame(ProfileSample* frameRoot, int frameNumber);
+    void SetNumFramesToKeep(unsigned int numFramesToKeep);
+    void Clear();
+    ProfilePercentiles GetFramePercentiles() const;
+    bool GetSectionPercentiles(const char* id, ProfilePercentiles& outPercentiles) const;
+    void BuildFrameHistogram(unsigned int* outBucketCounts, unsigned int numBuckets, float bucketWidthMs) const;
+    void PrintSummary(unsigned int maxSectionsToShow) const;
+    void PrintHitches() const;
+    const char* GetSectionName(unsigned int sectionIndex) const;
+    inline unsigned int GetNumHitches() const { return m_numHitches; };
+    //0 is the most recent hitch. Only the last MAX_HITCH_CAPTURES are kept.
+    const HitchCapture& GetRecentHitch(unsigned int hitchesAgo) const;
+    inline unsigned int GetNumFramesToKeep() const { return m_numFramesToKeep; };
+    inline unsigned int GetNumFramesRecorded() const { return m_numFramesRecorded; };
+    inline unsigned int GetNumSections() const { return (unsigned int)m_sections.size(); };
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    //Nearest rank percentiles. Reorders values.
+    static ProfilePercentiles CalculatePercentiles(float* values, unsigned int numValues);
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int MAX_HITCH_CAPTURES = 8;
+    //Past this, a new id takes over the ring of the least recently seen section, so ids built at runtime can't grow memory forever.
+    //Sections in the current frame or a kept hitch are never evicted, so a frame with more ids than this still gets them all.
+    static const unsigned int MAX_SECTIONS = 1024;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    float m_hitchThresholdMs;
+
+private:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void AccumulateSections(ProfileSample* root);
+    void CaptureHitch(ProfileSample* frameRoot, int frameNumber, float frameTimeMs);
+    void CaptureHitchSample(HitchCapture& capture, ProfileSample* sample, unsigned int depth);
+    int FindSection(const char* id, size_t idHash) const;
+    unsigned int FindOrAddSection(const char* id);
+    int FindSectionToEvict() const;
+    ProfilePercentiles GetSectionPercentiles(unsigned int sectionIndex) const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<float, UntrackedAllocator<float>> m_frameTimesMs;
+    std::vector<ProfileSectionHistory, UntrackedAllocator<ProfileSectionHistory>> m_sections;
+    std::multimap<size_t, unsigned int, std::less<size_t>, UntrackedAllocator<std::pair<const size_t, unsigned int>>> m_sectionIndices; //By hash of the id. Names that collide each get their own entry.
+    std::vector<unsigned int, UntrackedAllocator<unsigned int>> m_sectionsThisFrame;
+    HitchCapture m_hitches[MAX_HITCH_CAPTURES];
+    unsigned int m_numHitches;
+    unsigned int m_numFramesToKeep;
+    unsigned int m_numFramesRecorded;
+    unsigned int m_nextFrameIndex;
+    unsigned int m_frameCount; //Every frame since the last clear, unlike m_numFramesRecorded which stops at m_numFramesToKeep
+};
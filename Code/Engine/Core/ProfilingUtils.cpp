@@ -1,47 +1,439 @@
 #include "Engine/Core/ProfilingUtils.h"
-#include "Engine/Input/Logging.hpp"
+#include "Engine/Input/LogChannels.hpp"
 #include "Engine/DataStructures/InPlaceLinkedList.hpp"
 #include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/ProfilingCounters.hpp"
 #include "Engine/Input/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #include <algorithm>
 using namespace std::chrono;
 
 std::vector<ProfileReportNode, UntrackedAllocator<ProfileReportNode>> g_profilingResults;
+std::vector<ProfileFlowAttribution, UntrackedAllocator<ProfileFlowAttribution>> g_profilingFlowAttribution;
+//Open addressed lookup from a sample id to its index in g_profilingResults, -1 for an empty slot. Only valid while building a report.
+static std::vector<int, UntrackedAllocator<int>> g_profilingResultsTable;
 ProfilingSystem* ProfilingSystem::instance = nullptr;
 extern int g_frameNumber;
 
+//-----------------------------------------------------------------------------------
+size_t HashSampleId(const char* id)
+{
+    //FNV-1a. The same name can live at different addresses in different translation units, so we hash the contents instead of the pointer.
+    size_t hash = 2166136261U;
+    for (const char* character = id; *character; ++character)
+    {
+        hash = (hash ^ (unsigned char)*character) * 16777619U;
+    }
+    return hash;
+}
+
+//-----------------------------------------------------------------------------------
+void FormatAllocationsByTag(const size_t* sizeAllocsByTag, char* outBuffer, size_t bufferSize)
+{
+    size_t length = 0;
+    outBuffer[0] = '\0';
+    for (int i = 0; i < NUM_MEMORY_TAGS && length < bufferSize; ++i)
+    {
+        if (sizeAllocsByTag[i] != 0)
+        {
+            length += FormatTo(outBuffer + length, bufferSize - length, "%s%s:%u", length == 0 ? "" : " ", GetMemoryTagName((MemoryTag)i), sizeAllocsByTag[i]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//How many bytes the UTF-8 sequence starting with this byte should be. Stray continuation bytes count as 1 so they still get copied through.
+static size_t GetUTF8SequenceLength(unsigned char leadByte)
+{
+    if (leadByte >= 0xF0)
+    {
+        return 4;
+    }
+    if (leadByte >= 0xE0)
+    {
+        return 3;
+    }
+    if (leadByte >= 0xC0)
+    {
+        return 2;
+    }
+    return 1;
+}
+
+//-----------------------------------------------------------------------------------
+//Sample ids are usually literals, but layer and thread names come from data, so escape anything that would break a JSON string.
+//UTF-8 passes straight through, and truncation never splits a multibyte character.
+void EscapeTraceString(const char* source, char* outEscaped, size_t bufferSize)
+{
+    size_t length = 0;
+    const unsigned char* character = (const unsigned char*)source;
+    while (character && *character)
+    {
+        if (*character == '"' || *character == '\\')
+        {
+            if (length + 2 >= bufferSize)
+            {
+                break;
+            }
+            outEscaped[length++] = '\\';
+            outEscaped[length++] = (char)*character++;
+        }
+        else if (*character < ' ')
+        {
+            if (length + 6 >= bufferSize)
+            {
+                break;
+            }
+            length += FormatTo(outEscaped + length, bufferSize - length, "\\u%04x", *character++);
+        }
+        else
+        {
+            size_t sequenceLength = GetUTF8SequenceLength(*character);
+            if (length + sequenceLength >= bufferSize)
+            {
+                break;
+            }
+            outEscaped[length++] = (char)*character++;
+            //Only copies the continuation bytes that are actually there, so a malformed name can't walk us off the end.
+            for (size_t i = 1; i < sequenceLength && (*character & 0xC0) == 0x80; ++i)
+            {
+                outEscaped[length++] = (char)*character++;
+            }
+        }
+    }
+    outEscaped[length] = '\0';
+}
+
+//-----------------------------------------------------------------------------------
+struct ProfileFlowSource
+{
+    size_t m_nameHash;
+    char m_name[MAX_PROFILE_FLOW_SOURCE_NAME_LENGTH];
+};
+
+//Append only. Readers only look at entries below the published count, so the common case of finding a source we've already seen never takes the lock.
+static ProfileFlowSource g_profileFlowSources[MAX_PROFILE_FLOW_SOURCES] = { { 0, "Unknown" } };
+static std::atomic<unsigned int> g_numProfileFlowSources(1);
+static SRWLOCK g_profileFlowSourcesLock = SRWLOCK_INIT;
+
+//-----------------------------------------------------------------------------------
+static int FindProfileFlowSource(const char* sourceName, size_t nameLength, size_t nameHash, unsigned int numSources)
+{
+    for (unsigned int i = 1; i < numSources; ++i)
+    {
+        const ProfileFlowSource& source = g_profileFlowSources[i];
+        if (source.m_nameHash == nameHash && strncmp(source.m_name, sourceName, nameLength) == 0 && source.m_name[nameLength] == '\0')
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------------
+//Long names are truncated, and hashed after truncating so they still find their own entry.
+unsigned int FindOrAddProfileFlowSource(const char* sourceName)
+{
+    size_t nameLength = 0;
+    size_t nameHash = 2166136261U;
+    for (; sourceName[nameLength] != '\0' && nameLength < MAX_PROFILE_FLOW_SOURCE_NAME_LENGTH - 1; ++nameLength)
+    {
+        nameHash = (nameHash ^ (unsigned char)sourceName[nameLength]) * 16777619U;
+    }
+    int sourceIndex = FindProfileFlowSource(sourceName, nameLength, nameHash, g_numProfileFlowSources.load(std::memory_order_acquire));
+    if (sourceIndex >= 0)
+    {
+        return (unsigned int)sourceIndex;
+    }
+
+    AcquireSRWLockExclusive(&g_profileFlowSourcesLock);
+    unsigned int numSources = g_numProfileFlowSources.load(std::memory_order_relaxed);
+    sourceIndex = FindProfileFlowSource(sourceName, nameLength, nameHash, numSources);
+    if (sourceIndex < 0 && numSources < MAX_PROFILE_FLOW_SOURCES)
+    {
+        ProfileFlowSource& newSource = g_profileFlowSources[numSources];
+        newSource.m_nameHash = nameHash;
+        memcpy(newSource.m_name, sourceName, nameLength);
+        newSource.m_name[nameLength] = '\0';
+        g_numProfileFlowSources.store(numSources + 1, std::memory_order_release);
+        sourceIndex = (int)numSources;
+    }
+    ReleaseSRWLockExclusive(&g_profileFlowSourcesLock);
+    return sourceIndex >= 0 ? (unsigned int)sourceIndex : 0;
+}
+
+//-----------------------------------------------------------------------------------
+const char* GetProfileFlowSourceName(unsigned int sourceIndex)
+{
+    return sourceIndex < g_numProfileFlowSources.load(std::memory_order_acquire) ? g_profileFlowSources[sourceIndex].m_name : g_profileFlowSources[0].m_name;
+}
+
 #ifdef PROFILING_ENABLED
 
+//Main thread gets a much bigger pool since it holds the entire frame tree.
+static const size_t MAIN_THREAD_SAMPLE_POOL_SIZE = 2048 * 8;
+static const size_t WORKER_THREAD_SAMPLE_POOL_SIZE = 2048;
+
+//-----------------------------------------------------------------------------------
+//Gives the thread's context back when the thread exits, so short lived threads don't leak a sample pool apiece.
+struct ProfilingThreadContextHolder
+{
+    ProfilingThreadContextHolder() : m_context(nullptr), m_generation(0) {};
+    ~ProfilingThreadContextHolder() { Release(); };
+
+    //-----------------------------------------------------------------------------------
+    void Release()
+    {
+        if (m_context && m_context->m_state.exchange(THREAD_CONTEXT_RETIRED) == THREAD_CONTEXT_ORPHANED)
+        {
+            delete m_context;
+        }
+        m_context = nullptr;
+        m_generation = 0;
+    }
+
+    ProfilingThreadContext* m_context;
+    unsigned int m_generation;
+};
+
+static thread_local ProfilingThreadContextHolder t_profilingThreadContext;
+//Every profiler gets a new one, so a thread can tell its context came from a profiler that's been destroyed. 0 is never used.
+static std::atomic<unsigned int> g_nextProfilingSystemGeneration(1);
+//Shared by every thread that hands work off. 0 is reserved for "no flow".
+static std::atomic<unsigned int> g_nextProfileFlowId(1);
+
+//-----------------------------------------------------------------------------------
+ProfilingThreadContext::ProfilingThreadContext(const char* threadName, size_t poolSize)
+    : m_sampleAllocator(poolSize)
+    , m_activeSample(nullptr)
+    , m_committedSamples(nullptr)
+    , m_samplesToRecycle(nullptr)
+    , m_previousFrameSamples(nullptr)
+    , m_nextContext(nullptr)
+    , m_threadName(threadName)
+    , m_tracedThreadName(nullptr)
+    , m_state(THREAD_CONTEXT_LIVE)
+    , m_threadId(GetCurrentThreadId())
+    , m_droppedSampleDepth(0)
+{
+}
+
+//-----------------------------------------------------------------------------------
+ProfileSample* ProfilingThreadContext::AllocSample()
+{
+    //ObjectPool doesn't check for us, and we'd rather lose a few samples than crash.
+    if (m_sampleAllocator.m_freeList == nullptr)
+    {
+        return nullptr;
+    }
+    return m_sampleAllocator.Alloc<ProfileSample>();
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingThreadContext::FreeSampleTree(ProfileSample* root)
+{
+    if (root == nullptr)
+    {
+        return;
+    }
+    while (root->children != nullptr)
+    {
+        ProfileSample* child = root->children;
+        RemoveInPlace(root->children, child);
+        FreeSampleTree(child);
+    }
+    m_sampleAllocator.Free(root);
+}
+
+//-----------------------------------------------------------------------------------
+//Owner thread only. Cheap enough to call on every top level push.
+void ProfilingThreadContext::FreeRecycledSamples()
+{
+    ProfileSample* root = m_samplesToRecycle.exchange(nullptr, std::memory_order_acquire);
+    while (root)
+    {
+        ProfileSample* nextRoot = root->next;
+        FreeSampleTree(root);
+        root = nextRoot;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Owner thread only. Publishes a finished top level sample for the main thread to pick up.
+void ProfilingThreadContext::CommitSample(ProfileSample* root)
+{
+    ProfileSample* head = m_committedSamples.load(std::memory_order_relaxed);
+    do
+    {
+        root->next = head;
+    } while (!m_committedSamples.compare_exchange_weak(head, root, std::memory_order_release, std::memory_order_relaxed));
+}
+
+//-----------------------------------------------------------------------------------
+//Main thread only. Returns everything committed since the last call, oldest first.
+ProfileSample* ProfilingThreadContext::TakeCommittedSamples()
+{
+    ProfileSample* newestFirst = m_committedSamples.exchange(nullptr, std::memory_order_acquire);
+    ProfileSample* oldestFirst = nullptr;
+    while (newestFirst)
+    {
+        ProfileSample* nextRoot = newestFirst->next;
+        newestFirst->next = oldestFirst;
+        oldestFirst = newestFirst;
+        newestFirst = nextRoot;
+    }
+    return oldestFirst;
+}
+
+//-----------------------------------------------------------------------------------
+//Main thread only. Hands a list of roots linked through next back to the owner to free.
+void ProfilingThreadContext::RecycleSamples(ProfileSample* firstRoot)
+{
+    if (firstRoot == nullptr)
+    {
+        return;
+    }
+    ProfileSample* lastRoot = firstRoot;
+    while (lastRoot->next)
+    {
+        lastRoot = lastRoot->next;
+    }
+    ProfileSample* head = m_samplesToRecycle.load(std::memory_order_relaxed);
+    do
+    {
+        lastRoot->next = head;
+    } while (!m_samplesToRecycle.compare_exchange_weak(head, firstRoot, std::memory_order_release, std::memory_order_relaxed));
+}
+
 //-----------------------------------------------------------------------------------
 ProfilingSystem::ProfilingSystem()
     : m_isEnabled(true)
     , m_intentToEnable(true)
     , m_currentFrameRoot(nullptr)
     , m_previousFrameRoot(nullptr)
-    , m_activeSample(nullptr)
-    , m_sampleAllocator(2048 * 8)
+    , m_mainThreadContext(nullptr)
+    , m_threadContexts(nullptr)
+    , m_traceFile(nullptr)
+    , m_traceFramesRemaining(0)
+    , m_hasWrittenTraceEvent(false)
+    , m_generation(g_nextProfilingSystemGeneration.fetch_add(1))
 {
+    memset(m_previousFrameMemoryTagBytes, 0, sizeof(m_previousFrameMemoryTagBytes));
+    RegisterCurrentThread("Main");
+    m_mainThreadContext = GetCurrentThreadContext();
 }
 
 //-----------------------------------------------------------------------------------
 ProfilingSystem::~ProfilingSystem()
 {
-    if (DeleteSampleTree(m_previousFrameRoot))
+    StopTraceCapture();
+
+    //The pools own every sample, so deleting the contexts takes all of the trees with them.
+    //Threads that are still running own theirs from here on, and delete them when they exit.
+    ProfilingThreadContext* context = m_threadContexts.exchange(nullptr);
+    while (context)
     {
-        m_sampleAllocator.Free(m_previousFrameRoot);
+        ProfilingThreadContext* nextContext = context->m_nextContext;
+        if (context == t_profilingThreadContext.m_context)
+        {
+            t_profilingThreadContext.m_context = nullptr;
+            t_profilingThreadContext.m_generation = 0;
+            delete context;
+        }
+        else if (context->m_state.exchange(THREAD_CONTEXT_ORPHANED) == THREAD_CONTEXT_RETIRED)
+        {
+            delete context;
+        }
+        context = nextContext;
     }
-    if (DeleteSampleTree(m_currentFrameRoot))
+    g_profilingResults.clear();
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingSystem::RegisterCurrentThread(const char* threadName)
+{
+    ProfilingThreadContext* existingContext = GetCurrentThreadContext();
+    if (existingContext)
     {
-        m_sampleAllocator.Free(m_currentFrameRoot);
+        existingContext->m_threadName.store(threadName, std::memory_order_relaxed);
+        return;
+    }
+    //Anything left over is from a profiler that's already gone.
+    t_profilingThreadContext.Release();
+
+    MemoryTagScope profilingScope(MEMTAG_PROFILING);
+    size_t poolSize = m_mainThreadContext ? WORKER_THREAD_SAMPLE_POOL_SIZE : MAIN_THREAD_SAMPLE_POOL_SIZE;
+    ProfilingThreadContext* context = new ProfilingThreadContext(threadName, poolSize);
+
+    //Contexts are only ever added, so a lock free push is all we need.
+    ProfilingThreadContext* head = m_threadContexts.load(std::memory_order_relaxed);
+    do
+    {
+        context->m_nextContext = head;
+    } while (!m_threadContexts.compare_exchange_weak(head, context, std::memory_order_release, std::memory_order_relaxed));
+    t_profilingThreadContext.m_context = context;
+    t_profilingThreadContext.m_generation = m_generation;
+}
+
+//-----------------------------------------------------------------------------------
+//nullptr if this thread hasn't pushed anything to this profiler yet.
+ProfilingThreadContext* ProfilingSystem::GetCurrentThreadContext()
+{
+    return t_profilingThreadContext.m_generation == m_generation ? t_profilingThreadContext.m_context : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+ProfilingThreadContext* ProfilingSystem::GetOrCreateThreadContext()
+{
+    ProfilingThreadContext* context = GetCurrentThreadContext();
+    if (!context)
+    {
+        RegisterCurrentThread("Unnamed Thread");
+        context = GetCurrentThreadContext();
+    }
+    return context;
+}
+
+//-----------------------------------------------------------------------------------
+//Main thread only. Pushes only ever touch the head, so anything past it can be unlinked without racing them.
+void ProfilingSystem::UnlinkThreadContext(ProfilingThreadContext* context)
+{
+    ProfilingThreadContext* head = context;
+    if (m_threadContexts.compare_exchange_strong(head, context->m_nextContext, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    for (ProfilingThreadContext* previous = head; previous != nullptr; previous = previous->m_nextContext)
+    {
+        if (previous->m_nextContext == context)
+        {
+            previous->m_nextContext = context->m_nextContext;
+            return;
+        }
     }
-    g_profilingResults.clear();
+}
+
+//-----------------------------------------------------------------------------------
+//Never creates a context, this gets called from inside the memory tracker.
+ProfileSample* ProfilingSystem::GetActiveSample()
+{
+    ProfilingThreadContext* context = GetCurrentThreadContext();
+    return context ? context->m_activeSample : nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+ProfilingThreadContext* ProfilingSystem::GetThreadContexts()
+{
+    return m_threadContexts.load(std::memory_order_acquire);
 }
 
 //-----------------------------------------------------------------------------------
 void ProfilingSystem::MarkFrame()
 {
+    //Counters keep counting with the profiler off, so they get sampled every frame either way.
+    SampleProfilingCounters();
     EndPreviousFrame();
 
     m_isEnabled = m_intentToEnable;
@@ -58,20 +450,50 @@ void ProfilingSystem::EndPreviousFrame()
     }
 
     //If this hits, we forgot to POP!  Bad Programmer, No Cookie!
-    ASSERT_OR_DIE(m_activeSample == m_currentFrameRoot, "There was an active sample still on the profiling stack. (Did you forget to pop?)");
+    ASSERT_OR_DIE(m_mainThreadContext->m_activeSample == m_currentFrameRoot, "There was an active sample still on the profiling stack. (Did you forget to pop?)");
 
     //Delete old previous sample if we have one
-    if (DeleteSampleTree(m_previousFrameRoot))
-    {
-        m_sampleAllocator.Free(m_previousFrameRoot);
-    }
+    m_mainThreadContext->FreeSampleTree(m_previousFrameRoot);
     m_previousFrameRoot = m_currentFrameRoot;
 
     PopSample();
+    for (int i = 0; i < NUM_MEMORY_TAGS; ++i)
+    {
+        m_previousFrameMemoryTagBytes[i] = GetMemoryTagStats((MemoryTag)i).numberOfBytes;
+    }
+    CollectThreadSamples();
+    m_frameHistory.RecordFrame(m_previousFrameRoot, g_frameNumber);
+    if (IsCapturingTrace())
+    {
+        WriteTraceFrame();
+    }
     m_rollingAverageFrametime *= 0.97;
     m_rollingAverageFrametime += (0.03 * m_previousFrameRoot->GetDurationInSeconds());
 }
 
+//-----------------------------------------------------------------------------------
+//Swaps every worker's view of the last frame for whatever they've committed since.
+//Threads that have exited get deleted once the last of their samples has been shown for a frame.
+void ProfilingSystem::CollectThreadSamples()
+{
+    ProfilingThreadContext* nextContext = nullptr;
+    for (ProfilingThreadContext* context = GetThreadContexts(); context != nullptr; context = nextContext)
+    {
+        nextContext = context->m_nextContext;
+        if (context == m_mainThreadContext)
+        {
+            continue;
+        }
+        const bool hasThreadExited = context->m_state.load(std::memory_order_acquire) == THREAD_CONTEXT_RETIRED;
+        context->RecycleSamples(context->m_previousFrameSamples);
+        context->m_previousFrameSamples = context->TakeCommittedSamples();
+        if (hasThreadExited && context->m_previousFrameSamples == nullptr)
+        {
+            UnlinkThreadContext(context);
+            delete context;
+        }
+    }
+}
 
 //-----------------------------------------------------------------------------------
 void ProfilingSystem::StartNewFrame()
@@ -82,47 +504,134 @@ void ProfilingSystem::StartNewFrame()
     }
 
     //active_sample is what right now? nullptr!
-    ASSERT_OR_DIE(m_activeSample == nullptr, "There was an active sample still on the profiling stack. (Did you forget to pop?)");
+    ASSERT_OR_DIE(m_mainThreadContext->m_activeSample == nullptr, "There was an active sample still on the profiling stack. (Did you forget to pop?)");
 
     //Start new sample tree
     this->PushSample("frame");
-    m_currentFrameRoot = m_activeSample;
+    m_currentFrameRoot = m_mainThreadContext->m_activeSample;
 }
 
 //-----------------------------------------------------------------------------------
 void ProfilingSystem::PushSample(const char* id)
 {
-    if (IsDisabled()) 
+    PushSampleOnCurrentThread(id);
+}
+
+//-----------------------------------------------------------------------------------
+//Opens a sample for work that was handed off by BeginFlow, so reports and traces can tie it back to whoever handed it off.
+void ProfilingSystem::PushFlowSample(const char* id, const ProfileFlow& flow)
+{
+    ProfileSample* newSample = PushSampleOnCurrentThread(id);
+    if (newSample)
+    {
+        newSample->flow = flow;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Call where work gets handed to another thread.
+void ProfilingSystem::BeginFlow(ProfileFlow& outFlow, const char* sourceName)
+{
+    outFlow = ProfileFlow();
+    ProfileSample* activeSample = GetActiveSample();
+    if (IsDisabled() || activeSample == nullptr)
     {
         return;
     }
+    outFlow.m_flowId = g_nextProfileFlowId.fetch_add(1, std::memory_order_relaxed);
+    outFlow.m_startCount = GetCurrentPerformanceCount();
+    outFlow.m_threadId = GetCurrentThreadContext()->m_threadId;
+    outFlow.m_sourceIndex = sourceName ? FindOrAddProfileFlowSource(sourceName) : FindDispatchingSource(activeSample);
+}
+
+//-----------------------------------------------------------------------------------
+//The subsystem is the outermost section below the frame, so "Update" gets the credit rather than whatever helper inside it called DispatchJob.
+//Work handed off from inside other handed off work belongs to whoever handed off the outer work.
+unsigned int ProfilingSystem::FindDispatchingSource(ProfileSample* activeSample)
+{
+    ProfileSample* subsystemSample = activeSample;
+    for (ProfileSample* sample = activeSample; sample != nullptr; sample = sample->parent)
+    {
+        if (sample->flow.IsValid())
+        {
+            return sample->flow.m_sourceIndex;
+        }
+        if (sample != m_currentFrameRoot)
+        {
+            subsystemSample = sample;
+        }
+    }
+    return FindOrAddProfileFlowSource(subsystemSample->id);
+}
+
+//-----------------------------------------------------------------------------------
+//Returns the new sample, or nullptr if profiling is off or we're out of samples.
+ProfileSample* ProfilingSystem::PushSampleOnCurrentThread(const char* id)
+{
+    if (IsDisabled()) 
+    {
+        return nullptr;
+    }
+
+    ProfilingThreadContext* context = GetOrCreateThreadContext();
+    if (context->m_activeSample == nullptr)
+    {
+        context->FreeRecycledSamples();
+    }
 
     //Create a profiling node
-    ProfileSample* newSample = m_sampleAllocator.Alloc<ProfileSample>();
+    ProfileSample* newSample = context->AllocSample();
+    if (!newSample)
+    {
+        ++context->m_droppedSampleDepth;
+        return nullptr;
+    }
     newSample->id = id;
     newSample->startCount = GetCurrentPerformanceCount();
 
     //Add new_sample as a child to active_sample
-    if (m_activeSample)
+    if (context->m_activeSample)
     {
-        AddInPlace(m_activeSample->children, newSample);
+        AddInPlace(context->m_activeSample->children, newSample);
     }
-    newSample->parent = m_activeSample;
-    m_activeSample = newSample;
+    newSample->parent = context->m_activeSample;
+    context->m_activeSample = newSample;
+    return newSample;
 }
 
 //-----------------------------------------------------------------------------------
 void ProfilingSystem::PopSample(const char*)
 {
-    if (IsDisabled()) 
+    ProfilingThreadContext* context = GetCurrentThreadContext();
+    if (context && context->m_droppedSampleDepth > 0)
     {
+        --context->m_droppedSampleDepth;
         return;
     }
-    ASSERT_OR_DIE(m_activeSample != nullptr, "There was no active sample, attempted to pop the bottom of the stack. (Did you pop too many times?)");
+    if (context != m_mainThreadContext)
+    {
+        //Workers can have profiling toggled out from under them mid-sample, so an unmatched pop isn't an error.
+        if (!context || !context->m_activeSample)
+        {
+            return;
+        }
+    }
+    else if (IsDisabled()) 
+    {
+        return;
+    }
+    ASSERT_OR_DIE(context->m_activeSample != nullptr, "There was no active sample, attempted to pop the bottom of the stack. (Did you pop too many times?)");
 
     //Update the end time on the active sample
-    m_activeSample->endCount = GetCurrentPerformanceCount();
-    m_activeSample = m_activeSample->parent;
+    ProfileSample* finishedSample = context->m_activeSample;
+    finishedSample->endCount = GetCurrentPerformanceCount();
+    context->m_activeSample = finishedSample->parent;
+
+    //The main thread's only root is the frame, which MarkFrame takes care of. Everyone else hands their roots off as they finish.
+    if (context != m_mainThreadContext && finishedSample->parent == nullptr)
+    {
+        context->CommitSample(finishedSample);
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -131,33 +640,15 @@ ProfileSample* ProfilingSystem::GetLastFrame()
     return m_previousFrameRoot;
 }
 
-//-----------------------------------------------------------------------------------
-bool ProfilingSystem::DeleteSampleTree(ProfileSample* root)
-{
-    if (root == nullptr)
-    {
-        return false;
-    }
-    else
-    {
-        while (root->children != nullptr)
-        {
-            ProfileSample* child = root->children;
-            DeleteSampleTree(child);
-            RemoveInPlace(root->children, child);
-            m_sampleAllocator.Free(child);
-        }
-        return true;
-    }
-}
-
 //-----------------------------------------------------------------------------------
 void ProfilingSystem::PrintNodeListView(ProfileSample* root, unsigned int depth)
 {
     std::string tag = Stringf("%s%s", std::string(depth, '-').c_str(), root->id);
     float msTaken = root->GetDurationInSeconds() * 1000.0f;
     float percentageTaken = (root->GetDurationInSeconds() / GetLastFrame()->GetDurationInSeconds()) * 100.0f;
-    Console::instance->PrintLine(Stringf("%-30s%12i%12i%12i%10.02fms%10.02f%%\n", tag.c_str(), root->numDrawCalls, root->numAllocs, root->sizeAllocs, msTaken, percentageTaken), RGBA(root->startCount, 1.0f, root->endCount, 1.0f));
+    char allocationsByTag[256];
+    FormatAllocationsByTag(root->sizeAllocsByTag, allocationsByTag, sizeof(allocationsByTag));
+    Console::instance->PrintLine(Stringf("%-30s%12i%12i%12i%10.02fms%10.02f%%  %s\n", tag.c_str(), root->numDrawCalls, root->numAllocs, root->sizeAllocs, msTaken, percentageTaken, allocationsByTag), RGBA(root->startCount, 1.0f, root->endCount, 1.0f));
 
     ProfileSample* currentChild = root->children;
     while (currentChild != nullptr)
@@ -176,59 +667,268 @@ void ProfilingSystem::PrintTreeListView()
 {
     if (m_previousFrameRoot)
     {
-        Console::instance->PrintLine(Stringf("%-30s%12s%12s%12s%12s%11s", "TAG", "NUM DRAWS", "NUM ALLOCS", "SIZE ALLOCS", "TIME", "%FRAME"));
+        Console::instance->PrintLine(Stringf("%-30s%12s%12s%12s%12s%11s  %s", "TAG", "NUM DRAWS", "NUM ALLOCS", "SIZE ALLOCS", "TIME", "%FRAME", "ALLOCS BY MEMORY TAG"));
         PrintNodeListView(m_previousFrameRoot, 0);
+        for (ProfilingThreadContext* context = GetThreadContexts(); context != nullptr; context = context->m_nextContext)
+        {
+            if (context == m_mainThreadContext || context->m_previousFrameSamples == nullptr)
+            {
+                continue;
+            }
+            Console::instance->PrintLine(Stringf("---Thread %s (%lu)---", context->m_threadName.load(std::memory_order_relaxed), context->m_threadId), RGBA::CERULEAN);
+            for (ProfileSample* root = context->m_previousFrameSamples; root != nullptr; root = root->next)
+            {
+                PrintNodeListView(root, 0);
+            }
+        }
+        PrintMemoryTagUsage();
+        PrintCounterValues();
         GenerateProfilingReport();
     }
 }
 
 //-----------------------------------------------------------------------------------
-bool ProfilingSystem::AddProfileNode(ProfileSample* root)
+void ProfilingSystem::PrintMemoryTagUsage()
 {
-    if (root == nullptr)
+    Console::instance->PrintLine(Stringf("%-30s%12s", "MEMORY TAG", "BYTES"));
+    for (int i = 0; i < NUM_MEMORY_TAGS; ++i)
+    {
+        Console::instance->PrintLine(Stringf("%-30s%12u", GetMemoryTagName((MemoryTag)i), m_previousFrameMemoryTagBytes[i]));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingSystem::PrintCounterValues()
+{
+    Console::instance->PrintLine(Stringf("%-30s%12s", "COUNTER", "VALUE"));
+    for (int i = 0; i < NUM_PROFILING_COUNTERS; ++i)
+    {
+        Console::instance->PrintLine(Stringf("%-30s%12lld", GetProfilingCounterName((ProfilingCounter)i), GetProfilingCounterValue((ProfilingCounter)i)));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Writes the next numFrames frames out as Chrome trace events. Open the file in chrome://tracing or ui.perfetto.dev.
+bool ProfilingSystem::StartTraceCapture(const char* filePath, unsigned int numFrames)
+{
+    StopTraceCapture();
+    errno_t error = fopen_s(&m_traceFile, filePath, "w");
+    if (error != 0 || m_traceFile == nullptr)
     {
+        m_traceFile = nullptr;
         return false;
     }
-    else
+    m_traceFramesRemaining = numFrames;
+    m_hasWrittenTraceEvent = false;
+    fprintf(m_traceFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    //Name every thread we know about up front so the viewer doesn't just show ids.
+    for (ProfilingThreadContext* context = GetThreadContexts(); context != nullptr; context = context->m_nextContext)
+    {
+        context->m_tracedThreadName = nullptr;
+    }
+    WriteTraceThreadNames();
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+//Names any thread that's registered or been renamed since the last time we wrote names, so late starters don't show up as bare ids.
+void ProfilingSystem::WriteTraceThreadNames()
+{
+    for (ProfilingThreadContext* context = GetThreadContexts(); context != nullptr; context = context->m_nextContext)
     {
-        ProfileSample* currentChild = root->children;
-        if (currentChild == nullptr)
+        const char* threadName = context->m_threadName.load(std::memory_order_relaxed);
+        if (threadName == context->m_tracedThreadName)
         {
-            return false;
+            continue;
         }
-        do
+        char escapedName[256];
+        EscapeTraceString(threadName, escapedName, sizeof(escapedName));
+        fprintf(m_traceFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s (%lu)\"}}", m_hasWrittenTraceEvent ? ",\n" : "", context->m_threadId, escapedName, context->m_threadId);
+        m_hasWrittenTraceEvent = true;
+        context->m_tracedThreadName = threadName;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingSystem::StopTraceCapture()
+{
+    if (m_traceFile)
+    {
+        fprintf(m_traceFile, "\n]}\n");
+        fclose(m_traceFile);
+        m_traceFile = nullptr;
+    }
+    m_traceFramesRemaining = 0;
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingSystem::WriteTraceFrame()
+{
+    WriteTraceThreadNames();
+    WriteTraceSample(m_previousFrameRoot, m_mainThreadContext->m_threadId);
+    for (ProfilingThreadContext* context = GetThreadContexts(); context != nullptr; context = context->m_nextContext)
+    {
+        for (ProfileSample* root = context->m_previousFrameSamples; root != nullptr && context != m_mainThreadContext; root = root->next)
         {
-            bool foundSameTag = false;
-            for (ProfileReportNode& node : g_profilingResults)
-            {
-                if (strcmp(node.m_id, currentChild->id) == 0) //Same sample, add a call
-                {
-                    foundSameTag = true;
-                    node.AddSample(currentChild);
-                    break;
-                }
-            }
-            if (!foundSameTag) //Add the new sample
-            {
-                ProfileReportNode currentNode;
-                currentNode.m_id = currentChild->id;
-                currentNode.m_start = currentChild->startCount;
-                currentNode.m_end = currentChild->endCount;
-                currentNode.AddSample(currentChild);
-                g_profilingResults.push_back(currentNode);
-            }
+            WriteTraceSample(root, context->m_threadId);
+        }
+    }
+    WriteTraceCounters();
 
-            currentChild = currentChild->next;
-            AddProfileNode(currentChild);
-        } while (currentChild != root->children);
-        return true;
+    if (--m_traceFramesRemaining == 0)
+    {
+        StopTraceCapture();
+        Console::instance->PrintLine("Profile trace capture finished.", RGBA::GBLIGHTGREEN);
     }
 }
 
 //-----------------------------------------------------------------------------------
-void ProfilingSystem::GenerateProfilingReport()
+//One counter ("C") event per counter, stamped at the end of the frame they were sampled for.
+void ProfilingSystem::WriteTraceCounters()
+{
+    static const double SECONDS_TO_MICROSECONDS = 1000000.0;
+    double endMicroseconds = PerformanceCountToSeconds(m_previousFrameRoot->endCount) * SECONDS_TO_MICROSECONDS;
+    for (int i = 0; i < NUM_PROFILING_COUNTERS; ++i)
+    {
+        fprintf(m_traceFile, "%s{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%lld}}"
+            , m_hasWrittenTraceEvent ? ",\n" : "", GetProfilingCounterName((ProfilingCounter)i), endMicroseconds, GetProfilingCounterValue((ProfilingCounter)i));
+        m_hasWrittenTraceEvent = true;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//One complete ("X") event per sample. Children follow their parent so the viewer nests them by time.
+void ProfilingSystem::WriteTraceSample(ProfileSample* sample, unsigned long threadId)
+{
+    static const double SECONDS_TO_MICROSECONDS = 1000000.0;
+    double startMicroseconds = PerformanceCountToSeconds(sample->startCount) * SECONDS_TO_MICROSECONDS;
+    double durationMicroseconds = sample->GetDurationInSeconds() * SECONDS_TO_MICROSECONDS;
+
+    char escapedName[256];
+    EscapeTraceString(sample->id, escapedName, sizeof(escapedName));
+    char allocationsByTag[256];
+    FormatAllocationsByTag(sample->sizeAllocsByTag, allocationsByTag, sizeof(allocationsByTag));
+
+    fprintf(m_traceFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"draws\":%u,\"allocs\":%u,\"allocBytes\":%u,\"allocBytesByTag\":\"%s\"}}"
+        , m_hasWrittenTraceEvent ? ",\n" : "", escapedName, threadId, startMicroseconds, durationMicroseconds, sample->numDrawCalls, sample->numAllocs, sample->sizeAllocs, allocationsByTag);
+    m_hasWrittenTraceEvent = true;
+    if (sample->flow.IsValid())
+    {
+        WriteTraceFlow(sample, threadId);
+    }
+
+    ProfileSample* currentChild = sample->children;
+    while (currentChild != nullptr)
+    {
+        WriteTraceSample(currentChild, threadId);
+        currentChild = currentChild->next;
+        if (currentChild == sample->children)
+        {
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//A flow start ("s") inside the dispatching sample and a flow end ("f") bound to the sample that picked the work up, which the viewer draws as an arrow.
+void ProfilingSystem::WriteTraceFlow(ProfileSample* sample, unsigned long threadId)
+{
+    static const double SECONDS_TO_MICROSECONDS = 1000000.0;
+    double dispatchMicroseconds = PerformanceCountToSeconds(sample->flow.m_startCount) * SECONDS_TO_MICROSECONDS;
+    double startMicroseconds = PerformanceCountToSeconds(sample->startCount) * SECONDS_TO_MICROSECONDS;
+
+    char escapedSource[256];
+    EscapeTraceString(GetProfileFlowSourceName(sample->flow.m_sourceIndex), escapedSource, sizeof(escapedSource));
+
+    fprintf(m_traceFile, ",\n{\"name\":\"%s\",\"cat\":\"flow\",\"ph\":\"s\",\"id\":%u,\"pid\":1,\"tid\":%lu,\"ts\":%.3f}"
+        , escapedSource, sample->flow.m_flowId, sample->flow.m_threadId, dispatchMicroseconds);
+    fprintf(m_traceFile, ",\n{\"name\":\"%s\",\"cat\":\"flow\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%u,\"pid\":1,\"tid\":%lu,\"ts\":%.3f}"
+        , escapedSource, sample->flow.m_flowId, threadId, startMicroseconds);
+}
+
+//-----------------------------------------------------------------------------------
+static void ResetProfilingResultsTable(size_t capacity)
+{
+    g_profilingResultsTable.assign(capacity, -1);
+}
+
+//-----------------------------------------------------------------------------------
+static void GrowProfilingResultsTable()
+{
+    ResetProfilingResultsTable(g_profilingResultsTable.size() * 2);
+    size_t mask = g_profilingResultsTable.size() - 1;
+    for (unsigned int i = 0; i < g_profilingResults.size(); ++i)
+    {
+        size_t slot = g_profilingResults[i].m_idHash & mask;
+        while (g_profilingResultsTable[slot] != -1)
+        {
+            slot = (slot + 1) & mask;
+        }
+        g_profilingResultsTable[slot] = i;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingSystem::AddSampleToReport(ProfileSample* sample)
+{
+    //Keep the table at most half full so probes stay short.
+    if ((g_profilingResults.size() + 1) * 2 > g_profilingResultsTable.size())
+    {
+        GrowProfilingResultsTable();
+    }
+
+    size_t idHash = HashSampleId(sample->id);
+    size_t mask = g_profilingResultsTable.size() - 1;
+    size_t slot = idHash & mask;
+    while (g_profilingResultsTable[slot] != -1)
+    {
+        ProfileReportNode& node = g_profilingResults[g_profilingResultsTable[slot]];
+        //Pointer check first, it's the common case since most ids are literals.
+        if (node.m_idHash == idHash && (node.m_id == sample->id || strcmp(node.m_id, sample->id) == 0)) //Same sample, add a call
+        {
+            node.AddSample(sample);
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    //Add the new sample
+    ProfileReportNode newNode;
+    newNode.m_id = sample->id;
+    newNode.m_idHash = idHash;
+    newNode.m_start = sample->startCount;
+    newNode.m_end = sample->endCount;
+    newNode.AddSample(sample);
+    g_profilingResultsTable[slot] = (int)g_profilingResults.size();
+    g_profilingResults.push_back(newNode);
+}
+
+//-----------------------------------------------------------------------------------
+//Adds every sample under root to the report. The root itself isn't added.
+bool ProfilingSystem::AddProfileNode(ProfileSample* root)
+{
+    if (root == nullptr || root->children == nullptr)
+    {
+        return false;
+    }
+
+    ProfileSample* currentChild = root->children;
+    do
+    {
+        AddSampleToReport(currentChild);
+        AddProfileNode(currentChild);
+        currentChild = currentChild->next;
+    } while (currentChild != root->children);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+//Fills g_profilingResults for the previous frame, sorted by self time.
+void ProfilingSystem::BuildProfilingReport()
 {
     g_profilingResults.clear();
+    ResetProfilingResultsTable(64);
 
     AddProfileNode(m_previousFrameRoot);
 
@@ -238,19 +938,156 @@ void ProfilingSystem::GenerateProfilingReport()
     }
 
     std::sort(g_profilingResults.begin(), g_profilingResults.end());
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingSystem::GenerateProfilingReport()
+{
+    BuildProfilingReport();
 
     DebuggerPrintf("---===Frame impact report===---\n");
     DebuggerPrintf("Frame %i's time: %10.02fms\n", g_frameNumber, m_previousFrameRoot->GetDurationInSeconds() * 1000.0f);
     DebuggerPrintf("///TOP///\n");
-    DebuggerPrintf("%-25s%12s%12s%12s%12s%12s%12s%12s%12s%11s\n", "TAG", "NUM CALLS", "NUM DRAWS", "NUM ALLOCS", "SIZE ALLOCS", "SELF TIME", "TOTAL TIME", "MAX TIME", "AVG TIME", "PERCENTAGE");
+    DebuggerPrintf("%-25s%12s%12s%12s%12s%12s%12s%12s%12s%12s%12s%11s  %s\n", "TAG", "NUM CALLS", "NUM DRAWS", "NUM ALLOCS", "SIZE ALLOCS", "SELF TIME", "TOTAL TIME", "MIN TIME", "MAX TIME", "AVG TIME", "AVG SELF", "PERCENTAGE", "ALLOCS BY MEMORY TAG");
     for (ProfileReportNode& node : g_profilingResults)
     {
-        DebuggerPrintf("%-25s%12i%12i%12i%12i%10.02fms%10.02fms%10.02fms%10.02fms%10.02f%%\n", node.m_id, (int)node.m_numSamples, node.m_numDrawCalls, node.m_numAllocs, node.m_sizeAllocs, (float)node.m_totalSelfTime * 1000.0f, (float)node.m_totalTime * 1000.0f, (float)node.m_maxTime * 1000.0f, (float)node.m_averageTime * 1000.0f, node.m_framePercentage * 100.0f);
+        double averageSelfTime = node.m_totalSelfTime / (double)node.m_numSamples;
+        char allocationsByTag[256];
+        FormatAllocationsByTag(node.m_sizeAllocsByTag, allocationsByTag, sizeof(allocationsByTag));
+        DebuggerPrintf("%-25s%12i%12i%12i%12i%10.03fms%10.03fms%10.03fms%10.03fms%10.03fms%10.03fms%10.02f%%  %s\n", node.m_id, (int)node.m_numSamples, node.m_numDrawCalls, node.m_numAllocs, node.m_sizeAllocs, (float)node.m_totalSelfTime * 1000.0f, (float)node.m_totalTime * 1000.0f, (float)node.m_minTime * 1000.0f, (float)node.m_maxTime * 1000.0f, (float)node.m_averageTime * 1000.0f, (float)averageSelfTime * 1000.0f, node.m_framePercentage * 100.0f, allocationsByTag);
     }
     DebuggerPrintf("///BOTTOM///\n");
+
+    BuildFlowAttribution();
+    if (!g_profilingFlowAttribution.empty())
+    {
+        DebuggerPrintf("///HANDED OFF WORK BY DISPATCHER///\n");
+        DebuggerPrintf("%-25s%12s%12s%12s%12s\n", "DISPATCHED FROM", "NUM JOBS", "TOTAL TIME", "MAX TIME", "AVG WAIT");
+        for (ProfileFlowAttribution& attribution : g_profilingFlowAttribution)
+        {
+            DebuggerPrintf("%-25s%12u%10.03fms%10.03fms%10.03fms\n", attribution.m_sourceName, attribution.m_numFlows, (float)attribution.m_totalTime * 1000.0f, (float)attribution.m_maxTime * 1000.0f, (float)(attribution.m_totalLatency / attribution.m_numFlows) * 1000.0f);
+        }
+    }
     DebuggerPrintf("---===End of Frame impact report===---\n");
 }
 
+//-----------------------------------------------------------------------------------
+//Fills g_profilingFlowAttribution from every thread's samples for the previous frame, heaviest dispatcher first.
+void ProfilingSystem::BuildFlowAttribution()
+{
+    g_profilingFlowAttribution.clear();
+    AddFlowSamplesToAttribution(m_previousFrameRoot);
+    for (ProfilingThreadContext* context = GetThreadContexts(); context != nullptr; context = context->m_nextContext)
+    {
+        for (ProfileSample* root = context->m_previousFrameSamples; root != nullptr && context != m_mainThreadContext; root = root->next)
+        {
+            AddFlowSamplesToAttribution(root);
+        }
+    }
+
+    std::sort(g_profilingFlowAttribution.begin(), g_profilingFlowAttribution.end(), [](const ProfileFlowAttribution& first, const ProfileFlowAttribution& second)
+    {
+        return first.m_totalTime > second.m_totalTime;
+    });
+}
+
+//-----------------------------------------------------------------------------------
+//Stops at the first sample that carries a flow. Anything nested inside it is already part of its time.
+void ProfilingSystem::AddFlowSamplesToAttribution(ProfileSample* sample)
+{
+    if (sample == nullptr)
+    {
+        return;
+    }
+
+    if (sample->flow.IsValid())
+    {
+        //Only a handful of subsystems hand work off, so a linear search beats setting up a table.
+        ProfileFlowAttribution* attribution = nullptr;
+        for (ProfileFlowAttribution& existingAttribution : g_profilingFlowAttribution)
+        {
+            if (existingAttribution.m_sourceIndex == sample->flow.m_sourceIndex)
+            {
+                attribution = &existingAttribution;
+                break;
+            }
+        }
+        if (!attribution)
+        {
+            ProfileFlowAttribution newAttribution;
+            newAttribution.m_sourceIndex = sample->flow.m_sourceIndex;
+            newAttribution.m_sourceName = GetProfileFlowSourceName(sample->flow.m_sourceIndex);
+            newAttribution.m_numFlows = 0;
+            newAttribution.m_totalTime = 0.0;
+            newAttribution.m_maxTime = 0.0;
+            newAttribution.m_totalLatency = 0.0;
+            g_profilingFlowAttribution.push_back(newAttribution);
+            attribution = &g_profilingFlowAttribution.back();
+        }
+
+        double sampleTime = sample->GetDurationInSeconds();
+        ++attribution->m_numFlows;
+        attribution->m_totalTime += sampleTime;
+        attribution->m_maxTime = sampleTime > attribution->m_maxTime ? sampleTime : attribution->m_maxTime;
+        attribution->m_totalLatency += PerformanceCountToSeconds(sample->startCount) - PerformanceCountToSeconds(sample->flow.m_startCount);
+        return;
+    }
+
+    ProfileSample* currentChild = sample->children;
+    while (currentChild != nullptr)
+    {
+        AddFlowSamplesToAttribution(currentChild);
+        currentChild = currentChild->next;
+        if (currentChild == sample->children)
+        {
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void ProfilingSystem::PrintFlowAttribution()
+{
+    BuildFlowAttribution();
+    if (g_profilingFlowAttribution.empty())
+    {
+        Console::instance->PrintLine("No handed off work finished last frame.", RGBA::RED);
+        return;
+    }
+    Console::instance->PrintLine(Stringf("%-30s%12s%12s%12s%12s", "DISPATCHED FROM", "NUM JOBS", "TOTAL TIME", "MAX TIME", "AVG WAIT"), RGBA::VAPORWAVE);
+    for (ProfileFlowAttribution& attribution : g_profilingFlowAttribution)
+    {
+        Console::instance->PrintLine(Stringf("%-30s%12u%10.03fms%10.03fms%10.03fms", attribution.m_sourceName, attribution.m_numFlows, (float)attribution.m_totalTime * 1000.0f, (float)attribution.m_maxTime * 1000.0f, (float)(attribution.m_totalLatency / attribution.m_numFlows) * 1000.0f));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//One line, small enough to stream every frame: frame number, time, p99 over the history, the heaviest sections by self time, then every counter.
+bool ProfilingSystem::BuildFrameSummary(char* outBuffer, size_t bufferSize, unsigned int numTopSections)
+{
+    if (!m_previousFrameRoot || bufferSize == 0)
+    {
+        return false;
+    }
+
+    BuildProfilingReport();
+    ProfilePercentiles framePercentiles = m_frameHistory.GetFramePercentiles();
+    //_snprintf_s hands back -1 once it had to truncate, which still leaves a terminated string behind, so just stop there.
+    int length = _snprintf_s(outBuffer, bufferSize, _TRUNCATE, "frame=%i;ms=%.3f;p99=%.3f;top=", g_frameNumber, m_previousFrameRoot->GetDurationInSeconds() * 1000.0, framePercentiles.p99);
+    for (unsigned int i = 0; i < numTopSections && i < g_profilingResults.size() && length >= 0; ++i)
+    {
+        const ProfileReportNode& node = g_profilingResults[i];
+        int written = _snprintf_s(outBuffer + length, bufferSize - length, _TRUNCATE, "%s%s:%.3f", i == 0 ? "" : ",", node.m_id, node.m_totalSelfTime * 1000.0);
+        length = written < 0 ? -1 : length + written;
+    }
+    for (int i = 0; i < NUM_PROFILING_COUNTERS && length >= 0; ++i)
+    {
+        int written = _snprintf_s(outBuffer + length, bufferSize - length, _TRUNCATE, ";%s=%lld", GetProfilingCounterName((ProfilingCounter)i), GetProfilingCounterValue((ProfilingCounter)i));
+        length = written < 0 ? -1 : length + written;
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------------------
 double ProfilingSystem::GetAverageFrameDuration()
 {
@@ -289,11 +1126,15 @@ double PerformanceCountToSeconds(uint64_t& performanceCount)
 void ProfileReportNode::AddSample(ProfileSample* otherSample)
 {
     double sampleTime = otherSample->GetDurationInSeconds();
-    m_sizeAllocs += otherSample->numAllocs;
+    m_sizeAllocs += otherSample->sizeAllocs;
     m_numAllocs += otherSample->numAllocs;
     m_numDrawCalls += otherSample->numDrawCalls;
+    for (int i = 0; i < NUM_MEMORY_TAGS; ++i)
+    {
+        m_sizeAllocsByTag[i] += otherSample->sizeAllocsByTag[i];
+    }
     m_lastTime = sampleTime;
-    m_minTime = (sampleTime < m_minTime) ? sampleTime : m_minTime;
+    m_minTime = (m_numSamples == 0 || sampleTime < m_minTime) ? sampleTime : m_minTime;
     m_maxTime = (sampleTime > m_maxTime) ? sampleTime : m_maxTime;
     double currentRollingAverage = m_averageTime;
     double currentRollingAverageExpanded = currentRollingAverage * m_numSamples;
@@ -338,7 +1179,7 @@ ProfileLogSection::~ProfileLogSection()
     static const float secondsToMs = 1000.0f;
     m_end = GetCurrentPerformanceCount();
     uint64_t duration = m_end - m_start;
-    LogPrintf("[%s]: took %.02f ms\n", m_id, PerformanceCountToSeconds(duration) * secondsToMs);
+    LOG_DEFAULT(LOG_CHANNEL_PROFILING, "[%s]: took %.02f ms\n", m_id, PerformanceCountToSeconds(duration) * secondsToMs);
 }
 
 //-----------------------------------------------------------------------------------
@@ -364,14 +1205,65 @@ CONSOLE_COMMAND(printprofiling)
     ProfilingSystem::instance->PrintTreeListView();
 }
 
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profilejobs)
+{
+    UNUSED(args);
+    if (!ProfilingSystem::IsProfilingEnabled())
+    {
+        Console::instance->PrintLine("Profiling is disabled.", RGBA::RED);
+        return;
+    }
+    ProfilingSystem::instance->PrintFlowAttribution();
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profiletrace)
+{
+    if (!args.HasArgs(1) && !args.HasArgs(2))
+    {
+        Console::instance->PrintLine("profiletrace <number of frames> <optional: file path>", RGBA::RED);
+        return;
+    }
+    int numFrames = args.GetIntArgument(0);
+    std::string filePath = args.HasArgs(2) ? args.GetStringArgument(1) : "profile_trace.json";
+    if (numFrames <= 0)
+    {
+        ProfilingSystem::instance->StopTraceCapture();
+        Console::instance->PrintLine("Profile trace capture stopped.", RGBA::GBLIGHTGREEN);
+        return;
+    }
+    if (!ProfilingSystem::instance->StartTraceCapture(filePath.c_str(), (unsigned int)numFrames))
+    {
+        Console::instance->PrintLine(Stringf("Couldn't open '%s' for writing.", filePath.c_str()), RGBA::RED);
+        return;
+    }
+    Console::instance->PrintLine(Stringf("Capturing %i frames to '%s'.", numFrames, filePath.c_str()), RGBA::GBLIGHTGREEN);
+}
+
 #else
-ProfilingSystem::ProfilingSystem() : m_sampleAllocator(0) {}
+ProfilingSystem::ProfilingSystem() : m_traceFile(nullptr), m_generation(0) {}
+void ProfilingSystem::PrintMemoryTagUsage() {}
 ProfilingSystem::~ProfilingSystem() {}
 void ProfilingSystem::StartNewFrame() {}
 void ProfilingSystem::EndPreviousFrame() {}
-bool ProfilingSystem::DeleteSampleTree(ProfileSample*) { return false; }
+void ProfilingSystem::RegisterCurrentThread(const char*) {}
+ProfileSample* ProfilingSystem::GetActiveSample() { return nullptr; }
+ProfilingThreadContext* ProfilingSystem::GetThreadContexts() { return nullptr; }
+bool ProfilingSystem::StartTraceCapture(const char*, unsigned int) { return false; }
+void ProfilingSystem::StopTraceCapture() {}
+void ProfilingSystem::WriteTraceFrame() {}
+void ProfilingSystem::WriteTraceThreadNames() {}
+void ProfilingSystem::WriteTraceSample(ProfileSample*, unsigned long) {}
+void ProfilingSystem::WriteTraceCounters() {}
+void ProfilingSystem::PrintCounterValues() {}
+bool ProfilingSystem::BuildFrameSummary(char*, size_t, unsigned int) { return false; }
 void ProfilingSystem::MarkFrame() {}
 void ProfilingSystem::PushSample(const char*) {}
+void ProfilingSystem::PushFlowSample(const char*, const ProfileFlow&) {}
+void ProfilingSystem::BeginFlow(ProfileFlow& outFlow, const char*) { outFlow = ProfileFlow(); }
+void ProfilingSystem::BuildFlowAttribution() {}
+void ProfilingSystem::PrintFlowAttribution() {}
 void ProfilingSystem::PopSample(const char*) {}
 void ProfilingSystem::PrintTreeListView() {}
 ProfileSample* ProfilingSystem::GetLastFrame() { return nullptr; }
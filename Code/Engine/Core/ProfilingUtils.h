@@ -1,11 +1,17 @@
 #pragma once
 #include "Engine/Core/Memory/UntrackedAllocator.hpp"
 #include "Engine/DataStructures/ObjectPool.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Core/ProfilingHistory.hpp"
+#include <atomic>
+#include <stdio.h>
 #include <chrono>
 #include <vector>
+#include <cstring>
 
 struct ProfileLogSection;
 struct ProfileReportNode;
+struct ProfileFlowAttribution;
 
 #define COMBINE1(X,Y) X##Y  // helper macro
 #define COMBINE(X,Y) COMBINE1(X,Y)
@@ -14,20 +20,58 @@ struct ProfileReportNode;
 //GLOBAL FUNCTIONS/////////////////////////////////////////////////////////////////////
 uint64_t GetCurrentPerformanceCount();
 double PerformanceCountToSeconds(uint64_t& performanceCount);
+size_t HashSampleId(const char* id);
+//Writes something like "renderer:1024 ui:64", skipping tags that didn't allocate anything.
+void FormatAllocationsByTag(const size_t* sizeAllocsByTag, char* outBuffer, size_t bufferSize);
+//Escapes a name for a JSON string in a trace file, truncating to fit the buffer.
+void EscapeTraceString(const char* source, char* outEscaped, size_t bufferSize);
+//Handed off work is attributed to a source by index. Names are copied on first use and kept for the life of the program, so flows never point at a string that's gone.
+unsigned int FindOrAddProfileFlowSource(const char* sourceName);
+const char* GetProfileFlowSourceName(unsigned int sourceIndex);
+
+//CONSTANTS/////////////////////////////////////////////////////////////////////
+static const unsigned int MAX_PROFILE_FLOW_SOURCES = 256; //Past this, new sources all get lumped in with source 0
+static const unsigned int MAX_PROFILE_FLOW_SOURCE_NAME_LENGTH = 64;
 
 //GLOBAL VARIABLES/////////////////////////////////////////////////////////////////////
 extern uint64_t g_profilingStartTime;
 extern uint64_t g_profilingEndTime;
 extern std::vector<ProfileReportNode, UntrackedAllocator<ProfileReportNode>> g_profilingResults;
+extern std::vector<ProfileFlowAttribution, UntrackedAllocator<ProfileFlowAttribution>> g_profilingFlowAttribution;
 
 //STRUCTS/////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------------
+//Links work that was handed off to another thread back to the sample that was active when it got handed off.
+struct ProfileFlow
+{
+    ProfileFlow() : m_flowId(0), m_startCount(0), m_threadId(0), m_sourceIndex(0) {};
+    inline bool IsValid() const { return m_flowId != 0; };
+
+    unsigned int m_flowId; //0 if profiling was off when the work was handed off
+    uint64_t m_startCount;
+    unsigned long m_threadId;
+    unsigned int m_sourceIndex; //See FindOrAddProfileFlowSource
+};
+
+//-----------------------------------------------------------------------------------
+//How much handed off work each dispatching subsystem was responsible for last frame.
+struct ProfileFlowAttribution
+{
+    unsigned int m_sourceIndex;
+    const char* m_sourceName;
+    unsigned int m_numFlows;
+    double m_totalTime;
+    double m_maxTime;
+    double m_totalLatency; //Time spent waiting between the hand off and the work starting
+};
+
 //-----------------------------------------------------------------------------------
 struct ProfileSample
 {
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
-    ProfileSample() : id(nullptr), startCount(0), endCount(0), parent(nullptr), children(nullptr), prev(nullptr), next(nullptr) {};
+    ProfileSample() : id(nullptr), startCount(0), endCount(0), parent(nullptr), children(nullptr), prev(nullptr), next(nullptr) { memset(sizeAllocsByTag, 0, sizeof(sizeAllocsByTag)); };
     inline double GetDurationInSeconds() { return PerformanceCountToSeconds(endCount) - PerformanceCountToSeconds(startCount); };
-    inline void AddAllocation(size_t allocationSize) { sizeAllocs += allocationSize; ++numAllocs; };
+    inline void AddAllocation(size_t allocationSize, MemoryTag tag) { sizeAllocs += allocationSize; sizeAllocsByTag[tag] += allocationSize; ++numAllocs; };
     //inline void GetDurationInSeconds(ProfileSample* other) { PerformanceCountToSeconds(endCount) - PerformanceCountToSeconds(startCount); };
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
@@ -35,13 +79,15 @@ struct ProfileSample
     uint64_t endCount;
     ProfileSample* parent;
     ProfileSample* children;
-    //Sibling pointers
+    //Sibling pointers. Top level samples on worker threads have no siblings, so next links them into their thread's committed list instead.
     ProfileSample* prev;
     ProfileSample* next;
     const char* id;
     size_t sizeAllocs = 0;
     size_t numAllocs = 0;
     size_t numDrawCalls = 0;
+    size_t sizeAllocsByTag[NUM_MEMORY_TAGS]; //Bytes allocated during this sample, split by the memory tag that was active
+    ProfileFlow flow; //Only set on the sample that picked the work up, anything nested inside it belongs to the same flow
     //unsigned int numCalls;
     //double averageTime = -1.0;
 };
@@ -50,12 +96,13 @@ struct ProfileSample
 struct ProfileReportNode
 {
 public:
-    ProfileReportNode() : m_lastTime(0.0), m_numSamples(0), m_minTime(0.0), m_maxTime(0.0), m_averageTime(0.0) {};
+    ProfileReportNode() : m_id(nullptr), m_idHash(0), m_lastTime(0.0), m_numSamples(0), m_minTime(0.0), m_maxTime(0.0), m_averageTime(0.0) { memset(m_sizeAllocsByTag, 0, sizeof(m_sizeAllocsByTag)); };
     void AddSample(ProfileSample* otherSample);
     void CalculatePercentage(double frameTime) { m_framePercentage = static_cast<float>(m_totalTime / frameTime); };
     inline bool operator<(const ProfileReportNode& other) { return (m_totalSelfTime > other.m_totalSelfTime); }; //This is intentional for sorting yes I'm evil.
     double GetTimeForChildren(ProfileSample* otherSample);
     const char* m_id;
+    size_t m_idHash;
     double m_lastTime;
     unsigned long long m_numSamples;
     double m_minTime;
@@ -67,11 +114,52 @@ public:
     size_t m_sizeAllocs = 0;
     size_t m_numAllocs = 0;
     size_t m_numDrawCalls = 0;
+    size_t m_sizeAllocsByTag[NUM_MEMORY_TAGS];
     float m_framePercentage = 0.0f;
     uint64_t m_start;
     uint64_t m_end;
 };
 
+//-----------------------------------------------------------------------------------
+//Who's responsible for deleting a thread context. Whichever of the thread and the profiler lets go of it second deletes it.
+enum ProfilingThreadContextState
+{
+    THREAD_CONTEXT_LIVE, //Both the thread and the profiler are using it
+    THREAD_CONTEXT_RETIRED, //The thread exited, the profiler deletes it once nothing from it is being shown
+    THREAD_CONTEXT_ORPHANED, //The profiler went away first, the thread deletes it when it exits or registers again
+    NUM_THREAD_CONTEXT_STATES
+};
+
+//-----------------------------------------------------------------------------------
+//Everything one thread needs to record samples without touching any other thread's data.
+//Only the owning thread allocates or frees from the pool. Finished trees go to the main thread, and old ones come back, through the two atomic lists.
+struct ProfilingThreadContext
+{
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    ProfilingThreadContext(const char* threadName, size_t poolSize);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    ProfileSample* AllocSample();
+    void FreeSampleTree(ProfileSample* root);
+    void FreeRecycledSamples();
+    void CommitSample(ProfileSample* root);
+    ProfileSample* TakeCommittedSamples();
+    void RecycleSamples(ProfileSample* firstRoot);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    ObjectPool<ProfileSample> m_sampleAllocator;
+    ProfileSample* m_activeSample;
+    std::atomic<ProfileSample*> m_committedSamples; //Finished top level samples, pushed by the owner and taken at MarkFrame
+    std::atomic<ProfileSample*> m_samplesToRecycle; //Trees from older frames, handed back for the owner to free
+    ProfileSample* m_previousFrameSamples; //What this thread committed during the last frame. Main thread only.
+    ProfilingThreadContext* m_nextContext; //Only the main thread unlinks contexts, and only the main thread walks the list.
+    std::atomic<const char*> m_threadName; //Can be renamed by its thread while the main thread is printing it
+    const char* m_tracedThreadName; //The name last written to the trace file. Main thread only.
+    std::atomic<int> m_state; //ProfilingThreadContextState
+    unsigned long m_threadId;
+    unsigned int m_droppedSampleDepth; //Pushes we ignored because the pool ran dry, so we ignore the matching pops too.
+};
+
 //-----------------------------------------------------------------------------------
 class ProfilingSystem
 {
@@ -83,11 +171,25 @@ public:
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     void MarkFrame();
     void PushSample(const char* id);
+    void PushFlowSample(const char* id, const ProfileFlow& flow);
+    //Leave sourceName null to attribute the work to whichever subsystem is dispatching it.
+    void BeginFlow(ProfileFlow& outFlow, const char* sourceName = nullptr);
     //The sample id here is unused, just used for readability for pushing and popping samples.
     void PopSample(const char* id = "");
     void PrintTreeListView();
+    void RegisterCurrentThread(const char* threadName);
+    ProfileSample* GetActiveSample();
+    ProfilingThreadContext* GetThreadContexts();
+    bool StartTraceCapture(const char* filePath, unsigned int numFrames);
+    void StopTraceCapture();
+    inline bool IsCapturingTrace() const { return m_traceFile != nullptr; };
     bool AddProfileNode(ProfileSample* root);
+    void AddSampleToReport(ProfileSample* sample);
+    void BuildProfilingReport();
     void GenerateProfilingReport();
+    void BuildFlowAttribution();
+    void PrintFlowAttribution();
+    bool BuildFrameSummary(char* outBuffer, size_t bufferSize, unsigned int numTopSections);
     double GetAverageFrameDuration();
     ProfileSample* GetLastFrame();
     inline bool IsEnabled() const { return m_isEnabled; };
@@ -105,20 +207,39 @@ public:
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     ProfileSample* m_currentFrameRoot;
-    ProfileSample* m_activeSample;
     ProfileSample* m_previousFrameRoot;
-    ObjectPool<ProfileSample> m_sampleAllocator;
+    ProfilingThreadContext* m_mainThreadContext; //Whoever constructed us owns the frame tree.
+    size_t m_previousFrameMemoryTagBytes[NUM_MEMORY_TAGS]; //Live bytes per memory tag at the end of the previous frame
+    ProfilingHistory m_frameHistory; //Main thread frame trees only
 
 private:
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
     void StartNewFrame();
     void EndPreviousFrame();
-    bool DeleteSampleTree(ProfileSample* root);
+    ProfileSample* PushSampleOnCurrentThread(const char* id);
+    unsigned int FindDispatchingSource(ProfileSample* activeSample);
+    void AddFlowSamplesToAttribution(ProfileSample* sample);
+    ProfilingThreadContext* GetCurrentThreadContext();
+    ProfilingThreadContext* GetOrCreateThreadContext();
+    void UnlinkThreadContext(ProfilingThreadContext* context);
+    void CollectThreadSamples();
     void PrintNodeListView(ProfileSample* root, unsigned int depth);
+    void PrintMemoryTagUsage();
+    void PrintCounterValues();
+    void WriteTraceFrame();
+    void WriteTraceThreadNames();
+    void WriteTraceSample(ProfileSample* sample, unsigned long threadId);
+    void WriteTraceFlow(ProfileSample* sample, unsigned long threadId);
+    void WriteTraceCounters();
 
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     double m_rollingAverageFrametime = 0.0f;
-    bool m_isEnabled;
+    std::atomic<ProfilingThreadContext*> m_threadContexts; //Every live thread that's pushed a sample, newest first. Pushed from any thread, pruned by the main thread.
+    const unsigned int m_generation; //Tells threads their context belongs to a profiler that's since been destroyed
+    std::atomic<bool> m_isEnabled;
+    FILE* m_traceFile; //Chrome trace event JSON, only open while a capture is running
+    unsigned int m_traceFramesRemaining;
+    bool m_hasWrittenTraceEvent;
     bool m_intentToEnable;
 };
 
@@ -1,51 +1,28 @@
 #include "Engine/Core/RunInSeconds.hpp"
 
-std::vector<RunAfterSecondsCallbackData, UntrackedAllocator<RunAfterSecondsCallbackData>> g_runAfterSecondsCallbackFunctions;
-std::vector<RunAfterSecondsCallbackData, UntrackedAllocator<RunAfterSecondsCallbackData>> g_newlyAddedRunAfterSecondsCallbackFunctions;
-extern bool g_isDispatchingRunAfterSeconds = false;
+TimerWheel g_runAfterSecondsTimers;
 
 //-----------------------------------------------------------------------------------
-void RunCallback(RunAfterSecondsCallbackData* callback)
+TimerHandle RunAfterSeconds(RunAfterSecondsFunction function, void* data, float secondsToWait)
 {
-    callback->m_function(callback->m_data);
+    return g_runAfterSecondsTimers.Schedule(function, data, secondsToWait);
+}
+
+//-----------------------------------------------------------------------------------
+bool CancelRunAfterSeconds(TimerHandle& handle)
+{
+    return g_runAfterSecondsTimers.Cancel(handle);
 }
 
 //-----------------------------------------------------------------------------------
 void FlushRunAfterSecondsFunctions()
 {
-    while (g_runAfterSecondsCallbackFunctions.size() > 0)
-    {
-        RunCallback(&g_runAfterSecondsCallbackFunctions[0]);
-        g_runAfterSecondsCallbackFunctions.erase(g_runAfterSecondsCallbackFunctions.begin());
-    }
+    g_runAfterSecondsTimers.FlushAll();
 }
 
 //-----------------------------------------------------------------------------------
 //This is what runs the functions, needs to be called somewhere.
 void DispatchRunAfterSeconds()
 {
-    unsigned int size = g_runAfterSecondsCallbackFunctions.size();
-    g_isDispatchingRunAfterSeconds = true;
-
-    for (auto iter = g_runAfterSecondsCallbackFunctions.begin(); iter != g_runAfterSecondsCallbackFunctions.end();)
-    {
-        if (GetCurrentTimeSeconds() - iter->m_dispatchedTimestampSeconds > iter->m_secondsToWait)
-        {
-            RunAfterSecondsCallbackData& callbackData = *iter;
-            RunCallback(&callbackData);
-            iter = g_runAfterSecondsCallbackFunctions.erase(iter);
-        }
-        if (iter == g_runAfterSecondsCallbackFunctions.end())
-        {
-            break;
-        }
-        ++iter;
-    }
-
-    g_isDispatchingRunAfterSeconds = false;
-    for (auto iter = g_newlyAddedRunAfterSecondsCallbackFunctions.begin(); iter != g_newlyAddedRunAfterSecondsCallbackFunctions.end(); ++iter)
-    {
-        g_runAfterSecondsCallbackFunctions.push_back(*iter);
-    }
-    g_newlyAddedRunAfterSecondsCallbackFunctions.clear();
-}
\ No newline at end of file
+    g_runAfterSecondsTimers.Update();
+}
@@ -1,66 +1,28 @@
 #pragma once
-#include "Engine/Time/Time.hpp"
-#include "Memory/UntrackedAllocator.hpp"
-#include <vector>
+#include "Engine/Core/TimerWheel.hpp"
 
 typedef void(*RunAfterSecondsFunction)(void*);
-struct RunAfterSecondsCallbackData;
 
 //GLOBAL VARIABLES/////////////////////////////////////////////////////////////////////
-extern std::vector<RunAfterSecondsCallbackData, UntrackedAllocator<RunAfterSecondsCallbackData>> g_runAfterSecondsCallbackFunctions;
-extern std::vector<RunAfterSecondsCallbackData, UntrackedAllocator<RunAfterSecondsCallbackData>> g_newlyAddedRunAfterSecondsCallbackFunctions;
-extern bool g_isDispatchingRunAfterSeconds;
-
-//-----------------------------------------------------------------------------------
-struct RunAfterSecondsCallbackData
-{
-    RunAfterSecondsCallbackData()
-    {
-        m_dispatchedTimestampSeconds = GetCurrentTimeSeconds();
-    }
-
-    RunAfterSecondsCallbackData(RunAfterSecondsFunction functionPointer, void* data, float secondsToWait)
-        : m_function(functionPointer)
-        , m_data(data)
-        , m_secondsToWait(secondsToWait)
-    {
-        m_dispatchedTimestampSeconds = GetCurrentTimeSeconds();
-    }
-
-    RunAfterSecondsFunction m_function = nullptr;
-    void* m_data = nullptr;
-    double m_dispatchedTimestampSeconds;
-    float m_secondsToWait;
-
-    bool operator< (const RunAfterSecondsCallbackData& other) { return this->m_secondsToWait < other.m_secondsToWait; };
-};
+extern TimerWheel g_runAfterSecondsTimers;
 
 //FUNCTIONS/////////////////////////////////////////////////////////////////////
-void RunCallback(RunAfterSecondsCallbackData* callback);
+TimerHandle RunAfterSeconds(RunAfterSecondsFunction function, void* data, float secondsToWait);
+bool CancelRunAfterSeconds(TimerHandle& handle);
 void FlushRunAfterSecondsFunctions();
 void DispatchRunAfterSeconds();
 
 //-----------------------------------------------------------------------------------
 template <typename CB>
-void RunLater(void *data)
+TimerHandle RunAfterSeconds(CB callback, float secondsToWait)
 {
-    // Cast this to CB type
-    CB* callback = (CB*)data;
-    (*callback)();
-
-    delete callback;
+    return g_runAfterSecondsTimers.Schedule(callback, secondsToWait);
 }
 
 //-----------------------------------------------------------------------------------
+//Keeps running every intervalSeconds until it's cancelled with CancelRunAfterSeconds.
 template <typename CB>
-void RunAfterSeconds(CB callback, float secondsToWait)
+TimerHandle RunEverySeconds(CB callback, float intervalSeconds)
 {
-    CB* copy = new CB(callback);
-
-    RunAfterSecondsCallbackData cbd;
-    cbd.m_function = RunLater<CB>;
-    cbd.m_data = copy;
-    cbd.m_secondsToWait = secondsToWait;
-
-    g_isDispatchingRunAfterSeconds ? g_newlyAddedRunAfterSecondsCallbackFunctions.push_back(cbd) : g_runAfterSecondsCallbackFunctions.push_back(cbd);
-}
\ No newline at end of file
+    return g_runAfterSecondsTimers.Schedule(callback, intervalSeconds, intervalSeconds);
+}
@@ -0,0 +1,452 @@
+#include "Engine/Core/SamplingProfiler.hpp"
+#include "Engine/Core/Memory/Callstack.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ProfilingUtils.h"
+#include "Engine/Input/Console.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <stdio.h>
+
+SamplingProfiler* SamplingProfiler::instance = nullptr;
+
+//Threads are registered as they start, whether or not anyone is sampling yet, and give their slot back when they exit.
+static const unsigned int MAX_SAMPLED_THREADS = 64;
+static SampledThread g_sampledThreads[MAX_SAMPLED_THREADS];
+static unsigned int g_numSampledThreadSlots = 0;
+//Held for each capture, so unregistering waits until the sampler is done with that thread.
+static SRWLOCK g_sampledThreadsLock = SRWLOCK_INIT;
+
+//-----------------------------------------------------------------------------------
+//Unregisters on the way out, otherwise the sampler would go on capturing a thread that no longer exists.
+struct SampledThreadRegistration
+{
+    SampledThreadRegistration() : m_threadIndex(-1) {};
+    ~SampledThreadRegistration() { SamplingProfiler::UnregisterCurrentThread(); };
+    int m_threadIndex;
+};
+static thread_local SampledThreadRegistration t_samplingRegistration;
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::RegisterCurrentThread(const char* threadName)
+{
+    if (t_samplingRegistration.m_threadIndex != -1)
+    {
+        return;
+    }
+    uintptr_t threadHandle = CallstackGetCurrentThreadHandle();
+    AcquireSRWLockExclusive(&g_sampledThreadsLock);
+    {
+        unsigned int threadIndex = 0;
+        while (threadIndex < g_numSampledThreadSlots && g_sampledThreads[threadIndex].m_handle != 0)
+        {
+            ++threadIndex;
+        }
+        if (threadIndex < MAX_SAMPLED_THREADS)
+        {
+            FormatTo(g_sampledThreads[threadIndex].m_threadName, "%s", threadName);
+            g_sampledThreads[threadIndex].m_handle = threadHandle;
+            g_numSampledThreadSlots = threadIndex < g_numSampledThreadSlots ? g_numSampledThreadSlots : threadIndex + 1;
+            t_samplingRegistration.m_threadIndex = (int)threadIndex;
+        }
+    }
+    ReleaseSRWLockExclusive(&g_sampledThreadsLock);
+
+    if (t_samplingRegistration.m_threadIndex == -1)
+    {
+        DebuggerPrintf("WARNING: Too many threads to sample, ignoring '%s'.\n", threadName);
+        CallstackReleaseThreadHandle(threadHandle);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::UnregisterCurrentThread()
+{
+    if (t_samplingRegistration.m_threadIndex == -1)
+    {
+        return;
+    }
+    uintptr_t threadHandle = 0;
+    AcquireSRWLockExclusive(&g_sampledThreadsLock);
+    {
+        SampledThread& thread = g_sampledThreads[t_samplingRegistration.m_threadIndex];
+        threadHandle = thread.m_handle;
+        thread.m_handle = 0;
+        thread.m_threadName[0] = '\0';
+    }
+    ReleaseSRWLockExclusive(&g_sampledThreadsLock);
+    CallstackReleaseThreadHandle(threadHandle);
+    t_samplingRegistration.m_threadIndex = -1;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int SamplingProfiler::GetNumRegisteredThreads()
+{
+    unsigned int numThreads = 0;
+    AcquireSRWLockExclusive(&g_sampledThreadsLock);
+    for (unsigned int i = 0; i < g_numSampledThreadSlots; ++i)
+    {
+        numThreads += g_sampledThreads[i].m_handle != 0 ? 1 : 0;
+    }
+    ReleaseSRWLockExclusive(&g_sampledThreadsLock);
+    return numThreads;
+}
+
+//-----------------------------------------------------------------------------------
+SamplingProfiler::SamplingProfiler()
+    : m_isRunning(false)
+    , m_samplesPerSecond(DEFAULT_SAMPLES_PER_SECOND)
+    , m_numSamplingPasses(0)
+    , m_numSamples(0)
+    , m_ownsCallstackSystem(false)
+{
+    InitializeCriticalSection(&m_stacksCriticalSection);
+    RegisterCurrentThread("Main");
+}
+
+//-----------------------------------------------------------------------------------
+SamplingProfiler::~SamplingProfiler()
+{
+    Stop();
+    if (m_ownsCallstackSystem)
+    {
+        CallstackSystemDeinit();
+    }
+    DeleteCriticalSection(&m_stacksCriticalSection);
+}
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::Start(unsigned int samplesPerSecond)
+{
+    Stop();
+    //Memory tracking normally brings the callstack system up, but release builds don't track memory.
+    //We keep it up after stopping, since reports still need to resolve symbols.
+    if (!CallstackSystemIsInitialized())
+    {
+        CallstackSystemInit();
+        m_ownsCallstackSystem = true;
+    }
+    m_samplesPerSecond = samplesPerSecond > 0 ? samplesPerSecond : DEFAULT_SAMPLES_PER_SECOND;
+    m_isRunning = true;
+    m_samplingThread = std::thread(&SamplingProfiler::SamplingThreadMain, this);
+}
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::Stop()
+{
+    if (!m_isRunning)
+    {
+        return;
+    }
+    m_isRunning = false;
+    m_samplingThread.join();
+}
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::Clear()
+{
+    EnterCriticalSection(&m_stacksCriticalSection);
+    {
+        m_stacks.clear();
+        m_stackIndices.clear();
+        m_numSamplingPasses = 0;
+        m_numSamples = 0;
+    }
+    LeaveCriticalSection(&m_stacksCriticalSection);
+}
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::SamplingThreadMain()
+{
+    std::chrono::microseconds samplePeriod(1000000 / m_samplesPerSecond);
+    std::chrono::steady_clock::time_point nextSampleTime = std::chrono::steady_clock::now();
+    while (m_isRunning)
+    {
+        TakeSample();
+        //Schedule off of the ideal time instead of when we woke up, so slow captures don't drag the rate down.
+        nextSampleTime += samplePeriod;
+        std::this_thread::sleep_until(nextSampleTime);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::TakeSample()
+{
+    void* frames[SampledStack::MAX_FRAMES];
+    for (unsigned int i = 0; i < MAX_SAMPLED_THREADS; ++i)
+    {
+        //Registering threads could be waiting on this lock, so don't hold it across AddSample.
+        AcquireSRWLockExclusive(&g_sampledThreadsLock);
+        if (i >= g_numSampledThreadSlots)
+        {
+            ReleaseSRWLockExclusive(&g_sampledThreadsLock);
+            break;
+        }
+        char threadName[MAX_SAMPLED_THREAD_NAME_LENGTH];
+        memcpy(threadName, g_sampledThreads[i].m_threadName, sizeof(threadName));
+        uintptr_t threadHandle = g_sampledThreads[i].m_handle;
+        unsigned int numFrames = threadHandle != 0 ? CallstackCaptureThread(threadHandle, frames, SampledStack::MAX_FRAMES) : 0;
+        ReleaseSRWLockExclusive(&g_sampledThreadsLock);
+
+        if (numFrames > 0)
+        {
+            AddSample(i, threadName, frames, numFrames);
+        }
+    }
+    ++m_numSamplingPasses;
+}
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::AddSample(unsigned int threadIndex, const char* threadName, void** frames, unsigned int numFrames)
+{
+    //FNV-1a over the return addresses and the thread they came from. The name's in there too, since slots get reused.
+    uint64_t hash = (14695981039346656037ULL ^ threadIndex) * 1099511628211ULL;
+    for (const char* character = threadName; *character; ++character)
+    {
+        hash = (hash ^ (uint64_t)(unsigned char)*character) * 1099511628211ULL;
+    }
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        hash = (hash ^ (uint64_t)(uintptr_t)frames[i]) * 1099511628211ULL;
+    }
+
+    EnterCriticalSection(&m_stacksCriticalSection);
+    {
+        auto found = m_stackIndices.find(hash);
+        if (found != m_stackIndices.end())
+        {
+            ++m_stacks[found->second].m_numHits;
+        }
+        else
+        {
+            m_stackIndices[hash] = (unsigned int)m_stacks.size();
+            m_stacks.emplace_back();
+            SampledStack& stack = m_stacks.back();
+            stack.m_threadIndex = threadIndex;
+            FormatTo(stack.m_threadName, "%s", threadName);
+            stack.m_numFrames = numFrames;
+            stack.m_numHits = 1;
+            memcpy(stack.m_frames, frames, sizeof(void*) * numFrames);
+        }
+        ++m_numSamples;
+    }
+    LeaveCriticalSection(&m_stacksCriticalSection);
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int SamplingProfiler::GetNumSamples(const char* threadName)
+{
+    if (!threadName)
+    {
+        return m_numSamples;
+    }
+    unsigned int numSamples = 0;
+    EnterCriticalSection(&m_stacksCriticalSection);
+    {
+        for (const SampledStack& stack : m_stacks)
+        {
+            numSamples += strcmp(stack.m_threadName, threadName) == 0 ? stack.m_numHits : 0;
+        }
+    }
+    LeaveCriticalSection(&m_stacksCriticalSection);
+    return numSamples;
+}
+
+//-----------------------------------------------------------------------------------
+//Inclusive hits are samples with the function anywhere on the stack, self hits are samples where it was the one running.
+//Symbolizing is safe from any thread, but nobody can clear the symbol cache while this runs.
+unsigned int SamplingProfiler::GetFunctionHits(const char* functionName, unsigned int& outSelfHits, const char* threadName)
+{
+    unsigned int inclusiveHits = 0;
+    outSelfHits = 0;
+    EnterCriticalSection(&m_stacksCriticalSection);
+    {
+        for (const SampledStack& stack : m_stacks)
+        {
+            if (threadName && strcmp(stack.m_threadName, threadName) != 0)
+            {
+                continue;
+            }
+            for (unsigned int i = 0; i < stack.m_numFrames; ++i)
+            {
+                if (strcmp(CallstackGetFunctionName(stack.m_frames[i]), functionName) == 0)
+                {
+                    inclusiveHits += stack.m_numHits;
+                    outSelfHits += (i == 0) ? stack.m_numHits : 0;
+                    break;
+                }
+            }
+        }
+    }
+    LeaveCriticalSection(&m_stacksCriticalSection);
+    return inclusiveHits;
+}
+
+//-----------------------------------------------------------------------------------
+struct SampledFunction
+{
+    const char* m_name;
+    unsigned int m_selfHits;
+    unsigned int m_inclusiveHits;
+    unsigned int m_lastStackCounted; //So recursion only counts once per stack
+};
+
+//-----------------------------------------------------------------------------------
+void SamplingProfiler::PrintReport(unsigned int maxFunctionsToShow)
+{
+    //Symbol names are cached by the callstack system for as long as it's up, so the pointers are stable while we build this.
+    std::vector<SampledFunction, UntrackedAllocator<SampledFunction>> functions;
+    std::map<size_t, unsigned int, std::less<size_t>, UntrackedAllocator<std::pair<const size_t, unsigned int>>> functionIndices;
+    unsigned int numSamples = 0;
+    EnterCriticalSection(&m_stacksCriticalSection);
+    {
+        numSamples = m_numSamples;
+        for (unsigned int stackIndex = 0; stackIndex < m_stacks.size(); ++stackIndex)
+        {
+            const SampledStack& stack = m_stacks[stackIndex];
+            for (unsigned int i = 0; i < stack.m_numFrames; ++i)
+            {
+                //Addresses in the same function resolve to different cache entries, so key off the contents.
+                const char* name = CallstackGetFunctionName(stack.m_frames[i]);
+                size_t nameHash = HashSampleId(name);
+                unsigned int functionIndex = 0;
+                auto found = functionIndices.find(nameHash);
+                if (found == functionIndices.end())
+                {
+                    SampledFunction function = { name, 0, 0, (unsigned int)-1 };
+                    functionIndex = (unsigned int)functions.size();
+                    functionIndices[nameHash] = functionIndex;
+                    functions.push_back(function);
+                }
+                else
+                {
+                    functionIndex = found->second;
+                }
+
+                SampledFunction& function = functions[functionIndex];
+                if (i == 0)
+                {
+                    function.m_selfHits += stack.m_numHits;
+                }
+                if (function.m_lastStackCounted != stackIndex)
+                {
+                    function.m_inclusiveHits += stack.m_numHits;
+                    function.m_lastStackCounted = stackIndex;
+                }
+            }
+        }
+    }
+    LeaveCriticalSection(&m_stacksCriticalSection);
+
+    if (numSamples == 0)
+    {
+        Console::instance->PrintLine("No samples yet. Start sampling with samplingstart.", RGBA::RED);
+        return;
+    }
+
+    std::sort(functions.begin(), functions.end(), [](const SampledFunction& first, const SampledFunction& second) { return first.m_selfHits > second.m_selfHits; });
+    Console::instance->PrintLine(Stringf("%u samples over %u passes at %u Hz", numSamples, m_numSamplingPasses, m_samplesPerSecond), RGBA::VAPORWAVE);
+    Console::instance->PrintLine(Stringf("%-50s%10s%10s%12s%12s", "FUNCTION", "SELF", "SELF%", "INCLUSIVE", "INCLUSIVE%"), RGBA::VAPORWAVE);
+    for (unsigned int i = 0; i < functions.size() && i < maxFunctionsToShow; ++i)
+    {
+        const SampledFunction& function = functions[i];
+        Console::instance->PrintLine(Stringf("%-50.50s%10u%9.02f%%%12u%11.02f%%", function.m_name, function.m_selfHits, (function.m_selfHits * 100.0f) / numSamples, function.m_inclusiveHits, (function.m_inclusiveHits * 100.0f) / numSamples));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//One "thread;root;...;leaf count" line per unique stack, which is what flamegraph.pl and speedscope expect.
+bool SamplingProfiler::WriteFoldedStacks(const char* filePath)
+{
+    FILE* file = nullptr;
+    errno_t error = fopen_s(&file, filePath, "w");
+    if (error != 0 || file == nullptr)
+    {
+        return false;
+    }
+
+    EnterCriticalSection(&m_stacksCriticalSection);
+    {
+        for (const SampledStack& stack : m_stacks)
+        {
+            fprintf(file, "%s", stack.m_threadName);
+            for (int i = (int)stack.m_numFrames - 1; i >= 0; --i)
+            {
+                //Semicolons separate frames, so they can't show up inside of a name.
+                const char* name = CallstackGetFunctionName(stack.m_frames[i]);
+                fputc(';', file);
+                for (const char* character = name; *character; ++character)
+                {
+                    fputc(*character == ';' ? ':' : *character, file);
+                }
+            }
+            fprintf(file, " %u\n", stack.m_numHits);
+        }
+    }
+    LeaveCriticalSection(&m_stacksCriticalSection);
+    fclose(file);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(samplingstart)
+{
+    unsigned int samplesPerSecond = args.HasArgs(1) ? (unsigned int)args.GetIntArgument(0) : SamplingProfiler::DEFAULT_SAMPLES_PER_SECOND;
+    if (!SamplingProfiler::instance)
+    {
+        SamplingProfiler::instance = new SamplingProfiler();
+    }
+    SamplingProfiler::instance->Start(samplesPerSecond);
+    Console::instance->PrintLine(Stringf("Sampling every thread at %u Hz.", samplesPerSecond), RGBA::GBLIGHTGREEN);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(samplingstop)
+{
+    UNUSED(args);
+    if (SamplingProfiler::instance)
+    {
+        SamplingProfiler::instance->Stop();
+    }
+    Console::instance->PrintLine("Sampling stopped.", RGBA::GBLIGHTGREEN);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(samplingclear)
+{
+    UNUSED(args);
+    if (SamplingProfiler::instance)
+    {
+        SamplingProfiler::instance->Clear();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(samplingreport)
+{
+    if (!SamplingProfiler::instance)
+    {
+        Console::instance->PrintLine("No samples yet. Start sampling with samplingstart.", RGBA::RED);
+        return;
+    }
+    unsigned int maxFunctionsToShow = args.HasArgs(1) ? (unsigned int)args.GetIntArgument(0) : 30;
+    SamplingProfiler::instance->PrintReport(maxFunctionsToShow);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(samplingfolded)
+{
+    if (!SamplingProfiler::instance)
+    {
+        Console::instance->PrintLine("No samples yet. Start sampling with samplingstart.", RGBA::RED);
+        return;
+    }
+    std::string filePath = args.HasArgs(1) ? args.GetStringArgument(0) : "samples.folded";
+    if (!SamplingProfiler::instance->WriteFoldedStacks(filePath.c_str()))
+    {
+        Console::instance->PrintLine(Stringf("Couldn't open '%s' for writing.", filePath.c_str()), RGBA::RED);
+        return;
+    }
+    Console::instance->PrintLine(Stringf("Wrote folded stacks to '%s'.", filePath.c_str()), RGBA::GBLIGHTGREEN);
+}
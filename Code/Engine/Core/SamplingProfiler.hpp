@@ -0,0 +1,84 @@
+#pragma once
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+//CONSTANTS/////////////////////////////////////////////////////////////////////
+static const unsigned int MAX_SAMPLED_THREAD_NAME_LENGTH = 32; //Longer names get cut off
+
+//-----------------------------------------------------------------------------------
+//Only touched while holding the sampled thread lock, so a thread can't exit partway through being captured.
+struct SampledThread
+{
+    uintptr_t m_handle; //0 if the slot's free
+    char m_threadName[MAX_SAMPLED_THREAD_NAME_LENGTH]; //Copied, the name the thread registered with could be a temporary
+};
+
+//-----------------------------------------------------------------------------------
+//Every time we caught a thread with this exact stack. Frames are leaf first.
+struct SampledStack
+{
+    static const unsigned int MAX_FRAMES = 64;
+
+    unsigned int m_threadIndex;
+    char m_threadName[MAX_SAMPLED_THREAD_NAME_LENGTH]; //Slots get reused once a thread exits, so keep our own copy
+    unsigned int m_numFrames;
+    unsigned int m_numHits;
+    void* m_frames[MAX_FRAMES];
+};
+
+//-----------------------------------------------------------------------------------
+//Statistical profiler that works in any build. A background thread periodically pauses every registered thread and buckets its callstack,
+//so it finds hot code that nobody thought to put a PushSample around.
+class SamplingProfiler
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SamplingProfiler();
+    ~SamplingProfiler();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void Start(unsigned int samplesPerSecond);
+    void Stop();
+    void Clear();
+    void PrintReport(unsigned int maxFunctionsToShow);
+    bool WriteFoldedStacks(const char* filePath);
+    //Leave threadName null to count every thread.
+    unsigned int GetNumSamples(const char* threadName = nullptr);
+    unsigned int GetFunctionHits(const char* functionName, unsigned int& outSelfHits, const char* threadName = nullptr);
+    inline bool IsRunning() const { return m_isRunning; };
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void RegisterCurrentThread(const char* threadName);
+    //Happens automatically when a registered thread exits.
+    static void UnregisterCurrentThread();
+    static unsigned int GetNumRegisteredThreads();
+
+    //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
+    static SamplingProfiler* instance;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int DEFAULT_SAMPLES_PER_SECOND = 200;
+
+private:
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void SamplingThreadMain();
+    void TakeSample();
+    void AddSample(unsigned int threadIndex, const char* threadName, void** frames, unsigned int numFrames);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<SampledStack, UntrackedAllocator<SampledStack>> m_stacks;
+    std::map<uint64_t, unsigned int, std::less<uint64_t>, UntrackedAllocator<std::pair<const uint64_t, unsigned int>>> m_stackIndices;
+    CRITICAL_SECTION m_stacksCriticalSection;
+    std::thread m_samplingThread;
+    std::atomic<bool> m_isRunning;
+    unsigned int m_samplesPerSecond;
+    unsigned int m_numSamplingPasses;
+    unsigned int m_numSamples;
+    bool m_ownsCallstackSystem;
+};
@@ -0,0 +1,255 @@
+#include "Engine/Core/ScopeTimer.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Input/Console.hpp"
+#include <algorithm>
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <thread>
+#endif
+
+//-----------------------------------------------------------------------------------
+//Hands the thread's ring back when the thread exits, so short lived threads reuse rings instead of adding one apiece.
+//Kept apart from t_scopeTimerRing so the pointer ScopeTimer reads stays a plain thread_local.
+struct ScopeTimerRingHolder
+{
+    ~ScopeTimerRingHolder()
+    {
+        if (t_scopeTimerRing)
+        {
+            t_scopeTimerRing->m_isOwned.store(false, std::memory_order_release);
+            t_scopeTimerRing = nullptr;
+        }
+    };
+    bool m_isRegistered = false;
+};
+
+thread_local ScopeTimerRing* t_scopeTimerRing = nullptr;
+static thread_local ScopeTimerRingHolder t_scopeTimerRingHolder;
+//Every ring that's ever been made, newest first. A report could be walking the list at any time, so rings are never freed, just handed to the next thread.
+static std::atomic<ScopeTimerRing*> g_scopeTimerRings(nullptr);
+
+//-----------------------------------------------------------------------------------
+ScopeTimerRing::ScopeTimerRing(unsigned long threadId)
+    : m_numWritten(0)
+    , m_ownerFirstIndex(0)
+    , m_threadId(threadId)
+    , m_isOwned(true)
+    , m_depth(0)
+    , m_nextRing(nullptr)
+{
+}
+
+//-----------------------------------------------------------------------------------
+//Takes over a ring some exited thread gave back, or makes a new one if every ring is in use.
+ScopeTimerRing* CreateScopeTimerRingForThisThread()
+{
+#ifdef WIN32
+    unsigned long threadId = GetCurrentThreadId();
+#else
+    unsigned long threadId = (unsigned long)std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+    //Touching the holder is what gets its destructor run when this thread exits.
+    t_scopeTimerRingHolder.m_isRegistered = true;
+
+    for (ScopeTimerRing* ring = GetScopeTimerRings(); ring != nullptr; ring = ring->m_nextRing)
+    {
+        bool isOwned = false;
+        if (!ring->m_isOwned.load(std::memory_order_relaxed) && ring->m_isOwned.compare_exchange_strong(isOwned, true, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            ring->m_depth = 0;
+            ring->m_threadId.store(threadId, std::memory_order_relaxed);
+            ring->m_ownerFirstIndex.store(ring->m_numWritten.load(std::memory_order_relaxed), std::memory_order_release);
+            t_scopeTimerRing = ring;
+            return ring;
+        }
+    }
+
+    MemoryTagScope profilingScope(MEMTAG_PROFILING);
+    ScopeTimerRing* ring = new ScopeTimerRing(threadId);
+
+    ScopeTimerRing* head = g_scopeTimerRings.load(std::memory_order_relaxed);
+    do
+    {
+        ring->m_nextRing = head;
+    } while (!g_scopeTimerRings.compare_exchange_weak(head, ring, std::memory_order_release, std::memory_order_relaxed));
+    t_scopeTimerRing = ring;
+    return ring;
+}
+
+//-----------------------------------------------------------------------------------
+ScopeTimerRing* GetScopeTimerRings()
+{
+    return g_scopeTimerRings.load(std::memory_order_acquire);
+}
+
+//-----------------------------------------------------------------------------------
+//Counts TSC ticks against the performance counter for a few milliseconds. Only ever runs once.
+static double CalibrateNanosecondsPerTick()
+{
+#ifdef WIN32
+    static const double CALIBRATION_SECONDS = 0.02;
+    LARGE_INTEGER countsPerSecond;
+    LARGE_INTEGER startCount;
+    LARGE_INTEGER currentCount;
+    QueryPerformanceFrequency(&countsPerSecond);
+    QueryPerformanceCounter(&startCount);
+    uint64_t startTicks = ReadScopeTimerTicks();
+    do
+    {
+        QueryPerformanceCounter(&currentCount);
+    } while ((double)(currentCount.QuadPart - startCount.QuadPart) / (double)countsPerSecond.QuadPart < CALIBRATION_SECONDS);
+    uint64_t endTicks = ReadScopeTimerTicks();
+
+    double elapsedNanoseconds = ((double)(currentCount.QuadPart - startCount.QuadPart) / (double)countsPerSecond.QuadPart) * 1000000000.0;
+    return elapsedNanoseconds / (double)(endTicks - startTicks);
+#else
+    //steady_clock already counts in nanoseconds.
+    return 1.0;
+#endif
+}
+
+//-----------------------------------------------------------------------------------
+double ScopeTimerTicksToNanoseconds(uint64_t ticks)
+{
+    static const double s_nanosecondsPerTick = CalibrateNanosecondsPerTick();
+    return (double)ticks * s_nanosecondsPerTick;
+}
+
+//-----------------------------------------------------------------------------------
+//Safe to call while the owner keeps writing. Anything the owner overwrote while we were copying gets thrown out.
+//Only the current owner's scopes are copied, and if the ring changes hands partway through we get nothing.
+static void CopyTimedScopes(ScopeTimerRing* ring, std::vector<TimedScope, UntrackedAllocator<TimedScope>>& outScopes)
+{
+    unsigned int ownerFirstIndex = ring->m_ownerFirstIndex.load(std::memory_order_acquire);
+    unsigned int numWritten = ring->m_numWritten.load(std::memory_order_acquire);
+    unsigned int firstIndex = numWritten - ownerFirstIndex > ScopeTimerRing::NUM_SCOPES ? numWritten - ScopeTimerRing::NUM_SCOPES : ownerFirstIndex;
+    outScopes.clear();
+    outScopes.reserve(numWritten - firstIndex);
+    for (unsigned int i = firstIndex; i < numWritten; ++i)
+    {
+        outScopes.push_back(ring->m_scopes[i & ScopeTimerRing::SCOPE_INDEX_MASK]);
+    }
+
+    //Keeps the copy above from being reordered past the second load.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (ring->m_ownerFirstIndex.load(std::memory_order_relaxed) != ownerFirstIndex)
+    {
+        outScopes.clear();
+        return;
+    }
+    unsigned int numWrittenAfterCopy = ring->m_numWritten.load(std::memory_order_relaxed);
+    //The owner may already be partway through writing scope numWrittenAfterCopy, which lands on top of the one NUM_SCOPES before it.
+    unsigned int firstSafeIndex = numWrittenAfterCopy + 1 > ScopeTimerRing::NUM_SCOPES ? numWrittenAfterCopy + 1 - ScopeTimerRing::NUM_SCOPES : 0;
+    if (firstSafeIndex > firstIndex)
+    {
+        unsigned int numClobbered = std::min(firstSafeIndex - firstIndex, (unsigned int)outScopes.size());
+        outScopes.erase(outScopes.begin(), outScopes.begin() + numClobbered);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Scopes land in the ring as they finish, so children come before their parents. Sorting by start time puts every parent
+//right before its children, and anything that isn't inside the scope on top of the stack must belong further up.
+void BuildScopeTree(ScopeTimerRing* ring, std::vector<ScopeTreeNode, UntrackedAllocator<ScopeTreeNode>>& outNodes)
+{
+    std::vector<TimedScope, UntrackedAllocator<TimedScope>> scopes;
+    CopyTimedScopes(ring, scopes);
+    std::sort(scopes.begin(), scopes.end(), [](const TimedScope& first, const TimedScope& second)
+    {
+        return first.m_startTicks != second.m_startTicks ? first.m_startTicks < second.m_startTicks : first.m_depth < second.m_depth;
+    });
+
+    outNodes.clear();
+    std::vector<const TimedScope*, UntrackedAllocator<const TimedScope*>> openScopes;
+    std::vector<int, UntrackedAllocator<int>> openNodes;
+    for (const TimedScope& scope : scopes)
+    {
+        while (!openScopes.empty() && !(openScopes.back()->m_startTicks <= scope.m_startTicks && scope.m_endTicks <= openScopes.back()->m_endTicks))
+        {
+            openScopes.pop_back();
+            openNodes.pop_back();
+        }
+
+        int parentIndex = openNodes.empty() ? -1 : openNodes.back();
+        int nodeIndex = -1;
+        for (int i = parentIndex + 1; i < (int)outNodes.size(); ++i)
+        {
+            if (outNodes[i].m_parentIndex == parentIndex && outNodes[i].m_name == scope.m_name)
+            {
+                nodeIndex = i;
+                break;
+            }
+        }
+        if (nodeIndex == -1)
+        {
+            ScopeTreeNode node;
+            node.m_name = scope.m_name;
+            node.m_parentIndex = parentIndex;
+            node.m_depth = (unsigned int)openNodes.size();
+            node.m_numCalls = 0;
+            node.m_totalTicks = 0;
+            node.m_maxTicks = 0;
+            nodeIndex = (int)outNodes.size();
+            outNodes.push_back(node);
+        }
+
+        uint64_t durationTicks = scope.m_endTicks - scope.m_startTicks;
+        ScopeTreeNode& node = outNodes[nodeIndex];
+        ++node.m_numCalls;
+        node.m_totalTicks += durationTicks;
+        node.m_maxTicks = std::max(node.m_maxTicks, durationTicks);
+
+        openScopes.push_back(&scope);
+        openNodes.push_back(nodeIndex);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static void PrintScopeTreeNode(const std::vector<ScopeTreeNode, UntrackedAllocator<ScopeTreeNode>>& nodes, int nodeIndex)
+{
+    const ScopeTreeNode& node = nodes[nodeIndex];
+    std::string tag = Stringf("%s%s", std::string(node.m_depth, '-').c_str(), node.m_name);
+    double totalMs = ScopeTimerTicksToNanoseconds(node.m_totalTicks) / 1000000.0;
+    double averageUs = ScopeTimerTicksToNanoseconds(node.m_totalTicks / node.m_numCalls) / 1000.0;
+    double maxUs = ScopeTimerTicksToNanoseconds(node.m_maxTicks) / 1000.0;
+    Console::instance->PrintLine(Stringf("%-30s%10u%10.03fms%10.02fus%10.02fus", tag.c_str(), node.m_numCalls, totalMs, averageUs, maxUs));
+
+    for (int i = nodeIndex + 1; i < (int)nodes.size(); ++i)
+    {
+        if (nodes[i].m_parentIndex == nodeIndex)
+        {
+            PrintScopeTreeNode(nodes, i);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profilescopes)
+{
+    UNUSED(args);
+    std::vector<ScopeTreeNode, UntrackedAllocator<ScopeTreeNode>> nodes;
+    for (ScopeTimerRing* ring = GetScopeTimerRings(); ring != nullptr; ring = ring->m_nextRing)
+    {
+        //Threads that have exited don't get listed, their ring's waiting for someone new.
+        if (!ring->m_isOwned.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+        BuildScopeTree(ring, nodes);
+        unsigned int numWritten = ring->m_numWritten.load() - ring->m_ownerFirstIndex.load();
+        unsigned int numScopes = numWritten < ScopeTimerRing::NUM_SCOPES ? numWritten : ScopeTimerRing::NUM_SCOPES;
+        Console::instance->PrintLine(Stringf("---Thread %lu, last %u scopes---", ring->m_threadId.load(std::memory_order_relaxed), numScopes), RGBA::CERULEAN);
+        Console::instance->PrintLine(Stringf("%-30s%10s%12s%12s%12s", "SCOPE", "CALLS", "TOTAL", "AVG", "MAX"), RGBA::VAPORWAVE);
+        for (int i = 0; i < (int)nodes.size(); ++i)
+        {
+            if (nodes[i].m_parentIndex == -1)
+            {
+                PrintScopeTreeNode(nodes, i);
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/ProfilingUtils.h"
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+#ifdef WIN32
+#include <intrin.h>
+#else
+#include <chrono>
+#endif
+
+//-----------------------------------------------------------------------------------
+//One finished scope. Trees are rebuilt from the start/end ticks and depth when someone asks for a report.
+struct TimedScope
+{
+    const char* m_name;
+    uint64_t m_startTicks;
+    uint64_t m_endTicks;
+    unsigned int m_depth;
+};
+
+//-----------------------------------------------------------------------------------
+//Only the owning thread writes. Once full, the oldest scopes get overwritten.
+//When the owner exits the ring goes back up for grabs, and the next thread to time a scope takes it over.
+struct ScopeTimerRing
+{
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int NUM_SCOPES = 4096; //Must be a power of two
+    static const unsigned int SCOPE_INDEX_MASK = NUM_SCOPES - 1;
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    ScopeTimerRing(unsigned long threadId);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    TimedScope m_scopes[NUM_SCOPES];
+    std::atomic<unsigned int> m_numWritten; //Ever, across every owner, so readers can tell how much has wrapped
+    std::atomic<unsigned int> m_ownerFirstIndex; //m_numWritten when the current owner took over. Anything before it was a previous owner's
+    std::atomic<unsigned long> m_threadId;
+    std::atomic<bool> m_isOwned;
+    unsigned int m_depth;
+    ScopeTimerRing* m_nextRing;
+};
+
+//GLOBAL VARIABLES/////////////////////////////////////////////////////////////////////
+extern thread_local ScopeTimerRing* t_scopeTimerRing;
+
+//-----------------------------------------------------------------------------------
+//Every scope with the same name under the same parent, merged.
+struct ScopeTreeNode
+{
+    const char* m_name;
+    int m_parentIndex; //-1 for roots
+    unsigned int m_depth;
+    unsigned int m_numCalls;
+    uint64_t m_totalTicks;
+    uint64_t m_maxTicks;
+};
+
+//FUNCTIONS/////////////////////////////////////////////////////////////////////
+ScopeTimerRing* CreateScopeTimerRingForThisThread();
+ScopeTimerRing* GetScopeTimerRings();
+double ScopeTimerTicksToNanoseconds(uint64_t ticks);
+void BuildScopeTree(ScopeTimerRing* ring, std::vector<ScopeTreeNode, UntrackedAllocator<ScopeTreeNode>>& outNodes);
+
+//-----------------------------------------------------------------------------------
+//Raw TSC on Windows. Assumes an invariant TSC, which everything we ship on has had for years.
+inline uint64_t ReadScopeTimerTicks()
+{
+#ifdef WIN32
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//-----------------------------------------------------------------------------------
+//Much lighter than PushSample/PopSample: two timestamps and one ring write, no strings or pool allocation.
+class ScopeTimer
+{
+public:
+    inline ScopeTimer(const char* staticName)
+        : m_name(staticName)
+        , m_ring(t_scopeTimerRing ? t_scopeTimerRing : CreateScopeTimerRingForThisThread())
+    {
+        ++m_ring->m_depth;
+        m_startTicks = ReadScopeTimerTicks();
+    }
+
+    inline ~ScopeTimer()
+    {
+        uint64_t endTicks = ReadScopeTimerTicks();
+        unsigned int index = m_ring->m_numWritten.load(std::memory_order_relaxed);
+        TimedScope& scope = m_ring->m_scopes[index & ScopeTimerRing::SCOPE_INDEX_MASK];
+        scope.m_name = m_name;
+        scope.m_startTicks = m_startTicks;
+        scope.m_endTicks = endTicks;
+        scope.m_depth = --m_ring->m_depth;
+        m_ring->m_numWritten.store(index + 1, std::memory_order_release);
+    }
+
+private:
+    const char* m_name;
+    ScopeTimerRing* m_ring;
+    uint64_t m_startTicks;
+};
+
+//The name has to outlive the report, so only pass string literals.
+#ifdef PROFILING_ENABLED
+    #define PROFILE_SCOPE(NAME) ScopeTimer COMBINE(scopeTimer, __LINE__)(NAME)
+#else
+    #define PROFILE_SCOPE(NAME)
+#endif // PROFILING_ENABLED
@@ -0,0 +1,80 @@
+#pragma once
+#include "Engine/Core/StringUtils.hpp"
+
+//-----------------------------------------------------------------------------------
+//A string that lives entirely inside the object, so building one never touches the heap. Anything past CAPACITY - 1 characters
+//gets cut off (never partway through a UTF-8 character) and IsTruncated() starts returning true.
+template <size_t CAPACITY>
+class StackString
+{
+public:
+    static_assert(CAPACITY > 0, "StackString needs room for the null terminator.");
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    StackString() : m_length(0), m_isTruncated(false) { m_data[0] = '\0'; };
+    StackString(const StringView& text) : m_length(0), m_isTruncated(false) { m_data[0] = '\0'; Append(text); };
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    inline const char* c_str() const { return m_data; };
+    inline size_t GetLength() const { return m_length; };
+    inline bool IsEmpty() const { return m_length == 0; };
+    inline bool IsTruncated() const { return m_isTruncated; };
+    inline operator StringView() const { return StringView(m_data, m_length); };
+
+    //-----------------------------------------------------------------------------------
+    void Clear()
+    {
+        m_length = 0;
+        m_data[0] = '\0';
+        m_isTruncated = false;
+    }
+
+    //-----------------------------------------------------------------------------------
+    StackString& Append(const StringView& text)
+    {
+        size_t spaceLeft = CAPACITY - 1 - m_length;
+        size_t lengthToCopy = text.m_length;
+        if (lengthToCopy > spaceLeft)
+        {
+            lengthToCopy = GetUtf8SafeLength(text.m_data, text.m_length, spaceLeft);
+            m_isTruncated = true;
+        }
+        memcpy(m_data + m_length, text.m_data, lengthToCopy);
+        m_length += lengthToCopy;
+        m_data[m_length] = '\0';
+        return *this;
+    }
+
+    //-----------------------------------------------------------------------------------
+    StackString& Format(const char* format, ...)
+    {
+        va_list variableArgumentList;
+        va_start(variableArgumentList, format);
+        m_length = VFormatTo(m_data, CAPACITY, format, variableArgumentList, &m_isTruncated);
+        va_end(variableArgumentList);
+        return *this;
+    }
+
+    //-----------------------------------------------------------------------------------
+    StackString& AppendFormat(const char* format, ...)
+    {
+        bool wasTruncated = false;
+        va_list variableArgumentList;
+        va_start(variableArgumentList, format);
+        m_length += VFormatTo(m_data + m_length, CAPACITY - m_length, format, variableArgumentList, &wasTruncated);
+        va_end(variableArgumentList);
+        m_isTruncated = m_isTruncated || wasTruncated;
+        return *this;
+    }
+
+    //-----------------------------------------------------------------------------------
+    inline StackString& operator+=(const StringView& text) { return Append(text); };
+    inline bool operator==(const StringView& other) const { return StringView(*this) == other; };
+    inline bool operator!=(const StringView& other) const { return StringView(*this) != other; };
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    char m_data[CAPACITY];
+    size_t m_length;
+    bool m_isTruncated;
+};
@@ -2,6 +2,11 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include <stdarg.h>
 #include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cfloat>
+#include <climits>
+#include <cmath>
 #include <wtypes.h>
 
 //-----------------------------------------------------------------------------------------------
@@ -10,19 +15,101 @@
 //-----------------------------------------------------------------------------------------------
 const int STRINGF_STACK_LOCAL_TEMP_LENGTH = 2048;
 
+//-----------------------------------------------------------------------------------------------
+const int CSTRINGF_NUM_BUFFERS = 8;
+
 //-----------------------------------------------------------------------------------------------
 const char* CStringf(const char* format, ...)
 {
-    char* textLiteral = new char[STRINGF_STACK_LOCAL_TEMP_LENGTH];
+    static thread_local char t_buffers[CSTRINGF_NUM_BUFFERS][STRINGF_STACK_LOCAL_TEMP_LENGTH];
+    static thread_local int t_nextBufferIndex = 0;
+    char* textLiteral = t_buffers[t_nextBufferIndex];
+    t_nextBufferIndex = (t_nextBufferIndex + 1) % CSTRINGF_NUM_BUFFERS;
+
     va_list variableArgumentList;
     va_start(variableArgumentList, format);
-    vsnprintf_s(textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, variableArgumentList);
+    VFormatTo(textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, format, variableArgumentList);
     va_end(variableArgumentList);
-    textLiteral[STRINGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
     return textLiteral;
 }
 
+//-----------------------------------------------------------------------------------------------
+size_t FormatTo(char* buffer, size_t bufferSize, const char* format, ...)
+{
+    va_list variableArgumentList;
+    va_start(variableArgumentList, format);
+    size_t length = VFormatTo(buffer, bufferSize, format, variableArgumentList);
+    va_end(variableArgumentList);
+    return length;
+}
+
+//-----------------------------------------------------------------------------------------------
+size_t VFormatTo(char* buffer, size_t bufferSize, const char* format, va_list variableArgumentList, bool* outWasTruncated)
+{
+    if (outWasTruncated)
+    {
+        *outWasTruncated = false;
+    }
+    if (bufferSize == 0)
+    {
+        return 0;
+    }
+
+    int result = vsnprintf_s(buffer, bufferSize, _TRUNCATE, format, variableArgumentList);
+    if (result >= 0)
+    {
+        return (size_t)result;
+    }
+
+    //Either it didn't fit, or the format was bad. Whatever made it into the buffer is what we keep.
+    buffer[bufferSize - 1] = '\0';
+    size_t length = strlen(buffer);
+    if (length == bufferSize - 1)
+    {
+        length = GetUtf8SafeLength(buffer, length, length);
+        buffer[length] = '\0';
+        if (outWasTruncated)
+        {
+            *outWasTruncated = true;
+        }
+    }
+    return length;
+}
+
+//-----------------------------------------------------------------------------------------------
+//If the cut lands inside a character, back up to where it starts. Without the text past the cut we check the tail instead,
+//by seeing whether the last lead byte promises more continuation bytes than it got.
+size_t GetUtf8SafeLength(const char* text, size_t textLength, size_t maxLength)
+{
+    if (textLength < maxLength)
+    {
+        return textLength;
+    }
+    if (textLength > maxLength)
+    {
+        size_t length = maxLength;
+        while (length > 0 && ((unsigned char)text[length] & 0xC0) == 0x80)
+        {
+            --length;
+        }
+        return length;
+    }
+
+    size_t leadIndex = maxLength;
+    while (leadIndex > 0 && maxLength - leadIndex < 4)
+    {
+        --leadIndex;
+        unsigned char character = (unsigned char)text[leadIndex];
+        if ((character & 0xC0) != 0x80)
+        {
+            size_t characterLength = (character & 0x80) == 0 ? 1 : (character & 0xE0) == 0xC0 ? 2 : (character & 0xF0) == 0xE0 ? 3 : 4;
+            return leadIndex + characterLength > maxLength ? leadIndex : maxLength;
+        }
+    }
+    return maxLength;
+}
+
 //-----------------------------------------------------------------------------------------------
 const std::string Stringf( const char* format, ... )
 {
@@ -70,6 +157,150 @@ const std::wstring WStringf(const LPWSTR format, ...)
     return std::wstring(textLiteral);
 }
 
+//-----------------------------------------------------------------------------------------------
+size_t StringView::Find(const StringView& toFind, size_t startIndex) const
+{
+    if (toFind.m_length > m_length)
+    {
+        return NOT_FOUND;
+    }
+    size_t lastStartIndex = m_length - toFind.m_length;
+    for (size_t index = startIndex; index <= lastStartIndex; ++index)
+    {
+        if (memcmp(m_data + index, toFind.m_data, toFind.m_length) == 0)
+        {
+            return index;
+        }
+    }
+    return NOT_FOUND;
+}
+
+//-----------------------------------------------------------------------------------------------
+StringView StringView::Substring(size_t startIndex, size_t length) const
+{
+    if (startIndex >= m_length)
+    {
+        return StringView(m_data + m_length, 0);
+    }
+    size_t charactersLeft = m_length - startIndex;
+    return StringView(m_data + startIndex, length < charactersLeft ? length : charactersLeft);
+}
+
+//-----------------------------------------------------------------------------------------------
+//strtol and strtod need a terminator, so the view gets copied somewhere that has one. Nothing that long is a number anyway.
+static bool CopyNumberString(const StringView& view, char(&outNumberString)[64])
+{
+    if (view.m_length >= sizeof(outNumberString))
+    {
+        return false;
+    }
+    memcpy(outNumberString, view.m_data, view.m_length);
+    outNumberString[view.m_length] = '\0';
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+static bool IsOnlyWhitespace(const char* text)
+{
+    while (*text != '\0' && isspace((unsigned char)*text))
+    {
+        ++text;
+    }
+    return *text == '\0';
+}
+
+//-----------------------------------------------------------------------------------------------
+bool StringView::ParseInt(int& outValue) const
+{
+    char numberString[64];
+    if (!CopyNumberString(*this, numberString))
+    {
+        return false;
+    }
+    char* numberEnd = nullptr;
+    errno = 0;
+    long value = strtol(numberString, &numberEnd, 10);
+    if (numberEnd == numberString || !IsOnlyWhitespace(numberEnd) || errno == ERANGE || value < INT_MIN || value > INT_MAX)
+    {
+        return false;
+    }
+    outValue = (int)value;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool StringView::ParseFloat(float& outValue) const
+{
+    char numberString[64];
+    if (!CopyNumberString(*this, numberString))
+    {
+        return false;
+    }
+    char* numberEnd = nullptr;
+    double value = strtod(numberString, &numberEnd);
+    if (numberEnd == numberString || !IsOnlyWhitespace(numberEnd) || !(fabs(value) <= FLT_MAX))
+    {
+        return false;
+    }
+    outValue = (float)value;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+StringTokenizer::StringTokenizer(const StringView& input, const StringView& delimiters, bool splitOnAnyCharacter)
+    : m_input(input)
+    , m_delimiters(delimiters)
+    , m_position(0)
+    , m_splitOnAnyCharacter(splitOnAnyCharacter)
+{
+    if (m_splitOnAnyCharacter)
+    {
+        for (size_t i = 0; i < m_delimiters.m_length; ++i)
+        {
+            ASSERT_OR_DIE(((unsigned char)m_delimiters.m_data[i] & 0x80) == 0, "Splitting on any character only works with ASCII delimiters.");
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+bool StringTokenizer::Next(StringView& outToken)
+{
+    if (m_position == StringView::NOT_FOUND)
+    {
+        return false;
+    }
+
+    size_t tokenEnd = StringView::NOT_FOUND;
+    size_t delimiterLength = m_delimiters.m_length;
+    if (m_splitOnAnyCharacter)
+    {
+        for (size_t index = m_position; index < m_input.m_length && tokenEnd == StringView::NOT_FOUND; ++index)
+        {
+            if (memchr(m_delimiters.m_data, m_input.m_data[index], m_delimiters.m_length))
+            {
+                tokenEnd = index;
+            }
+        }
+        delimiterLength = 1;
+    }
+    else if (m_delimiters.m_length > 0)
+    {
+        tokenEnd = m_input.Find(m_delimiters, m_position);
+    }
+
+    if (tokenEnd == StringView::NOT_FOUND)
+    {
+        outToken = m_input.Substring(m_position);
+        m_position = StringView::NOT_FOUND;
+    }
+    else
+    {
+        outToken = StringView(m_input.m_data + m_position, tokenEnd - m_position);
+        m_position = tokenEnd + delimiterLength;
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------------------------------
 //Modified from http://stackoverflow.com/a/325000/2619871
 //Returns a new vector with the tokenized string pieces.
@@ -3,11 +3,97 @@
 // Based on code written by Squirrel Eiserloh
 #include <string>
 #include <vector>
+#include <cstring>
+#include <stdarg.h>
 #include "Engine/Renderer/RGBA.hpp"
 #include <wtypes.h>
 
 //-----------------------------------------------------------------------------------------------
-const char* CStringf(const char* format, ...); //This function leaks memory like nobody's business.
+//A pointer and a length into someone else's characters, which don't have to be null terminated. Stand-in for std::string_view until we're on C++17.
+struct StringView
+{
+    StringView() : m_data(""), m_length(0) {};
+    StringView(const char* cString) : m_data(cString ? cString : ""), m_length(cString ? strlen(cString) : 0) {};
+    StringView(const char* data, size_t length) : m_data(data), m_length(length) {};
+    StringView(const std::string& string) : m_data(string.c_str()), m_length(string.size()) {};
+
+    inline bool IsEmpty() const { return m_length == 0; };
+    inline bool operator==(const StringView& other) const { return m_length == other.m_length && memcmp(m_data, other.m_data, m_length) == 0; };
+    inline bool operator!=(const StringView& other) const { return !(*this == other); };
+    inline std::string ToString() const { return std::string(m_data, m_length); };
+    size_t Find(const StringView& toFind, size_t startIndex = 0) const;
+    StringView Substring(size_t startIndex, size_t length = NOT_FOUND) const;
+    //Same parsing as strtol/strtod, but stops at the end of the view. Whitespace around the number is fine, anything else
+    //(or nothing at all, or a number that doesn't fit) returns false and leaves outValue alone.
+    bool ParseInt(int& outValue) const;
+    bool ParseFloat(float& outValue) const;
+
+    static const size_t NOT_FOUND = (size_t)-1;
+
+    const char* m_data;
+    size_t m_length;
+};
+
+//-----------------------------------------------------------------------------------------------
+//Walks the pieces of a string between delimiters without copying any of them, the same pieces SplitString would give you:
+//"a,,b," on "," is "a", "", "b", "". Use it with Next() or a range-based for.
+//Delimiters are matched on whole bytes, so ASCII delimiters never split a UTF-8 character.
+class StringTokenizer
+{
+public:
+    //-----------------------------------------------------------------------------------------------
+    class Iterator
+    {
+    public:
+        Iterator(StringTokenizer* tokenizer) : m_tokenizer(tokenizer) { ++(*this); };
+        inline const StringView& operator*() const { return m_token; };
+        inline bool operator!=(const Iterator& other) const { return m_tokenizer != other.m_tokenizer; };
+        inline Iterator& operator++() { if (m_tokenizer && !m_tokenizer->Next(m_token)) { m_tokenizer = nullptr; } return *this; };
+
+    private:
+        StringTokenizer* m_tokenizer; //nullptr once we've run out of tokens
+        StringView m_token;
+    };
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    //With splitOnAnyCharacter, every character in delimiters is its own delimiter, and they all have to be ASCII.
+    StringTokenizer(const StringView& input, const StringView& delimiters, bool splitOnAnyCharacter = false);
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    bool Next(StringView& outToken);
+    inline Iterator begin() { return Iterator(this); };
+    inline Iterator end() { return Iterator(nullptr); };
+
+private:
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    StringView m_input;
+    StringView m_delimiters;
+    size_t m_position; //NOT_FOUND once the last token's been handed out
+    bool m_splitOnAnyCharacter;
+};
+
+//-----------------------------------------------------------------------------------------------
+//Formats straight into a buffer you own. Always null terminates, and if the text doesn't fit it's cut short without splitting a UTF-8 character.
+//Returns how many characters were written, not counting the terminator.
+size_t FormatTo(char* buffer, size_t bufferSize, const char* format, ...);
+size_t VFormatTo(char* buffer, size_t bufferSize, const char* format, va_list variableArgumentList, bool* outWasTruncated = nullptr);
+//Largest length up to maxLength that doesn't end partway through a UTF-8 character.
+size_t GetUtf8SafeLength(const char* text, size_t textLength, size_t maxLength);
+
+//-----------------------------------------------------------------------------------------------
+template <size_t BUFFER_SIZE>
+size_t FormatTo(char(&buffer)[BUFFER_SIZE], const char* format, ...)
+{
+    va_list variableArgumentList;
+    va_start(variableArgumentList, format);
+    size_t length = VFormatTo(buffer, BUFFER_SIZE, format, variableArgumentList);
+    va_end(variableArgumentList);
+    return length;
+}
+
+//-----------------------------------------------------------------------------------------------
+//Hands out a thread local buffer that gets reused after CSTRINGF_NUM_BUFFERS more calls on the same thread, so copy it if you need to keep it.
+const char* CStringf(const char* format, ...);
 const std::string Stringf( const char* format, ... );
 const std::string Stringf( const int maxLength, const char* format, ... );
 const std::wstring WStringf(const LPWSTR format, ...);
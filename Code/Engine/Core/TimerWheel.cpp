@@ -0,0 +1,427 @@
+#include "Engine/Core/TimerWheel.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Time/Time.hpp"
+#include <algorithm>
+#include <cmath>
+
+const double TimerWheel::DEFAULT_SECONDS_PER_TICK = 0.001;
+
+//-----------------------------------------------------------------------------------
+static inline void InitializeList(TimerListLink& sentinel)
+{
+    sentinel.m_next = &sentinel;
+    sentinel.m_previous = &sentinel;
+}
+
+//-----------------------------------------------------------------------------------
+static inline bool IsListEmpty(const TimerListLink& sentinel)
+{
+    return sentinel.m_next == &sentinel;
+}
+
+//-----------------------------------------------------------------------------------
+static inline void AppendToList(TimerListLink& sentinel, TimerListLink* link)
+{
+    link->m_previous = sentinel.m_previous;
+    link->m_next = &sentinel;
+    sentinel.m_previous->m_next = link;
+    sentinel.m_previous = link;
+}
+
+//-----------------------------------------------------------------------------------
+static inline void UnlinkFromList(TimerListLink* link)
+{
+    link->m_previous->m_next = link->m_next;
+    link->m_next->m_previous = link->m_previous;
+    link->m_next = link;
+    link->m_previous = link;
+}
+
+//-----------------------------------------------------------------------------------
+//Moves everything in source onto the end of destination in one go, leaving source empty.
+static inline void SpliceList(TimerListLink& source, TimerListLink& destination)
+{
+    if (IsListEmpty(source))
+    {
+        return;
+    }
+    source.m_next->m_previous = destination.m_previous;
+    destination.m_previous->m_next = source.m_next;
+    source.m_previous->m_next = &destination;
+    destination.m_previous = source.m_previous;
+    InitializeList(source);
+}
+
+//-----------------------------------------------------------------------------------
+TimerWheel::TimerWheel(TimerClockFunction clock, double secondsPerTick)
+    : m_freeNodes(nullptr)
+    , m_clock(clock ? clock : &GetCurrentTimeSeconds)
+    , m_secondsPerTick(secondsPerTick)
+    , m_currentTick(0)
+    , m_targetTick(0)
+    , m_nextSequence(0)
+    , m_numScheduledTimers(0)
+    , m_isAdvancing(false)
+{
+    for (unsigned int level = 0; level < NUM_LEVELS; ++level)
+    {
+        for (unsigned int slotIndex = 0; slotIndex < SLOTS_PER_LEVEL; ++slotIndex)
+        {
+            InitializeList(m_slots[level][slotIndex]);
+        }
+    }
+    InitializeList(m_detachedNodes);
+    for (unsigned int level = 0; level < NUM_LEVELS; ++level)
+    {
+        m_numTimersInLevel[level] = 0;
+    }
+    m_currentTick = SecondsToTicks(m_clock());
+}
+
+//-----------------------------------------------------------------------------------
+TimerWheel::~TimerWheel()
+{
+    CancelAll();
+    for (TimerNode* block : m_nodeBlocks)
+    {
+        delete[] block;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+TimerHandle TimerWheel::Schedule(TimerFunction function, void* data, float delaySeconds, float repeatSeconds)
+{
+    TimerNode* node = AllocateNode();
+    node->m_function = function;
+    node->m_data = data;
+    node->m_destroyData = nullptr;
+    return ScheduleNode(node, delaySeconds, repeatSeconds);
+}
+
+//-----------------------------------------------------------------------------------
+bool TimerWheel::Cancel(TimerHandle& handle)
+{
+    TimerNode* node = handle.m_node;
+    bool wasCancelled = false;
+    if (node && node->m_generation == handle.m_generation)
+    {
+        if (node->m_state == TIMER_SCHEDULED)
+        {
+            UnlinkNode(node);
+            --m_numScheduledTimers;
+            FreeNode(node);
+            wasCancelled = true;
+        }
+        else if (node->m_state == TIMER_FIRING && node->m_intervalTicks > 0)
+        {
+            //It's our own callback, so let FireNode clean up once it returns.
+            node->m_state = TIMER_CANCELLED_WHILE_FIRING;
+            wasCancelled = true;
+        }
+    }
+    handle = TimerHandle();
+    return wasCancelled;
+}
+
+//-----------------------------------------------------------------------------------
+bool TimerWheel::IsScheduled(const TimerHandle& handle) const
+{
+    const TimerNode* node = handle.m_node;
+    if (!node || node->m_generation != handle.m_generation)
+    {
+        return false;
+    }
+    return node->m_state == TIMER_SCHEDULED || (node->m_state == TIMER_FIRING && node->m_intervalTicks > 0);
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int TimerWheel::Update()
+{
+    return AdvanceToTick(SecondsToTicks(m_clock()));
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int TimerWheel::AdvanceToTick(uint64_t targetTick)
+{
+    if (m_isAdvancing)
+    {
+        ERROR_RECOVERABLE("Timers can't advance the wheel they're firing from.");
+        return 0;
+    }
+    m_isAdvancing = true;
+    m_targetTick = targetTick;
+    unsigned int numFired = 0;
+    while (m_currentTick < targetTick)
+    {
+        if (m_numScheduledTimers == 0)
+        {
+            //Nothing to cascade or fire, so skip straight there.
+            m_currentTick = targetTick;
+            break;
+        }
+
+        //Timers only move down a level when the one below wraps, so while the low levels are empty we can jump to the tick before their next wrap.
+        uint64_t lastQuietTick = m_currentTick;
+        for (unsigned int level = 0; level < NUM_LEVELS - 1 && m_numTimersInLevel[level] == 0; ++level)
+        {
+            lastQuietTick = m_currentTick | (((uint64_t)1 << (BITS_PER_LEVEL * (level + 1))) - 1);
+        }
+        if (lastQuietTick > m_currentTick)
+        {
+            m_currentTick = std::min(lastQuietTick, targetTick);
+            continue;
+        }
+        ++m_currentTick;
+        numFired += ProcessTick();
+    }
+    m_isAdvancing = false;
+    return numFired;
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int TimerWheel::FlushAll()
+{
+    if (m_isAdvancing)
+    {
+        ERROR_RECOVERABLE("Timers can't flush the wheel they're firing from.");
+        return 0;
+    }
+    m_isAdvancing = true;
+    unsigned int numFired = 0;
+    //Anything the callbacks schedule goes into the wheel, and gets flushed by the next pass.
+    while (m_numScheduledTimers > 0)
+    {
+        for (unsigned int level = 0; level < NUM_LEVELS; ++level)
+        {
+            for (unsigned int slotIndex = 0; slotIndex < SLOTS_PER_LEVEL; ++slotIndex)
+            {
+                SpliceList(m_slots[level][slotIndex], m_detachedNodes);
+            }
+        }
+
+        m_dueTimers.clear();
+        for (TimerListLink* link = m_detachedNodes.m_next; link != &m_detachedNodes; link = link->m_next)
+        {
+            TimerNode* node = static_cast<TimerNode*>(link);
+            node->m_intervalTicks = 0;
+            DueTimer dueTimer = { node, node->m_generation };
+            m_dueTimers.push_back(dueTimer);
+        }
+        std::sort(m_dueTimers.begin(), m_dueTimers.end(), [](const DueTimer& first, const DueTimer& second)
+        {
+            return first.m_node->m_expirationTick != second.m_node->m_expirationTick ? first.m_node->m_expirationTick < second.m_node->m_expirationTick : first.m_node->m_sequence < second.m_node->m_sequence;
+        });
+
+        for (const DueTimer& dueTimer : m_dueTimers)
+        {
+            //Anything an earlier callback cancelled has a new generation by now, even if it's been reused.
+            if (dueTimer.m_node->m_generation == dueTimer.m_generation && dueTimer.m_node->m_state == TIMER_SCHEDULED)
+            {
+                FireNode(dueTimer.m_node);
+                ++numFired;
+            }
+        }
+    }
+    m_isAdvancing = false;
+    return numFired;
+}
+
+//-----------------------------------------------------------------------------------
+void TimerWheel::CancelAll()
+{
+    for (unsigned int level = 0; level < NUM_LEVELS; ++level)
+    {
+        for (unsigned int slotIndex = 0; slotIndex < SLOTS_PER_LEVEL; ++slotIndex)
+        {
+            SpliceList(m_slots[level][slotIndex], m_detachedNodes);
+        }
+    }
+    while (!IsListEmpty(m_detachedNodes))
+    {
+        TimerNode* node = static_cast<TimerNode*>(m_detachedNodes.m_next);
+        UnlinkNode(node);
+        FreeNode(node);
+    }
+    m_numScheduledTimers = 0;
+}
+
+//-----------------------------------------------------------------------------------
+TimerNode* TimerWheel::AllocateNode()
+{
+    if (!m_freeNodes)
+    {
+        TimerNode* block = new TimerNode[NODES_PER_BLOCK];
+        m_nodeBlocks.push_back(block);
+        for (unsigned int i = 0; i < NODES_PER_BLOCK; ++i)
+        {
+            block[i].m_generation = 0;
+            block[i].m_state = TIMER_FREE;
+            block[i].m_next = i + 1 < NODES_PER_BLOCK ? &block[i + 1] : nullptr;
+        }
+        m_freeNodes = block;
+    }
+    TimerNode* node = m_freeNodes;
+    m_freeNodes = static_cast<TimerNode*>(node->m_next);
+    return node;
+}
+
+//-----------------------------------------------------------------------------------
+void TimerWheel::FreeNode(TimerNode* node)
+{
+    if (node->m_destroyData)
+    {
+        node->m_destroyData(node->m_data);
+    }
+    ++node->m_generation;
+    node->m_state = TIMER_FREE;
+    node->m_next = m_freeNodes;
+    m_freeNodes = node;
+}
+
+//-----------------------------------------------------------------------------------
+//Delays are measured from the clock, not the last tick we processed, so scheduling from a wheel that hasn't been updated in a while still waits the full delay.
+TimerHandle TimerWheel::ScheduleNode(TimerNode* node, float delaySeconds, float repeatSeconds)
+{
+    uint64_t nowTick = std::max(SecondsToTicks(m_clock()), m_currentTick);
+    node->m_expirationTick = nowTick + std::max(RoundSecondsToTicks(delaySeconds), (uint64_t)1);
+    node->m_intervalTicks = repeatSeconds > 0.0f ? std::max(RoundSecondsToTicks(repeatSeconds), (uint64_t)1) : 0;
+    node->m_sequence = m_nextSequence++;
+    node->m_state = TIMER_SCHEDULED;
+    InsertNode(node);
+    ++m_numScheduledTimers;
+
+    TimerHandle handle;
+    handle.m_node = node;
+    handle.m_generation = node->m_generation;
+    return handle;
+}
+
+//-----------------------------------------------------------------------------------
+//Each level is picked by how far out the timer is, and the slot within it by the matching bits of its expiration tick.
+void TimerWheel::InsertNode(TimerNode* node)
+{
+    uint64_t ticksUntilExpiration = node->m_expirationTick > m_currentTick ? node->m_expirationTick - m_currentTick : 0;
+    uint64_t placementTick = ticksUntilExpiration > 0 ? node->m_expirationTick : m_currentTick;
+    unsigned int level = 0;
+    while (level < NUM_LEVELS - 1 && ticksUntilExpiration >= ((uint64_t)1 << (BITS_PER_LEVEL * (level + 1))))
+    {
+        ++level;
+    }
+    //Past the top level's reach, it parks as far out as it can and gets re-inserted every time it cascades.
+    const uint64_t maxTicksUntilExpiration = ((uint64_t)1 << (BITS_PER_LEVEL * NUM_LEVELS)) - 1;
+    if (ticksUntilExpiration > maxTicksUntilExpiration)
+    {
+        placementTick = m_currentTick + maxTicksUntilExpiration;
+    }
+    unsigned int slotIndex = (unsigned int)(placementTick >> (BITS_PER_LEVEL * level)) & SLOT_MASK;
+    AppendToList(m_slots[level][slotIndex], node);
+    node->m_level = level;
+    ++m_numTimersInLevel[level];
+}
+
+//-----------------------------------------------------------------------------------
+//Works whether the node's still in its slot or has been moved out with the rest of it.
+void TimerWheel::UnlinkNode(TimerNode* node)
+{
+    UnlinkFromList(node);
+    --m_numTimersInLevel[node->m_level];
+}
+
+//-----------------------------------------------------------------------------------
+void TimerWheel::CascadeSlot(unsigned int level, unsigned int slotIndex)
+{
+    SpliceList(m_slots[level][slotIndex], m_detachedNodes);
+    while (!IsListEmpty(m_detachedNodes))
+    {
+        TimerNode* node = static_cast<TimerNode*>(m_detachedNodes.m_next);
+        UnlinkNode(node);
+        InsertNode(node);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int TimerWheel::ProcessTick()
+{
+    //Whenever a level wraps around, the next slot up is close enough to spread out into the levels below.
+    for (unsigned int level = 1; level < NUM_LEVELS; ++level)
+    {
+        if (((m_currentTick >> (BITS_PER_LEVEL * (level - 1))) & SLOT_MASK) != 0)
+        {
+            break;
+        }
+        CascadeSlot(level, (unsigned int)(m_currentTick >> (BITS_PER_LEVEL * level)) & SLOT_MASK);
+    }
+
+    TimerListLink& dueSlot = m_slots[0][m_currentTick & SLOT_MASK];
+    if (IsListEmpty(dueSlot))
+    {
+        return 0;
+    }
+    SpliceList(dueSlot, m_detachedNodes);
+
+    //Cascading appends older timers behind ones scheduled straight into this slot, so put them back in scheduling order.
+    m_dueTimers.clear();
+    bool isInOrder = true;
+    for (TimerListLink* link = m_detachedNodes.m_next; link != &m_detachedNodes; link = link->m_next)
+    {
+        TimerNode* node = static_cast<TimerNode*>(link);
+        isInOrder = isInOrder && (m_dueTimers.empty() || m_dueTimers.back().m_node->m_sequence < node->m_sequence);
+        DueTimer dueTimer = { node, node->m_generation };
+        m_dueTimers.push_back(dueTimer);
+    }
+    if (!isInOrder)
+    {
+        std::sort(m_dueTimers.begin(), m_dueTimers.end(), [](const DueTimer& first, const DueTimer& second) { return first.m_node->m_sequence < second.m_node->m_sequence; });
+    }
+
+    unsigned int numFired = 0;
+    for (const DueTimer& dueTimer : m_dueTimers)
+    {
+        //Anything an earlier callback cancelled has a new generation by now, even if it's been reused.
+        if (dueTimer.m_node->m_generation == dueTimer.m_generation && dueTimer.m_node->m_state == TIMER_SCHEDULED)
+        {
+            FireNode(dueTimer.m_node);
+            ++numFired;
+        }
+    }
+    return numFired;
+}
+
+//-----------------------------------------------------------------------------------
+//Repeating timers stay on the cadence they started with, but fire at most once per advance, so falling behind doesn't make them spiral.
+void TimerWheel::FireNode(TimerNode* node)
+{
+    UnlinkNode(node);
+    --m_numScheduledTimers;
+    node->m_state = TIMER_FIRING;
+    node->m_function(node->m_data);
+
+    if (node->m_state == TIMER_FIRING && node->m_intervalTicks > 0)
+    {
+        node->m_expirationTick += node->m_intervalTicks;
+        if (node->m_expirationTick <= m_targetTick)
+        {
+            node->m_expirationTick += ((m_targetTick - node->m_expirationTick) / node->m_intervalTicks + 1) * node->m_intervalTicks;
+        }
+        node->m_state = TIMER_SCHEDULED;
+        InsertNode(node);
+        ++m_numScheduledTimers;
+    }
+    else
+    {
+        FreeNode(node);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//The epsilon keeps a clock reading that's a hair under a tick boundary from landing a tick early.
+uint64_t TimerWheel::SecondsToTicks(double seconds) const
+{
+    return seconds > 0.0 ? (uint64_t)(seconds / m_secondsPerTick + 1e-6) : 0;
+}
+
+//-----------------------------------------------------------------------------------
+uint64_t TimerWheel::RoundSecondsToTicks(float seconds) const
+{
+    return seconds > 0.0f ? (uint64_t)(seconds / m_secondsPerTick + 0.5) : 0;
+}
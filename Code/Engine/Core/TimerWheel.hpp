@@ -0,0 +1,175 @@
+#pragma once
+#include "Engine/Core/Memory/UntrackedAllocator.hpp"
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <stdint.h>
+
+typedef void(*TimerFunction)(void*);
+typedef double(*TimerClockFunction)();
+
+//-----------------------------------------------------------------------------------
+enum TimerState
+{
+    TIMER_FREE = 0,
+    TIMER_SCHEDULED,
+    TIMER_FIRING,
+    TIMER_CANCELLED_WHILE_FIRING,
+    NUM_TIMER_STATES
+};
+
+//-----------------------------------------------------------------------------------
+//Every wheel slot is a circular list with one of these as its sentinel, so a node can unlink itself without knowing which slot it's in.
+struct TimerListLink
+{
+    TimerListLink* m_next;
+    TimerListLink* m_previous;
+};
+
+//-----------------------------------------------------------------------------------
+//Nodes live in fixed blocks that never move, so a node can point at its own inline callable.
+struct TimerNode : public TimerListLink
+{
+    static const size_t INLINE_CALLABLE_BYTES = 32;
+
+    uint64_t m_expirationTick;
+    uint64_t m_intervalTicks; //0 for one-shot timers
+    uint64_t m_sequence; //Breaks ties between timers due on the same tick, first scheduled fires first
+    TimerFunction m_function;
+    void* m_data;
+    void(*m_destroyData)(void*); //Cleans up a callable we copied, nullptr for plain function + data timers
+    unsigned int m_generation;
+    TimerState m_state;
+    unsigned int m_level; //Which level's count it's in
+    union
+    {
+        unsigned char m_inlineCallable[INLINE_CALLABLE_BYTES];
+        double m_alignment;
+    };
+};
+
+//-----------------------------------------------------------------------------------
+struct DueTimer
+{
+    TimerNode* m_node;
+    unsigned int m_generation;
+};
+
+//-----------------------------------------------------------------------------------
+//Refers to one scheduling of a timer. Goes stale once the timer fires (unless it repeats) or is cancelled, even if the node gets reused.
+struct TimerHandle
+{
+    TimerHandle() : m_node(nullptr), m_generation(0) {};
+    inline bool IsSet() const { return m_node != nullptr; };
+
+    TimerNode* m_node;
+    unsigned int m_generation;
+};
+
+//-----------------------------------------------------------------------------------
+//Hierarchical timer wheel, like the Linux kernel's. Scheduling and cancelling are O(1), and each tick only touches the one slot that's due,
+//plus a cascade from the level above every time a lower level wraps around. Timers due on the same tick fire in the order they were scheduled.
+//Levels cover 256 ticks, 65536 ticks, 2^24 ticks and 2^32 ticks, so at the default 1ms tick a timer can be 49 days out before it has to re-cascade.
+class TimerWheel
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    TimerWheel(TimerClockFunction clock = nullptr, double secondsPerTick = DEFAULT_SECONDS_PER_TICK);
+    ~TimerWheel();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    //A repeatSeconds above 0 keeps firing on that interval until cancelled.
+    TimerHandle Schedule(TimerFunction function, void* data, float delaySeconds, float repeatSeconds = 0.0f);
+    //Returns false if the handle already fired or was cancelled. Safe to call from inside any timer's callback, including its own.
+    bool Cancel(TimerHandle& handle);
+    bool IsScheduled(const TimerHandle& handle) const;
+    //Fires everything that's come due on the clock. Returns how many timers fired.
+    unsigned int Update();
+    unsigned int AdvanceToTick(uint64_t targetTick);
+    //Fires every pending timer once right now, soonest first, and cancels the repeating ones.
+    //Timers scheduled by those callbacks get flushed too, so one that always schedules another never lets this return.
+    unsigned int FlushAll();
+    void CancelAll();
+    inline unsigned int GetNumScheduledTimers() const { return m_numScheduledTimers; };
+    inline uint64_t GetCurrentTick() const { return m_currentTick; };
+
+    //-----------------------------------------------------------------------------------
+    //Small callables are stored in the timer node, bigger ones get copied to the heap.
+    template <typename CB>
+    TimerHandle Schedule(CB callback, float delaySeconds, float repeatSeconds = 0.0f)
+    {
+        TimerNode* node = AllocateNode();
+        if (sizeof(CB) <= TimerNode::INLINE_CALLABLE_BYTES && alignof(CB) <= alignof(double))
+        {
+            node->m_data = new (node->m_inlineCallable) CB(callback);
+            node->m_destroyData = std::is_trivially_destructible<CB>::value ? nullptr : &DestroyInlineCallable<CB>;
+        }
+        else
+        {
+            node->m_data = new CB(callback);
+            node->m_destroyData = &DeleteCallable<CB>;
+        }
+        node->m_function = &InvokeCallable<CB>;
+        return ScheduleNode(node, delaySeconds, repeatSeconds);
+    }
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    template <typename CB>
+    static void InvokeCallable(void* data)
+    {
+        (*static_cast<CB*>(data))();
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <typename CB>
+    static void DestroyInlineCallable(void* data)
+    {
+        static_cast<CB*>(data)->~CB();
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <typename CB>
+    static void DeleteCallable(void* data)
+    {
+        delete static_cast<CB*>(data);
+    }
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const unsigned int BITS_PER_LEVEL = 8;
+    static const unsigned int SLOTS_PER_LEVEL = 1 << BITS_PER_LEVEL;
+    static const unsigned int SLOT_MASK = SLOTS_PER_LEVEL - 1;
+    static const unsigned int NUM_LEVELS = 4;
+    static const unsigned int NODES_PER_BLOCK = 256;
+    static const double DEFAULT_SECONDS_PER_TICK;
+
+private:
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    TimerNode* AllocateNode();
+    void FreeNode(TimerNode* node);
+    TimerHandle ScheduleNode(TimerNode* node, float delaySeconds, float repeatSeconds);
+    void InsertNode(TimerNode* node);
+    void UnlinkNode(TimerNode* node);
+    void CascadeSlot(unsigned int level, unsigned int slotIndex);
+    unsigned int ProcessTick();
+    void FireNode(TimerNode* node);
+    uint64_t SecondsToTicks(double seconds) const;
+    uint64_t RoundSecondsToTicks(float seconds) const;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    TimerListLink m_slots[NUM_LEVELS][SLOTS_PER_LEVEL];
+    TimerListLink m_detachedNodes; //The slot we're cascading or firing, moved out so anything scheduled meanwhile goes into the real wheel
+    std::vector<DueTimer, UntrackedAllocator<DueTimer>> m_dueTimers;
+    std::vector<TimerNode*, UntrackedAllocator<TimerNode*>> m_nodeBlocks;
+    TimerNode* m_freeNodes;
+    TimerClockFunction m_clock;
+    double m_secondsPerTick;
+    uint64_t m_currentTick; //The last tick we processed
+    uint64_t m_targetTick; //Where the current advance is headed
+    uint64_t m_nextSequence;
+    unsigned int m_numScheduledTimers;
+    unsigned int m_numTimersInLevel[NUM_LEVELS]; //Lets us skip ahead to the next wrap when the lower levels are empty
+    bool m_isAdvancing;
+};
@@ -0,0 +1,454 @@
+#include "Engine/Input/BinaryLogging.hpp"
+#include "Engine/Input/InputOutputUtils.hpp"
+#include "Engine/Core/Memory/Buffer.hpp"
+#include "Engine/Input/Console.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Appends one conversion to the output. Returns false once the buffer is full.
+template <typename T>
+static bool AppendFormattedArg(char* outBuffer, size_t bufferSize, size_t& length, const char* spec, T value)
+{
+    int numWritten = _snprintf_s(outBuffer + length, bufferSize - length, _TRUNCATE, spec, value);
+    if (numWritten < 0)
+    {
+        length = bufferSize - 1;
+        return false;
+    }
+    length += (size_t)numWritten;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+static bool AppendText(char* outBuffer, size_t bufferSize, size_t& length, const char* text, size_t textLength)
+{
+    size_t roomLeft = bufferSize - 1 - length;
+    size_t numToCopy = textLength < roomLeft ? textLength : roomLeft;
+    memcpy(outBuffer + length, text, numToCopy);
+    length += numToCopy;
+    return numToCopy == textLength;
+}
+
+//-----------------------------------------------------------------------------------
+static inline bool IsIntegerArg(byte type)
+{
+    return type == BINARY_LOG_INT32 || type == BINARY_LOG_UINT32 || type == BINARY_LOG_INT64 || type == BINARY_LOG_UINT64;
+}
+
+//-----------------------------------------------------------------------------------
+//Returns the size of the argument at the front of args, or 0 if it's malformed or runs off the end.
+static size_t GetEncodedArgSize(const byte* args, size_t argsSize)
+{
+    if (argsSize < 1)
+    {
+        return 0;
+    }
+    size_t size = 0;
+    switch (args[0])
+    {
+    case BINARY_LOG_INT32:
+    case BINARY_LOG_UINT32:
+        size = 1 + sizeof(uint32_t);
+        break;
+    case BINARY_LOG_INT64:
+    case BINARY_LOG_UINT64:
+    case BINARY_LOG_POINTER:
+        size = 1 + sizeof(uint64_t);
+        break;
+    case BINARY_LOG_DOUBLE:
+        size = 1 + sizeof(double);
+        break;
+    case BINARY_LOG_STRING:
+    {
+        if (argsSize < 1 + sizeof(uint16_t))
+        {
+            return 0;
+        }
+        uint16_t stringLength = 0;
+        memcpy(&stringLength, args + 1, sizeof(uint16_t));
+        size = 1 + sizeof(uint16_t) + stringLength;
+        break;
+    }
+    default:
+        return 0;
+    }
+    return size <= argsSize ? size : 0;
+}
+
+//-----------------------------------------------------------------------------------
+//Widens whatever integer got encoded. Only for star widths, %c and %p, where the width it was logged at doesn't change the output.
+static uint64_t ReadEncodedInteger(const byte* arg)
+{
+    switch (arg[0])
+    {
+    case BINARY_LOG_INT32:
+    {
+        int32_t value = 0;
+        memcpy(&value, arg + 1, sizeof(int32_t));
+        return (uint64_t)(int64_t)value;
+    }
+    case BINARY_LOG_UINT32:
+    {
+        uint32_t value = 0;
+        memcpy(&value, arg + 1, sizeof(uint32_t));
+        return (uint64_t)value;
+    }
+    default:
+    {
+        uint64_t value = 0;
+        memcpy(&value, arg + 1, sizeof(uint64_t));
+        return value;
+    }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Formats an integer at the width it was logged at, so %x of a negative int still prints 8 digits like printf would, not 16.
+static bool AppendFormattedInteger(char* outBuffer, size_t bufferSize, size_t& length, char* spec, size_t specLength, char conversion, const byte* arg)
+{
+    if (arg[0] == BINARY_LOG_INT64 || arg[0] == BINARY_LOG_UINT64)
+    {
+        spec[specLength++] = 'l';
+        spec[specLength++] = 'l';
+    }
+    spec[specLength++] = conversion;
+    spec[specLength] = '\0';
+    switch (arg[0])
+    {
+    case BINARY_LOG_INT32:
+    {
+        int32_t value = 0;
+        memcpy(&value, arg + 1, sizeof(int32_t));
+        return AppendFormattedArg(outBuffer, bufferSize, length, spec, (int)value);
+    }
+    case BINARY_LOG_UINT32:
+    {
+        uint32_t value = 0;
+        memcpy(&value, arg + 1, sizeof(uint32_t));
+        return AppendFormattedArg(outBuffer, bufferSize, length, spec, (unsigned int)value);
+    }
+    case BINARY_LOG_INT64:
+    {
+        int64_t value = 0;
+        memcpy(&value, arg + 1, sizeof(int64_t));
+        return AppendFormattedArg(outBuffer, bufferSize, length, spec, (long long)value);
+    }
+    default:
+    {
+        uint64_t value = 0;
+        memcpy(&value, arg + 1, sizeof(uint64_t));
+        return AppendFormattedArg(outBuffer, bufferSize, length, spec, (unsigned long long)value);
+    }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Walks the format string the same way printf would, pulling a type tagged argument for each conversion.
+//Length modifiers in the format are thrown away and rebuilt from the encoded types, so a mismatched %d/%lld can't read garbage.
+//A conversion that doesn't match its argument, or has no argument left, prints as '?' instead.
+size_t FormatBinaryLogArgs(const char* format, const byte* args, size_t argsSize, char* outBuffer, size_t bufferSize)
+{
+    if (bufferSize == 0)
+    {
+        return 0;
+    }
+    size_t length = 0;
+    const byte* argsEnd = args + argsSize;
+    const char* current = format;
+    bool hasRoom = true;
+
+    while (*current != '\0' && hasRoom)
+    {
+        const char* nextPercent = strchr(current, '%');
+        if (!nextPercent)
+        {
+            hasRoom = AppendText(outBuffer, bufferSize, length, current, strlen(current));
+            break;
+        }
+        hasRoom = AppendText(outBuffer, bufferSize, length, current, nextPercent - current);
+        current = nextPercent + 1;
+        if (*current == '%')
+        {
+            hasRoom = hasRoom && AppendText(outBuffer, bufferSize, length, "%", 1);
+            ++current;
+            continue;
+        }
+
+        //Rebuild the spec without its length modifier. Flags, width and precision all carry over as is.
+        char spec[32] = "%";
+        size_t specLength = 1;
+        bool isSpecValid = true;
+        while (*current != '\0' && strchr("-+ #0", *current))
+        {
+            if (specLength < sizeof(spec) - 8) spec[specLength++] = *current;
+            ++current;
+        }
+        for (int widthOrPrecision = 0; widthOrPrecision < 2; ++widthOrPrecision)
+        {
+            if (widthOrPrecision == 1)
+            {
+                if (*current != '.')
+                {
+                    break;
+                }
+                if (specLength < sizeof(spec) - 8) spec[specLength++] = '.';
+                ++current;
+            }
+            if (*current == '*')
+            {
+                //Star widths come from an int argument, so bake that into the spec.
+                size_t argSize = GetEncodedArgSize(args, argsEnd - args);
+                if (argSize == 0 || !IsIntegerArg(args[0]))
+                {
+                    isSpecValid = false;
+                }
+                else
+                {
+                    char starValue[16];
+                    _snprintf_s(starValue, sizeof(starValue), _TRUNCATE, "%i", (int)ReadEncodedInteger(args));
+                    args += argSize;
+                    for (const char* digit = starValue; *digit != '\0'; ++digit)
+                    {
+                        if (specLength < sizeof(spec) - 8) spec[specLength++] = *digit;
+                    }
+                }
+                ++current;
+            }
+            while (*current >= '0' && *current <= '9')
+            {
+                if (specLength < sizeof(spec) - 8) spec[specLength++] = *current;
+                ++current;
+            }
+        }
+        //MSVC's I32/I64 as well as the standard modifiers.
+        while (*current != '\0' && strchr("hlLjztIq", *current))
+        {
+            if (*current == 'I' && ((current[1] == '3' && current[2] == '2') || (current[1] == '6' && current[2] == '4')))
+            {
+                current += 2;
+            }
+            ++current;
+        }
+        char conversion = *current;
+        if (conversion == '\0')
+        {
+            break;
+        }
+        ++current;
+
+        size_t argSize = GetEncodedArgSize(args, argsEnd - args);
+        const byte* arg = args;
+        args += argSize;
+        if (!isSpecValid || argSize == 0)
+        {
+            hasRoom = AppendText(outBuffer, bufferSize, length, "?", 1);
+            continue;
+        }
+
+        byte type = arg[0];
+        switch (conversion)
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            if (!IsIntegerArg(type))
+            {
+                hasRoom = AppendText(outBuffer, bufferSize, length, "?", 1);
+                break;
+            }
+            hasRoom = AppendFormattedInteger(outBuffer, bufferSize, length, spec, specLength, conversion, arg);
+            break;
+        case 'c':
+            if (!IsIntegerArg(type))
+            {
+                hasRoom = AppendText(outBuffer, bufferSize, length, "?", 1);
+                break;
+            }
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+            hasRoom = AppendFormattedArg(outBuffer, bufferSize, length, spec, (int)ReadEncodedInteger(arg));
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            if (type != BINARY_LOG_DOUBLE)
+            {
+                hasRoom = AppendText(outBuffer, bufferSize, length, "?", 1);
+                break;
+            }
+            double value = 0.0;
+            memcpy(&value, arg + 1, sizeof(double));
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+            hasRoom = AppendFormattedArg(outBuffer, bufferSize, length, spec, value);
+            break;
+        }
+        case 's':
+        {
+            if (type != BINARY_LOG_STRING)
+            {
+                hasRoom = AppendText(outBuffer, bufferSize, length, "?", 1);
+                break;
+            }
+            //The copy in the record isn't terminated.
+            char stringValue[MAX_BINARY_LOG_STRING_LENGTH + 1];
+            size_t stringLength = argSize - 1 - sizeof(uint16_t);
+            memcpy(stringValue, arg + 1 + sizeof(uint16_t), stringLength);
+            stringValue[stringLength] = '\0';
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+            hasRoom = AppendFormattedArg(outBuffer, bufferSize, length, spec, (const char*)stringValue);
+            break;
+        }
+        case 'p':
+            if (type != BINARY_LOG_POINTER)
+            {
+                hasRoom = AppendText(outBuffer, bufferSize, length, "?", 1);
+                break;
+            }
+            //Always print all 64 bits, the log might have come from a build with wider pointers than ours.
+            hasRoom = AppendFormattedArg(outBuffer, bufferSize, length, "0x%016llX", (unsigned long long)ReadEncodedInteger(arg));
+            break;
+        default:
+            //%n and anything we don't recognize.
+            hasRoom = AppendText(outBuffer, bufferSize, length, "?", 1);
+            break;
+        }
+    }
+    outBuffer[length] = '\0';
+    return length;
+}
+
+//-----------------------------------------------------------------------------------
+//Turns a file written by Logger::StartBinaryLog back into the same text the normal log would've had.
+bool DecodeBinaryLogFile(const char* binaryLogPath, const char* textLogPath)
+{
+    Buffer fileBuffer;
+    if (!FileReadIntoBuffer(binaryLogPath, fileBuffer))
+    {
+        return false;
+    }
+    const byte* current = fileBuffer.GetData();
+    const byte* end = current + fileBuffer.GetSize();
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (fileBuffer.GetSize() < sizeof(uint32_t) * 2)
+    {
+        return false;
+    }
+    memcpy(&magic, current, sizeof(uint32_t));
+    memcpy(&version, current + sizeof(uint32_t), sizeof(uint32_t));
+    if (magic != BINARY_LOG_FILE_MAGIC || version != BINARY_LOG_FILE_VERSION)
+    {
+        return false;
+    }
+    current += sizeof(uint32_t) * 2;
+
+    FILE* textFile = nullptr;
+    errno_t errorCode = fopen_s(&textFile, textLogPath, "wb");
+    if (errorCode != 0x0)
+    {
+        return false;
+    }
+
+    //Format ids are handed out in order, so the index into this is the id.
+    std::vector<std::string> formats;
+    char formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH];
+    bool isValid = true;
+    while (current < end && isValid)
+    {
+        byte chunkType = *current++;
+        if (chunkType == BINARY_LOG_CHUNK_FORMAT && end - current >= (ptrdiff_t)(sizeof(uint32_t) * 2))
+        {
+            uint32_t formatId = 0;
+            uint32_t formatLength = 0;
+            memcpy(&formatId, current, sizeof(uint32_t));
+            memcpy(&formatLength, current + sizeof(uint32_t), sizeof(uint32_t));
+            current += sizeof(uint32_t) * 2;
+            isValid = formatId == formats.size() && (size_t)(end - current) >= formatLength;
+            if (isValid)
+            {
+                formats.push_back(std::string(reinterpret_cast<const char*>(current), formatLength));
+                current += formatLength;
+            }
+        }
+        else if (chunkType == BINARY_LOG_CHUNK_MESSAGE && end - current >= (ptrdiff_t)(sizeof(uint32_t) * 2 + sizeof(uint16_t)))
+        {
+            uint32_t formatId = 0;
+            uint32_t argsSize = 0;
+            memcpy(&formatId, current, sizeof(uint32_t));
+            memcpy(&argsSize, current + sizeof(uint32_t) + sizeof(uint16_t), sizeof(uint32_t));
+            current += sizeof(uint32_t) * 2 + sizeof(uint16_t);
+            isValid = formatId < formats.size() && (size_t)(end - current) >= argsSize;
+            if (isValid)
+            {
+                size_t length = FormatBinaryLogArgs(formats[formatId].c_str(), current, argsSize, formattedMessage, LOGF_STACK_LOCAL_TEMP_LENGTH);
+                fwrite(formattedMessage, sizeof(unsigned char), length, textFile);
+                current += argsSize;
+            }
+        }
+        else
+        {
+            isValid = false;
+        }
+    }
+    fclose(textFile);
+    return isValid;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(logbinarystart)
+{
+    if (!args.HasArgs(1) || !Logger::instance)
+    {
+        Console::instance->PrintLine("logbinarystart <file path>", RGBA::RED);
+        return;
+    }
+    std::string filePath = args.GetStringArgument(0);
+    if (!Logger::instance->StartBinaryLog(filePath.c_str()))
+    {
+        Console::instance->PrintLine(Stringf("Couldn't open '%s' for the binary log.", filePath.c_str()), RGBA::RED);
+        return;
+    }
+    Console::instance->PrintLine(Stringf("Writing binary log records to '%s'.", filePath.c_str()), RGBA::GBLIGHTGREEN);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(logbinarystop)
+{
+    UNUSED(args);
+    if (!Logger::instance)
+    {
+        return;
+    }
+    Logger::instance->StopBinaryLog();
+    Console::instance->PrintLine("Binary log records are going to the text log again.", RGBA::GBLIGHTGREEN);
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(logdecode)
+{
+    if (!args.HasArgs(2))
+    {
+        Console::instance->PrintLine("logdecode <binary log path> <text output path>", RGBA::RED);
+        return;
+    }
+    std::string binaryLogPath = args.GetStringArgument(0);
+    std::string textLogPath = args.GetStringArgument(1);
+    if (!DecodeBinaryLogFile(binaryLogPath.c_str(), textLogPath.c_str()))
+    {
+        Console::instance->PrintLine(Stringf("Couldn't decode '%s', it's missing or not a binary log.", binaryLogPath.c_str()), RGBA::RED);
+        return;
+    }
+    Console::instance->PrintLine(Stringf("Decoded '%s' into '%s'.", binaryLogPath.c_str(), textLogPath.c_str()), RGBA::GBLIGHTGREEN);
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Input/Logging.hpp"
+#include <string.h>
+#include <stdint.h>
+
+//Deferred format logging. LogBinary copies the format string's address and the raw arguments into the thread's log buffer,
+//and the printf style formatting happens later on the writer thread, or never if the binary log gets decoded offline.
+//The format string is used as its own id, so it has to be a string literal or otherwise live for the whole run.
+
+//-----------------------------------------------------------------------------------
+enum BinaryLogArgType
+{
+    BINARY_LOG_INT32 = 0,
+    BINARY_LOG_UINT32,
+    BINARY_LOG_INT64,
+    BINARY_LOG_UINT64,
+    BINARY_LOG_DOUBLE,
+    BINARY_LOG_STRING, //Copied, since the string might not outlive the call
+    BINARY_LOG_POINTER,
+    NUM_BINARY_LOG_ARG_TYPES
+};
+
+//CONSTANTS/////////////////////////////////////////////////////////////////////
+static const uint16_t MAX_BINARY_LOG_STRING_LENGTH = 1024; //Longer strings are truncated
+static const uint32_t BINARY_LOG_FILE_MAGIC = 0x474F4C42; //"BLOG"
+static const uint32_t BINARY_LOG_FILE_VERSION = 1;
+
+//-----------------------------------------------------------------------------------
+//Chunks in a binary log file. Each format string gets defined once, the first time a message uses it.
+enum BinaryLogChunkType
+{
+    BINARY_LOG_CHUNK_FORMAT = 0, //uint32 id, uint32 length, the format string without a terminator
+    BINARY_LOG_CHUNK_MESSAGE, //uint32 format id, uint16 level, uint32 args size, the encoded args
+    NUM_BINARY_LOG_CHUNK_TYPES
+};
+
+//FUNCTIONS/////////////////////////////////////////////////////////////////////
+//Formats a record's arguments with its format string. Returns the length written, not counting the terminator.
+size_t FormatBinaryLogArgs(const char* format, const byte* args, size_t argsSize, char* outBuffer, size_t bufferSize);
+bool DecodeBinaryLogFile(const char* binaryLogPath, const char* textLogPath);
+
+//ENCODING/////////////////////////////////////////////////////////////////////
+//One overload per encoded type. Anything smaller than an int promotes to int, and float promotes to double, just like printf.
+//-----------------------------------------------------------------------------------
+inline size_t GetBinaryLogArgSize(int) { return 1 + sizeof(int32_t); }
+inline size_t GetBinaryLogArgSize(unsigned int) { return 1 + sizeof(uint32_t); }
+inline size_t GetBinaryLogArgSize(long) { return 1 + (sizeof(long) == sizeof(int32_t) ? sizeof(int32_t) : sizeof(int64_t)); }
+inline size_t GetBinaryLogArgSize(unsigned long) { return 1 + (sizeof(unsigned long) == sizeof(uint32_t) ? sizeof(uint32_t) : sizeof(uint64_t)); }
+inline size_t GetBinaryLogArgSize(long long) { return 1 + sizeof(int64_t); }
+inline size_t GetBinaryLogArgSize(unsigned long long) { return 1 + sizeof(uint64_t); }
+inline size_t GetBinaryLogArgSize(double) { return 1 + sizeof(double); }
+inline size_t GetBinaryLogArgSize(const void*) { return 1 + sizeof(uint64_t); }
+//-----------------------------------------------------------------------------------
+inline size_t GetBinaryLogArgSize(const char* value)
+{
+    size_t length = value ? strlen(value) : 0;
+    return 1 + sizeof(uint16_t) + (length > MAX_BINARY_LOG_STRING_LENGTH ? MAX_BINARY_LOG_STRING_LENGTH : length);
+}
+
+//-----------------------------------------------------------------------------------
+template <typename T>
+inline byte* WriteBinaryLogValue(byte* out, BinaryLogArgType type, T value)
+{
+    *out = (byte)type;
+    memcpy(out + 1, &value, sizeof(T));
+    return out + 1 + sizeof(T);
+}
+
+//-----------------------------------------------------------------------------------
+inline byte* WriteBinaryLogArg(byte* out, int value) { return WriteBinaryLogValue(out, BINARY_LOG_INT32, (int32_t)value); }
+inline byte* WriteBinaryLogArg(byte* out, unsigned int value) { return WriteBinaryLogValue(out, BINARY_LOG_UINT32, (uint32_t)value); }
+inline byte* WriteBinaryLogArg(byte* out, long value) { return sizeof(long) == sizeof(int32_t) ? WriteBinaryLogValue(out, BINARY_LOG_INT32, (int32_t)value) : WriteBinaryLogValue(out, BINARY_LOG_INT64, (int64_t)value); }
+inline byte* WriteBinaryLogArg(byte* out, unsigned long value) { return sizeof(unsigned long) == sizeof(uint32_t) ? WriteBinaryLogValue(out, BINARY_LOG_UINT32, (uint32_t)value) : WriteBinaryLogValue(out, BINARY_LOG_UINT64, (uint64_t)value); }
+inline byte* WriteBinaryLogArg(byte* out, long long value) { return WriteBinaryLogValue(out, BINARY_LOG_INT64, (int64_t)value); }
+inline byte* WriteBinaryLogArg(byte* out, unsigned long long value) { return WriteBinaryLogValue(out, BINARY_LOG_UINT64, (uint64_t)value); }
+inline byte* WriteBinaryLogArg(byte* out, double value) { return WriteBinaryLogValue(out, BINARY_LOG_DOUBLE, value); }
+inline byte* WriteBinaryLogArg(byte* out, const void* value) { return WriteBinaryLogValue(out, BINARY_LOG_POINTER, (uint64_t)(uintptr_t)value); }
+//-----------------------------------------------------------------------------------
+inline byte* WriteBinaryLogArg(byte* out, const char* value)
+{
+    size_t length = value ? strlen(value) : 0;
+    uint16_t clampedLength = (uint16_t)(length > MAX_BINARY_LOG_STRING_LENGTH ? MAX_BINARY_LOG_STRING_LENGTH : length);
+    *out = (byte)BINARY_LOG_STRING;
+    memcpy(out + 1, &clampedLength, sizeof(uint16_t));
+    if (clampedLength > 0)
+    {
+        memcpy(out + 1 + sizeof(uint16_t), value, clampedLength);
+    }
+    return out + 1 + sizeof(uint16_t) + clampedLength;
+}
+
+//-----------------------------------------------------------------------------------
+inline size_t GetBinaryLogArgsSize()
+{
+    return 0;
+}
+
+//-----------------------------------------------------------------------------------
+template <typename T, typename ...ARGS>
+inline size_t GetBinaryLogArgsSize(T arg, ARGS... args)
+{
+    return GetBinaryLogArgSize(arg) + GetBinaryLogArgsSize(args...);
+}
+
+//-----------------------------------------------------------------------------------
+inline byte* WriteBinaryLogArgs(byte* out)
+{
+    return out;
+}
+
+//-----------------------------------------------------------------------------------
+template <typename T, typename ...ARGS>
+inline byte* WriteBinaryLogArgs(byte* out, T arg, ARGS... args)
+{
+    return WriteBinaryLogArgs(WriteBinaryLogArg(out, arg), args...);
+}
+
+//-----------------------------------------------------------------------------------
+//Writes the record no matter what the threshold is. Most code wants LogBinary.
+template <typename ...ARGS>
+void WriteBinaryLogRecord(LogLevel level, const char* format, ARGS... args)
+{
+    size_t payloadSize = sizeof(const char*) + GetBinaryLogArgsSize(args...);
+    byte* payload = Logger::instance->BeginRecord(payloadSize);
+    memcpy(payload, &format, sizeof(const char*));
+    WriteBinaryLogArgs(payload + sizeof(const char*), args...);
+    Logger::instance->EndRecord(LOG_RECORD_BINARY, level, payloadSize);
+}
+
+//-----------------------------------------------------------------------------------
+//Same filtering as LogPrintf, but nothing gets formatted on this thread.
+template <typename ...ARGS>
+void LogBinary(LogLevel level, const char* format, ARGS... args)
+{
+    if (static_cast<int>(level) < LOG_LEVEL_THRESHOLD)
+    {
+        return;
+    }
+    WriteBinaryLogRecord(level, format, args...);
+}
@@ -1,6 +1,7 @@
 #include "Engine/Input/InputOutputUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/Events/EventSystem.hpp"
+#include "Engine/Core/Memory/Buffer.hpp"
 #include <windows.h>
 #include <strsafe.h>
 #include <fstream>
@@ -17,9 +18,17 @@ bool LoadBufferFromBinaryFile(std::vector<unsigned char>& out_buffer, const std:
     };
     fseek(file, 0, SEEK_END);
     long size = ftell(file);
+    if (size < 0)
+    {
+        fclose(file);
+        return false;
+    }
     rewind(file);
     out_buffer.resize(size);
-    fread(&out_buffer[0], sizeof(unsigned char), size, file);
+    if (size > 0)
+    {
+        fread(&out_buffer[0], sizeof(unsigned char), size, file);
+    }
     fclose(file);
     return true;
 }
@@ -113,6 +122,11 @@ char* FileReadIntoNewBuffer(const std::string& filePath)
     };
     fseek(file, 0, SEEK_END);
     long size = ftell(file);
+    if (size < 0)
+    {
+        fclose(file);
+        return nullptr;
+    }
     rewind(file);
     char* buffer = new char[size + 1];
     fread(buffer, sizeof(unsigned char), size, file);
@@ -121,6 +135,34 @@ char* FileReadIntoNewBuffer(const std::string& filePath)
     return buffer;
 }
 
+//-----------------------------------------------------------------------------------
+//Reads the whole file into one pooled allocation that can be sliced and shared without copying it again.
+//The byte just past the end is always '\0', so a text file's data can be used as a C string.
+bool FileReadIntoBuffer(const std::string& filePath, Buffer& outBuffer)
+{
+    FILE* file = nullptr;
+    errno_t errorCode = fopen_s(&file, filePath.c_str(), "rb");
+    if (errorCode != 0x0)
+    {
+        return false;
+    };
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    if (size < 0)
+    {
+        fclose(file);
+        return false;
+    }
+    rewind(file);
+    BufferBuilder builder(size + 1);
+    byte* data = builder.Reserve(size + 1);
+    size_t numRead = fread(data, sizeof(unsigned char), size, file);
+    fclose(file);
+    data[numRead] = '\0';
+    outBuffer = builder.Finish().Slice(0, numRead);
+    return numRead == (size_t)size;
+}
+
 //-----------------------------------------------------------------------------------
 std::wstring RelativeToFullPath(const std::wstring& relativePath)
 {
@@ -156,6 +198,8 @@ std::vector<std::string> EnumerateFiles(const std::wstring& baseDirectory, const
     fileNames.reserve(20);
     std::deque<std::wstring> directories;
     directories.push_back(baseDirectory);
+    //The name's only known at runtime, so hash it once up front rather than once per file.
+    const EventId eventIdToFire = eventToFire ? HashEventName(eventToFire) : 0;
 
     if (recurseSubfolders)
     {
@@ -218,7 +262,7 @@ std::vector<std::string> EnumerateFiles(const std::wstring& baseDirectory, const
                 properties.Set<std::string>("FileRelativePath", fullFileName);
                 properties.Set<std::string>("FileAbsolutePath", fullPathStr);
 
-                EventSystem::FireEvent(eventToFire, properties);
+                EventSystem::FireEvent(eventIdToFire, properties);
             }
 
         } while (FindNextFile(handleToResults, &finder) != 0);
@@ -244,6 +288,8 @@ std::vector<std::wstring> EnumerateWideFiles(const std::wstring& baseDirectory,
     fileNames.reserve(20);
     std::deque<std::wstring> directories;
     directories.push_back(baseDirectory);
+    //Hashed once, same as EnumerateFiles.
+    const EventId eventIdToFire = eventToFire ? HashEventName(eventToFire) : 0;
 
     if (recurseSubfolders)
     {
@@ -304,7 +350,7 @@ std::vector<std::wstring> EnumerateWideFiles(const std::wstring& baseDirectory,
                 properties.Set<std::wstring>("FileRelativePath", fullFileName);
                 properties.Set<std::wstring>("FileAbsolutePath", fullPathWStr);
 
-                EventSystem::FireEvent(eventToFire, properties);
+                EventSystem::FireEvent(eventIdToFire, properties);
             }
 
         } while (FindNextFile(handleToResults, &finder) != 0);
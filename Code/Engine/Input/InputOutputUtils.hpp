@@ -2,6 +2,8 @@
 #include <vector>
 #include <string>
 
+class Buffer;
+
 bool LoadBufferFromBinaryFile(std::vector<unsigned char>& out_buffer, const std::string& filePath);
 bool SaveBufferToBinaryFile(const std::vector<unsigned char>& buffer, const std::string& filePath);
 bool EnsureDirectoryExists(const std::string& directoryPath);
@@ -9,6 +11,7 @@ bool EnsureFileExists(const std::string& fullFilePath);
 bool EnsureFileExists(const std::wstring& fullFilePath);
 bool ReadTextFileIntoVector(std::vector<std::string>& outBuffer, const std::string& filePath);
 char* FileReadIntoNewBuffer(const std::string& filePath);
+bool FileReadIntoBuffer(const std::string& filePath, Buffer& outBuffer);
 std::vector<std::string> EnumerateFiles(const std::string& baseFolder, const std::string& filePattern, bool recurseSubfolders = false, const char* eventToFire = nullptr);
 std::vector<std::string> EnumerateFiles(const std::wstring& baseFolder, const std::wstring& filePattern, bool recurseSubfolders = false, const char* eventToFire = nullptr);
 std::vector<std::wstring> EnumerateWideFiles(const std::wstring& baseDirectory, const std::wstring& filePatternWStr, bool recurseSubfolders = false, const char* eventToFire = nullptr);
@@ -0,0 +1,143 @@
+#include "Engine/Input/LogChannels.hpp"
+#include "Engine/Input/Console.hpp"
+
+std::atomic<int> g_logChannelLevels[NUM_LOG_CHANNELS] =
+{
+    { LOG_LEVEL_THRESHOLD },
+    { LOG_LEVEL_THRESHOLD },
+    { LOG_LEVEL_THRESHOLD },
+    { LOG_LEVEL_THRESHOLD },
+    { LOG_LEVEL_THRESHOLD },
+    { LOG_LEVEL_THRESHOLD },
+    { LOG_LEVEL_THRESHOLD },
+    { LOG_LEVEL_THRESHOLD }
+};
+
+static const char* LOG_CHANNEL_NAMES[NUM_LOG_CHANNELS] =
+{
+    "general",
+    "net",
+    "render",
+    "audio",
+    "jobs",
+    "input",
+    "ui",
+    "profiling"
+};
+
+static const char* LOG_LEVEL_NAMES[static_cast<int>(LogLevel::NUM_LOG_LEVELS)] =
+{
+    "verbose",
+    "default",
+    "warning",
+    "severe",
+    "none"
+};
+
+//-----------------------------------------------------------------------------------
+const char* GetLogChannelName(LogChannel channel)
+{
+    return LOG_CHANNEL_NAMES[channel];
+}
+
+//-----------------------------------------------------------------------------------
+LogChannel GetLogChannelFromName(const char* name)
+{
+    for (int i = 0; i < NUM_LOG_CHANNELS; ++i)
+    {
+        if (strcmp(LOG_CHANNEL_NAMES[i], name) == 0)
+        {
+            return static_cast<LogChannel>(i);
+        }
+    }
+    return NUM_LOG_CHANNELS;
+}
+
+//-----------------------------------------------------------------------------------
+void SetLogChannelLevel(LogChannel channel, LogLevel level)
+{
+    g_logChannelLevels[channel].store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------
+void SetAllLogChannelLevels(LogLevel level)
+{
+    for (int i = 0; i < NUM_LOG_CHANNELS; ++i)
+    {
+        g_logChannelLevels[i].store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Tags the message with its channel, then hands it to the logger like LogPrintf does.
+void LogChannelPrintf(LogChannel channel, LogLevel level, const char* format, ...)
+{
+    char channelPrefix[32];
+    _snprintf_s(channelPrefix, sizeof(channelPrefix), _TRUNCATE, "[%s] ", LOG_CHANNEL_NAMES[channel]);
+    va_list variableArgumentList;
+    va_start(variableArgumentList, format);
+    Logger::instance->LogFormatted(level, nullptr, format, variableArgumentList, channelPrefix);
+    va_end(variableArgumentList);
+}
+
+//-----------------------------------------------------------------------------------
+//Takes a level's name or its number.
+static bool ParseLogLevel(std::string levelName, LogLevel& outLevel)
+{
+    ToLower(levelName);
+    for (int i = 0; i < static_cast<int>(LogLevel::NUM_LOG_LEVELS); ++i)
+    {
+        if (levelName == LOG_LEVEL_NAMES[i] || levelName == std::to_string(i))
+        {
+            outLevel = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(logchannels)
+{
+    UNUSED(args);
+    Console::instance->PrintLine(Stringf("%-20s%10s", "CHANNEL", "LEVEL"), RGBA::VAPORWAVE);
+    for (int i = 0; i < NUM_LOG_CHANNELS; ++i)
+    {
+        int level = g_logChannelLevels[i].load(std::memory_order_relaxed);
+        RGBA color = level < LOG_LEVEL_THRESHOLD ? RGBA::YELLOW : RGBA::WHITE;
+        Console::instance->PrintLine(Stringf("%-20s%10s", LOG_CHANNEL_NAMES[i], LOG_LEVEL_NAMES[level]), color);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(logchannel)
+{
+    if (!args.HasArgs(2))
+    {
+        Console::instance->PrintLine("logchannel <channel name or all> <verbose, default, warning, severe or none>", RGBA::RED);
+        return;
+    }
+    std::string channelName = args.GetStringArgument(0);
+    ToLower(channelName);
+    LogLevel level = LogLevel::NONE;
+    if (!ParseLogLevel(args.GetStringArgument(1), level))
+    {
+        Console::instance->PrintLine(Stringf("Unknown log level '%s'.", args.GetStringArgument(1).c_str()), RGBA::RED);
+        return;
+    }
+
+    if (channelName == "all")
+    {
+        SetAllLogChannelLevels(level);
+        Console::instance->PrintLine(Stringf("Every channel now logs %s and above.", LOG_LEVEL_NAMES[static_cast<int>(level)]), RGBA::GBLIGHTGREEN);
+        return;
+    }
+    LogChannel channel = GetLogChannelFromName(channelName.c_str());
+    if (channel == NUM_LOG_CHANNELS)
+    {
+        Console::instance->PrintLine(Stringf("Unknown log channel '%s'.", channelName.c_str()), RGBA::RED);
+        return;
+    }
+    SetLogChannelLevel(channel, level);
+    Console::instance->PrintLine(Stringf("'%s' now logs %s and above.", LOG_CHANNEL_NAMES[channel], LOG_LEVEL_NAMES[static_cast<int>(level)]), RGBA::GBLIGHTGREEN);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Input/Logging.hpp"
+#include <atomic>
+
+//-----------------------------------------------------------------------------------
+enum LogChannel
+{
+    LOG_CHANNEL_GENERAL = 0,
+    LOG_CHANNEL_NET,
+    LOG_CHANNEL_RENDER,
+    LOG_CHANNEL_AUDIO,
+    LOG_CHANNEL_JOBS,
+    LOG_CHANNEL_INPUT,
+    LOG_CHANNEL_UI,
+    LOG_CHANNEL_PROFILING,
+    NUM_LOG_CHANNELS
+};
+
+//GLOBAL VARIABLES/////////////////////////////////////////////////////////////////////
+//The lowest level each channel lets through. Starts at LOG_LEVEL_THRESHOLD and gets changed at runtime with the logchannel command.
+//Relaxed loads are all the check needs, a message or two on either side of a change doesn't matter.
+extern std::atomic<int> g_logChannelLevels[NUM_LOG_CHANNELS];
+
+//GLOBAL FUNCTIONS/////////////////////////////////////////////////////////////////////
+const char* GetLogChannelName(LogChannel channel);
+//Returns NUM_LOG_CHANNELS if there's no channel by that name.
+LogChannel GetLogChannelFromName(const char* name);
+void SetLogChannelLevel(LogChannel channel, LogLevel level);
+void SetAllLogChannelLevels(LogLevel level);
+//Doesn't check the channel's level, go through the LOG_ macros below so disabled messages never get this far.
+void LogChannelPrintf(LogChannel channel, LogLevel level, const char* format, ...);
+
+//-----------------------------------------------------------------------------------
+inline bool IsLogChannelEnabled(LogChannel channel, LogLevel level)
+{
+    return static_cast<int>(level) >= g_logChannelLevels[channel].load(std::memory_order_relaxed);
+}
+
+//MACROS/////////////////////////////////////////////////////////////////////
+//A disabled channel costs one compare against its cached level, and the arguments are only evaluated once it passes.
+#define LOG_CHANNEL_MESSAGE(channel, level, ...) do { if (IsLogChannelEnabled(channel, level)) { LogChannelPrintf(channel, level, __VA_ARGS__); } } while (0)
+
+//Still type checked, so stripped calls can't rot, but sizeof never evaluates the call or its arguments.
+#define LOG_CHANNEL_MESSAGE_STRIPPED(channel, level, ...) ((void)sizeof((LogChannelPrintf(channel, level, __VA_ARGS__), 0)))
+
+//Anything under LOG_COMPILE_TIME_MIN_LEVEL compiles down to nothing.
+#if LOG_COMPILE_TIME_MIN_LEVEL <= 0
+#define LOG_VERBOSE(channel, ...) LOG_CHANNEL_MESSAGE(channel, LogLevel::VERBOSE, __VA_ARGS__)
+#else
+#define LOG_VERBOSE(channel, ...) LOG_CHANNEL_MESSAGE_STRIPPED(channel, LogLevel::VERBOSE, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_TIME_MIN_LEVEL <= 1
+#define LOG_DEFAULT(channel, ...) LOG_CHANNEL_MESSAGE(channel, LogLevel::DEFAULT, __VA_ARGS__)
+#else
+#define LOG_DEFAULT(channel, ...) LOG_CHANNEL_MESSAGE_STRIPPED(channel, LogLevel::DEFAULT, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_TIME_MIN_LEVEL <= 2
+#define LOG_WARNING(channel, ...) LOG_CHANNEL_MESSAGE(channel, LogLevel::WARNING, __VA_ARGS__)
+#else
+#define LOG_WARNING(channel, ...) LOG_CHANNEL_MESSAGE_STRIPPED(channel, LogLevel::WARNING, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_TIME_MIN_LEVEL <= 3
+#define LOG_SEVERE(channel, ...) LOG_CHANNEL_MESSAGE(channel, LogLevel::SEVERE, __VA_ARGS__)
+#else
+#define LOG_SEVERE(channel, ...) LOG_CHANNEL_MESSAGE_STRIPPED(channel, LogLevel::SEVERE, __VA_ARGS__)
+#endif
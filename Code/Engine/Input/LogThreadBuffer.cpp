@@ -0,0 +1,100 @@
+#include "Engine/Input/LogThreadBuffer.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+//-----------------------------------------------------------------------------------
+LogThreadBuffer::LogThreadBuffer(size_t capacity)
+    : m_isInUse(true)
+    , m_nextBuffer(nullptr)
+    , m_data(nullptr)
+    , m_capacity(capacity)
+    , m_head(0)
+    , m_reservedHead(0)
+    , m_tail(0)
+{
+    ASSERT_OR_DIE(capacity % RECORD_ALIGNMENT == 0, "Log thread buffers need to be a multiple of the record alignment.");
+    m_data = new byte[capacity];
+}
+
+//-----------------------------------------------------------------------------------
+LogThreadBuffer::~LogThreadBuffer()
+{
+    delete[] m_data;
+}
+
+//-----------------------------------------------------------------------------------
+byte* LogThreadBuffer::Reserve(size_t maxPayloadSize)
+{
+    size_t recordSize = GetRecordSize(maxPayloadSize);
+    ASSERT_OR_DIE(recordSize <= m_capacity / 2, "Log record is too big for its thread's buffer.");
+
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    uint64_t tail = m_tail.load(std::memory_order_acquire);
+    size_t offset = (size_t)(head % m_capacity);
+    size_t bytesUntilEnd = m_capacity - offset;
+
+    //Records never straddle the end of the ring, so if this one won't fit we burn the rest of the ring on filler.
+    size_t bytesNeeded = bytesUntilEnd < recordSize ? bytesUntilEnd + recordSize : recordSize;
+    if ((head - tail) + bytesNeeded > m_capacity)
+    {
+        return nullptr;
+    }
+
+    if (bytesUntilEnd < recordSize)
+    {
+        LogRecordHeader* wrapHeader = reinterpret_cast<LogRecordHeader*>(m_data + offset);
+        wrapHeader->m_size = (uint32_t)(bytesUntilEnd - sizeof(LogRecordHeader));
+        wrapHeader->m_type = LOG_RECORD_WRAP;
+        wrapHeader->m_level = 0;
+        head += bytesUntilEnd;
+        offset = 0;
+    }
+    m_reservedHead = head;
+    return m_data + offset + sizeof(LogRecordHeader);
+}
+
+//-----------------------------------------------------------------------------------
+//The sequence number is taken as late as possible, so there's only a few instructions where it's been handed out but the record can't be seen yet.
+void LogThreadBuffer::Commit(LogRecordType type, unsigned int level, size_t payloadSize, std::atomic<uint64_t>& sequenceCounter)
+{
+    LogRecordHeader* header = reinterpret_cast<LogRecordHeader*>(m_data + (size_t)(m_reservedHead % m_capacity));
+    header->m_size = (uint32_t)payloadSize;
+    header->m_type = (uint16_t)type;
+    header->m_level = (uint16_t)level;
+    header->m_sequence = sequenceCounter.fetch_add(1, std::memory_order_relaxed);
+    //Release so the consumer sees the whole record, and any wrap filler in front of it, before it sees the new head.
+    m_head.store(m_reservedHead + GetRecordSize(payloadSize), std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------
+const LogRecordHeader* LogThreadBuffer::Peek()
+{
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    while (tail != head)
+    {
+        const LogRecordHeader* header = reinterpret_cast<const LogRecordHeader*>(m_data + (size_t)(tail % m_capacity));
+        if (header->m_type != LOG_RECORD_WRAP)
+        {
+            return header;
+        }
+        tail += GetRecordSize(header->m_size);
+        m_tail.store(tail, std::memory_order_release);
+    }
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+//Only valid right after a Peek that returned a record.
+void LogThreadBuffer::Pop()
+{
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    const LogRecordHeader* header = reinterpret_cast<const LogRecordHeader*>(m_data + (size_t)(tail % m_capacity));
+    //Release so the producer can't reuse the bytes until we're done reading them.
+    m_tail.store(tail + GetRecordSize(header->m_size), std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------
+size_t LogThreadBuffer::GetNumBytesUsed() const
+{
+    return (size_t)(m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire));
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+typedef unsigned char byte;
+
+//-----------------------------------------------------------------------------------
+enum LogRecordType
+{
+    LOG_RECORD_TEXT = 0, //Already formatted, null terminated
+    LOG_RECORD_CALLSTACK, //A Callstack* followed by formatted, null terminated text. The writer frees the callstack.
+    LOG_RECORD_BINARY, //A format string pointer followed by type tagged arguments, formatted by whoever drains it
+    LOG_RECORD_WRAP, //Filler at the end of the ring, the next record starts back at the beginning
+    NUM_LOG_RECORD_TYPES
+};
+
+//-----------------------------------------------------------------------------------
+//Sits in front of every record. Records are padded out to a multiple of the header size, so the next header is always aligned
+//and whatever's left at the end of the ring always has room for a wrap header.
+struct LogRecordHeader
+{
+    uint32_t m_size; //Payload bytes, not counting the header or padding
+    uint16_t m_type;
+    uint16_t m_level;
+    uint64_t m_sequence; //From a counter every thread shares, so records from different rings can be put back in the order they were logged
+};
+
+//-----------------------------------------------------------------------------------
+//Single producer, single consumer ring of log records. The owning thread writes records in place, and the writer thread reads them out.
+//Neither side ever takes a lock, and a record's bytes are only ever written once.
+class LogThreadBuffer
+{
+public:
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    LogThreadBuffer(size_t capacity);
+    ~LogThreadBuffer();
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    //Producer side. Reserve hands back room for up to maxPayloadSize bytes, or nullptr if the ring is too full right now.
+    byte* Reserve(size_t maxPayloadSize);
+    //Publishes the reserved record, stamped with the next number from sequenceCounter. payloadSize can be less than what was reserved.
+    void Commit(LogRecordType type, unsigned int level, size_t payloadSize, std::atomic<uint64_t>& sequenceCounter);
+
+    //Consumer side. Peek returns the oldest record, or nullptr if there aren't any. Pop frees it for the producer.
+    const LogRecordHeader* Peek();
+    void Pop();
+
+    size_t GetNumBytesUsed() const;
+    inline size_t GetCapacity() const { return m_capacity; };
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static inline size_t GetRecordSize(size_t payloadSize) { return (sizeof(LogRecordHeader) + payloadSize + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1); };
+    static inline const byte* GetPayload(const LogRecordHeader* header) { return reinterpret_cast<const byte*>(header + 1); };
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const size_t RECORD_ALIGNMENT = sizeof(LogRecordHeader);
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::atomic<bool> m_isInUse; //Cleared when the owning thread exits so another thread can take the buffer over
+    LogThreadBuffer* m_nextBuffer;
+
+private:
+    LogThreadBuffer(const LogThreadBuffer&) = delete;
+    LogThreadBuffer& operator=(const LogThreadBuffer&) = delete;
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    byte* m_data;
+    size_t m_capacity;
+    //Both only ever count up. The producer owns m_head and the consumer owns m_tail.
+    //Padded apart by hand rather than with alignas, since these get heap allocated and new doesn't honor over-alignment yet.
+    std::atomic<uint64_t> m_head;
+    uint64_t m_reservedHead; //Where Commit should publish from, past any wrap filler Reserve had to write
+    byte m_padding[64];
+    std::atomic<uint64_t> m_tail;
+};
+static_assert((LogThreadBuffer::RECORD_ALIGNMENT & (LogThreadBuffer::RECORD_ALIGNMENT - 1)) == 0, "GetRecordSize needs the record alignment to be a power of two.");
@@ -1,8 +1,11 @@
 #include "Engine/Input/Logging.hpp"
+#include "Engine/Input/BinaryLogging.hpp"
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/Memory/Callstack.hpp"
 #include "Engine/Input/InputOutputUtils.hpp"
 #include "Engine/Input/Console.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Time/Time.hpp"
 #include <chrono>
 #include <ctime>
 #include <algorithm>
@@ -13,44 +16,62 @@ extern bool g_isQuitting;
 //This works for all of my current projects, but will probably get out of date at some time later once MainWin32 gets nuked c:
 extern const char* APP_NAME;
 Logger* Logger::instance = nullptr;
-const int LOGF_STACK_LOCAL_TEMP_LENGTH = 2048;
 
 //-----------------------------------------------------------------------------------
-void LoggerThreadMain()
+//Hands the thread's buffer back when the thread exits, so threads that come and go don't each leave a buffer behind.
+struct LogThreadBufferOwner
 {
-    while (!g_isQuitting)
+    ~LogThreadBufferOwner()
     {
-        SwitchToThread();
-        LogMessage* message = nullptr;
-
-        if (Logger::instance->HasMessages())
+        //The logger may have been torn down and its buffers freed before this thread got around to exiting.
+        if (m_buffer && m_logger == Logger::instance)
         {
-            message = Logger::instance->DequeueMessage();
+            m_buffer->m_isInUse.store(false, std::memory_order_release);
         }
+    }
 
-        if (message)
-        {
-            Logger::instance->Log(message);
-            if (message->callstack)
-            {
-                Callstack* callstack = message->callstack;
-                CallstackLine* callstackLines = CallstackGetLines(callstack);
-                Logger::instance->Log(">>>Callstack:\n//-----------------------------------------------------------------------------------\n");
-                for (unsigned int i = 0; i < callstack->frameCount; ++i)
-                {
-                    Logger::instance->Log(Stringf("%s(%i): %s\n", callstackLines[i].filename, callstackLines[i].line, callstackLines[i].functionName).c_str());
-                }
-                Logger::instance->Log("//-----------------------------------------------------------------------------------\n\n");
-            }
-            delete message;
-        }
+    LogThreadBuffer* m_buffer = nullptr;
+    Logger* m_logger = nullptr;
+};
+
+static thread_local LogThreadBufferOwner t_logThreadBufferOwner;
+static LPTOP_LEVEL_EXCEPTION_FILTER s_previousExceptionFilter = nullptr;
+
+//-----------------------------------------------------------------------------------
+void LoggerThreadMain()
+{
+    Logger* logger = Logger::instance;
+    while (logger->IsLoggingThreadRunning() && !g_isQuitting)
+    {
+        WaitForSingleObject(logger->m_wakeEvent, Logger::DRAIN_INTERVAL_MS);
+        logger->DrainThreadBuffers();
     }
+    //Anyone who fills their buffer from here on drains it themselves.
+    logger->m_isLoggingThreadRunning.store(false, std::memory_order_release);
 }
 
 //-----------------------------------------------------------------------------------
-Logger::Logger()
+Logger::Logger(LogClockFunction clock)
     : m_file(nullptr)
+    , m_rotationSizeBytes(LOG_ROTATION_SIZE_BYTES)
+    , m_rotationIntervalSeconds(LOG_ROTATION_INTERVAL_SECONDS)
+    , m_flushIntervalSeconds(LOG_FLUSH_INTERVAL_MS / 1000.0)
+    , m_threadBuffers(nullptr)
+    , m_isDraining(false)
+    , m_clock(clock ? clock : &GetCurrentTimeSeconds)
+    , m_wakeEvent(CreateEvent(nullptr, FALSE, FALSE, nullptr))
+    , m_nextRecordSequence(0)
+    , m_nextSequenceToWrite(0)
+    , m_binaryFile(nullptr)
+    , m_isLoggingThreadRunning(false)
+    , m_fileSizeBytes(0)
+    , m_fileOpenedTimeSeconds(0.0)
+    , m_lastFlushTimeSeconds(0.0)
+    , m_filePartIndex(0)
+    , m_hasUnflushedSevereRecord(false)
 {
+    InitializeCriticalSection(&m_drainCriticalSection);
+    m_writeBatch.reserve(WRITE_BATCH_SIZE);
     CreateLogFile();
     CleanUpOldLogFiles();
 }
@@ -59,14 +80,22 @@ Logger::Logger()
 Logger::~Logger()
 {
     //Wait for the thread to finish shutting down, then continue.
-    if (m_loggingThread.joinable())
+    StopLoggingThread();
+    //Flush anything still sitting in a thread's buffer before we destroy the system.
+    FlushLog();
+    StopBinaryLog();
+    fclose(m_file);
+    CopyLogFileAsLatest();
+
+    LogThreadBuffer* buffer = m_threadBuffers.exchange(nullptr);
+    while (buffer)
     {
-        m_loggingThread.join();
+        LogThreadBuffer* nextBuffer = buffer->m_nextBuffer;
+        delete buffer;
+        buffer = nextBuffer;
     }
-    //Flush any remaining things in the queue before we destory the system.
-    Logger::instance->FlushLog();
-    fclose(m_file);
-    Logger::instance->CopyLogFileAsLatest();
+    CloseHandle(m_wakeEvent);
+    DeleteCriticalSection(&m_drainCriticalSection);
 }
 
 //-----------------------------------------------------------------------------------
@@ -99,90 +128,444 @@ void Logger::CreateLogFile()
     //Supressed because localtime_s isn't actually accessible because I don't know why try for yourself. >:I
     #pragma warning(suppress: 4996)
     std::tm time = *std::localtime(&timeNow);
-    std::string timestamp = Stringf("%02i-%i-%i %i.%02i.%02i", time.tm_mon + 1, time.tm_mday, time.tm_year + 1900, time.tm_hour, time.tm_min, time.tm_sec);
+    //Year first and zero padded, so sorting the names in CleanUpOldLogFiles puts them oldest first.
+    std::string timestamp = Stringf("%i-%02i-%02i %02i.%02i.%02i", time.tm_year + 1900, time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec);
     EnsureDirectoryExists("Logs");
-    m_fileName = Stringf("Logs\\%s Log %s.txt", APP_NAME, timestamp.c_str());
+    m_fileName = Stringf("Logs\\%s Log %s Part %03u.txt", APP_NAME, timestamp.c_str(), m_filePartIndex);
     errno_t errorCode = fopen_s(&m_file, m_fileName.c_str(), "wb");
     if (errorCode != 0x0)
     {
         ERROR_AND_DIE("Unable to open LogFile.txt for write");
     };
+    m_fileSizeBytes = 0;
+    m_fileOpenedTimeSeconds = m_clock();
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::EnqueueMessage(LogMessage* msg)
+//Consumer side only, so it's always called with the drain lock held.
+void Logger::OpenNextLogFile()
 {
-    m_loggingQueue.Enqueue(msg);
+    fclose(m_file);
+    ++m_filePartIndex;
+    CreateLogFile();
+    CleanUpOldLogFiles();
 }
 
 //-----------------------------------------------------------------------------------
-LogMessage* Logger::DequeueMessage()
+//Anything still buffered goes out to the old file first.
+void Logger::RotateLogFile()
 {
-    LogMessage* front = m_loggingQueue.Dequeue();
-    return front;
+    EnterCriticalSection(&m_drainCriticalSection);
+    DrainThreadBuffers();
+    OpenNextLogFile();
+    LeaveCriticalSection(&m_drainCriticalSection);
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::FlushLog()
+bool Logger::ShouldRotateLogFile(size_t numBytesToWrite) const
+{
+    //An empty file always takes the write, otherwise one huge message would rotate forever.
+    if (m_fileSizeBytes == 0)
+    {
+        return false;
+    }
+    if (m_rotationSizeBytes > 0 && m_fileSizeBytes + numBytesToWrite > m_rotationSizeBytes)
+    {
+        return true;
+    }
+    return m_rotationIntervalSeconds > 0.0 && m_clock() - m_fileOpenedTimeSeconds >= m_rotationIntervalSeconds;
+}
+
+//-----------------------------------------------------------------------------------
+LogThreadBuffer* Logger::GetOrCreateThreadBuffer()
 {
-    LogMessage* message;
-    unsigned int numMessages = m_loggingQueue.Size();
-    for (unsigned int i = 0; i < numMessages; ++i)
+    LogThreadBufferOwner& owner = t_logThreadBufferOwner;
+    if (owner.m_buffer && owner.m_logger == this)
     {
-        message = DequeueMessage();
-        Log(message);
-        delete message;
+        return owner.m_buffer;
     }
 
-    fflush(m_file);
+    //Take over a buffer from a thread that's already exited before making a new one.
+    LogThreadBuffer* buffer = m_threadBuffers.load(std::memory_order_acquire);
+    for (; buffer != nullptr; buffer = buffer->m_nextBuffer)
+    {
+        bool wasInUse = false;
+        if (!buffer->m_isInUse.load(std::memory_order_relaxed) && buffer->m_isInUse.compare_exchange_strong(wasInUse, true, std::memory_order_acquire))
+        {
+            break;
+        }
+    }
+
+    if (!buffer)
+    {
+        MemoryTagScope loggingScope(MEMTAG_LOGGING);
+        buffer = new LogThreadBuffer(THREAD_BUFFER_SIZE);
+
+        //Buffers are only ever added, so a lock free push is all we need.
+        LogThreadBuffer* head = m_threadBuffers.load(std::memory_order_relaxed);
+        do
+        {
+            buffer->m_nextBuffer = head;
+        } while (!m_threadBuffers.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    owner.m_buffer = buffer;
+    owner.m_logger = this;
+    return buffer;
 }
 
+//-----------------------------------------------------------------------------------
+//Never drops a message. If the ring is full we wait on the writer, or drain it ourselves once there's no writer left.
+byte* Logger::ReserveRecord(LogThreadBuffer* buffer, size_t maxPayloadSize)
+{
+    byte* payload = buffer->Reserve(maxPayloadSize);
+    while (!payload)
+    {
+        if (IsLoggingThreadRunning())
+        {
+            WakeLoggingThread();
+            SwitchToThread();
+        }
+        else
+        {
+            FlushLog();
+        }
+        payload = buffer->Reserve(maxPayloadSize);
+    }
+    return payload;
+}
 
 //-----------------------------------------------------------------------------------
-bool Logger::HasMessages()
+byte* Logger::BeginRecord(size_t maxPayloadSize)
 {
-    return m_loggingQueue.Size() > 0;
+    return ReserveRecord(GetOrCreateThreadBuffer(), maxPayloadSize);
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::StartLoggingThread()
+void Logger::EndRecord(LogRecordType type, LogLevel level, size_t payloadSize)
 {
-    m_loggingThread = std::thread(LoggerThreadMain);
+    LogThreadBuffer* buffer = GetOrCreateThreadBuffer();
+    size_t halfCapacity = buffer->GetCapacity() / 2;
+    bool wasUnderHalfFull = buffer->GetNumBytesUsed() < halfCapacity;
+    buffer->Commit(type, (unsigned int)level, payloadSize, m_nextRecordSequence);
+
+    //Waking the writer costs a kernel call, so only bother once the ring is filling up or for messages we can't afford to sit on.
+    if (level >= LogLevel::SEVERE || (wasUnderHalfFull && buffer->GetNumBytesUsed() >= halfCapacity))
+    {
+        WakeLoggingThread();
+    }
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::Log(const char* message)
+//Formats straight into this thread's buffer. Takes ownership of the callstack, if there is one.
+//The text prefix, if there is one, goes in front of the message as is, and counts against the same length limit.
+void Logger::LogFormatted(LogLevel level, Callstack* callstack, const char* format, va_list args, const char* textPrefix)
 {
-    fwrite(message, sizeof(unsigned char), strlen(message), m_file);
-    #ifdef FORWARD_LOG_TO_OUTPUT_WINDOW
+    size_t prefixSize = callstack ? sizeof(Callstack*) : 0;
+    byte* payload = BeginRecord(prefixSize + LOGF_STACK_LOCAL_TEMP_LENGTH);
+    if (callstack)
     {
-        DebuggerPrintf(message);
+        memcpy(payload, &callstack, sizeof(Callstack*));
     }
-    #endif // FORWARD_LOG_TO_OUTPUT_WINDOW
-    #ifdef FORWARD_LOG_TO_CONSOLE
+    char* formattedMessage = reinterpret_cast<char*>(payload + prefixSize);
+    size_t textPrefixLength = 0;
+    if (textPrefix)
     {
-        if (Console::instance != nullptr)
+        textPrefixLength = std::min(strlen(textPrefix), (size_t)LOGF_STACK_LOCAL_TEMP_LENGTH - 1);
+        memcpy(formattedMessage, textPrefix, textPrefixLength);
+    }
+    vsnprintf_s(formattedMessage + textPrefixLength, LOGF_STACK_LOCAL_TEMP_LENGTH - textPrefixLength, _TRUNCATE, format, args);
+    formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
+    size_t payloadSize = prefixSize + strlen(formattedMessage) + 1;
+    EndRecord(callstack ? LOG_RECORD_CALLSTACK : LOG_RECORD_TEXT, level, payloadSize);
+}
+
+//-----------------------------------------------------------------------------------
+//Safe to call from any thread, the writer thread and anyone flushing take turns on the consumer side.
+void Logger::DrainThreadBuffers()
+{
+    EnterCriticalSection(&m_drainCriticalSection);
+    bool wasDraining = m_isDraining;
+    m_isDraining = true;
+    {
+        //Every ring is already in order, so always taking the lowest sequence number off the front of any of them writes the log in the order it was logged.
+        unsigned int numGapChecks = 0;
+        for (;;)
         {
-            Console::instance->PrintLine(message, RGBA::CERULEAN);
+            LogThreadBuffer* oldestBuffer = nullptr;
+            const LogRecordHeader* oldestHeader = nullptr;
+            for (LogThreadBuffer* buffer = m_threadBuffers.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->m_nextBuffer)
+            {
+                const LogRecordHeader* header = buffer->Peek();
+                if (header && (!oldestHeader || header->m_sequence < oldestHeader->m_sequence))
+                {
+                    oldestBuffer = buffer;
+                    oldestHeader = header;
+                }
+            }
+            if (!oldestHeader)
+            {
+                break;
+            }
+
+            //A gap means someone has their number but hasn't published yet, which only takes a moment. We don't wait forever though, they might have crashed.
+            if (oldestHeader->m_sequence > m_nextSequenceToWrite && numGapChecks < MAX_SEQUENCE_GAP_CHECKS)
+            {
+                ++numGapChecks;
+                continue;
+            }
+            numGapChecks = 0;
+            m_nextSequenceToWrite = std::max(m_nextSequenceToWrite, oldestHeader->m_sequence + 1);
+            WriteRecord(oldestHeader);
+            oldestBuffer->Pop();
+        }
+        WriteBatch();
+
+        //Flushing is what actually costs us, so it waits for the interval unless something severe needs to hit the disk now.
+        double currentTimeSeconds = m_clock();
+        if (m_hasUnflushedSevereRecord || currentTimeSeconds - m_lastFlushTimeSeconds >= m_flushIntervalSeconds)
+        {
+            fflush(m_file);
+            m_lastFlushTimeSeconds = currentTimeSeconds;
+            m_hasUnflushedSevereRecord = false;
         }
     }
-    #endif // FORWARD_LOG_TO_CONSOLE
+    m_isDraining = wasDraining;
+    LeaveCriticalSection(&m_drainCriticalSection);
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::WriteRecord(const LogRecordHeader* header)
+{
+    const byte* payload = LogThreadBuffer::GetPayload(header);
+    if (header->m_level >= static_cast<uint16_t>(LogLevel::SEVERE))
+    {
+        m_hasUnflushedSevereRecord = true;
+    }
+    if (header->m_type == LOG_RECORD_BINARY)
+    {
+        if (m_binaryFile)
+        {
+            WriteBinaryRecord(header);
+            return;
+        }
+        const char* format = nullptr;
+        memcpy(&format, payload, sizeof(const char*));
+        char formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH];
+        FormatBinaryLogArgs(format, payload + sizeof(const char*), header->m_size - sizeof(const char*), formattedMessage, LOGF_STACK_LOCAL_TEMP_LENGTH);
+        Log(formattedMessage);
+        return;
+    }
+
+    Callstack* callstack = nullptr;
+    if (header->m_type == LOG_RECORD_CALLSTACK)
+    {
+        memcpy(&callstack, payload, sizeof(Callstack*));
+        payload += sizeof(Callstack*);
+    }
+    Log(reinterpret_cast<const char*>(payload));
+
+    if (callstack)
+    {
+        CallstackLine* callstackLines = CallstackGetLines(callstack);
+        Log(">>>Callstack:\n//-----------------------------------------------------------------------------------\n");
+        for (unsigned int i = 0; i < callstack->frameCount; ++i)
+        {
+            Log(Stringf("%s(%i): %s\n", callstackLines[i].filename, callstackLines[i].line, callstackLines[i].functionName).c_str());
+        }
+        Log("//-----------------------------------------------------------------------------------\n\n");
+        FreeCallstack(callstack);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Defines the format string the first time we see it, then writes the arguments as is. Nothing gets formatted until the file is decoded.
+void Logger::WriteBinaryRecord(const LogRecordHeader* header)
+{
+    const byte* payload = LogThreadBuffer::GetPayload(header);
+    const char* format = nullptr;
+    memcpy(&format, payload, sizeof(const char*));
+
+    auto formatIter = m_binaryFormatIds.find(format);
+    uint32_t formatId = 0;
+    if (formatIter == m_binaryFormatIds.end())
+    {
+        MemoryTagScope loggingScope(MEMTAG_LOGGING);
+        formatId = (uint32_t)m_binaryFormatIds.size();
+        m_binaryFormatIds[format] = formatId;
+        byte chunkType = BINARY_LOG_CHUNK_FORMAT;
+        uint32_t formatLength = (uint32_t)strlen(format);
+        fwrite(&chunkType, sizeof(byte), 1, m_binaryFile);
+        fwrite(&formatId, sizeof(uint32_t), 1, m_binaryFile);
+        fwrite(&formatLength, sizeof(uint32_t), 1, m_binaryFile);
+        fwrite(format, sizeof(char), formatLength, m_binaryFile);
+    }
+    else
+    {
+        formatId = formatIter->second;
+    }
+
+    byte chunkType = BINARY_LOG_CHUNK_MESSAGE;
+    uint16_t level = header->m_level;
+    uint32_t argsSize = header->m_size - sizeof(const char*);
+    fwrite(&chunkType, sizeof(byte), 1, m_binaryFile);
+    fwrite(&formatId, sizeof(uint32_t), 1, m_binaryFile);
+    fwrite(&level, sizeof(uint16_t), 1, m_binaryFile);
+    fwrite(&argsSize, sizeof(uint32_t), 1, m_binaryFile);
+    fwrite(payload + sizeof(const char*), sizeof(byte), argsSize, m_binaryFile);
+}
+
+//-----------------------------------------------------------------------------------
+//Anything already sitting in the buffers gets drained first, so it lands in whichever log it was written under.
+//Critical sections are reentrant, so draining while we hold it is fine.
+bool Logger::StartBinaryLog(const char* filePath)
+{
+    EnterCriticalSection(&m_drainCriticalSection);
+    DrainThreadBuffers();
+    if (m_binaryFile)
+    {
+        fclose(m_binaryFile);
+        m_binaryFile = nullptr;
+    }
+    m_binaryFormatIds.clear();
+    errno_t errorCode = fopen_s(&m_binaryFile, filePath, "wb");
+    if (errorCode != 0x0)
+    {
+        m_binaryFile = nullptr;
+    }
+    else
+    {
+        uint32_t magic = BINARY_LOG_FILE_MAGIC;
+        uint32_t version = BINARY_LOG_FILE_VERSION;
+        fwrite(&magic, sizeof(uint32_t), 1, m_binaryFile);
+        fwrite(&version, sizeof(uint32_t), 1, m_binaryFile);
+    }
+    LeaveCriticalSection(&m_drainCriticalSection);
+    return m_binaryFile != nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::StopBinaryLog()
+{
+    EnterCriticalSection(&m_drainCriticalSection);
+    DrainThreadBuffers();
+    if (m_binaryFile)
+    {
+        fclose(m_binaryFile);
+        m_binaryFile = nullptr;
+    }
+    m_binaryFormatIds.clear();
+    LeaveCriticalSection(&m_drainCriticalSection);
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::AppendToBatch(const char* text, size_t length)
+{
+    if (m_writeBatch.size() + length > WRITE_BATCH_SIZE)
+    {
+        WriteBatch();
+    }
+    if (length > WRITE_BATCH_SIZE)
+    {
+        WriteToFile(text, length);
+        return;
+    }
+    m_writeBatch.insert(m_writeBatch.end(), text, text + length);
+}
+
+//-----------------------------------------------------------------------------------
+//One fwrite for everything we've drained, instead of one per message.
+void Logger::WriteBatch()
+{
+    if (!m_writeBatch.empty())
+    {
+        WriteToFile(m_writeBatch.data(), m_writeBatch.size());
+        m_writeBatch.clear();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Rotation only ever happens between batches, so a message never gets split across two files.
+void Logger::WriteToFile(const char* data, size_t length)
+{
+    if (ShouldRotateLogFile(length))
+    {
+        OpenNextLogFile();
+    }
+    fwrite(data, sizeof(unsigned char), length, m_file);
+    m_fileSizeBytes += length;
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::FlushLog()
+{
+    DrainThreadBuffers();
+    fflush(m_file);
+    if (m_binaryFile)
+    {
+        fflush(m_binaryFile);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//The crash might have hit with the writer halfway through a drain, so only drain if nobody else is. Whatever made it out still gets flushed.
+void Logger::FlushLogAfterCrash()
+{
+    if (TryEnterCriticalSection(&m_drainCriticalSection))
+    {
+        //Critical sections are reentrant, so getting the lock doesn't mean nobody's draining. It might be us, crashed partway through.
+        if (!m_isDraining)
+        {
+            DrainThreadBuffers();
+        }
+        LeaveCriticalSection(&m_drainCriticalSection);
+    }
+    fflush(m_file);
+    if (m_binaryFile)
+    {
+        fflush(m_binaryFile);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::StartLoggingThread()
+{
+    m_isLoggingThreadRunning.store(true, std::memory_order_release);
+    m_loggingThread = std::thread(LoggerThreadMain);
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::StopLoggingThread()
+{
+    m_isLoggingThreadRunning.store(false, std::memory_order_release);
+    WakeLoggingThread();
+    if (m_loggingThread.joinable())
+    {
+        m_loggingThread.join();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+void Logger::WakeLoggingThread()
+{
+    SetEvent(m_wakeEvent);
 }
 
 //-----------------------------------------------------------------------------------
-void Logger::Log(LogMessage* message)
+//Consumer side only. Batches the message for the next write and forwards it wherever the build config asks.
+void Logger::Log(const char* message)
 {
-    fwrite(message->formattedMessage, sizeof(unsigned char), strlen(message->formattedMessage), m_file);
+    AppendToBatch(message, strlen(message));
     #ifdef FORWARD_LOG_TO_OUTPUT_WINDOW
     {
-        DebuggerPrintf(message->formattedMessage);
+        DebuggerPrintf("%s", message);
     }
     #endif // FORWARD_LOG_TO_OUTPUT_WINDOW
     #ifdef FORWARD_LOG_TO_CONSOLE
     {
         if (Console::instance != nullptr)
         {
-            Console::instance->PrintLine(message->formattedMessage, RGBA::CERULEAN);
+            Console::instance->PrintLine(message, RGBA::CERULEAN);
         }
     }
     #endif // FORWARD_LOG_TO_CONSOLE
@@ -195,14 +578,7 @@ static void LogPrintf(LogLevel level, const char* format, va_list args)
     {
         return;
     }
-    LogMessage* msg = new LogMessage();
-    msg->formattedMessage = new char[LOGF_STACK_LOCAL_TEMP_LENGTH];
-    vsnprintf_s(msg->formattedMessage, LOGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, args);
-    msg->formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
-
-    //Send message off to I/O thread
-    Logger::instance->EnqueueMessage(msg);
-
+    Logger::instance->LogFormatted(level, nullptr, format, args);
 }
 
 //-----------------------------------------------------------------------------------
@@ -232,17 +608,30 @@ void LogPrintfWithCallstack(LogLevel level, const char* format, ...)
     }
     va_list variableArgumentList;
     va_start(variableArgumentList, format); 
-    LogMessage* msg = new LogMessage();
-    msg->callstack = AllocateCallstack();
-    msg->formattedMessage = new char[LOGF_STACK_LOCAL_TEMP_LENGTH];
-    vsnprintf_s(msg->formattedMessage, LOGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, variableArgumentList);
-    msg->formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
-
-    //Send message off to I/O thread
-    Logger::instance->EnqueueMessage(msg);
+    Logger::instance->LogFormatted(level, AllocateCallstack(), format, variableArgumentList);
     va_end(variableArgumentList);
 }
 
+//-----------------------------------------------------------------------------------
+static LONG WINAPI FlushLogOnUnhandledException(EXCEPTION_POINTERS* exceptionInfo)
+{
+    if (Logger::instance)
+    {
+        Logger::instance->FlushLogAfterCrash();
+    }
+    return s_previousExceptionFilter ? s_previousExceptionFilter(exceptionInfo) : EXCEPTION_CONTINUE_SEARCH;
+}
+
+//-----------------------------------------------------------------------------------
+//FatalError and anything else that calls exit() skips the logger's destructor.
+static void FlushLogAtExit()
+{
+    if (Logger::instance)
+    {
+        Logger::instance->FlushLogAfterCrash();
+    }
+}
+
 //-----------------------------------------------------------------------------------
 void LoggerStartup()
 {
@@ -254,6 +643,13 @@ void LoggerStartup()
     {
         Logger::instance = new Logger();
         Logger::instance->StartLoggingThread();
+        s_previousExceptionFilter = SetUnhandledExceptionFilter(FlushLogOnUnhandledException);
+        static bool hasRegisteredExitFlush = false;
+        if (!hasRegisteredExitFlush)
+        {
+            atexit(FlushLogAtExit);
+            hasRegisteredExitFlush = true;
+        }
     }
 }
 
@@ -262,6 +658,8 @@ void LoggerShutdown()
 {
     if (Logger::instance)
     {
+        SetUnhandledExceptionFilter(s_previousExceptionFilter);
+        s_previousExceptionFilter = nullptr;
         delete Logger::instance;
         Logger::instance = nullptr;
     }
@@ -272,22 +670,13 @@ void LoggerShutdown()
 }
 
 //-----------------------------------------------------------------------------------
-LogMessage::LogMessage()
-    : formattedMessage(nullptr)
-    , callstack(nullptr) 
-{
-
-};
-
-//-----------------------------------------------------------------------------------
-LogMessage::~LogMessage()
+CONSOLE_COMMAND(logrotate)
 {
-    if (formattedMessage)
+    UNUSED(args);
+    if (!Logger::instance)
     {
-        delete[] formattedMessage;
-    }
-    if (callstack)
-    {
-        FreeCallstack(callstack);
+        return;
     }
-};
+    Logger::instance->RotateLogFile();
+    Console::instance->PrintLine(Stringf("Now logging to '%s'.", Logger::instance->m_fileName.c_str()), RGBA::GBLIGHTGREEN);
+}
@@ -2,13 +2,18 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <thread>
-#include <deque>
+#include <atomic>
+#include <vector>
+#include <map>
+#include <stdarg.h>
 #include "Engine/Core/Memory/UntrackedAllocator.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
-#include "Engine/DataStructures/ThreadSafeQueue.hpp"
+#include "Engine/Input/LogThreadBuffer.hpp"
 
 struct Callstack;
+const int LOGF_STACK_LOCAL_TEMP_LENGTH = 2048;
+typedef double(*LogClockFunction)();
 
 //-----------------------------------------------------------------------------------
 enum class LogLevel
@@ -23,44 +28,85 @@ enum class LogLevel
 };
 
 //-----------------------------------------------------------------------------------
-struct LogMessage
-{
-    LogMessage();
-    ~LogMessage();
-    char* formattedMessage;
-    Callstack* callstack;
-};
-
-//-----------------------------------------------------------------------------------
+//Every thread formats straight into its own ring buffer, so logging never locks or allocates on the calling thread.
+//The writer thread sleeps until it's signaled or the flush interval passes, then merges every ring by sequence number into one batched write.
 class Logger
 {
 public:
     //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
-    Logger();
+    //Rotation and flush timing read the clock, which defaults to GetCurrentTimeSeconds.
+    Logger(LogClockFunction clock = nullptr);
     ~Logger();
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
-    void EnqueueMessage(LogMessage* msg);
-    LogMessage* DequeueMessage();
+    void LogFormatted(LogLevel level, Callstack* callstack, const char* format, va_list args, const char* textPrefix = nullptr);
+    //Lets callers write a record straight into this thread's buffer. Every BeginRecord needs a matching EndRecord on the same thread.
+    byte* BeginRecord(size_t maxPayloadSize);
+    void EndRecord(LogRecordType type, LogLevel level, size_t payloadSize);
+    //While a binary log is open, binary records get written out raw instead of formatted into the text log.
+    bool StartBinaryLog(const char* filePath);
+    void StopBinaryLog();
     void FlushLog();
-    bool HasMessages();
+    //Only does what's safe with the process going down. Never waits on the writer thread.
+    void FlushLogAfterCrash();
+    void RotateLogFile();
     void StartLoggingThread();
-    void Log(LogMessage* message);
-    void Log(const char* message);
+    void StopLoggingThread();
+    void WakeLoggingThread();
     void CreateLogFile();
     void CleanUpOldLogFiles();
     void CopyLogFileAsLatest();
+    inline bool IsLoggingThreadRunning() const { return m_isLoggingThreadRunning.load(std::memory_order_acquire); };
 
     //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
     static Logger* instance;
 
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const size_t THREAD_BUFFER_SIZE = 64 * 1024;
+    static const size_t WRITE_BATCH_SIZE = 64 * 1024;
+    static const unsigned int DRAIN_INTERVAL_MS = 50;
+    static const unsigned int MAX_SEQUENCE_GAP_CHECKS = 1000;
+
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     std::thread m_loggingThread;
     FILE* m_file;
     std::string m_fileName;
+    size_t m_rotationSizeBytes; //0 for no size limit
+    double m_rotationIntervalSeconds; //0 for no time limit
+    double m_flushIntervalSeconds;
 
 private:
-    ThreadSafeQueue<LogMessage> m_loggingQueue;
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    friend void LoggerThreadMain();
+    LogThreadBuffer* GetOrCreateThreadBuffer();
+    byte* ReserveRecord(LogThreadBuffer* buffer, size_t maxPayloadSize);
+    void DrainThreadBuffers();
+    void WriteRecord(const LogRecordHeader* header);
+    void WriteBinaryRecord(const LogRecordHeader* header);
+    void Log(const char* message);
+    void AppendToBatch(const char* text, size_t length);
+    void WriteBatch();
+    void WriteToFile(const char* data, size_t length);
+    bool ShouldRotateLogFile(size_t numBytesToWrite) const;
+    void OpenNextLogFile();
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::atomic<LogThreadBuffer*> m_threadBuffers; //Every buffer ever handed out, newest first. Buffers get reused once their thread exits, never freed.
+    std::vector<char, UntrackedAllocator<char>> m_writeBatch;
+    CRITICAL_SECTION m_drainCriticalSection; //Keeps the consumer side single threaded when someone flushes from outside the writer thread
+    bool m_isDraining; //Only touched with the drain lock held, so it's only ever seen set by the thread doing the draining
+    LogClockFunction m_clock;
+    HANDLE m_wakeEvent;
+    std::atomic<uint64_t> m_nextRecordSequence; //Shared by every producer
+    uint64_t m_nextSequenceToWrite; //Consumer side only
+    FILE* m_binaryFile;
+    std::map<const char*, uint32_t, std::less<const char*>, UntrackedAllocator<std::pair<const char* const, uint32_t>>> m_binaryFormatIds; //Which format strings this binary log has defined already
+    std::atomic<bool> m_isLoggingThreadRunning;
+    size_t m_fileSizeBytes;
+    double m_fileOpenedTimeSeconds;
+    double m_lastFlushTimeSeconds;
+    unsigned int m_filePartIndex; //Bumped on every rotation, so files rotated within the same second still get their own names
+    bool m_hasUnflushedSevereRecord;
 };
 
 //GLOBAL FUNCTIONS/////////////////////////////////////////////////////////////////////
@@ -1,5 +1,6 @@
 #include "Engine/Math/Dice.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Math/MathUtils.hpp"
 
 //-----------------------------------------------------------------------------------
@@ -17,18 +18,24 @@ Dice::Dice(const std::string& diceString)
     , m_numDice(0)
     , m_bonusModifier(0)
 {
-    std::vector<std::string>* stringPieces = SplitStringOnMultipleDelimiters(diceString, 3, "d", "+", "-");
-    m_numDice = stoi(stringPieces->at(0));
-    m_numSides = stoi(stringPieces->at(1));
-    if (stringPieces->size() == 3)
+    StringTokenizer stringPieces(diceString, "d+-", true);
+    StringView numDice;
+    StringView numSides;
+    StringView bonusModifier;
+    //A bad string leaves the dice at 0d0+0, so it rolls 0 instead of garbage.
+    if (!stringPieces.Next(numDice) || !stringPieces.Next(numSides) || !numDice.ParseInt(m_numDice) || !numSides.ParseInt(m_numSides)
+        || (stringPieces.Next(bonusModifier) && !bonusModifier.ParseInt(m_bonusModifier)))
     {
-        m_bonusModifier = stoi(stringPieces->at(2));
-        if (diceString.find('-') != std::string::npos)
-        {
-            m_bonusModifier *= -1;
-        }
+        ERROR_RECOVERABLE(Stringf("Couldn't read \"%s\" as dice, expected something like 2d6+1.", diceString.c_str()));
+        m_numDice = 0;
+        m_numSides = 0;
+        m_bonusModifier = 0;
+        return;
+    }
+    if (diceString.find('-') != std::string::npos)
+    {
+        m_bonusModifier *= -1;
     }
-    delete stringPieces;
 }
 
 //-----------------------------------------------------------------------------------
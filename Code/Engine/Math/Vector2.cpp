@@ -7,6 +7,7 @@
 #include <float.h>
 #include <string>
 #include "../Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 
 const Vector2 Vector2::ZERO = Vector2(0.0f, 0.0f);
 const Vector2 Vector2::ONE = Vector2(1.0f, 1.0f);
@@ -215,9 +216,15 @@ Vector2& Vector2::operator/=(const float& scalarConstant)
 //-----------------------------------------------------------------------------------
 Vector2 Vector2::CreateFromString(const char* xmlString)
 {
-    std::vector<std::string>* components = SplitString(std::string(xmlString), ",");
-    Vector2 returnValue = Vector2(std::stof(components->at(0)), std::stof(components->at(1)));
-    delete components;
+    StringTokenizer components(xmlString, ",");
+    StringView x;
+    StringView y;
+    Vector2 returnValue = Vector2::ZERO;
+    if (!components.Next(x) || !components.Next(y) || !x.ParseFloat(returnValue.x) || !y.ParseFloat(returnValue.y))
+    {
+        ERROR_RECOVERABLE(Stringf("Couldn't read \"%s\" as a Vector2, using (0, 0).", xmlString ? xmlString : ""));
+        return Vector2::ZERO;
+    }
     return returnValue;
 }
 
@@ -1,7 +1,8 @@
 #include "Engine/Net/NetSystem.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-#include "Engine/Input/Logging.hpp"
+#include "Engine/Core/ProfilingCounters.hpp"
+#include "Engine/Input/LogChannels.hpp"
 #include "Engine/Input/Console.hpp"
 #include "Engine/Net/UDPIP/NetSession.hpp"
 
@@ -70,7 +71,7 @@ addrinfo* NetSystem::AllocAddressesForHost(char const* hostName, // host, like g
     int status = getaddrinfo(hostName, portNumber, &hints, &result);
     if (status != 0) 
     {
-        LogPrintf(LogLevel::WARNING, "Network: Failed to find addresses for [%s:%s]. Error[%s]", hostName, portNumber, gai_strerror(status));
+        LOG_WARNING(LOG_CHANNEL_NET, "Network: Failed to find addresses for [%s:%s]. Error[%s]", hostName, portNumber, gai_strerror(status));
         return nullptr;
     }
 
@@ -288,7 +289,8 @@ size_t NetSystem::SendOnSocket(bool& outShouldDisconnect, SOCKET mySocket, const
     outShouldDisconnect = false;
     if (mySocket != INVALID_SOCKET) 
     {
-        //send will return the amount of data actually sent. It SHOULD match, or be an error.  
+        //send will return the amount of data actually sent. On a non-blocking TCP socket that can be less than we asked for,
+        //so the caller has to hang on to the rest and try again later.
         int size = ::send(mySocket, (char const*)data, (int)dataSize, 0);
         if (size < 0) 
         {
@@ -298,12 +300,10 @@ size_t NetSystem::SendOnSocket(bool& outShouldDisconnect, SOCKET mySocket, const
                 //If the error is critical - disconnect this socket
                 outShouldDisconnect = true;
             }
+            return 0U;
         }
-        else 
-        {
-            ASSERT_OR_DIE((size_t)size == dataSize, "The size of the data sent wasn't the same as the size we attempted to send");
-        }
-
+        PROFILE_COUNTER_INCREMENT(COUNTER_PACKETS_SENT);
+        PROFILE_COUNTER_ADD(COUNTER_BYTES_SENT, size);
         return (size_t)size;
     }
     else
@@ -335,6 +335,8 @@ size_t NetSystem::RecieveFromSocket(bool& outShouldDisconnect, SOCKET mySocket,
         }
         else 
         {
+            //0 is the other side closing the connection. With nothing to read, a non-blocking socket errors with WSAEWOULDBLOCK instead.
+            outShouldDisconnect = (size == 0 && bufferSize > 0);
             return (size_t)size;
         }
     }
@@ -382,12 +384,12 @@ bool NetSystem::StringToSockAddrIPv4(sockaddr_in& outSockAddr, const char* strin
     unsigned long address = inet_addr(string);
     if (address == INADDR_NONE) 
     {
-        LogPrintf(LogLevel::SEVERE, "StringToSockAddrIPv4 failed and returned INADDR_NONE.\n");
+        LOG_SEVERE(LOG_CHANNEL_NET, "StringToSockAddrIPv4 failed and returned INADDR_NONE.\n");
         return false;
     }
     if (address == INADDR_ANY) 
     {
-        LogPrintf(LogLevel::SEVERE, "StringToSockAddrIPv4 failed and returned INADDR_ANY.\n");
+        LOG_SEVERE(LOG_CHANNEL_NET, "StringToSockAddrIPv4 failed and returned INADDR_ANY.\n");
         return false;
     }
     outSockAddr.sin_addr.S_un.S_addr = address;
@@ -1,14 +1,22 @@
 #include "Engine/Net/RemoteCommandService.hpp"
 #include "Engine/Input/Console.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Core/ProfilingUtils.h"
+#include "Engine/Time/Time.hpp"
 #include "NetSystem.hpp"
+#include <algorithm>
 #include <string.h>
+#include <stdlib.h>
 
 RemoteCommandService* RemoteCommandService::instance = nullptr;
+extern int g_frameNumber;
 
 //-----------------------------------------------------------------------------------
 RemoteCommandService::RemoteCommandService()
     : m_listener(nullptr)
+    , m_profileStreamLog(nullptr)
+    , m_profileSummaryFrame(-1)
 {
 
 }
@@ -16,6 +24,7 @@ RemoteCommandService::RemoteCommandService()
 //-----------------------------------------------------------------------------------
 RemoteCommandService::~RemoteCommandService()
 {
+    StopProfileStreamLog();
     if (m_listener)
     {
         delete m_listener;
@@ -84,8 +93,11 @@ void RemoteCommandService::SendCommand(byte commandId, const char* command)
 //-----------------------------------------------------------------------------------
 void RemoteCommandService::Update()
 {
+    MemoryTagScope tagScope(MEMTAG_NETWORKING);
     CheckForConnection(); //Accepts
     CheckForMessages(); //Recieves
+    StreamProfilingSummaries(); //Sends profiling data to anyone who asked for it
+    FlushPendingOutput(); //Sends whatever didn't fit last time
     CheckForDisconnection(); //Disconeccts
 }
 
@@ -97,10 +109,87 @@ void RemoteCommandService::AddConnection(RemoteCommandServiceConnection* connect
 }
 
 //-----------------------------------------------------------------------------------
-void RemoteCommandService::OnRecieveRemoteMessage(RemoteCommandServiceConnection* , const byte , const char* msg)
+void RemoteCommandService::OnRecieveRemoteMessage(RemoteCommandServiceConnection* connection, const byte id, const char* msg)
 {
-    Console::instance->PrintLine(Stringf("Running remote command: %s", msg), RGBA::FOREST_GREEN);
-    Console::instance->RunCommand(msg);
+    m_onMessage.Trigger(connection, id, msg);
+    if (id == MSG_PROFILE_SUBSCRIBE)
+    {
+        connection->m_profileSummariesPerSecond = (float)atof(msg);
+        connection->m_nextProfileSummarySeconds = 0.0;
+        return;
+    }
+    else if (id == MSG_PROFILE_FRAME)
+    {
+        if (Console::instance)
+        {
+            Console::instance->PrintLine(msg, RGBA::CERULEAN);
+        }
+        if (m_profileStreamLog)
+        {
+            fprintf(m_profileStreamLog, "%s\n", msg);
+        }
+        return;
+    }
+    //Tools run without a console, they only see messages through m_onMessage.
+    if (Console::instance)
+    {
+        Console::instance->PrintLine(Stringf("Running remote command: %s", msg), RGBA::FOREST_GREEN);
+        Console::instance->RunCommand(msg);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Rate limited per connection, and a backed up connection just skips a summary. The game thread never waits on the network.
+//The summary is built at most once a frame, no matter how many subscribers or updates there are.
+void RemoteCommandService::StreamProfilingSummaries()
+{
+    static const unsigned int NUM_TOP_SECTIONS = 5;
+    double currentTime = GetCurrentTimeSeconds();
+    for (RemoteCommandServiceConnection* connection : m_connections)
+    {
+        if (connection->m_profileSummariesPerSecond <= 0.0f || currentTime < connection->m_nextProfileSummarySeconds || connection->m_lastProfileSummaryFrame == g_frameNumber)
+        {
+            continue;
+        }
+        if (m_profileSummaryFrame != g_frameNumber)
+        {
+            char summary[1024];
+            if (!ProfilingSystem::IsProfilingEnabled() || !ProfilingSystem::instance->BuildFrameSummary(summary, sizeof(summary), NUM_TOP_SECTIONS))
+            {
+                return;
+            }
+            m_profileSummary = summary;
+            m_profileSummaryFrame = g_frameNumber;
+        }
+        if (connection->SendMessageIfPossible(MSG_PROFILE_FRAME, m_profileSummary.c_str()))
+        {
+            connection->m_lastProfileSummaryFrame = g_frameNumber;
+        }
+        connection->m_nextProfileSummarySeconds = currentTime + (1.0 / connection->m_profileSummariesPerSecond);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+bool RemoteCommandService::StartProfileStreamLog(const char* filePath)
+{
+    StopProfileStreamLog();
+    errno_t error = fopen_s(&m_profileStreamLog, filePath, "a");
+    if (error != 0 || m_profileStreamLog == nullptr)
+    {
+        m_profileStreamLog = nullptr;
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+void RemoteCommandService::StopProfileStreamLog()
+{
+    if (m_profileStreamLog)
+    {
+        fclose(m_profileStreamLog);
+        m_profileStreamLog = nullptr;
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -113,7 +202,11 @@ void RemoteCommandService::CheckForConnection()
         {
             RemoteCommandServiceConnection* rcs = new RemoteCommandServiceConnection(connection);
             AddConnection(rcs);
-            Console::instance->PrintLine(Stringf("Connected with %s", rcs->GetAddressString()), RGBA::GBLIGHTGREEN);
+            if (Console::instance)
+            {
+                Console::instance->PrintLine(Stringf("Connected with %s", rcs->GetAddressString()), RGBA::GBLIGHTGREEN);
+            }
+            m_onConnectionJoin.Trigger(rcs);
         }
     }
 }
@@ -130,12 +223,39 @@ void RemoteCommandService::CheckForMessages()
 //-----------------------------------------------------------------------------------
 void RemoteCommandService::CheckForDisconnection()
 {
+    for (auto iter = m_connections.begin(); iter != m_connections.end();)
+    {
+        RemoteCommandServiceConnection* connection = *iter;
+        if (connection->IsConnected())
+        {
+            ++iter;
+            continue;
+        }
+        if (Console::instance)
+        {
+            Console::instance->PrintLine(Stringf("Lost the connection with %s", connection->GetAddressString()), RGBA::CHOCOLATE);
+        }
+        m_onConnectionLeave.Trigger(connection);
+        iter = m_connections.erase(iter);
+        delete connection;
+    }
+}
 
+//-----------------------------------------------------------------------------------
+void RemoteCommandService::FlushPendingOutput()
+{
+    for (RemoteCommandServiceConnection* connection : m_connections)
+    {
+        connection->FlushPendingOutput();
+    }
 }
 
 //-----------------------------------------------------------------------------------
 RemoteCommandServiceConnection::RemoteCommandServiceConnection(TCPConnection* tcpConn)
     : m_tcpConnection(tcpConn)
+    , m_profileSummariesPerSecond(0.0f)
+    , m_nextProfileSummarySeconds(0.0)
+    , m_lastProfileSummaryFrame(-1)
 {
 
 }
@@ -146,17 +266,58 @@ RemoteCommandServiceConnection::~RemoteCommandServiceConnection()
     if (m_tcpConnection && m_tcpConnection->IsConnected())
     {
         m_tcpConnection->Disconnect();
-        delete m_tcpConnection;
     }
+    delete m_tcpConnection;
 }
 
 //-----------------------------------------------------------------------------------
+//Never lost and never split: whatever the socket won't take right now waits in m_pendingOutput for the next update.
 void RemoteCommandServiceConnection::Send(byte commandId, const char* command)
 {
-    m_tcpConnection->Send(&commandId, 1);
-    m_tcpConnection->Send(command, strlen(command));
-    char nil = NULL;
-    m_tcpConnection->Send(&nil, 1);
+    if (!IsConnected())
+    {
+        return;
+    }
+    size_t commandLength = strlen(command);
+    if (m_pendingOutput.size() + commandLength + 2 > MAX_PENDING_OUTPUT_BYTES)
+    {
+        //They haven't been reading for a long time. Better to drop them than to grow forever or stall the game thread.
+        m_tcpConnection->Disconnect();
+        m_pendingOutput.clear();
+        return;
+    }
+    m_pendingOutput.push_back((char)commandId);
+    m_pendingOutput.insert(m_pendingOutput.end(), command, command + commandLength + 1);
+    FlushPendingOutput();
+}
+
+//-----------------------------------------------------------------------------------
+//For messages that are fine to lose, like a profiling summary that'll be stale by next frame anyway.
+//Skipped while older output is still waiting, so a slow reader can't make us queue up more and more of them.
+bool RemoteCommandServiceConnection::SendMessageIfPossible(byte commandId, const char* message)
+{
+    if (!IsConnected() || !m_pendingOutput.empty())
+    {
+        return false;
+    }
+    Send(commandId, message);
+    return IsConnected();
+}
+
+//-----------------------------------------------------------------------------------
+void RemoteCommandServiceConnection::FlushPendingOutput()
+{
+    size_t numBytesSent = 0;
+    while (numBytesSent < m_pendingOutput.size() && IsConnected())
+    {
+        size_t sent = m_tcpConnection->Send(m_pendingOutput.data() + numBytesSent, m_pendingOutput.size() - numBytesSent);
+        if (sent == 0)
+        {
+            break;
+        }
+        numBytesSent += sent;
+    }
+    m_pendingOutput.erase(m_pendingOutput.begin(), m_pendingOutput.begin() + numBytesSent);
 }
 
 //-----------------------------------------------------------------------------------
@@ -164,18 +325,30 @@ void RemoteCommandServiceConnection::Receive()
 {
     const size_t BUFFER_SIZE = 1024;
     byte buffer[BUFFER_SIZE];
-    size_t read = m_tcpConnection->Receive(buffer, BUFFER_SIZE);
-    for (size_t i = 0; i < read; ++i)
+    size_t read = 0;
+    while (IsConnected() && (read = m_tcpConnection->Receive(buffer, BUFFER_SIZE)) > 0)
     {
-        char c = buffer[i];
-        m_nextMessage.push_back(c);
-        if (c == NULL)
+        for (size_t i = 0; i < read; ++i)
         {
-            m_onMessage.Trigger(this, m_nextMessage[0], &m_nextMessage[1]);
-            m_nextMessage.clear();
+            char c = buffer[i];
+            m_nextMessage.push_back(c);
+            if (c == NULL)
+            {
+                //A lone terminator has no id to go with it, so there's nothing to hand out.
+                if (m_nextMessage.size() > 1)
+                {
+                    m_onMessage.Trigger(this, m_nextMessage[0], &m_nextMessage[1]);
+                }
+                m_nextMessage.clear();
+            }
         }
     }
-    read = m_tcpConnection->Receive(buffer, BUFFER_SIZE);
+}
+
+//-----------------------------------------------------------------------------------
+bool RemoteCommandServiceConnection::IsConnected()
+{
+    return m_tcpConnection && m_tcpConnection->IsConnected();
 }
 
 //-----------------------------------------------------------------------------------
@@ -354,4 +527,40 @@ CONSOLE_COMMAND(commandserverleave)
     {
         Console::instance->PrintLine("Failed to disconnect because you're not connected to a host.", RGBA::RED);
     }
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------------
+CONSOLE_COMMAND(profilestream)
+{
+    if (!RemoteCommandService::instance)
+    {
+        Console::instance->PrintLine("The remote command service isn't running.", RGBA::RED);
+        return;
+    }
+    if (!args.HasArgs(1) && !args.HasArgs(2))
+    {
+        Console::instance->PrintLine("profilestream <summaries per second, 0 stops> <optional: log file path>", RGBA::GRAY);
+        Console::instance->PrintLine("Asks every joined command service to stream profiling summaries here.", RGBA::GRAY);
+        return;
+    }
+    std::string rate = args.GetStringArgument(0);
+    for (RemoteCommandServiceConnection* connection : RemoteCommandService::instance->m_connections)
+    {
+        connection->Send(MSG_PROFILE_SUBSCRIBE, rate.c_str());
+    }
+    if (atof(rate.c_str()) <= 0.0)
+    {
+        RemoteCommandService::instance->StopProfileStreamLog();
+        Console::instance->PrintLine("Stopped the profiling stream.", RGBA::CHOCOLATE);
+        return;
+    }
+    if (args.HasArgs(2))
+    {
+        std::string filePath = args.GetStringArgument(1);
+        if (!RemoteCommandService::instance->StartProfileStreamLog(filePath.c_str()))
+        {
+            Console::instance->PrintLine(Stringf("Couldn't open '%s' for writing.", filePath.c_str()), RGBA::RED);
+        }
+    }
+    Console::instance->PrintLine(Stringf("Requested %s profiling summaries per second from %u connections.", rate.c_str(), RemoteCommandService::instance->m_connections.size()), RGBA::GBLIGHTGREEN);
+}
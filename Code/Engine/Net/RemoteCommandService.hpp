@@ -2,7 +2,9 @@
 #include "Engine/Net/TCPIP/TCPConnection.hpp"
 #include "Engine/Net/TCPIP/TCPListener.hpp"
 #include "Engine/Core/Events/Event.hpp"
+#include <string>
 #include <vector>
+#include <stdio.h>
 
 //TYPEDEFS/////////////////////////////////////////////////////////////////////
 typedef unsigned char byte;
@@ -13,6 +15,10 @@ typedef unsigned char byte;
 const byte MSG_COMMAND = 1; //Run a console command
 const byte MSG_ECHO = 2; //Print on the remote console
 const byte MSG_RENAME = 3; //Give the remote connection a name
+const byte MSG_PROFILE_SUBSCRIBE = 4; //Ask the other side to stream profiling summaries. The payload is how many per second, 0 stops them.
+const byte MSG_PROFILE_FRAME = 5; //One profiling summary line
+//Anything a connection can't get rid of past this and it's dropped, the other side has stopped reading.
+const size_t MAX_PENDING_OUTPUT_BYTES = 4 * 1024 * 1024;
 
 //-----------------------------------------------------------------------------------
 class RemoteCommandServiceConnection
@@ -21,11 +27,18 @@ public:
     RemoteCommandServiceConnection(TCPConnection* tcpConnection);
     ~RemoteCommandServiceConnection();
     void Send(byte commandId, const char* command);
+    bool SendMessageIfPossible(byte commandId, const char* message);
+    void FlushPendingOutput();
     void Receive();
+    bool IsConnected();
     const char* GetAddressString();
     //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
     TCPConnection* m_tcpConnection;
     std::vector<char> m_nextMessage;
+    std::vector<char> m_pendingOutput; //Whatever the socket wouldn't take yet. Goes out before anything newer.
+    float m_profileSummariesPerSecond; //0 if they haven't subscribed
+    double m_nextProfileSummarySeconds;
+    int m_lastProfileSummaryFrame; //So a frame's summary only goes out once
     Event<RemoteCommandServiceConnection*, byte, const char*> m_onMessage;
 };
 
@@ -45,6 +58,10 @@ public:
     void CheckForConnection();
     void CheckForMessages();
     void CheckForDisconnection();
+    void FlushPendingOutput();
+    void StreamProfilingSummaries();
+    bool StartProfileStreamLog(const char* filePath);
+    void StopProfileStreamLog();
     inline bool IsHosting() { return m_listener != nullptr; };
     inline bool IsJoined() { return !IsHosting() && (m_connections.size() > 0); };
     void DisconnectFromHost();
@@ -53,6 +70,9 @@ public:
 
     TCPListener* m_listener;
     std::vector<RemoteCommandServiceConnection*> m_connections;
+    FILE* m_profileStreamLog; //Where summaries we receive get written, on top of the console
+    std::string m_profileSummary; //Shared by every subscriber, only rebuilt when the frame changes
+    int m_profileSummaryFrame;
     Event<RemoteCommandServiceConnection*> m_onConnectionJoin;
     Event<RemoteCommandServiceConnection*> m_onConnectionLeave;
     Event<RemoteCommandServiceConnection*, const byte, const char*> m_onMessage;
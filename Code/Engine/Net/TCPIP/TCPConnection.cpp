@@ -29,6 +29,10 @@ size_t TCPConnection::Send(const void* data, size_t size)
 {
     bool shouldDisconnect = false;
     size_t sizeSent = NetSystem::SendOnSocket(shouldDisconnect, m_socket, data, size);
+    if (shouldDisconnect)
+    {
+        Disconnect();
+    }
     return sizeSent;
 }
 
@@ -37,6 +41,10 @@ size_t TCPConnection::Receive(void* buffer, size_t size)
 {
     bool shouldDisconnect = false;
     size_t sizeRecieved = NetSystem::RecieveFromSocket(shouldDisconnect, m_socket, buffer, size);
+    if (shouldDisconnect)
+    {
+        Disconnect();
+    }
     return sizeRecieved;
 }
 
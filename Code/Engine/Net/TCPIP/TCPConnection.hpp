@@ -11,8 +11,8 @@ public:
     TCPConnection(const char* host, const char* portNumber); //SocketConnect
 
     void Disconnect(); //Close Socket
-    size_t Send(const void* data, size_t size); //Send On Socket
-    size_t Receive(void* buffer, size_t size); //ReceiveOnSocket
+    size_t Send(const void* data, size_t size); //Send On Socket, can send less than size. Disconnects on a fatal error.
+    size_t Receive(void* buffer, size_t size); //ReceiveOnSocket. Disconnects on a fatal error or if the other side closed.
     bool IsConnected(); //Socket != INVALID_SOCKET
     const char* GetAddressString();
 
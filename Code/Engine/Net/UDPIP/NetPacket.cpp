@@ -1,6 +1,6 @@
 #include "Engine/Net/UDPIP/NetPacket.hpp"
 #include "Engine/Net/UDPIP/NetSession.hpp"
-#include "Engine/Input/Logging.hpp"
+#include "Engine/Input/LogChannels.hpp"
 
 //-----------------------------------------------------------------------------------
 void NetPacket::WriteHeader()
@@ -154,7 +154,7 @@ void NetPacket::ReadMessage(NetMessage& outMessage)
     Read<uint16_t>(msgSize);
     if (msgSize > (MESSAGE_MTU))
     {
-        LogPrintf(LogLevel::WARNING, "Invalid Packet thrown out.");
+        LOG_WARNING(LOG_CHANNEL_NET, "Invalid Packet thrown out.");
         return;
     }
 
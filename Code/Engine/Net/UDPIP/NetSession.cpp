@@ -7,6 +7,7 @@
 #include "Engine/Core/Events/Event.hpp"
 #include "Engine/Input/Logging.hpp"
 #include "Engine/Time/Time.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
 
 NetSession* NetSession::instance = nullptr;
 extern Event<float> NetworkUpdate;
@@ -112,6 +113,7 @@ bool NetSession::SetSessionState(State newState, void(NetSession::*onStateSwitch
 //-----------------------------------------------------------------------------------
 void NetSession::Update(float deltaSeconds)
 {
+    MemoryTagScope tagScope(MEMTAG_NETWORKING);
     ProcessIncomingPackets(); 
     m_timeSinceLastUpdate += deltaSeconds;
     if (m_timeSinceLastUpdate >= m_tickRate)
@@ -2,7 +2,8 @@
 #include "Engine/Net/NetSystem.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
-#include "../../Input/Logging.hpp"
+#include "Engine/Core/ProfilingCounters.hpp"
+#include "../../Input/LogChannels.hpp"
 
 //-----------------------------------------------------------------------------------
 SOCKET UDPSocket::CreateUDPSocket(char const* address,
@@ -87,7 +88,7 @@ SOCKET UDPSocket::CreateUDPSocket(char const* address,
     }
     if (currNumRetries == MAX_RETRIES)
     {
-        LogPrintf(LogLevel::WARNING, "Was unable to bind to a port after %i retries", MAX_RETRIES);
+        LOG_WARNING(LOG_CHANNEL_NET, "Was unable to bind to a port after %i retries", MAX_RETRIES);
     }
     return INVALID_SOCKET;
 }
@@ -108,6 +109,8 @@ size_t UDPSocket::SendTo(const sockaddr_in& toAddress, void const* data, const s
 
         if (size > 0) 
         {
+            PROFILE_COUNTER_INCREMENT(COUNTER_PACKETS_SENT);
+            PROFILE_COUNTER_ADD(COUNTER_BYTES_SENT, size);
             return size;
         }
     }
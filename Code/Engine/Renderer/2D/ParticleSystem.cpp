@@ -7,6 +7,10 @@
 #include "Engine/Math/Matrix4x4.hpp"
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Renderer/2D/ResourceDatabase.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Core/Memory/ArenaAllocator.hpp"
+#include "Engine/Core/ProfilingCounters.hpp"
+#include "Engine/Core/FrameBudgetGovernor.hpp"
 #include "../../Core/ProfilingUtils.h"
 //-----------------------------------------------------------------------------------
 Particle::Particle(const Vector2& spawnPosition, const ParticleEmitterDefinition* definition, float rotationDegrees /*= 0.0f*/, const Vector2& initalVelocity /*= Vector2::ZERO*/, const Vector2& initialAcceleration /*= Vector2::ZERO*/, const RGBA& color /*= RGBA::WHITE*/) 
@@ -25,6 +29,8 @@ Particle::Particle(const Vector2& spawnPosition, const ParticleEmitterDefinition
     definition->m_properties.Get<Range<float>>(PROPERTY_EXPLOSIVE_VELOCITY_MAGNITUDE, explosiveVelocityForce);
     m_velocity += Vector2::CreateFromPolar(explosiveVelocityForce.GetRandom(), m_rotationDegrees);
 }
+int ParticleEmitter::s_spawnQualityLevel = ParticleEmitter::MAX_SPAWN_QUALITY_LEVEL;
+
 //-----------------------------------------------------------------------------------
 ParticleEmitter::ParticleEmitter(ParticleSystem* parent, const ParticleEmitterDefinition* definition, const Transform2D& startingTransform, Transform2D* parentTransform)
     : m_parentSystem(parent)
@@ -131,6 +137,7 @@ void ParticleEmitter::CleanUpDeadParticles()
         {
             m_particles[i] = m_particles[m_particles.size() - 1];
             m_particles.pop_back();
+            PROFILE_COUNTER_ADD(COUNTER_PARTICLES_ALIVE, -1);
         }
         else 
         {
@@ -187,6 +194,7 @@ void ParticleEmitter::SpawnParticle()
     
     RGBA color = m_parentSystem->m_colorOverride == RGBA::WHITE ? m_definition->m_properties.Get<RGBA>(PROPERTY_INITIAL_COLOR) : m_parentSystem->m_colorOverride;
     m_particles.emplace_back(spawnPosition, m_definition, initialRotation, initialVelocity, Vector2::ZERO, color);
+    PROFILE_COUNTER_INCREMENT(COUNTER_PARTICLES_ALIVE);
 }
 
 //-----------------------------------------------------------------------------------
@@ -196,8 +204,10 @@ const SpriteResource* ParticleEmitter::GetSpriteResource()
 }
 
 //-----------------------------------------------------------------------------------
+//CleanUpDeadParticles already took dead particles out of the count as it removed them, so only what's still here comes off.
 void ParticleEmitter::Flush()
 {
+    PROFILE_COUNTER_ADD(COUNTER_PARTICLES_ALIVE, -(int64_t)m_particles.size());
     m_particles.clear();
 }
 
@@ -206,11 +216,13 @@ void ParticleEmitter::SpawnParticles(float deltaSeconds)
 {
     if (m_secondsPerParticle > 0.0f && m_emitterAge < m_maxEmitterAge && !m_parentSystem->m_isPaused)
     {
+        //Lower quality levels stretch the time between particles rather than dropping them, so emitters still look even.
+        float secondsPerParticle = m_secondsPerParticle * (float)MAX_SPAWN_QUALITY_LEVEL / (float)s_spawnQualityLevel;
         m_timeSinceLastEmission += deltaSeconds;
-        while (m_timeSinceLastEmission >= m_secondsPerParticle)
+        while (m_timeSinceLastEmission >= secondsPerParticle)
         {
             SpawnParticle();
-            m_timeSinceLastEmission -= m_secondsPerParticle;
+            m_timeSinceLastEmission -= secondsPerParticle;
         }
     }
 }
@@ -241,6 +253,7 @@ ParticleSystem::~ParticleSystem()
 //-----------------------------------------------------------------------------------
 void ParticleSystem::Update(float deltaSeconds)
 {
+    MemoryTagScope tagScope(MEMTAG_PARTICLES);
     ProfilingSystem::instance->PushSample("ParticleUpdate");
     m_boundingBox = AABB2::INVALID;
     if (!m_isDead)
@@ -261,6 +274,7 @@ void ParticleSystem::Update(float deltaSeconds)
 //-----------------------------------------------------------------------------------
 void ParticleSystem::Render(BufferedMeshRenderer& renderer)
 {
+    MemoryTagScope tagScope(MEMTAG_PARTICLES);
     ProfilingSystem::instance->PushSample("ParticleRender");
     for (ParticleEmitter* emitter : m_emitters)
     {
@@ -288,6 +302,13 @@ void ParticleSystem::DestroyImmediately(ParticleSystem* systemToDestroy)
     delete systemToDestroy;
 }
 
+//-----------------------------------------------------------------------------------
+//Fewer particles is more noticeable than softer bloom, so this goes after the renderer's knob.
+void ParticleSystem::RegisterQualityKnobs(FrameBudgetGovernor* governor)
+{
+    governor->RegisterKnob("particles", &ParticleEmitter::s_spawnQualityLevel, 1, ParticleEmitter::MAX_SPAWN_QUALITY_LEVEL, 10);
+}
+
 //-----------------------------------------------------------------------------------
 void ParticleSystem::Destroy(ParticleSystem* systemToDestroy)
 {
@@ -318,6 +339,7 @@ void ParticleSystem::Flush()
 //-----------------------------------------------------------------------------------
 void RibbonParticleSystem::Update(float deltaSeconds)
 {
+    MemoryTagScope tagScope(MEMTAG_PARTICLES);
     ProfilingSystem::instance->PushSample("RibbonParticleUpdate");
     ParticleSystem::Update(deltaSeconds);
     ProfilingSystem::instance->PopSample("RibbonParticleUpdate");
@@ -326,6 +348,7 @@ void RibbonParticleSystem::Update(float deltaSeconds)
 //-----------------------------------------------------------------------------------
 void RibbonParticleSystem::Render(BufferedMeshRenderer& renderer)
 {
+    MemoryTagScope tagScope(MEMTAG_PARTICLES);
     ProfilingSystem::instance->PushSample("RibbonParticleRender");
     for (ParticleEmitter* emitter : m_emitters)
     {
@@ -360,7 +383,11 @@ void ParticleEmitter::BuildRibbonParticles(BufferedMeshRenderer& renderer)
     float halfWidth = width * 0.5f;
 
     ProfilingSystem::instance->PushSample("RibbonParticleVectorShit");
-    std::vector<RibbonParticlePiece> points;
+    //Scratch space for this function only, so it comes out of the frame arena instead of the heap.
+    LinearArenaScope scratchScope(GetFrameArena());
+    ArenaAllocator<RibbonParticlePiece> frameAllocator(GetFrameArena());
+    ArenaVector<RibbonParticlePiece> points(frameAllocator);
+    points.reserve(numParticles + 1);
     points.emplace_back(m_particles[0]);
     points[0].m_particle.m_position = m_transform.GetWorldPosition();
     points[0].m_particle.m_age = 0;
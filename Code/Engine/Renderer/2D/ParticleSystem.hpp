@@ -12,6 +12,7 @@ class ParticleEmitterDefinition;
 class ParticleSystemDefinition;
 class SpriteResource;
 class ParticleSystem;
+class FrameBudgetGovernor;
 
 //-----------------------------------------------------------------------------------
 struct Particle
@@ -37,6 +38,9 @@ class ParticleEmitter
 public:
     //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
     ParticleEmitter(ParticleSystem* parent, const ParticleEmitterDefinition* definition, const Transform2D& startingTransform, Transform2D* parentTransform = nullptr);
+    //Live particles are counted in COUNTER_PARTICLES_ALIVE, so a copy would take them off the count a second time when it's destroyed.
+    ParticleEmitter(const ParticleEmitter&) = delete;
+    ParticleEmitter& operator=(const ParticleEmitter&) = delete;
     virtual ~ParticleEmitter();
 
     //FUNCTIONS/////////////////////////////////////////////////////////////////////
@@ -66,6 +70,13 @@ public:
     float m_timeSinceLastEmission;
     float m_secondsPerParticle;
     bool m_isDead;
+
+    //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
+    //Scales the spawn rate of every emitter. Driven by the FrameBudgetGovernor.
+    static int s_spawnQualityLevel;
+
+    //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int MAX_SPAWN_QUALITY_LEVEL = 4;
 };
 
 //-----------------------------------------------------------------------------------
@@ -83,6 +94,7 @@ public:
 
     //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
     static void DestroyImmediately(ParticleSystem* systemToDestroy);
+    static void RegisterQualityKnobs(FrameBudgetGovernor* governor);
     static void Destroy(ParticleSystem* systemToDestroy);
     static ParticleSystem* PlayOneShotParticleEffect(const std::string& systemName, unsigned int const layerName, const Transform2D& startingTransform, Transform2D* parentTransform = nullptr, const SpriteResource* spriteOverride = nullptr);
     void Flush();
@@ -11,6 +11,8 @@
 #include "Engine/Input/Console.hpp"
 #include "Engine/Renderer/Framebuffer.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Core/FrameBudgetGovernor.hpp"
 #include "Engine/Time/Time.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "../../Input/InputSystem.hpp"
@@ -20,6 +22,7 @@
 
 //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
 SpriteGameRenderer* SpriteGameRenderer::instance = nullptr;
+int SpriteGameRenderer::s_bloomQualityLevel = SpriteGameRenderer::MAX_BLOOM_QUALITY_LEVEL;
 
 //-----------------------------------------------------------------------------------
 const char* SpriteGameRenderer::DEFAULT_VERT_SHADER =
@@ -115,15 +118,13 @@ SpriteLayer::SpriteLayer(int layerIndex)
     , m_renderablesList(nullptr)
     , m_isEnabled(true)
     , m_boundingVolume(SpriteGameRenderer::instance->m_worldBounds)
-    , m_layerName(CStringf("SpriteLayer[%i]", layerIndex))
 {
-
+    m_layerName.Format("SpriteLayer[%i]", layerIndex);
 }
 
 //-----------------------------------------------------------------------------------
 SpriteLayer::~SpriteLayer()
 {
-    delete m_layerName;
     Renderable2D* currentRenderable = m_renderablesList;
     if (currentRenderable)
     {
@@ -249,6 +250,7 @@ SpriteGameRenderer::~SpriteGameRenderer()
 //-----------------------------------------------------------------------------------
 void SpriteGameRenderer::Update(float deltaSeconds)
 {
+    MemoryTagScope tagScope(MEMTAG_RENDERER);
     #pragma todo("Get changes in screen resolution for the SpriteGameRenderer")
 
     for (auto layerPair : m_layers)
@@ -270,6 +272,7 @@ void SpriteGameRenderer::Update(float deltaSeconds)
 //-----------------------------------------------------------------------------------
 void SpriteGameRenderer::Render()
 {
+    MemoryTagScope tagScope(MEMTAG_RENDERER);
     m_fullscreenCompositeFBO->Bind();
     m_fullscreenCompositeFBO->ClearColorBuffer(0, RGBA::VAPORWAVE);
     m_fullscreenCompositeFBO->Unbind();
@@ -315,9 +318,9 @@ void SpriteGameRenderer::RenderView(const ViewportDefinition& renderArea)
 
     for (auto layerPair : m_layers)
     {
-        ProfilingSystem::instance->PushSample(layerPair.second->m_layerName);
+        ProfilingSystem::instance->PushSample(layerPair.second->m_layerName.c_str());
         RenderLayer(layerPair.second, renderArea);
-        ProfilingSystem::instance->PopSample(layerPair.second->m_layerName);
+        ProfilingSystem::instance->PopSample(layerPair.second->m_layerName.c_str());
     }
     //m_meshRenderer->m_material = nullptr;
 
@@ -432,7 +435,7 @@ void SpriteGameRenderer::RenderLayer(SpriteLayer* layer, const ViewportDefinitio
             m_blurEffect->SetFloatUniform(horizontalUniform, 0.0f);
             Renderer::instance->RenderFullScreenEffect(m_blurEffect);
 
-            int numPasses = layer->m_numBloomPasses;
+            int numPasses = (layer->m_numBloomPasses * s_bloomQualityLevel) / MAX_BLOOM_QUALITY_LEVEL;
             for (int i = 0; i < numPasses; ++i)
             {
                 Renderer::instance->SetRenderTargets(1, &effectCanvas, nullptr);
@@ -616,6 +619,14 @@ void SpriteGameRenderer::UpdateCameraPositionInWorldBounds(const Vector2& newCam
     }
 }
 
+//-----------------------------------------------------------------------------------
+//Bloom is the cheapest thing to lose visually, so it goes first. Its blur passes run once per splitscreen view, so it's also where most of the extra splitscreen cost is.
+//The number of views is left alone on purpose: each one belongs to a player, and dropping one isn't a quality tradeoff the governor gets to make.
+void SpriteGameRenderer::RegisterQualityKnobs(FrameBudgetGovernor* governor)
+{
+    governor->RegisterKnob("bloom", &s_bloomQualityLevel, 1, MAX_BLOOM_QUALITY_LEVEL, 0);
+}
+
 //-----------------------------------------------------------------------------------
 void SpriteGameRenderer::SetSplitscreen(unsigned int numViews /*= 1*/)
 {
@@ -12,6 +12,7 @@
 #include "Engine/Renderer/BufferedMeshRenderer.hpp"
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Renderer/FullScreenEffect.hpp"
+#include "Engine/Core/StackString.hpp"
 
 #define BIT_FLAG(f) (1 << (f))
 
@@ -19,6 +20,7 @@ class ShaderProgram;
 class Mesh;
 class MeshRenderer;
 class Framebuffer;
+class FrameBudgetGovernor;
 
 //-----------------------------------------------------------------------------------
 struct ViewportDefinition
@@ -56,7 +58,7 @@ public:
     std::vector<FullScreenEffect> m_fullScreenEffects;
     AABB2 m_boundingVolume;
     Renderable2D* m_renderablesList;
-    const char* m_layerName;
+    StackString<32> m_layerName;
     int m_layerIndex;
     int m_numBloomPasses = 6;
     float m_virtualScaleMultiplier = 1.0f;
@@ -160,10 +162,16 @@ public:
     static PlayerVisibility GetVisibilityFilterForPlayerNumber(unsigned int i);
     void AddScreenshakeMagnitude(float magnitude, const Vector2& direction = Vector2::ZERO, int viewportNumber = 0);
 
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    static void RegisterQualityKnobs(FrameBudgetGovernor* governor);
+
     //STATIC VARIABLES/////////////////////////////////////////////////////////////////////
     static SpriteGameRenderer* instance;
+    //Scales every layer's bloom passes down from their authored count. Driven by the FrameBudgetGovernor.
+    static int s_bloomQualityLevel;
 
     //CONSTANTS/////////////////////////////////////////////////////////////////////
+    static const int MAX_BLOOM_QUALITY_LEVEL = 4;
     static const char* DEFAULT_VERT_SHADER;
     static const char* DEFAULT_FRAG_SHADER;
     static const char* DEFAULT_BLUR_SHADER;
@@ -47,7 +47,7 @@ void BufferedMeshRenderer::FlushAndRender()
     m_mesh.MarkMeshEmpty();
     //m_mesh.CleanUpRenderObjects();
 #ifdef PROFILING_ENABLED
-    ProfilingSystem::instance->m_activeSample->numDrawCalls += 1;
+    ProfilingSystem::instance->GetActiveSample()->numDrawCalls += 1;
 #endif
 
     ProfilingSystem::instance->PopSample("FlushAndRender");
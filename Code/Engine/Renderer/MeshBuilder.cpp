@@ -9,6 +9,8 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "2D/Sprite.hpp"
 #include "../Core/ProfilingUtils.h"
+#include "../Core/ProfilingCounters.hpp"
+#include "../Core/Memory/MemoryArena.hpp"
 #include "../Input/InputOutputUtils.hpp"
 #include <queue>
 
@@ -73,6 +75,20 @@ MeshBuilder::MeshBuilder()
 
 }
 
+//-----------------------------------------------------------------------------------
+MeshBuilder::MeshBuilder(MemoryArena* arena)
+    : m_vertices(ArenaAllocator<Vertex_Master>(arena))
+    , m_indices(ArenaAllocator<unsigned int>(arena))
+    , m_dataMask(0)
+    , m_stamp()
+    , m_startIndex(0)
+    , m_materialName(nullptr)
+    , m_drawMode(Renderer::DrawMode::TRIANGLES)
+    , m_isSkinned(false)
+{
+
+}
+
 //-----------------------------------------------------------------------------------
 MeshBuilder::~MeshBuilder()
 {
@@ -160,8 +176,10 @@ void MeshBuilder::CopyToMesh(Mesh* mesh, VertexCopyCallback* copyFunction, unsig
     unsigned int vertexSize = sizeofVertex; //mesh->vdefn->vertexSize;
     unsigned int vertex_buffer_size = vertexCount * vertexSize;
 
-    byte* vertexBuffer = new byte[vertex_buffer_size];
+    //Only needed until the mesh has copied it, so it comes out of the frame arena instead of the heap.
     //if (small enough) vertexBuffer = (byte*)_alloca(vertex_buffer_size); //_alloca would on the stack, falls off later. Removed because of stack overflow reasons ;P
+    LinearArenaScope scratchScope(GetFrameArena());
+    byte* vertexBuffer = (byte*)GetFrameArena()->Allocate(vertex_buffer_size, 16);
     byte* currentBufferIndex = vertexBuffer;
 
     for (unsigned int vertex_index = 0;	vertex_index < vertexCount;	++vertex_index) 
@@ -169,6 +187,7 @@ void MeshBuilder::CopyToMesh(Mesh* mesh, VertexCopyCallback* copyFunction, unsig
         copyFunction(m_vertices[vertex_index], currentBufferIndex);
         currentBufferIndex += vertexSize;
     }
+    PROFILE_COUNTER_ADD(COUNTER_VERTICES_BUILT, vertexCount);
     if (ProfilingSystem::instance)
     {
         ProfilingSystem::instance->PushSample("Mesh Init");
@@ -180,7 +199,6 @@ void MeshBuilder::CopyToMesh(Mesh* mesh, VertexCopyCallback* copyFunction, unsig
     }
     mesh->m_drawMode = this->m_drawMode;
     ClearVertsAndIndices();
-    delete vertexBuffer;
 }
 
 //-----------------------------------------------------------------------------------
@@ -198,7 +216,8 @@ void MeshBuilder::AppendToMesh(Mesh* mesh, VertexCopyCallback* copyFunction, uns
     unsigned int vertexSize = sizeofVertex; //mesh->vdefn->vertexSize;
     unsigned int vertex_buffer_size = vertexCount * vertexSize;
 
-    byte* vertexBuffer = new byte[vertex_buffer_size];
+    LinearArenaScope scratchScope(GetFrameArena());
+    byte* vertexBuffer = (byte*)GetFrameArena()->Allocate(vertex_buffer_size, 16);
     byte* currentBufferIndex = vertexBuffer;
 
     //	mesh->m_verts.clear();
@@ -207,11 +226,9 @@ void MeshBuilder::AppendToMesh(Mesh* mesh, VertexCopyCallback* copyFunction, uns
         copyFunction(m_vertices[vertex_index], currentBufferIndex);
         currentBufferIndex += vertexSize;
     }
+    PROFILE_COUNTER_ADD(COUNTER_VERTICES_BUILT, vertexCount);
     mesh->Update(vertexBuffer, vertexCount, sizeofVertex, m_indices.data(), m_indices.size(), bindMeshFunction);
     mesh->m_drawMode = this->m_drawMode;
-    // Make sure we clean up after ourselves
-    delete vertexBuffer;
-
 }
 
 //-----------------------------------------------------------------------------------
@@ -4,6 +4,7 @@
 #include "Engine/Renderer/Vertex.hpp"
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/Vector2.hpp"
+#include "Engine/Core/Memory/ArenaAllocator.hpp"
 #include <vector>
 
 class IBinaryWriter;
@@ -48,6 +49,8 @@ public:
 
     //CONSTRUCTORS//////////////////////////////////////////////////////////////////////////
     MeshBuilder();
+    //Builders that only live for one draw can keep their verts in a scratch arena, see Renderer::DrawText2D.
+    explicit MeshBuilder(MemoryArena* arena);
     ~MeshBuilder();
 
     //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
@@ -140,8 +143,8 @@ public:
     void AddSprite(const SpriteResource* resource, const RGBA& color, Matrix4x4* transform = nullptr);
 
     //MEMBER VARIABLES//////////////////////////////////////////////////////////////////////////
-    std::vector<Vertex_Master> m_vertices;
-    std::vector<unsigned int> m_indices;
+    ArenaVector<Vertex_Master> m_vertices;
+    ArenaVector<unsigned int> m_indices;
     uint32_t m_dataMask;
 
 private:
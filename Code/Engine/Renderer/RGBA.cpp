@@ -2,6 +2,7 @@
 #include "Engine/Math/Vector4.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 
 const RGBA RGBA::WHITE(0xFFFFFFFF);
 const RGBA RGBA::BLACK(0x000000FF);
@@ -133,8 +134,19 @@ RGBA RGBA::CreateFromString(const std::string& textColor)
     }
     else //Format R,G,B
     {
-        std::vector<std::string>* strings = SplitString(textColor, ",");
-        return RGBA(stoi(strings->at(0)) / 255.0f, stoi(strings->at(1)) / 255.0f, stoi(strings->at(2)) / 255.0f);
+        StringTokenizer components(textColor, ",");
+        StringView red;
+        StringView green;
+        StringView blue;
+        int redValue = 0;
+        int greenValue = 0;
+        int blueValue = 0;
+        if (!components.Next(red) || !components.Next(green) || !components.Next(blue) || !red.ParseInt(redValue) || !green.ParseInt(greenValue) || !blue.ParseInt(blueValue))
+        {
+            ERROR_RECOVERABLE(Stringf("Couldn't read \"%s\" as an R,G,B color, using white.", textColor.c_str()));
+            return RGBA::WHITE;
+        }
+        return RGBA(redValue / 255.0f, greenValue / 255.0f, blueValue / 255.0f);
     }
 }
 
@@ -27,6 +27,7 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/Memory/MemoryTracking.hpp"
+#include "Engine/Core/Memory/MemoryArena.hpp"
 #include "Engine/Time/Time.hpp"
 #include "Engine/Math/Vector2Int.hpp"
 #include "../Core/ProfilingUtils.h"
@@ -453,7 +454,9 @@ void Renderer::DrawVertexArray(const Vertex_PCT* vertexes, int numVertexes, Draw
     {
         return;
     }
-    MeshBuilder builder;
+    //Only lives for this draw, so the verts come out of the frame arena. This is what the UI and debug text draw through.
+    LinearArenaScope scratchScope(GetFrameArena());
+    MeshBuilder builder(GetFrameArena());
     builder.Begin();
     for (int i = 0; i < numVertexes; ++i)
     {
@@ -553,7 +556,8 @@ void Renderer::DrawText2D
     {
         return;
     }
-    MeshBuilder builder;
+    LinearArenaScope scratchScope(GetFrameArena());
+    MeshBuilder builder(GetFrameArena());
     builder.Begin();
     if (font == nullptr)
     {
@@ -595,7 +599,8 @@ void Renderer::DrawText2D(const Vector2& position, const std::string& asciiText,
     //To be used when I expand this method to 3D text
     UNUSED(up);
     UNUSED(right);
-    MeshBuilder builder;
+    LinearArenaScope scratchScope(GetFrameArena());
+    MeshBuilder builder(GetFrameArena());
     builder.Begin();
     builder.AddText2D(position, asciiText, scale, tint, drawShadow, font);
     builder.End();
@@ -7,6 +7,7 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Input/InputOutputUtils.hpp"
+#include "Engine/Core/Memory/Buffer.hpp"
 #include "Engine/Renderer/OpenGLExtensions.hpp"
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/Memory/MemoryTracking.hpp"
@@ -75,13 +76,14 @@ ShaderProgram* ShaderProgram::CreateFromShaderStrings(const char* vertShaderStri
 //-----------------------------------------------------------------------------------
 GLuint ShaderProgram::LoadShader(const char* filename, GLenum shaderType)
 {
-    char* fileBuffer = FileReadIntoNewBuffer(filename);
-
-    GLuint shaderID = LoadShaderFromString(fileBuffer, shaderType, filename);
-
-    delete fileBuffer;
-    fileBuffer = nullptr;
-    return shaderID;
+    Buffer fileBuffer;
+    if (!FileReadIntoBuffer(filename, fileBuffer))
+    {
+        ERROR_AND_DIE(Stringf("Failed to read shader file %s", filename));
+    }
+    //FileReadIntoBuffer null terminates for us, so the source can go straight to GL without another copy.
+    const char* shaderSource = fileBuffer.IsEmpty() ? "" : (const char*)fileBuffer.GetData();
+    return LoadShaderFromString(shaderSource, shaderType, filename);
 }
 
 //-----------------------------------------------------------------------------------
@@ -4,6 +4,7 @@
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ProfilingCounters.hpp"
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -94,6 +95,7 @@ Texture::Texture(const std::string& imageFilePath)
         GL_UNSIGNED_BYTE,	// Pixel color components are unsigned bytes (one byte per color/alpha channel)
         m_imageData );		// Location of the actual pixel data bytes/buffer
     GL_CHECK_ERROR();
+    PROFILE_COUNTER_ADD(COUNTER_TEXTURE_BYTES_UPLOADED, m_texelSize.x * m_texelSize.y * numComponents);
 
     //glDisable(GL_TEXTURE_2D);
     GL_CHECK_ERROR();
@@ -158,6 +160,7 @@ Texture::Texture(unsigned char* textureData, int numColorComponents, const Vecto
         GL_UNSIGNED_BYTE,	// Pixel color components are unsigned bytes (one byte per color/alpha channel)
         m_imageData);		// Location of the actual pixel data bytes/buffer
     GL_CHECK_ERROR();
+    PROFILE_COUNTER_ADD(COUNTER_TEXTURE_BYTES_UPLOADED, m_texelSize.x * m_texelSize.y * numComponents);
 
     //glDisable(GL_TEXTURE_2D);
     GL_CHECK_ERROR();
@@ -206,6 +209,11 @@ Texture::Texture(uint32_t width, uint32_t height, TextureFormat format, void* da
         data);	//no actual data passed in, defaults black/white
 
     GL_CHECK_ERROR();
+    if (data)
+    {
+        //Every format we support is 4 bytes a texel.
+        PROFILE_COUNTER_ADD(COUNTER_TEXTURE_BYTES_UPLOADED, width * height * 4);
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -271,6 +279,7 @@ Texture::Texture(unsigned char* textureData, size_t bufferSize)
         GL_UNSIGNED_BYTE,	// Pixel color components are unsigned bytes (one byte per color/alpha channel)
         m_imageData);		// Location of the actual pixel data bytes/buffer
     GL_CHECK_ERROR();
+    PROFILE_COUNTER_ADD(COUNTER_TEXTURE_BYTES_UPLOADED, m_texelSize.x * m_texelSize.y * numComponents);
 
     //glDisable(GL_TEXTURE_2D);
     GL_CHECK_ERROR();
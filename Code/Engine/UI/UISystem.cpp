@@ -6,6 +6,7 @@
 #include "Engine/UI/Widgets/LabelWidget.hpp"
 #include "Engine/UI/Widgets/ButtonWidget.hpp"
 #include "Engine/Input/InputSystem.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
 #include "Widgets/WindowWidget.hpp"
 #include "Widgets/CheckboxWidget.hpp"
 
@@ -27,6 +28,7 @@ UISystem::~UISystem()
 //-----------------------------------------------------------------------------------
 void UISystem::Update(float deltaSeconds)
 {
+    MemoryTagScope tagScope(MEMTAG_UI);
     WidgetBase* newHighlightedWidget = FindHighlightedWidget();
     if (newHighlightedWidget != m_highlightedWidget)
     {
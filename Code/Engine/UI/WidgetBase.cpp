@@ -291,8 +291,8 @@ void WidgetBase::BuildFromXMLNode(XMLNode& node)
     }
     if (onClickAttribute)
     {
-        std::string eventName = std::string(onClickAttribute);
-        m_propertiesForAllStates.Set("OnClick", eventName);
+        //Hashed once here, so a click doesn't rehash the name.
+        m_propertiesForAllStates.Set<EventId>("OnClick", HashEventName(onClickAttribute));
     }
     if (nameAttribute)
     {
@@ -369,8 +369,8 @@ void WidgetBase::BuildFromXMLNode(XMLNode& node)
 //-----------------------------------------------------------------------------------
 void WidgetBase::OnClick()
 {
-    std::string clickEvent;
-    PropertyGetResult state = m_propertiesForAllStates.Get("OnClick", clickEvent);
+    EventId clickEvent = 0;
+    PropertyGetResult state = m_propertiesForAllStates.Get<EventId>("OnClick", clickEvent);
     if (state == PGR_SUCCESS)
     {
         EventSystem::FireEvent(clickEvent);
@@ -0,0 +1,172 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Input/BinaryLogging.hpp"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Encodes the arguments exactly the way LogBinary would, then formats them the way the writer thread or the decoder would.
+template <typename ...ARGS>
+static std::string FormatThroughBinaryLog(const char* format, ARGS... args)
+{
+    std::vector<byte> encodedArgs(GetBinaryLogArgsSize(args...) + 1);
+    byte* end = WriteBinaryLogArgs(encodedArgs.data(), args...);
+    char formattedMessage[LOGF_STACK_LOCAL_TEMP_LENGTH];
+    FormatBinaryLogArgs(format, encodedArgs.data(), end - encodedArgs.data(), formattedMessage, sizeof(formattedMessage));
+    return formattedMessage;
+}
+
+//-----------------------------------------------------------------------------------
+//Anything that round trips has to come out exactly the way printf would've done it on the spot.
+template <typename ...ARGS>
+static bool MatchesPrintf(const char* format, ARGS... args)
+{
+    char expected[LOGF_STACK_LOCAL_TEMP_LENGTH];
+    _snprintf_s(expected, sizeof(expected), _TRUNCATE, format, args...);
+    return FormatThroughBinaryLog(format, args...) == expected;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BinaryLogRoundTripsEveryIntegerType)
+{
+    CHECK(MatchesPrintf("%i %d %u", -42, 2147483647, 4294967295u));
+    CHECK(MatchesPrintf("%x %X %o", -1, -255, -8));
+    CHECK(MatchesPrintf("%08x|%-6d|%+i|% d|%#x", 0xBEEFu, -12, 7, 3, 255u));
+    CHECK(MatchesPrintf("%ld %lu %lx", -5L, 123456789UL, -1L));
+    CHECK(MatchesPrintf("%lld %llu %llx", -9000000000LL, 18446744073709551615ULL, -1LL));
+    CHECK(MatchesPrintf("%hhd %hd %c%c", (char)-3, (short)-30000, 'o', 'k'));
+
+    //A negative int logged under %x is 8 digits wide, not 16.
+    CHECK(FormatThroughBinaryLog("%x", -1) == "ffffffff");
+    CHECK(FormatThroughBinaryLog("%llx", -1LL) == "ffffffffffffffff");
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BinaryLogRoundTripsFloatsStringsAndPointers)
+{
+    CHECK(MatchesPrintf("%f %.2f %e %g %G", 3.14159, 2.5f, -0.000125, 1e20, 1e-10));
+    CHECK(MatchesPrintf("%8.3f|%-10.1e|", 1.0 / 3.0, 12345.678));
+    CHECK(MatchesPrintf("%s and %s", "left", "right"));
+    CHECK(MatchesPrintf("[%10s|%-10s|%.3s]", "pad", "pad", "truncate"));
+    CHECK(MatchesPrintf("%*d|%-*d|%.*f", 6, 42, 6, 42, 2, 3.14159));
+    CHECK(MatchesPrintf("100%% done, %s", "really"));
+
+    char mutableString[] = "mutable";
+    CHECK(FormatThroughBinaryLog("%s", mutableString) == "mutable");
+    CHECK(FormatThroughBinaryLog("[%s]", (const char*)nullptr) == "[]");
+
+    //Pointers always get all 64 bits, since the reader might be a different build from the writer.
+    int onTheStack = 0;
+    char expectedPointer[32];
+    _snprintf_s(expectedPointer, sizeof(expectedPointer), _TRUNCATE, "0x%016llX", (unsigned long long)(uintptr_t)&onTheStack);
+    CHECK(FormatThroughBinaryLog("%p", (const void*)&onTheStack) == expectedPointer);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BinaryLogTruncatesLongStringsAndFlagsMismatches)
+{
+    std::string longString(MAX_BINARY_LOG_STRING_LENGTH + 500, 'z');
+    CHECK(FormatThroughBinaryLog("%s", longString.c_str()) == std::string(MAX_BINARY_LOG_STRING_LENGTH, 'z'));
+
+    //Nothing reads past the end or reinterprets bits, the bad conversion just shows up as '?'.
+    CHECK(FormatThroughBinaryLog("%d %s", 1.5, 7) == "? ?");
+    CHECK(FormatThroughBinaryLog("%f", "text") == "?");
+    CHECK(FormatThroughBinaryLog("%p", 12) == "?");
+    CHECK(FormatThroughBinaryLog("%d and %d", 1) == "1 and ?");
+    CHECK(FormatThroughBinaryLog("%n", 1) == "?");
+
+    //Modifiers in the format don't matter, the width that was logged does.
+    CHECK(FormatThroughBinaryLog("%lld %hd", 70000, 5000000000LL) == "70000 5000000000");
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BinaryLogFileDecodesToTheSameText)
+{
+    const char* binaryPath = "BinaryLoggingTests.blog";
+    const char* textPath = "BinaryLoggingTests.txt";
+    Logger* previousLogger = Logger::instance;
+    Logger::instance = new Logger();
+    std::string logFileName = Logger::instance->m_fileName;
+    REQUIRE(Logger::instance->StartBinaryLog(binaryPath));
+
+    //Format strings repeat so both the definition and the reuse path get exercised.
+    std::string expected;
+    for (int i = 0; i < 100; ++i)
+    {
+        WriteBinaryLogRecord(LogLevel::DEFAULT, "Line %i of %u, %s, %.3f, %llx\n", i, 100u, i % 2 ? "odd" : "even", i * 0.5, (long long)-i);
+        expected += Stringf("Line %i of %u, %s, %.3f, %llx\n", i, 100u, i % 2 ? "odd" : "even", i * 0.5, (long long)-i);
+        WriteBinaryLogRecord(LogLevel::DEFAULT, "%x\n", -i);
+        expected += Stringf("%x\n", -i);
+    }
+    Logger::instance->StopBinaryLog();
+    delete Logger::instance;
+    Logger::instance = previousLogger;
+    remove(logFileName.c_str());
+
+    CHECK(DecodeBinaryLogFile(binaryPath, textPath));
+    std::string decoded;
+    FILE* textFile = fopen(textPath, "rb");
+    REQUIRE(textFile != nullptr);
+    char chunk[256];
+    size_t numRead = 0;
+    while ((numRead = fread(chunk, 1, sizeof(chunk), textFile)) > 0)
+    {
+        decoded.append(chunk, numRead);
+    }
+    fclose(textFile);
+    remove(binaryPath);
+    remove(textPath);
+    CHECK(decoded == expected);
+
+    //Anything that isn't a binary log is refused rather than half decoded.
+    CHECK(!DecodeBinaryLogFile("BinaryLoggingTests.missing", textPath));
+}
+
+//-----------------------------------------------------------------------------------
+static void LogFormattedLine(const char* format, ...)
+{
+    va_list variableArgumentList;
+    va_start(variableArgumentList, format);
+    Logger::instance->LogFormatted(LogLevel::DEFAULT, nullptr, format, variableArgumentList);
+    va_end(variableArgumentList);
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(BinaryLogLatencyPerCall)
+{
+    //Only what the calling thread pays. Both variants go through the same rings, the difference is formatting here versus on the writer.
+    const int NUM_LINES = 200000;
+    Logger* previousLogger = Logger::instance;
+    Logger::instance = new Logger();
+    Logger::instance->m_rotationSizeBytes = 0;
+    Logger::instance->m_rotationIntervalSeconds = 0.0;
+    std::string logFileName = Logger::instance->m_fileName;
+    Logger::instance->StartLoggingThread();
+    Logger::instance->StartBinaryLog("BinaryLoggingTests.blog");
+    {
+        BenchmarkTimer timer("WriteBinaryLogRecord, binary file", NUM_LINES);
+        for (int i = 0; i < NUM_LINES; ++i)
+        {
+            WriteBinaryLogRecord(LogLevel::DEFAULT, "Entity %i moved to (%f, %f) in %s\n", i, i * 0.25, i * -0.5, "Overworld");
+        }
+    }
+    Logger::instance->StopBinaryLog();
+    {
+        BenchmarkTimer timer("WriteBinaryLogRecord, formatted on the writer", NUM_LINES);
+        for (int i = 0; i < NUM_LINES; ++i)
+        {
+            WriteBinaryLogRecord(LogLevel::DEFAULT, "Entity %i moved to (%f, %f) in %s\n", i, i * 0.25, i * -0.5, "Overworld");
+        }
+    }
+    {
+        BenchmarkTimer timer("LogFormatted", NUM_LINES);
+        for (int i = 0; i < NUM_LINES; ++i)
+        {
+            LogFormattedLine("Entity %i moved to (%f, %f) in %s\n", i, i * 0.25, i * -0.5, "Overworld");
+        }
+    }
+    delete Logger::instance;
+    Logger::instance = previousLogger;
+    remove(logFileName.c_str());
+    remove("BinaryLoggingTests.blog");
+}
@@ -0,0 +1,150 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/Memory/Buffer.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include <thread>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+static Buffer BuildCountingBuffer(int numInts)
+{
+    BufferBuilder builder(4);
+    for (int i = 0; i < numInts; ++i)
+    {
+        builder.Write<int>(i);
+    }
+    return builder.Finish();
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BufferSlicesShareStorageWithoutCopying)
+{
+    Buffer whole = BuildCountingBuffer(100);
+    REQUIRE(whole.GetSize() == 100 * sizeof(int));
+    CHECK(whole.GetRefCount() == 1);
+
+    Buffer middle = whole.Slice(10 * sizeof(int), 10 * sizeof(int));
+    CHECK(middle.GetData() == whole.GetData() + 10 * sizeof(int));
+    CHECK(((const int*)middle.GetData())[0] == 10);
+    CHECK(((const int*)middle.GetData())[9] == 19);
+    CHECK(whole.GetRefCount() == 2);
+
+    //Slicing a slice is relative to the slice, not the original storage.
+    Buffer tail = middle.Slice(8 * sizeof(int));
+    CHECK(tail.GetSize() == 2 * sizeof(int));
+    CHECK(((const int*)tail.GetData())[0] == 18);
+    CHECK(whole.GetRefCount() == 3);
+
+    //The slices keep the storage alive after the original lets go.
+    whole.Reset();
+    CHECK(whole.IsEmpty());
+    CHECK(whole.GetData() == nullptr);
+    CHECK(middle.GetRefCount() == 2);
+    CHECK(((const int*)tail.GetData())[1] == 19);
+
+    Buffer empty = middle.Slice(middle.GetSize());
+    CHECK(empty.IsEmpty());
+    CHECK(empty.GetRefCount() == 0);
+    CHECK(middle.GetRefCount() == 2);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BufferCopiesAndMovesKeepRefCountsStraight)
+{
+    Buffer original = BuildCountingBuffer(16);
+    {
+        Buffer copy = original;
+        CHECK(original.GetRefCount() == 2);
+        Buffer assigned;
+        assigned = copy;
+        CHECK(original.GetRefCount() == 3);
+
+        //Assigning a buffer to another view of the same storage shouldn't drop it to zero partway through.
+        assigned = original;
+        CHECK(original.GetRefCount() == 3);
+        assigned = assigned;
+        CHECK(original.GetRefCount() == 3);
+
+        Buffer moved = std::move(copy);
+        CHECK(copy.GetData() == nullptr);
+        CHECK(original.GetRefCount() == 3);
+    }
+    CHECK(original.GetRefCount() == 1);
+
+    Buffer movedInto;
+    movedInto = std::move(original);
+    CHECK(original.IsEmpty());
+    CHECK(movedInto.GetRefCount() == 1);
+    CHECK(((const int*)movedInto.GetData())[15] == 15);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BufferRefCountSurvivesManyThreads)
+{
+    Buffer shared = BuildCountingBuffer(64);
+    const int NUM_THREADS = 8;
+    const int NUM_COPIES_PER_THREAD = 20000;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        threads.emplace_back([&shared, NUM_COPIES_PER_THREAD]()
+        {
+            for (int copyIndex = 0; copyIndex < NUM_COPIES_PER_THREAD; ++copyIndex)
+            {
+                Buffer copy = shared;
+                Buffer slice = copy.Slice(sizeof(int));
+                Buffer moved = std::move(slice);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(shared.GetRefCount() == 1);
+    CHECK(((const int*)shared.GetData())[63] == 63);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BufferStorageHandsOffToTheLastThreadHoldingIt)
+{
+    //Whichever thread drops the last reference recycles the storage, even when it isn't the thread that allocated it.
+    std::vector<Buffer> buffers;
+    for (int i = 0; i < 256; ++i)
+    {
+        buffers.push_back(BuildCountingBuffer(i + 1));
+    }
+    std::thread consumer([&buffers]()
+    {
+        for (Buffer& buffer : buffers)
+        {
+            buffer.Reset();
+        }
+    });
+    consumer.join();
+    for (const Buffer& buffer : buffers)
+    {
+        CHECK(buffer.IsEmpty());
+    }
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(BufferStorageIsTrackedUnderTheBuffersTag)
+{
+#if !defined(TRACK_MEMORY)
+    SKIP_TEST("Needs TRACK_MEMORY in BuildConfig.hpp");
+#endif
+    BufferPoolShutdown();
+    const size_t bytesBefore = GetMemoryTagStats(MEMTAG_BUFFERS).numberOfBytes;
+    {
+        MemoryTagScope uiScope(MEMTAG_UI);
+        Buffer buffer = BuildCountingBuffer(8);
+        CHECK(GetMemoryTagStats(MEMTAG_BUFFERS).numberOfBytes > bytesBefore);
+    }
+    //Freed storage waits in the pool, and still counts, until the pool shuts down.
+    CHECK(GetMemoryTagStats(MEMTAG_BUFFERS).numberOfBytes > bytesBefore);
+    BufferPoolShutdown();
+    CHECK(GetMemoryTagStats(MEMTAG_BUFFERS).numberOfBytes == bytesBefore);
+}
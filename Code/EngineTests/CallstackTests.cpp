@@ -0,0 +1,219 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/Memory/Callstack.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstring>
+
+//-----------------------------------------------------------------------------------
+//Initializes the callstack system for the length of a test if nobody else already has.
+class ScopedCallstackSystem
+{
+public:
+    ScopedCallstackSystem() : m_ownsSystem(!CallstackSystemIsInitialized()) { if (m_ownsSystem) { CallstackSystemInit(); } };
+    ~ScopedCallstackSystem() { if (m_ownsSystem) { CallstackSystemDeinit(); } };
+
+private:
+    bool m_ownsSystem;
+};
+
+//-----------------------------------------------------------------------------------
+//A known chain to look for. Not static, so platforms that only know exported symbols can still name them,
+//and each one does some work after its call so it can't turn into a jump.
+#if defined( _MSC_VER )
+#define CALLSTACK_TESTS_NOINLINE __declspec(noinline)
+#else
+#define CALLSTACK_TESTS_NOINLINE __attribute__((noinline))
+#endif
+
+static std::atomic<bool> s_keepChainRunning(false);
+static std::atomic<bool> s_isChainRunning(false);
+static volatile int s_chainDepth = 0;
+
+//-----------------------------------------------------------------------------------
+CALLSTACK_TESTS_NOINLINE Callstack* CallstackTestsFunctionC()
+{
+    Callstack* callstack = AllocateCallstack(0);
+    s_isChainRunning.store(true);
+    while (s_keepChainRunning.load())
+    {
+        std::this_thread::yield();
+    }
+    ++s_chainDepth;
+    return callstack;
+}
+
+//-----------------------------------------------------------------------------------
+CALLSTACK_TESTS_NOINLINE Callstack* CallstackTestsFunctionB()
+{
+    Callstack* callstack = CallstackTestsFunctionC();
+    ++s_chainDepth;
+    return callstack;
+}
+
+//-----------------------------------------------------------------------------------
+CALLSTACK_TESTS_NOINLINE Callstack* CallstackTestsFunctionA()
+{
+    Callstack* callstack = CallstackTestsFunctionB();
+    ++s_chainDepth;
+    return callstack;
+}
+
+//-----------------------------------------------------------------------------------
+//True if C, B and A each show up in the names, in that order.
+static bool HasChainInOrder(const char* const* functionNames, unsigned int numFunctionNames)
+{
+    const char* const CHAIN[] = { "CallstackTestsFunctionC", "CallstackTestsFunctionB", "CallstackTestsFunctionA" };
+    unsigned int nextInChain = 0;
+    for (unsigned int i = 0; i < numFunctionNames && nextInChain < 3; ++i)
+    {
+        if (strstr(functionNames[i], CHAIN[nextInChain]))
+        {
+            ++nextInChain;
+        }
+    }
+    return nextInChain == 3;
+}
+
+//-----------------------------------------------------------------------------------
+static void ResolveAddressRange(uintptr_t firstAddress, unsigned int numAddresses, unsigned int stride)
+{
+    for (unsigned int i = 0; i < numAddresses; ++i)
+    {
+        CallstackGetFunctionName((void*)(firstAddress + i * stride));
+    }
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(CallstackSymbolCacheSurvivesConcurrentGrowth)
+{
+    ScopedCallstackSystem callstackSystem;
+    CallstackClearSymbolCache();
+
+    //Every address inside this function is a distinct key, so enough of them forces the table to grow several times while both threads are using it.
+    const uintptr_t baseAddress = (uintptr_t)&ResolveAddressRange;
+    const unsigned int NUM_ADDRESSES = 4096;
+    const unsigned int NUM_THREADS = 4;
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < NUM_THREADS; ++i)
+    {
+        //Interleaved, so each thread is constantly inserting next to the others.
+        threads.emplace_back(&ResolveAddressRange, baseAddress + i, NUM_ADDRESSES / NUM_THREADS, NUM_THREADS);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(CallstackGetNumCachedSymbols() == NUM_ADDRESSES);
+
+    //Everything's cached now, so a second pass shouldn't add anything.
+    ResolveAddressRange(baseAddress, NUM_ADDRESSES, 1);
+    CHECK(CallstackGetNumCachedSymbols() == NUM_ADDRESSES);
+    CallstackClearSymbolCache();
+    CHECK(CallstackGetNumCachedSymbols() == 0);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(CallstackLinesBelongToTheCallingThread)
+{
+    ScopedCallstackSystem callstackSystem;
+    Callstack* mainStack = AllocateCallstack(0);
+    REQUIRE(mainStack->frameCount > 0);
+    CallstackLine* mainLines = CallstackGetLines(mainStack);
+    char mainFunctionName[CALLSTACK_BUFFER_SIZE];
+    strcpy(mainFunctionName, mainLines[0].functionName);
+
+    //Another thread symbolizing its own stack must not stomp the lines we were handed.
+    CallstackLine* otherLines = nullptr;
+    std::thread other([&otherLines]()
+    {
+        Callstack* otherStack = AllocateCallstack(0);
+        otherLines = CallstackGetLines(otherStack);
+        FreeCallstack(otherStack);
+    });
+    other.join();
+    CHECK(otherLines != mainLines);
+    CHECK(strcmp(mainLines[0].functionName, mainFunctionName) == 0);
+    FreeCallstack(mainStack);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(CallstackSymbolizesAKnownChain)
+{
+    ScopedCallstackSystem callstackSystem;
+    s_keepChainRunning.store(false);
+    Callstack* callstack = CallstackTestsFunctionA();
+    REQUIRE(callstack->frameCount >= 3);
+    CallstackLine* lines = CallstackGetLines(callstack);
+    std::vector<const char*> functionNames;
+    for (unsigned int i = 0; i < callstack->frameCount; ++i)
+    {
+        functionNames.push_back(lines[i].functionName);
+    }
+    CHECK(HasChainInOrder(functionNames.data(), callstack->frameCount));
+    FreeCallstack(callstack);
+
+    //Same chain, captured from outside while the thread's sitting in C.
+    s_keepChainRunning.store(true);
+    s_isChainRunning.store(false);
+    uintptr_t chainThreadHandle = 0;
+    std::atomic<bool> hasHandle(false);
+    std::thread chainThread([&chainThreadHandle, &hasHandle]()
+    {
+        chainThreadHandle = CallstackGetCurrentThreadHandle();
+        hasHandle.store(true);
+        FreeCallstack(CallstackTestsFunctionA());
+    });
+    while (!hasHandle.load() || !s_isChainRunning.load())
+    {
+        std::this_thread::yield();
+    }
+    void* frames[64];
+    unsigned int numFrames = CallstackCaptureThread(chainThreadHandle, frames, 64);
+    CallstackReleaseThreadHandle(chainThreadHandle);
+    s_keepChainRunning.store(false);
+    chainThread.join();
+
+    std::vector<const char*> capturedNames;
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        capturedNames.push_back(CallstackGetFunctionName(frames[i]));
+    }
+    CHECK(numFrames >= 3);
+    CHECK(HasChainInOrder(capturedNames.data(), numFrames));
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(CallstackCaptureCost)
+{
+    ScopedCallstackSystem callstackSystem;
+    const unsigned int NUM_CAPTURES = 20000;
+    {
+        BenchmarkTimer timer("AllocateCallstack + FreeCallstack", NUM_CAPTURES);
+        for (unsigned int i = 0; i < NUM_CAPTURES; ++i)
+        {
+            FreeCallstack(AllocateCallstack());
+        }
+    }
+
+    Callstack* callstack = AllocateCallstack();
+    const unsigned int NUM_COLD_RESOLVES = 20;
+    {
+        BenchmarkTimer timer("CallstackGetLines, cold cache", NUM_COLD_RESOLVES);
+        for (unsigned int i = 0; i < NUM_COLD_RESOLVES; ++i)
+        {
+            CallstackClearSymbolCache();
+            CallstackGetLines(callstack);
+        }
+    }
+
+    const unsigned int NUM_WARM_RESOLVES = 20000;
+    {
+        BenchmarkTimer timer("CallstackGetLines, warm cache", NUM_WARM_RESOLVES);
+        for (unsigned int i = 0; i < NUM_WARM_RESOLVES; ++i)
+        {
+            CallstackGetLines(callstack);
+        }
+    }
+    FreeCallstack(callstack);
+}
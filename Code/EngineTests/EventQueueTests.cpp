@@ -0,0 +1,224 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/Events/EventQueue.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char* const QUEUED_EVENT_NAME = "EventQueueTests Queued";
+static const char* const COALESCED_EVENT_NAME = "EventQueueTests Coalesced";
+static const EventId QUEUED_EVENT = HashEventName(QUEUED_EVENT_NAME);
+static const EventId COALESCED_EVENT = HashEventName(COALESCED_EVENT_NAME);
+
+//-----------------------------------------------------------------------------------
+struct QueuedTestPayload
+{
+    unsigned int m_threadIndex;
+    unsigned int m_postIndex;
+};
+
+//-----------------------------------------------------------------------------------
+struct QueuedEventRecorder
+{
+    QueuedEventRecorder(const char* eventName)
+    {
+        EventSystem::RegisterObjectForEvent(eventName, this, &QueuedEventRecorder::OnEvent);
+    };
+
+    ~QueuedEventRecorder()
+    {
+        EventSystem::UnregisterFromAllEvents(this);
+    };
+
+    void OnEvent(NamedProperties& params)
+    {
+        const QueuedTestPayload* payload = GetQueuedEventPayload<QueuedTestPayload>(params);
+        if (payload)
+        {
+            m_payloads.push_back(*payload);
+        }
+        else
+        {
+            ++m_numWithoutPayload;
+        }
+    };
+
+    std::vector<QueuedTestPayload> m_payloads;
+    unsigned int m_numWithoutPayload = 0;
+};
+
+//-----------------------------------------------------------------------------------
+//Full queues are expected while the main thread's busy, so keep trying until it catches up.
+static void PostUntilAccepted(EventQueue& queue, EventId eventId, const QueuedTestPayload& payload)
+{
+    while (!queue.Post(eventId, payload))
+    {
+        std::this_thread::yield();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventQueueKeepsEachProducersOrder)
+{
+    //A small queue and arena, so producers keep running into the main thread recycling them.
+    const unsigned int NUM_THREADS = 8;
+    const unsigned int NUM_POSTS_PER_THREAD = 20000;
+    EventQueue queue(256, 4 * 1024);
+    QueuedEventRecorder recorder(QUEUED_EVENT_NAME);
+    std::vector<std::thread> threads;
+    for (unsigned int threadIndex = 0; threadIndex < NUM_THREADS; ++threadIndex)
+    {
+        threads.emplace_back([&queue, threadIndex, NUM_POSTS_PER_THREAD]()
+        {
+            for (unsigned int i = 0; i < NUM_POSTS_PER_THREAD; ++i)
+            {
+                PostUntilAccepted(queue, QUEUED_EVENT, QueuedTestPayload{ threadIndex, i });
+            }
+        });
+    }
+    while (recorder.m_payloads.size() < NUM_THREADS * NUM_POSTS_PER_THREAD)
+    {
+        queue.DispatchQueuedEvents();
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(queue.DispatchQueuedEvents() == 0);
+
+    REQUIRE(recorder.m_payloads.size() == NUM_THREADS * NUM_POSTS_PER_THREAD);
+    CHECK(recorder.m_numWithoutPayload == 0);
+    std::vector<unsigned int> nextPostForThread(NUM_THREADS, 0);
+    bool allInOrder = true;
+    for (const QueuedTestPayload& payload : recorder.m_payloads)
+    {
+        allInOrder = allInOrder && payload.m_threadIndex < NUM_THREADS && nextPostForThread[payload.m_threadIndex] == payload.m_postIndex;
+        if (payload.m_threadIndex < NUM_THREADS)
+        {
+            ++nextPostForThread[payload.m_threadIndex];
+        }
+    }
+    CHECK(allInOrder);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventQueueFiresInTheOrderPostsWereMade)
+{
+    //The lock makes the order across threads unambiguous, while every post still races the others for a slot.
+    const unsigned int NUM_THREADS = 6;
+    const unsigned int NUM_POSTS = 30000;
+    EventQueue queue(512, 8 * 1024);
+    QueuedEventRecorder recorder(QUEUED_EVENT_NAME);
+    std::mutex orderLock;
+    unsigned int nextPostIndex = 0;
+    std::vector<std::thread> threads;
+    for (unsigned int threadIndex = 0; threadIndex < NUM_THREADS; ++threadIndex)
+    {
+        threads.emplace_back([&queue, &orderLock, &nextPostIndex, threadIndex, NUM_POSTS]()
+        {
+            for (;;)
+            {
+                std::lock_guard<std::mutex> lock(orderLock);
+                if (nextPostIndex == NUM_POSTS)
+                {
+                    return;
+                }
+                PostUntilAccepted(queue, QUEUED_EVENT, QueuedTestPayload{ threadIndex, nextPostIndex++ });
+            }
+        });
+    }
+    while (recorder.m_payloads.size() < NUM_POSTS)
+    {
+        queue.DispatchQueuedEvents();
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(recorder.m_payloads.size() == NUM_POSTS);
+    bool isInOrder = true;
+    for (unsigned int i = 0; i < NUM_POSTS; ++i)
+    {
+        isInOrder = isInOrder && recorder.m_payloads[i].m_postIndex == i;
+    }
+    CHECK(isInOrder);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventQueueCoalescesAndDropsWhenFull)
+{
+    EventQueue queue(8, 64);
+    QueuedEventRecorder queuedRecorder(QUEUED_EVENT_NAME);
+    QueuedEventRecorder coalescedRecorder(COALESCED_EVENT_NAME);
+    queue.SetCoalesced(COALESCED_EVENT, true);
+
+    //Only the newest coalesced post fires, in its own place in line.
+    CHECK(queue.Post(COALESCED_EVENT, QueuedTestPayload{ 0, 0 }));
+    CHECK(queue.Post(QUEUED_EVENT));
+    CHECK(queue.Post(COALESCED_EVENT, QueuedTestPayload{ 0, 1 }));
+    CHECK(queue.DispatchQueuedEvents() == 2);
+    REQUIRE(coalescedRecorder.m_payloads.size() == 1);
+    CHECK(coalescedRecorder.m_payloads[0].m_postIndex == 1);
+    CHECK(queuedRecorder.m_numWithoutPayload == 1);
+
+    //64 bytes of arena is four aligned payloads, after that posts with payloads are dropped but ones without still fit.
+    queue.SetCoalesced(COALESCED_EVENT, false);
+    unsigned int numPosted = 0;
+    for (unsigned int i = 0; i < 6; ++i)
+    {
+        numPosted += queue.Post(QUEUED_EVENT, QueuedTestPayload{ 0, i }) ? 1 : 0;
+    }
+    CHECK(numPosted == 4);
+    CHECK(queue.Post(QUEUED_EVENT));
+    CHECK(queue.GetNumDroppedEvents() == 2);
+
+    //And the ring itself holds 8.
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        CHECK(queue.Post(QUEUED_EVENT));
+    }
+    CHECK(!queue.Post(QUEUED_EVENT));
+    CHECK(queue.DispatchQueuedEvents() == 8);
+    CHECK(queue.Post(QUEUED_EVENT, QueuedTestPayload{ 0, 99 }));
+    CHECK(queue.DispatchQueuedEvents() == 1);
+    REQUIRE(!queuedRecorder.m_payloads.empty());
+    CHECK(queuedRecorder.m_payloads.back().m_postIndex == 99);
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(EventQueueThroughput)
+{
+    //Producers post as fast as they can while the main thread dispatches in a loop. Timed per event, end to end.
+    const unsigned int NUM_EVENTS = 400000;
+    const unsigned int PRODUCER_COUNTS[] = { 1, 4, 8 };
+    for (unsigned int numProducers : PRODUCER_COUNTS)
+    {
+        EventQueue queue;
+        QueuedEventRecorder recorder(QUEUED_EVENT_NAME);
+        recorder.m_payloads.reserve(NUM_EVENTS);
+        std::string label = Stringf("Post and dispatch, %u producers, per event", numProducers);
+        BenchmarkTimer timer(label.c_str(), NUM_EVENTS);
+        std::vector<std::thread> threads;
+        for (unsigned int threadIndex = 0; threadIndex < numProducers; ++threadIndex)
+        {
+            threads.emplace_back([&queue, threadIndex, numProducers, NUM_EVENTS]()
+            {
+                for (unsigned int i = 0; i < NUM_EVENTS / numProducers; ++i)
+                {
+                    PostUntilAccepted(queue, QUEUED_EVENT, QueuedTestPayload{ threadIndex, i });
+                }
+            });
+        }
+        const size_t numExpected = (NUM_EVENTS / numProducers) * numProducers;
+        while (recorder.m_payloads.size() < numExpected)
+        {
+            queue.DispatchQueuedEvents();
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
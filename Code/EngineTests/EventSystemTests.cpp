@@ -0,0 +1,162 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/Events/EventSystem.hpp"
+#include <string>
+#include <vector>
+
+static const char* const REENTRANT_EVENT_NAME = "EventSystemTests Reentrant";
+static const char* const NESTED_EVENT_NAME = "EventSystemTests Nested";
+static const char* const BENCHMARK_EVENT_NAME = "EventSystemTests Benchmark";
+static const EventId REENTRANT_EVENT = HashEventName(REENTRANT_EVENT_NAME);
+static const EventId NESTED_EVENT = HashEventName(NESTED_EVENT_NAME);
+static const EventId BENCHMARK_EVENT = HashEventName(BENCHMARK_EVENT_NAME);
+
+//-----------------------------------------------------------------------------------
+//Records every call, and can be told to do something to the event system from inside its own callback.
+struct EventRecorder
+{
+    ~EventRecorder()
+    {
+        EventSystem::UnregisterFromAllEvents(this);
+    };
+
+    void OnEvent(NamedProperties&)
+    {
+        ++m_numCalls;
+        if (m_unregisterSelf)
+        {
+            EventSystem::UnregisterFromAllEvents(this);
+        }
+        if (m_unregisterOther)
+        {
+            EventSystem::UnregisterFromAllEvents(m_unregisterOther);
+        }
+        if (m_registerOther)
+        {
+            EventSystem::RegisterObjectForEvent(REENTRANT_EVENT_NAME, m_registerOther, &EventRecorder::OnEvent);
+            m_registerOther = nullptr;
+        }
+        if (m_fireNested)
+        {
+            m_fireNested = false;
+            EventSystem::FireEvent(NESTED_EVENT);
+        }
+    };
+
+    unsigned int m_numCalls = 0;
+    bool m_unregisterSelf = false;
+    bool m_fireNested = false;
+    EventRecorder* m_unregisterOther = nullptr;
+    EventRecorder* m_registerOther = nullptr;
+};
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventSubscribersCanUnregisterDuringDispatch)
+{
+    EventRecorder first;
+    EventRecorder quitter;
+    EventRecorder victim;
+    EventRecorder last;
+    EventSystem::RegisterObjectForEvent(REENTRANT_EVENT_NAME, &first, &EventRecorder::OnEvent);
+    EventSystem::RegisterObjectForEvent(REENTRANT_EVENT_NAME, &quitter, &EventRecorder::OnEvent);
+    EventSystem::RegisterObjectForEvent(REENTRANT_EVENT_NAME, &victim, &EventRecorder::OnEvent);
+    EventSystem::RegisterObjectForEvent(REENTRANT_EVENT_NAME, &last, &EventRecorder::OnEvent);
+    REQUIRE(EventSystem::GetNumSubscribers(REENTRANT_EVENT) == 4);
+
+    //One leaves from inside its own callback and takes a later subscriber with it. Everyone else still hears this one.
+    quitter.m_unregisterSelf = true;
+    quitter.m_unregisterOther = &victim;
+    EventSystem::FireEvent(REENTRANT_EVENT);
+    CHECK(first.m_numCalls == 1);
+    CHECK(quitter.m_numCalls == 1);
+    CHECK(victim.m_numCalls == 0);
+    CHECK(last.m_numCalls == 1);
+    CHECK(EventSystem::GetNumSubscribers(REENTRANT_EVENT) == 2);
+
+    EventSystem::FireEvent(REENTRANT_EVENT);
+    CHECK(first.m_numCalls == 2);
+    CHECK(quitter.m_numCalls == 1);
+    CHECK(last.m_numCalls == 2);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventSubscribersAddedDuringDispatchWaitForTheNextOne)
+{
+    EventRecorder recruiter;
+    EventRecorder recruit;
+    EventSystem::RegisterObjectForEvent(REENTRANT_EVENT_NAME, &recruiter, &EventRecorder::OnEvent);
+    recruiter.m_registerOther = &recruit;
+
+    EventSystem::FireEvent(REENTRANT_EVENT);
+    CHECK(recruiter.m_numCalls == 1);
+    CHECK(recruit.m_numCalls == 0);
+    CHECK(EventSystem::GetNumSubscribers(REENTRANT_EVENT) == 2);
+
+    EventSystem::FireEvent(REENTRANT_EVENT);
+    CHECK(recruiter.m_numCalls == 2);
+    CHECK(recruit.m_numCalls == 1);
+
+    //Registering twice means being called twice, and unregistering takes both.
+    EventSystem::RegisterObjectForEvent(REENTRANT_EVENT_NAME, &recruit, &EventRecorder::OnEvent);
+    EventSystem::FireEvent(REENTRANT_EVENT);
+    CHECK(recruit.m_numCalls == 3);
+    EventSystem::UnregisterFromEvent(REENTRANT_EVENT_NAME, &recruit);
+    CHECK(EventSystem::GetNumSubscribers(REENTRANT_EVENT) == 1);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventChangesDuringNestedDispatchWaitForTheOutermost)
+{
+    EventRecorder outer;
+    EventRecorder inner;
+    EventRecorder newcomer;
+    EventSystem::RegisterObjectForEvent(REENTRANT_EVENT_NAME, &outer, &EventRecorder::OnEvent);
+    EventSystem::RegisterObjectForEvent(NESTED_EVENT_NAME, &inner, &EventRecorder::OnEvent);
+
+    //The inner event leaves and brings in someone new while the outer one is still running.
+    outer.m_fireNested = true;
+    inner.m_unregisterSelf = true;
+    inner.m_registerOther = &newcomer;
+    EventSystem::FireEvent(REENTRANT_EVENT);
+    CHECK(outer.m_numCalls == 1);
+    CHECK(inner.m_numCalls == 1);
+    CHECK(newcomer.m_numCalls == 0);
+    CHECK(EventSystem::GetNumSubscribers(NESTED_EVENT) == 0);
+    CHECK(EventSystem::GetNumSubscribers(REENTRANT_EVENT) == 2);
+
+    EventSystem::FireEvent(NESTED_EVENT);
+    EventSystem::FireEvent(REENTRANT_EVENT_NAME);
+    CHECK(inner.m_numCalls == 1);
+    CHECK(outer.m_numCalls == 2);
+    CHECK(newcomer.m_numCalls == 1);
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(EventFireCost)
+{
+    const unsigned int NUM_FIRES = 1000000;
+    const unsigned int SUBSCRIBER_COUNTS[] = { 1, 100 };
+    for (unsigned int numSubscribers : SUBSCRIBER_COUNTS)
+    {
+        std::vector<EventRecorder> recorders(numSubscribers);
+        for (EventRecorder& recorder : recorders)
+        {
+            EventSystem::RegisterObjectForEvent(BENCHMARK_EVENT_NAME, &recorder, &EventRecorder::OnEvent);
+        }
+        {
+            std::string label = Stringf("FireEvent by id, %u subscribers", numSubscribers);
+            BenchmarkTimer timer(label.c_str(), NUM_FIRES);
+            for (unsigned int i = 0; i < NUM_FIRES; ++i)
+            {
+                EventSystem::FireEvent(BENCHMARK_EVENT);
+            }
+        }
+        {
+            std::string label = Stringf("FireEvent by name, %u subscribers", numSubscribers);
+            BenchmarkTimer timer(label.c_str(), NUM_FIRES);
+            for (unsigned int i = 0; i < NUM_FIRES; ++i)
+            {
+                EventSystem::FireEvent(BENCHMARK_EVENT_NAME);
+            }
+        }
+    }
+}
@@ -0,0 +1,451 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/Events/Event.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <string>
+#include <vector>
+
+typedef Event<int> IntEvent;
+
+//-----------------------------------------------------------------------------------
+//Records every call, and can be told to change the event it's listening to from inside its own callback.
+struct EventListener
+{
+    void OnTrigger(int value)
+    {
+        m_values.push_back(value);
+        if (m_unregisterSelf)
+        {
+            m_event->UnregisterMethod(this, &EventListener::OnTrigger);
+        }
+        if (m_unregisterOther)
+        {
+            m_event->UnregisterMethod(m_unregisterOther, &EventListener::OnTrigger);
+        }
+        if (m_registerOther)
+        {
+            m_event->RegisterMethod(m_registerOther, &EventListener::OnTrigger);
+            m_registerOther = nullptr;
+        }
+        if (m_numNestedTriggers > 0)
+        {
+            --m_numNestedTriggers;
+            m_event->Trigger(value + 1);
+        }
+    };
+
+    void OnOtherTrigger(int value)
+    {
+        m_otherValues.push_back(value);
+    };
+
+    IntEvent* m_event = nullptr;
+    std::vector<int> m_values;
+    std::vector<int> m_otherValues;
+    bool m_unregisterSelf = false;
+    EventListener* m_unregisterOther = nullptr;
+    EventListener* m_registerOther = nullptr;
+    unsigned int m_numNestedTriggers = 0;
+};
+
+//-----------------------------------------------------------------------------------
+//Multiple inheritance and virtuals make for the biggest member function pointers MSVC has.
+struct EventListenerBase
+{
+    virtual ~EventListenerBase() {};
+    int m_baseData = 0;
+};
+
+//-----------------------------------------------------------------------------------
+struct VirtualEventListener : public EventListenerBase, public EventListener
+{
+    virtual void OnVirtualTrigger(int value)
+    {
+        m_virtualValues.push_back(value);
+    };
+
+    std::vector<int> m_virtualValues;
+};
+
+//-----------------------------------------------------------------------------------
+static unsigned int s_functionSum = 0;
+static void AddToFunctionSum(int value)
+{
+    s_functionSum += (unsigned int)value;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventIgnoresDuplicateRegistrations)
+{
+    IntEvent event;
+    EventListener listener;
+    s_functionSum = 0;
+
+    CHECK(event.RegisterMethod(&listener, &EventListener::OnTrigger));
+    CHECK(!event.RegisterMethod(&listener, &EventListener::OnTrigger));
+    CHECK(event.RegisterMethod(&listener, &EventListener::OnOtherTrigger));
+    CHECK(event.RegisterFunction(&AddToFunctionSum));
+    CHECK(!event.RegisterFunction(&AddToFunctionSum));
+    CHECK((event.RegisterMethod<EventListener, &EventListener::OnTrigger>(&listener)));
+    CHECK((!event.RegisterMethod<EventListener, &EventListener::OnTrigger>(&listener)));
+    CHECK(event.GetNumSubscriptions() == 4);
+
+    //The bound and unbound versions of the same method are separate subscriptions.
+    event.Trigger(3);
+    CHECK(listener.m_values.size() == 2);
+    CHECK(listener.m_otherValues.size() == 1);
+    CHECK(s_functionSum == 3);
+
+    CHECK(event.UnregisterMethod(&listener, &EventListener::OnTrigger));
+    CHECK(!event.UnregisterMethod(&listener, &EventListener::OnTrigger));
+    CHECK((event.UnregisterMethod<EventListener, &EventListener::OnTrigger>(&listener)));
+    CHECK(event.UnregisterFunction(&AddToFunctionSum));
+    CHECK(event.GetNumSubscriptions() == 1);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventCallsTheRightMethodThroughAnyMemberPointer)
+{
+    IntEvent event;
+    VirtualEventListener listener;
+    CHECK(event.RegisterMethod(&listener, &VirtualEventListener::OnVirtualTrigger));
+    CHECK(event.RegisterMethod(static_cast<EventListener*>(&listener), &EventListener::OnTrigger));
+    event.Trigger(7);
+    CHECK(listener.m_virtualValues.size() == 1 && listener.m_virtualValues[0] == 7);
+    CHECK(listener.m_values.size() == 1 && listener.m_values[0] == 7);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventMatchesTheBiggestMemberPointersWhenUnregistering)
+{
+    //Each register and unregister builds its member pointer fresh, so matching can't rely on any padding inside it being the same.
+    IntEvent event;
+    VirtualEventListener listener;
+    VirtualEventListener otherListener;
+    CHECK(event.RegisterMethod(&listener, &VirtualEventListener::OnVirtualTrigger));
+    CHECK(!event.RegisterMethod(&listener, &VirtualEventListener::OnVirtualTrigger));
+    CHECK(event.RegisterMethod(&otherListener, &VirtualEventListener::OnVirtualTrigger));
+    CHECK(event.GetNumSubscriptions() == 2);
+
+    CHECK(event.UnregisterMethod(&listener, &VirtualEventListener::OnVirtualTrigger));
+    CHECK(!event.UnregisterMethod(&listener, &VirtualEventListener::OnVirtualTrigger));
+    CHECK(event.GetNumSubscriptions() == 1);
+    event.Trigger(9);
+    CHECK(listener.m_virtualValues.empty());
+    CHECK(otherListener.m_virtualValues.size() == 1 && otherListener.m_virtualValues[0] == 9);
+
+    CHECK(event.UnregisterMethod(&otherListener, &VirtualEventListener::OnVirtualTrigger));
+    CHECK(event.GetNumSubscriptions() == 0);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventSubscribersCanBeRemovedDuringTrigger)
+{
+    IntEvent event;
+    EventListener listeners[4];
+    for (EventListener& listener : listeners)
+    {
+        listener.m_event = &event;
+        event.RegisterMethod(&listener, &EventListener::OnTrigger);
+    }
+
+    //One leaves from inside its own callback and takes a later one with it. The rest still hear this trigger.
+    listeners[1].m_unregisterSelf = true;
+    listeners[1].m_unregisterOther = &listeners[2];
+    event.Trigger(1);
+    CHECK(listeners[0].m_values.size() == 1);
+    CHECK(listeners[1].m_values.size() == 1);
+    CHECK(listeners[2].m_values.empty());
+    CHECK(listeners[3].m_values.size() == 1);
+    CHECK(event.GetNumSubscriptions() == 2);
+
+    //Clearing everything mid trigger stops the rest too.
+    listeners[1].m_unregisterSelf = false;
+    listeners[1].m_unregisterOther = nullptr;
+    event.Trigger(2);
+    CHECK(listeners[0].m_values.size() == 2);
+    CHECK(listeners[3].m_values.size() == 2);
+    event.UnregisterAllSubscriptions();
+    event.Trigger(3);
+    CHECK(listeners[0].m_values.size() == 2);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventSubscribersAddedDuringTriggerWaitForTheNextOne)
+{
+    //Enough newcomers that the array has to grow while the trigger that added them is still walking it.
+    IntEvent event;
+    EventListener recruiter;
+    std::vector<EventListener> recruits(64);
+    recruiter.m_event = &event;
+    event.RegisterMethod(&recruiter, &EventListener::OnTrigger);
+    for (EventListener& recruit : recruits)
+    {
+        recruit.m_event = &event;
+    }
+    struct Recruiter
+    {
+        void OnTrigger(int)
+        {
+            for (EventListener& recruit : *m_recruits)
+            {
+                m_event->RegisterMethod(&recruit, &EventListener::OnTrigger);
+            }
+        };
+        IntEvent* m_event;
+        std::vector<EventListener>* m_recruits;
+    };
+    Recruiter bulkRecruiter = { &event, &recruits };
+    event.RegisterMethod(&bulkRecruiter, &Recruiter::OnTrigger);
+
+    event.Trigger(1);
+    CHECK(recruiter.m_values.size() == 1);
+    CHECK(recruits[0].m_values.empty());
+    CHECK(event.GetNumSubscriptions() == 66);
+
+    event.Trigger(2);
+    CHECK(recruiter.m_values.size() == 2);
+    bool allRecruitsCalledOnce = true;
+    for (const EventListener& recruit : recruits)
+    {
+        allRecruitsCalledOnce = allRecruitsCalledOnce && recruit.m_values.size() == 1 && recruit.m_values[0] == 2;
+    }
+    CHECK(allRecruitsCalledOnce);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(EventNestedTriggersWaitForTheOutermostToCompact)
+{
+    IntEvent event;
+    EventListener outer;
+    EventListener quitter;
+    EventListener newcomer;
+    outer.m_event = &event;
+    quitter.m_event = &event;
+    newcomer.m_event = &event;
+    event.RegisterMethod(&outer, &EventListener::OnTrigger);
+    event.RegisterMethod(&quitter, &EventListener::OnTrigger);
+
+    //The outer listener triggers again from inside its callback. The quitter leaves and brings someone in during the inner trigger.
+    outer.m_numNestedTriggers = 1;
+    quitter.m_unregisterSelf = true;
+    quitter.m_registerOther = &newcomer;
+    event.Trigger(10);
+    CHECK(outer.m_values.size() == 2 && outer.m_values[0] == 10 && outer.m_values[1] == 11);
+    CHECK(quitter.m_values.size() == 1 && quitter.m_values[0] == 11);
+    CHECK(newcomer.m_values.empty());
+    CHECK(event.GetNumSubscriptions() == 2);
+
+    event.Trigger(20);
+    CHECK(outer.m_values.size() == 3);
+    CHECK(quitter.m_values.size() == 1);
+    CHECK(newcomer.m_values.size() == 1 && newcomer.m_values[0] == 20);
+}
+
+//-----------------------------------------------------------------------------------
+//Cheap enough that the benchmark times the dispatch and not the callback.
+struct EventCounter
+{
+    void OnTrigger(int value)
+    {
+        m_sum += (unsigned int)value;
+    };
+
+    unsigned int m_sum = 0;
+};
+
+//-----------------------------------------------------------------------------------
+//Event as it was before delegates, copied as is apart from the name and explicit void* casts. Only here so the benchmark has a baseline.
+template <typename ...Args>
+class SubscriptionEvent
+{
+public:
+    struct Subscription;
+    //TYPEDEFS/////////////////////////////////////////////////////////////////////
+    typedef void(SubscriptionCallback)(Subscription* sub, Args...);
+    typedef void(FunctionCallback)(Args...);
+    typedef void(EventCallback)(Subscription* sub, Args...);
+
+    //STRUCTS/////////////////////////////////////////////////////////////////////
+    template <typename CALLBACKTYPE>
+    struct SubscriptionType
+    {
+        SubscriptionCallback* utilityCallback; // This is the C style function the trigger actually calls
+        void* argument;         // Additional data that goes with the subscription (optional)
+
+        union {
+            CALLBACKTYPE callback;         // Is the callback registered by the user
+            char callback_data[16];
+        };
+    };
+
+    struct Subscription : public SubscriptionType<void*> {};
+
+    //CONSTRUCTORS/////////////////////////////////////////////////////////////////////
+    SubscriptionEvent() {};
+
+    //-----------------------------------------------------------------------------------
+    ~SubscriptionEvent()
+    {
+        UnregisterAllSubscriptions();
+    }
+
+    //FUNCTIONS/////////////////////////////////////////////////////////////////////
+    void RegisterFunction(FunctionCallback* cb)
+    {
+        RegisterSubscription((void*)&EventFunctionCallback, cb, nullptr);
+    }
+
+    //-----------------------------------------------------------------------------------
+    void UnregisterFunction(FunctionCallback* cb)
+    {
+        UnregisterSubscription((void*)&EventFunctionCallback, cb, nullptr);
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <typename T>
+    void RegisterMethod(T* object, void (T::*methodCallback)(Args...))
+    {
+        RegisterSubscription((void*)&MethodCallback<T, decltype(methodCallback)>, methodCallback, object);
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <typename T>
+    void UnregisterMethod(T* object, void (T::*methodCallback)(Args...))
+    {
+        UnregisterSubscription((void*)&MethodCallback<T, decltype(methodCallback)>, methodCallback, object);
+    }
+
+    //-----------------------------------------------------------------------------------
+    void UnregisterAllSubscriptions()
+    {
+        m_subscriptions.clear();
+    }
+
+    //-----------------------------------------------------------------------------------
+    void Trigger(Args... args)
+    {
+        unsigned int size = m_subscriptions.size();
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            auto& sub = m_subscriptions[i];
+            sub.utilityCallback(&sub, args...);
+            if (m_subscriptions.size() < size)
+            {
+                size = m_subscriptions.size();
+                --i;
+            }
+        }
+    }
+
+    //STATIC FUNCTIONS/////////////////////////////////////////////////////////////////////
+    template <typename T, typename METHODTYPE>
+    static void MethodCallback(SubscriptionType<METHODTYPE>* sub, Args... args)
+    {
+        METHODTYPE mcb = sub->callback;
+        T* objectPtr = (T*)sub->argument;
+        (objectPtr->*mcb)(args...);
+    }
+
+    //-----------------------------------------------------------------------------------
+    static void EventFunctionCallback(Subscription* sub, Args... args)
+    {
+        FunctionCallback* cb = (FunctionCallback*)(sub->callback);
+        cb(args...);
+    }
+
+private:
+    //PRIVATE FUNCTIONS/////////////////////////////////////////////////////////////////////
+    template <typename CBTYPE>
+    void RegisterSubscription(void* utilityCallback, CBTYPE actualCallback, void* data)
+    {
+        SubscriptionType<CBTYPE> sub;
+        sub.utilityCallback = (SubscriptionCallback*)utilityCallback;
+        sub.callback = actualCallback;
+        sub.argument = data;
+
+        Subscription subConv;
+        subConv = *(Subscription*)&sub;
+
+        m_subscriptions.push_back(subConv);
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <typename CBTYPE>
+    void UnregisterSubscription(void* utilityCallback, CBTYPE actualCallback, void* data)
+    {
+        for (auto subIter = m_subscriptions.begin(); subIter != m_subscriptions.end(); ++subIter)
+        {
+            SubscriptionType<CBTYPE> *sub = (SubscriptionType<CBTYPE>*) &(*subIter);
+            if (sub->callback == actualCallback && sub->utilityCallback == utilityCallback && sub->argument == data)
+            {
+                m_subscriptions.erase(subIter);
+                break;
+            }
+        }
+    }
+
+    //MEMBER VARIABLES/////////////////////////////////////////////////////////////////////
+    std::vector<Subscription, UntrackedAllocator<Subscription>> m_subscriptions;
+};
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(EventTriggerCost)
+{
+    const unsigned int NUM_TRIGGERS = 1000000;
+    const unsigned int SUBSCRIBER_COUNTS[] = { 1, 100 };
+    for (unsigned int numSubscribers : SUBSCRIBER_COUNTS)
+    {
+        std::vector<EventCounter> counters(numSubscribers);
+        SubscriptionEvent<int> subscriptionEvent;
+        IntEvent methodEvent;
+        IntEvent boundMethodEvent;
+        for (EventCounter& counter : counters)
+        {
+            subscriptionEvent.RegisterMethod(&counter, &EventCounter::OnTrigger);
+            methodEvent.RegisterMethod(&counter, &EventCounter::OnTrigger);
+            boundMethodEvent.RegisterMethod<EventCounter, &EventCounter::OnTrigger>(&counter);
+        }
+        {
+            std::string label = Stringf("Trigger, old subscription event, %u subscribers", numSubscribers);
+            BenchmarkTimer timer(label.c_str(), NUM_TRIGGERS);
+            for (unsigned int i = 0; i < NUM_TRIGGERS; ++i)
+            {
+                subscriptionEvent.Trigger((int)i);
+            }
+        }
+        {
+            std::string label = Stringf("Trigger, member pointer, %u subscribers", numSubscribers);
+            BenchmarkTimer timer(label.c_str(), NUM_TRIGGERS);
+            for (unsigned int i = 0; i < NUM_TRIGGERS; ++i)
+            {
+                methodEvent.Trigger((int)i);
+            }
+        }
+        {
+            std::string label = Stringf("Trigger, bound method, %u subscribers", numSubscribers);
+            BenchmarkTimer timer(label.c_str(), NUM_TRIGGERS);
+            for (unsigned int i = 0; i < NUM_TRIGGERS; ++i)
+            {
+                boundMethodEvent.Trigger((int)i);
+            }
+        }
+    }
+
+    //Duplicates are ignored, so there's only ever one function subscriber.
+    SubscriptionEvent<int> subscriptionFunctionEvent;
+    subscriptionFunctionEvent.RegisterFunction(&AddToFunctionSum);
+    {
+        BenchmarkTimer timer("Trigger, old subscription event, function, 1 subscriber", NUM_TRIGGERS);
+        for (unsigned int i = 0; i < NUM_TRIGGERS; ++i)
+        {
+            subscriptionFunctionEvent.Trigger((int)i);
+        }
+    }
+    IntEvent functionEvent;
+    functionEvent.RegisterFunction(&AddToFunctionSum);
+    BenchmarkTimer timer("Trigger, function, 1 subscriber", NUM_TRIGGERS);
+    for (unsigned int i = 0; i < NUM_TRIGGERS; ++i)
+    {
+        functionEvent.Trigger((int)i);
+    }
+}
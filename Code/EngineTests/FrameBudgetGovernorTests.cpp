@@ -0,0 +1,156 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/FrameBudgetGovernor.hpp"
+
+static const float TARGET_MS = 10.0f;
+static const unsigned int WINDOW_FRAMES = 10;
+static const unsigned int COOLDOWN_FRAMES = 5;
+
+//Comfortably either side of the dead zone, which runs from 8ms to 10.5ms with the default ratios.
+static const float SLOW_FRAME_MS = 20.0f;
+static const float FAST_FRAME_MS = 5.0f;
+static const float DEAD_ZONE_FRAME_MS = 9.0f;
+
+//-----------------------------------------------------------------------------------
+//Two knobs at full quality: cheap bloom that should go first, and particles that should go last.
+struct GovernedKnobs
+{
+    GovernedKnobs()
+        : m_governor(TARGET_MS, WINDOW_FRAMES)
+        , m_bloom(4)
+        , m_particles(3)
+    {
+        m_governor.m_cooldownFrames = COOLDOWN_FRAMES;
+        m_governor.RegisterKnob("bloom", &m_bloom, 1, 4, 0);
+        m_governor.RegisterKnob("particles", &m_particles, 1, 3, 10);
+    };
+
+    //Feeds the same frame time until a knob changes. Returns how many frames that took, or 0 if nothing changed.
+    unsigned int FramesUntilChange(float frameTimeMs, unsigned int maxFrames = 1000)
+    {
+        for (unsigned int i = 1; i <= maxFrames; ++i)
+        {
+            if (m_governor.Update(frameTimeMs))
+            {
+                return i;
+            }
+        }
+        return 0;
+    };
+
+    FrameBudgetGovernor m_governor;
+    int m_bloom;
+    int m_particles;
+};
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(GovernorLowersTheCheapestKnobFirstOneStepAtATime)
+{
+    GovernedKnobs knobs;
+
+    //Nothing's judged until the window is full.
+    CHECK(knobs.FramesUntilChange(SLOW_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.m_bloom == 3);
+    CHECK(knobs.m_particles == 3);
+
+    //After that every change waits out the cooldown, then a fresh window that was measured at the new settings.
+    CHECK(knobs.FramesUntilChange(SLOW_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.FramesUntilChange(SLOW_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.m_bloom == 1);
+    CHECK(knobs.m_particles == 3);
+
+    CHECK(knobs.FramesUntilChange(SLOW_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.FramesUntilChange(SLOW_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.m_bloom == 1);
+    CHECK(knobs.m_particles == 1);
+
+    //Everything's at its minimum, so there's nothing left to give.
+    CHECK(knobs.FramesUntilChange(SLOW_FRAME_MS) == 0);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(GovernorGivesQualityBackInReverseOrder)
+{
+    GovernedKnobs knobs;
+    knobs.m_bloom = 1;
+    knobs.m_particles = 1;
+
+    CHECK(knobs.FramesUntilChange(FAST_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.m_particles == 2);
+    CHECK(knobs.FramesUntilChange(FAST_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.m_particles == 3);
+    CHECK(knobs.m_bloom == 1);
+
+    CHECK(knobs.FramesUntilChange(FAST_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.FramesUntilChange(FAST_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.FramesUntilChange(FAST_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.m_bloom == 4);
+    CHECK(knobs.FramesUntilChange(FAST_FRAME_MS) == 0);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(GovernorHoldsStillInsideTheDeadZone)
+{
+    GovernedKnobs knobs;
+    knobs.m_bloom = 2;
+    CHECK(knobs.FramesUntilChange(DEAD_ZONE_FRAME_MS) == 0);
+    CHECK(knobs.m_bloom == 2);
+    CHECK(knobs.m_particles == 3);
+
+    //Alternating either side of the target without ever leaving the dead zone doesn't count as headroom or as being over.
+    unsigned int numChanges = 0;
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        numChanges += knobs.m_governor.Update(i % 2 == 0 ? 8.5f : 10.4f) ? 1 : 0;
+    }
+    CHECK(numChanges == 0);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(GovernorJudgesTheWindowByItsSlowFrames)
+{
+    //The average here is well under budget, but two spikes in ten frames put the p90 over it.
+    GovernedKnobs knobs;
+    bool changed = false;
+    for (unsigned int i = 0; i < WINDOW_FRAMES; ++i)
+    {
+        changed = knobs.m_governor.Update(i < 2 ? 12.0f : FAST_FRAME_MS) || changed;
+    }
+    CHECK(changed);
+    CHECK(knobs.m_bloom == 3);
+
+    //A single spike is inside the last 10%, so it's ignored and the window reads as headroom.
+    knobs.m_governor.RestoreFullQuality();
+    knobs.m_bloom = 3;
+    changed = false;
+    for (unsigned int i = 0; i < WINDOW_FRAMES; ++i)
+    {
+        changed = knobs.m_governor.Update(i == 0 ? 30.0f : FAST_FRAME_MS) || changed;
+    }
+    CHECK(changed);
+    CHECK(knobs.m_bloom == 4);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(GovernorLeavesKnobsAloneWhenDisabled)
+{
+    GovernedKnobs knobs;
+    knobs.m_governor.m_isEnabled = false;
+    CHECK(knobs.FramesUntilChange(SLOW_FRAME_MS) == 0);
+    CHECK(knobs.m_bloom == 4);
+    CHECK(knobs.m_particles == 3);
+
+    //Manual levels are clamped to the knob's range, and restoring puts everything back at its max.
+    CHECK(knobs.m_governor.SetKnobLevel("particles", -5));
+    CHECK(knobs.m_particles == 1);
+    CHECK(!knobs.m_governor.SetKnobLevel("shadows", 1));
+    knobs.m_governor.RestoreFullQuality();
+    CHECK(knobs.m_particles == 3);
+
+    //Unregistered knobs stop being touched.
+    knobs.m_governor.m_isEnabled = true;
+    knobs.m_governor.UnregisterKnob(&knobs.m_bloom);
+    CHECK(knobs.m_governor.GetNumKnobs() == 1);
+    CHECK(knobs.FramesUntilChange(SLOW_FRAME_MS) == WINDOW_FRAMES);
+    CHECK(knobs.m_bloom == 4);
+    CHECK(knobs.m_particles == 2);
+}
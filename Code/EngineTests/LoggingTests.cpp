@@ -0,0 +1,549 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Input/Logging.hpp"
+#include "Engine/Input/LogChannels.hpp"
+#include "Engine/Input/LogThreadBuffer.hpp"
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Stands up a logger with its writer thread for the length of a test. Rotation's off so everything lands in one file.
+class ScopedLogger
+{
+public:
+    ScopedLogger() : m_previousInstance(Logger::instance)
+    {
+        Logger::instance = new Logger();
+        Logger::instance->m_rotationSizeBytes = 0;
+        Logger::instance->m_rotationIntervalSeconds = 0.0;
+        m_fileName = Logger::instance->m_fileName;
+        Logger::instance->StartLoggingThread();
+    };
+
+    ~ScopedLogger()
+    {
+        Shutdown();
+        remove(m_fileName.c_str());
+        Logger::instance = m_previousInstance;
+    };
+
+    //Tears the logger down the way the game does, then hands back every line that made it to disk.
+    std::vector<std::string> ShutdownAndReadLines()
+    {
+        Shutdown();
+        std::vector<std::string> lines;
+        FILE* file = fopen(m_fileName.c_str(), "rb");
+        if (!file)
+        {
+            return lines;
+        }
+        char line[LOGF_STACK_LOCAL_TEMP_LENGTH];
+        while (fgets(line, sizeof(line), file))
+        {
+            lines.push_back(line);
+        }
+        fclose(file);
+        return lines;
+    };
+
+private:
+    void Shutdown()
+    {
+        delete Logger::instance;
+        Logger::instance = nullptr;
+    };
+
+    Logger* m_previousInstance;
+    std::string m_fileName;
+};
+
+//-----------------------------------------------------------------------------------
+//LogPrintf is compiled down to nothing by LOG_LEVEL_THRESHOLD in most configs, so tests go to the logger directly.
+static void LogTestLine(const char* format, ...)
+{
+    va_list variableArgumentList;
+    va_start(variableArgumentList, format);
+    Logger::instance->LogFormatted(LogLevel::DEFAULT, nullptr, format, variableArgumentList);
+    va_end(variableArgumentList);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogThreadBufferWrapsWithMixedRecordSizes)
+{
+    //Small enough to wrap constantly. The sizes don't divide evenly into it, so the gap left at the end of the ring lands on every possible size.
+    const size_t CAPACITY = 256;
+    const unsigned int NUM_RECORDS = 5000;
+    const size_t MAX_PAYLOAD_SIZE = CAPACITY / 2 - sizeof(LogRecordHeader);
+    LogThreadBuffer buffer(CAPACITY);
+    std::atomic<uint64_t> sequenceCounter(0);
+    unsigned int numWritten = 0;
+    unsigned int numRead = 0;
+    bool recordsIntact = true;
+    bool usageInBounds = true;
+    while (numRead < NUM_RECORDS)
+    {
+        //Fill until the ring pushes back, then drain a couple, so the producer and consumer cross the end at every offset.
+        while (numWritten < NUM_RECORDS)
+        {
+            size_t payloadSize = ((numWritten * 37) % MAX_PAYLOAD_SIZE) + 1;
+            byte* payload = buffer.Reserve(payloadSize);
+            if (!payload)
+            {
+                break;
+            }
+            memset(payload, (int)(numWritten & 0xFF), payloadSize);
+            buffer.Commit(LOG_RECORD_TEXT, numWritten % 7, payloadSize, sequenceCounter);
+            ++numWritten;
+            usageInBounds = usageInBounds && buffer.GetNumBytesUsed() <= CAPACITY;
+        }
+        for (int i = 0; i < 2; ++i)
+        {
+            const LogRecordHeader* header = buffer.Peek();
+            if (!header)
+            {
+                break;
+            }
+            size_t expectedSize = ((numRead * 37) % MAX_PAYLOAD_SIZE) + 1;
+            const byte* payload = LogThreadBuffer::GetPayload(header);
+            recordsIntact = recordsIntact && header->m_type == LOG_RECORD_TEXT && header->m_size == expectedSize && header->m_level == numRead % 7
+                && header->m_sequence == numRead && payload[0] == (byte)(numRead & 0xFF) && payload[expectedSize - 1] == (byte)(numRead & 0xFF);
+            buffer.Pop();
+            ++numRead;
+            usageInBounds = usageInBounds && buffer.GetNumBytesUsed() <= CAPACITY;
+        }
+        REQUIRE(recordsIntact);
+    }
+    CHECK(usageInBounds);
+    CHECK(buffer.Peek() == nullptr);
+    CHECK(buffer.GetNumBytesUsed() == 0);
+
+    //Drained, so the biggest record there is has to fit again.
+    CHECK(buffer.Reserve(MAX_PAYLOAD_SIZE) != nullptr);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogMergesThreadsInTheOrderTheyLogged)
+{
+    //The lock makes the order each line is logged in unambiguous, while every line still goes through the ring of whichever thread logged it.
+    ScopedLogger logger;
+    const int NUM_THREADS = 6;
+    const int NUM_LINES = 20000;
+    std::mutex orderLock;
+    int nextLineNumber = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        threads.emplace_back([&orderLock, &nextLineNumber, NUM_LINES]()
+        {
+            for (;;)
+            {
+                std::lock_guard<std::mutex> lock(orderLock);
+                if (nextLineNumber == NUM_LINES)
+                {
+                    return;
+                }
+                LogTestLine("%i\n", nextLineNumber++);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<std::string> lines = logger.ShutdownAndReadLines();
+    REQUIRE(lines.size() == NUM_LINES);
+    bool isInOrder = true;
+    for (int i = 0; i < NUM_LINES; ++i)
+    {
+        isInOrder = isInOrder && atoi(lines[i].c_str()) == i;
+    }
+    CHECK(isInOrder);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogLosesNothingAtShutdown)
+{
+    //The writer stops while everyone's still mid burst, so some of this only gets out through producers draining themselves and the final flush.
+    ScopedLogger logger;
+    const int NUM_THREADS = 8;
+    const int NUM_LINES_PER_THREAD = 20000;
+    std::atomic<int> numThreadsStarted(0);
+    std::vector<std::thread> threads;
+    for (int threadIndex = 0; threadIndex < NUM_THREADS; ++threadIndex)
+    {
+        threads.emplace_back([threadIndex, &numThreadsStarted, NUM_LINES_PER_THREAD]()
+        {
+            ++numThreadsStarted;
+            for (int i = 0; i < NUM_LINES_PER_THREAD; ++i)
+            {
+                LogTestLine("%i %i\n", threadIndex, i);
+            }
+        });
+    }
+    while (numThreadsStarted < NUM_THREADS)
+    {
+        std::this_thread::yield();
+    }
+    Logger::instance->StopLoggingThread();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    //Every thread's lines arrive whole, and each thread's own lines stay in order.
+    std::vector<std::string> lines = logger.ShutdownAndReadLines();
+    CHECK(lines.size() == NUM_THREADS * NUM_LINES_PER_THREAD);
+    std::vector<int> nextLineForThread(NUM_THREADS, 0);
+    bool allLinesExpected = true;
+    for (const std::string& line : lines)
+    {
+        int threadIndex = -1;
+        int lineIndex = -1;
+        if (sscanf(line.c_str(), "%i %i", &threadIndex, &lineIndex) != 2 || threadIndex < 0 || threadIndex >= NUM_THREADS || nextLineForThread[threadIndex] != lineIndex)
+        {
+            allLinesExpected = false;
+            break;
+        }
+        ++nextLineForThread[threadIndex];
+    }
+    CHECK(allLinesExpected);
+}
+
+//-----------------------------------------------------------------------------------
+static std::vector<std::string> ReadLogLines(const std::string& fileName)
+{
+    std::vector<std::string> lines;
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+    {
+        return lines;
+    }
+    char line[LOGF_STACK_LOCAL_TEMP_LENGTH];
+    while (fgets(line, sizeof(line), file))
+    {
+        lines.push_back(line);
+    }
+    fclose(file);
+    return lines;
+}
+
+//-----------------------------------------------------------------------------------
+//Only moves when the test says so. Can also stand in for a crash handler firing from inside the logger, since the logger reads it mid drain.
+static double s_fakeLogClockSeconds = 0.0;
+static bool s_crashInsideNextClockRead = false;
+static double ReadFakeLogClock()
+{
+    if (s_crashInsideNextClockRead)
+    {
+        s_crashInsideNextClockRead = false;
+        Logger::instance->FlushLogAfterCrash();
+    }
+    return s_fakeLogClockSeconds;
+}
+
+//-----------------------------------------------------------------------------------
+//No writer thread, so nothing's written except when the test flushes.
+class FakeClockLogger
+{
+public:
+    FakeClockLogger(double rotationIntervalSeconds, size_t rotationSizeBytes = 0) : m_previousInstance(Logger::instance)
+    {
+        s_fakeLogClockSeconds = 1000.0;
+        s_crashInsideNextClockRead = false;
+        Logger::instance = new Logger(&ReadFakeLogClock);
+        Logger::instance->m_rotationSizeBytes = rotationSizeBytes;
+        Logger::instance->m_rotationIntervalSeconds = rotationIntervalSeconds;
+        m_fileNames.push_back(Logger::instance->m_fileName);
+    };
+
+    ~FakeClockLogger()
+    {
+        delete Logger::instance;
+        Logger::instance = m_previousInstance;
+        for (const std::string& fileName : m_fileNames)
+        {
+            remove(fileName.c_str());
+        }
+    };
+
+    //Returns true if the flush moved the log on to a new file.
+    bool FlushAndCheckForRotation()
+    {
+        Logger::instance->FlushLog();
+        if (Logger::instance->m_fileName == m_fileNames.back())
+        {
+            return false;
+        }
+        m_fileNames.push_back(Logger::instance->m_fileName);
+        return true;
+    };
+
+    Logger* m_previousInstance;
+    std::vector<std::string> m_fileNames;
+};
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogRotatesOnTheClockItWasGiven)
+{
+    FakeClockLogger logger(60.0);
+    LogTestLine("first\n");
+    CHECK(!logger.FlushAndCheckForRotation());
+
+    //Real time passing means nothing, only the injected clock does.
+    s_fakeLogClockSeconds += 59.9;
+    LogTestLine("second\n");
+    CHECK(!logger.FlushAndCheckForRotation());
+
+    //Rotation happens before the write that finds the file too old, so that write starts the new file.
+    s_fakeLogClockSeconds += 0.1;
+    LogTestLine("third\n");
+    CHECK(logger.FlushAndCheckForRotation());
+
+    //The new file's age counts from when it was opened, and an empty file never rotates no matter how old it is.
+    s_fakeLogClockSeconds += 30.0;
+    LogTestLine("fourth\n");
+    CHECK(!logger.FlushAndCheckForRotation());
+    s_fakeLogClockSeconds += 600.0;
+    CHECK(!logger.FlushAndCheckForRotation());
+    LogTestLine("fifth\n");
+    CHECK(logger.FlushAndCheckForRotation());
+
+    REQUIRE(logger.m_fileNames.size() == 3);
+    std::vector<std::string> firstFile = ReadLogLines(logger.m_fileNames[0]);
+    std::vector<std::string> secondFile = ReadLogLines(logger.m_fileNames[1]);
+    REQUIRE(firstFile.size() == 2);
+    REQUIRE(secondFile.size() == 2);
+    CHECK(firstFile[0] == "first\n" && firstFile[1] == "second\n");
+    CHECK(secondFile[0] == "third\n" && secondFile[1] == "fourth\n");
+}
+
+//-----------------------------------------------------------------------------------
+static bool DoesLogFileExist(const std::string& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+    fclose(file);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogRotatesOnceTheSizeLimitWouldBePassed)
+{
+    //Each flush is one write, and rotation is only checked per write, so flushing every line puts the check right at each line.
+    FakeClockLogger logger(0.0, 32);
+    LogTestLine("ten bytes\n");
+    CHECK(!logger.FlushAndCheckForRotation());
+    LogTestLine("ten bytes\n");
+    CHECK(!logger.FlushAndCheckForRotation());
+
+    //Landing exactly on the limit is still fine. One more byte is what moves it on.
+    LogTestLine("12 bytes...\n");
+    CHECK(!logger.FlushAndCheckForRotation());
+    LogTestLine("\n");
+    CHECK(logger.FlushAndCheckForRotation());
+
+    //A message bigger than the limit gets a file to itself. An empty file takes any write, so it's the one after that moves on.
+    LogTestLine("this one line is longer than the whole size limit\n");
+    CHECK(logger.FlushAndCheckForRotation());
+    LogTestLine("after\n");
+    CHECK(logger.FlushAndCheckForRotation());
+
+    REQUIRE(logger.m_fileNames.size() == 4);
+    std::vector<std::string> firstFile = ReadLogLines(logger.m_fileNames[0]);
+    std::vector<std::string> secondFile = ReadLogLines(logger.m_fileNames[1]);
+    std::vector<std::string> thirdFile = ReadLogLines(logger.m_fileNames[2]);
+    REQUIRE(firstFile.size() == 3);
+    CHECK(firstFile[2] == "12 bytes...\n");
+    CHECK(secondFile.size() == 1 && secondFile[0] == "\n");
+    CHECK(thirdFile.size() == 1 && thirdFile[0] == "this one line is longer than the whole size limit\n");
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogRotationOnlyKeepsTheNewestFiles)
+{
+    //Every write rotates, so each line gets its own file and the oldest ones have to be cleaned up as we go.
+    FakeClockLogger logger(0.0, 1);
+    const unsigned int NUM_FILES = MAX_LOG_HISTORY + 3;
+    for (unsigned int i = 0; i < NUM_FILES; ++i)
+    {
+        LogTestLine("line\n");
+        logger.FlushAndCheckForRotation();
+    }
+    REQUIRE(logger.m_fileNames.size() == NUM_FILES);
+
+    //File names sort oldest first, so the first ones we rotated away from are the ones that go.
+    unsigned int numKept = 0;
+    for (const std::string& fileName : logger.m_fileNames)
+    {
+        numKept += DoesLogFileExist(fileName) ? 1 : 0;
+    }
+    CHECK(!DoesLogFileExist(logger.m_fileNames[0]));
+    CHECK(!DoesLogFileExist(logger.m_fileNames[1]));
+    CHECK(DoesLogFileExist(logger.m_fileNames.back()));
+    CHECK(numKept <= MAX_LOG_HISTORY);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogCrashFlushDoesntReenterADrain)
+{
+    //The crash lands while this thread is in the middle of draining, with a batch on its way to the file. Reentering would write that batch twice.
+    const int NUM_LINES = 500;
+    FakeClockLogger logger(60.0);
+    LogTestLine("%i\n", 0);
+    logger.FlushAndCheckForRotation();
+    for (int i = 1; i < NUM_LINES / 2; ++i)
+    {
+        LogTestLine("%i\n", i);
+    }
+    s_fakeLogClockSeconds += 60.0;
+    for (int i = NUM_LINES / 2; i < NUM_LINES; ++i)
+    {
+        LogTestLine("%i\n", i);
+    }
+    s_crashInsideNextClockRead = true;
+    logger.FlushAndCheckForRotation();
+    CHECK(!s_crashInsideNextClockRead);
+
+    //The crash flush from outside any drain still gets everything out.
+    LogTestLine("after\n");
+    Logger::instance->FlushLogAfterCrash();
+
+    std::vector<std::string> lines;
+    for (const std::string& fileName : logger.m_fileNames)
+    {
+        std::vector<std::string> fileLines = ReadLogLines(fileName);
+        lines.insert(lines.end(), fileLines.begin(), fileLines.end());
+    }
+    REQUIRE(lines.size() == NUM_LINES + 1);
+    bool isInOrder = true;
+    for (int i = 0; i < NUM_LINES; ++i)
+    {
+        isInOrder = isInOrder && atoi(lines[i].c_str()) == i;
+    }
+    CHECK(isInOrder);
+    CHECK(lines.back() == "after\n");
+}
+
+//-----------------------------------------------------------------------------------
+//Puts every channel back the way it was, whatever the test did to them.
+class ScopedLogChannelLevels
+{
+public:
+    ScopedLogChannelLevels()
+    {
+        for (int i = 0; i < NUM_LOG_CHANNELS; ++i)
+        {
+            m_previousLevels[i] = g_logChannelLevels[i].load();
+        }
+    };
+
+    ~ScopedLogChannelLevels()
+    {
+        for (int i = 0; i < NUM_LOG_CHANNELS; ++i)
+        {
+            g_logChannelLevels[i].store(m_previousLevels[i]);
+        }
+    };
+
+private:
+    int m_previousLevels[NUM_LOG_CHANNELS];
+};
+
+//-----------------------------------------------------------------------------------
+static int s_numArgumentEvaluations = 0;
+static int CountArgumentEvaluation()
+{
+    return ++s_numArgumentEvaluations;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogChannelsFilterByTheirOwnLevel)
+{
+    ScopedLogChannelLevels restoreLevels;
+    ScopedLogger logger;
+    SetAllLogChannelLevels(LogLevel::NONE);
+    SetLogChannelLevel(LOG_CHANNEL_NET, LogLevel::WARNING);
+    SetLogChannelLevel(LOG_CHANNEL_RENDER, LogLevel::VERBOSE);
+
+    LOG_VERBOSE(LOG_CHANNEL_NET, "net verbose\n");
+    LOG_DEFAULT(LOG_CHANNEL_NET, "net default\n");
+    LOG_WARNING(LOG_CHANNEL_NET, "net warning %i\n", 1);
+    LOG_SEVERE(LOG_CHANNEL_NET, "net severe %s\n", "2");
+    LOG_VERBOSE(LOG_CHANNEL_RENDER, "render verbose\n");
+    LOG_SEVERE(LOG_CHANNEL_AUDIO, "audio severe\n");
+
+    std::vector<std::string> lines = logger.ShutdownAndReadLines();
+    REQUIRE(lines.size() == 3);
+    CHECK(lines[0] == "[net] net warning 1\n");
+    CHECK(lines[1] == "[net] net severe 2\n");
+    CHECK(lines[2] == "[render] render verbose\n");
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LogChannelsSkipArgumentsTheyWontLog)
+{
+    ScopedLogChannelLevels restoreLevels;
+    ScopedLogger logger;
+    SetAllLogChannelLevels(LogLevel::NONE);
+    SetLogChannelLevel(LOG_CHANNEL_JOBS, LogLevel::WARNING);
+    s_numArgumentEvaluations = 0;
+
+    //Filtered at runtime.
+    LOG_DEFAULT(LOG_CHANNEL_JOBS, "%i\n", CountArgumentEvaluation());
+    LOG_SEVERE(LOG_CHANNEL_UI, "%i\n", CountArgumentEvaluation());
+    CHECK(s_numArgumentEvaluations == 0);
+
+    //Stripped at compile time, which wins even when the channel would let it through.
+    SetAllLogChannelLevels(LogLevel::VERBOSE);
+    LOG_CHANNEL_MESSAGE_STRIPPED(LOG_CHANNEL_JOBS, LogLevel::SEVERE, "%i\n", CountArgumentEvaluation());
+#if LOG_COMPILE_TIME_MIN_LEVEL > 0
+    LOG_VERBOSE(LOG_CHANNEL_JOBS, "%i\n", CountArgumentEvaluation());
+#endif
+    CHECK(s_numArgumentEvaluations == 0);
+
+    //And once it does get through, exactly once.
+    LOG_SEVERE(LOG_CHANNEL_JOBS, "%i\n", CountArgumentEvaluation());
+    CHECK(s_numArgumentEvaluations == 1);
+    std::vector<std::string> lines = logger.ShutdownAndReadLines();
+    REQUIRE(lines.size() == 1);
+    CHECK(lines[0] == "[jobs] 1\n");
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(LogThroughputWithConcurrentProducers)
+{
+    const int NUM_LINES = 400000;
+    const int PRODUCER_COUNTS[] = { 1, 4, 8, 16 };
+    for (int numProducers : PRODUCER_COUNTS)
+    {
+        ScopedLogger logger;
+        std::string label = Stringf("LogFormatted, %i producers, per line", numProducers);
+        BenchmarkTimer timer(label.c_str(), NUM_LINES);
+        std::vector<std::thread> threads;
+        for (int threadIndex = 0; threadIndex < numProducers; ++threadIndex)
+        {
+            threads.emplace_back([threadIndex, numProducers, NUM_LINES]()
+            {
+                for (int i = 0; i < NUM_LINES / numProducers; ++i)
+                {
+                    LogTestLine("Thread %i line %i with enough text to look like a real message.\n", threadIndex, i);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        //Counted in the time, so a writer that can't keep up shows here rather than hiding behind full rings.
+        Logger::instance->FlushLog();
+    }
+}
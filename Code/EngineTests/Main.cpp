@@ -0,0 +1,28 @@
+#include "EngineTests/TestFramework.hpp"
+#include <cstring>
+
+//Globals the engine expects the game to provide.
+bool g_isQuitting = false;
+const char* APP_NAME = "EngineTests";
+int g_frameNumber = 0;
+
+//-----------------------------------------------------------------------------------
+//EngineTests.exe [-bench] [name filter]
+//Runs every test whose name contains the filter, or every benchmark with -bench. Returns the number of failed tests.
+int main(int argc, char** argv)
+{
+    bool runBenchmarks = false;
+    const char* nameFilter = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-bench") == 0)
+        {
+            runBenchmarks = true;
+        }
+        else
+        {
+            nameFilter = argv[i];
+        }
+    }
+    return RunRegisteredTests(runBenchmarks, nameFilter);
+}
@@ -0,0 +1,128 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/Memory/ArenaAllocator.hpp"
+#include <map>
+#include <type_traits>
+#include <utility>
+
+//Containers should only ever end up in an arena because someone asked for it.
+static_assert(!std::is_convertible<MemoryArena*, ArenaAllocator<int>>::value, "ArenaAllocator's arena constructor should be explicit.");
+
+typedef std::map<int, int, std::less<int>, ArenaAllocator<std::pair<const int, int>>> ArenaMap;
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ArenaContainersCopyToTheHeapAndMoveWithTheirArena)
+{
+    LinearArena levelArena("level", 1024);
+    ArenaVector<int> original((ArenaAllocator<int>(&levelArena)));
+    for (int i = 0; i < 1000; ++i)
+    {
+        original.push_back(i);
+    }
+    CHECK(levelArena.GetNumBytesUsed() >= 1000 * sizeof(int));
+    CHECK(levelArena.GetNumChunks() > 1);
+
+    ArenaVector<int> copy(original);
+    CHECK(copy.get_allocator().GetArena() == GetHeapArena());
+    CHECK(copy.size() == 1000);
+
+    ArenaVector<int> moved(std::move(original));
+    CHECK(moved.get_allocator().GetArena() == &levelArena);
+    CHECK(moved[999] == 999);
+
+    //Copy assignment keeps the destination's arena.
+    ArenaVector<int> assigned;
+    assigned = moved;
+    CHECK(assigned.get_allocator().GetArena() == GetHeapArena());
+    CHECK(assigned.size() == 1000);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(LinearArenaScopesRewindInOrder)
+{
+    LinearArena scratchArena("scratch", 256);
+    scratchArena.Allocate(16, 8);
+    const size_t usedBeforeScopes = scratchArena.GetNumBytesUsed();
+    void* firstInsideScope = nullptr;
+    {
+        LinearArenaScope outerScope(&scratchArena);
+        firstInsideScope = scratchArena.Allocate(32, 8);
+        {
+            LinearArenaScope innerScope(&scratchArena);
+            //Big enough to force new chunks, which have to be kept around for reuse after the rewind.
+            scratchArena.Allocate(1000, 8);
+            scratchArena.Allocate(1000, 8);
+        }
+        CHECK(scratchArena.GetNumBytesUsed() == usedBeforeScopes + 32);
+    }
+    CHECK(scratchArena.GetNumBytesUsed() == usedBeforeScopes);
+
+    //Rewinding hands the same memory out again, and doesn't go back to malloc for chunks it already has.
+    const unsigned int numChunks = scratchArena.GetNumChunks();
+    {
+        LinearArenaScope scope(&scratchArena);
+        CHECK(scratchArena.Allocate(32, 8) == firstInsideScope);
+        scratchArena.Allocate(1000, 8);
+        scratchArena.Allocate(1000, 8);
+    }
+    CHECK(scratchArena.GetNumChunks() == numChunks);
+    CHECK(scratchArena.GetHighwaterInBytes() >= usedBeforeScopes + 2032);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(FrameArenaOnlyRewindsWhenItsScopeCloses)
+{
+    //Nothing else resets the frame arena, so whatever a scope allocates is still good until that scope ends.
+    LinearArena* frameArena = GetFrameArena();
+    const size_t usedBefore = frameArena->GetNumBytesUsed();
+    {
+        LinearArenaScope frameScope(frameArena);
+        ArenaVector<int> scratch((ArenaAllocator<int>(frameArena)));
+        scratch.resize(100, 7);
+        CHECK(frameArena->GetNumBytesUsed() > usedBefore);
+        CHECK(scratch[99] == 7);
+    }
+    CHECK(frameArena->GetNumBytesUsed() == usedBefore);
+}
+
+//-----------------------------------------------------------------------------------
+//Builds what a level might: lots of small node based containers. Then times throwing all of it away.
+template <typename MAP_TYPE>
+static void FillLevelMaps(MAP_TYPE* maps, unsigned int numMaps, unsigned int numEntriesPerMap)
+{
+    for (unsigned int mapIndex = 0; mapIndex < numMaps; ++mapIndex)
+    {
+        for (unsigned int i = 0; i < numEntriesPerMap; ++i)
+        {
+            maps[mapIndex][(int)i] = (int)(i * mapIndex);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(LevelTeardownHeapVersusArena)
+{
+    const unsigned int NUM_MAPS = 256;
+    const unsigned int NUM_ENTRIES_PER_MAP = 256;
+    const unsigned int NUM_ENTRIES = NUM_MAPS * NUM_ENTRIES_PER_MAP;
+
+    std::map<int, int>* heapMaps = new std::map<int, int>[NUM_MAPS];
+    FillLevelMaps(heapMaps, NUM_MAPS, NUM_ENTRIES_PER_MAP);
+    {
+        BenchmarkTimer timer("Heap teardown, per node", NUM_ENTRIES);
+        delete[] heapMaps;
+    }
+
+    LinearArena levelArena("level", 1024 * 1024);
+    {
+        //The maps still run their destructors, but every node free is a no-op.
+        ArenaMap* arenaMaps = new ArenaMap[NUM_MAPS];
+        for (unsigned int i = 0; i < NUM_MAPS; ++i)
+        {
+            arenaMaps[i] = ArenaMap(std::less<int>(), ArenaAllocator<std::pair<const int, int>>(&levelArena));
+        }
+        FillLevelMaps(arenaMaps, NUM_MAPS, NUM_ENTRIES_PER_MAP);
+        BenchmarkTimer timer("Arena teardown, destructors + Reset, per node", NUM_ENTRIES);
+        delete[] arenaMaps;
+        levelArena.Reset();
+    }
+}
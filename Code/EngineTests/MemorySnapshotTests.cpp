@@ -0,0 +1,188 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/Memory/MemorySnapshot.hpp"
+#include "Engine/Core/Memory/MemoryTracking.hpp"
+#include "Engine/Core/Memory/Callstack.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Input/BinaryWriter.hpp"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+static std::vector<unsigned char> ReadWholeFile(const char* filePath)
+{
+    std::vector<unsigned char> contents;
+    FILE* file = nullptr;
+    if (fopen_s(&file, filePath, "rb") != 0)
+    {
+        return contents;
+    }
+    int character = 0;
+    while ((character = fgetc(file)) != EOF)
+    {
+        contents.push_back((unsigned char)character);
+    }
+    fclose(file);
+    return contents;
+}
+
+//-----------------------------------------------------------------------------------
+static MemorySnapshot BuildSnapshot(unsigned int numAllocations, size_t numBytes)
+{
+    MemorySnapshot snapshot;
+    MemorySnapshotSite site;
+    site.m_callsite = "LoadLevel(12) <- main(3)";
+    site.m_tag = MEMTAG_GAME;
+    site.m_numberOfAllocations = numAllocations;
+    site.m_numberOfBytes = numBytes;
+    snapshot.m_sites.push_back(site);
+    snapshot.m_numberOfAllocations = numAllocations;
+    snapshot.m_numberOfBytes = numBytes;
+    return snapshot;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(MemorySnapshotRoundTripsThroughAFile)
+{
+    const char* filePath = "MemorySnapshotTest.msnp";
+    MemorySnapshot original = BuildSnapshot(3, 300);
+    REQUIRE(original.SaveToFile(filePath));
+
+    MemorySnapshot loaded;
+    REQUIRE(loaded.LoadFromFile(filePath));
+    remove(filePath);
+    REQUIRE(loaded.m_sites.size() == 1);
+    CHECK(loaded.m_sites[0].m_callsite == original.m_sites[0].m_callsite);
+    CHECK(loaded.m_sites[0].m_tag == MEMTAG_GAME);
+    CHECK(loaded.m_numberOfAllocations == 3);
+    CHECK(loaded.m_numberOfBytes == 300);
+
+    std::vector<MemorySnapshotDiffEntry> growth = MemorySnapshot::Diff(loaded, BuildSnapshot(5, 1000));
+    REQUIRE(growth.size() == 1);
+    CHECK(growth[0].m_allocationDelta == 2);
+    CHECK(growth[0].m_byteDelta == 700);
+    CHECK(MemorySnapshot::Diff(BuildSnapshot(5, 1000), loaded).empty());
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(MemorySnapshotRejectsTruncatedAndCorruptFiles)
+{
+    const char* filePath = "MemorySnapshotTest.msnp";
+    REQUIRE(BuildSnapshot(3, 300).SaveToFile(filePath));
+    const std::vector<unsigned char> goodFile = ReadWholeFile(filePath);
+    remove(filePath);
+    REQUIRE(goodFile.size() > 12);
+
+    MemorySnapshot snapshot = BuildSnapshot(1, 10);
+    CHECK(snapshot.LoadFromBytes(goodFile.data(), goodFile.size()));
+
+    //Every possible truncation has to fail, and leave what was already loaded alone.
+    for (size_t size = 0; size < goodFile.size(); ++size)
+    {
+        CHECK(!snapshot.LoadFromBytes(goodFile.data(), size));
+    }
+    CHECK(snapshot.m_numberOfBytes == 300);
+
+    std::vector<unsigned char> badFile = goodFile;
+    badFile[0] ^= 0xFF;
+    CHECK(!snapshot.LoadFromBytes(badFile.data(), badFile.size()));
+    badFile = goodFile;
+    badFile[4] = 2;
+    CHECK(!snapshot.LoadFromBytes(badFile.data(), badFile.size()));
+
+    //A site count far bigger than the file could hold must fail before anything gets reserved for it.
+    badFile = goodFile;
+    const uint32_t hugeSiteCount = 0xFFFFFFFF;
+    memcpy(&badFile[8], &hugeSiteCount, sizeof(hugeSiteCount));
+    CHECK(!snapshot.LoadFromBytes(badFile.data(), badFile.size()));
+
+    //Same for a string that claims to run past the end of the file.
+    badFile = goodFile;
+    const uint32_t hugeStringLength = 0x7FFFFFFF;
+    memcpy(&badFile[12], &hugeStringLength, sizeof(hugeStringLength));
+    CHECK(!snapshot.LoadFromBytes(badFile.data(), badFile.size()));
+
+    badFile = goodFile;
+    badFile.push_back(0);
+    CHECK(!snapshot.LoadFromBytes(badFile.data(), badFile.size()));
+    CHECK(snapshot.m_numberOfAllocations == 3);
+}
+
+//-----------------------------------------------------------------------------------
+//Turns on locked tracking for the length of a test without MemoryAnalyticsStartup, which would throw away every allocation made so far.
+class ScopedMemoryTracking
+{
+public:
+    ScopedMemoryTracking()
+        : m_ownsTracking(!g_memoryAnalytics.m_isInitialized)
+        , m_ownsCallstacks(!CallstackSystemIsInitialized())
+    {
+        if (m_ownsCallstacks) { CallstackSystemInit(); }
+        if (m_ownsTracking) { g_memoryAnalytics.m_isInitialized = true; }
+    };
+    ~ScopedMemoryTracking()
+    {
+        if (m_ownsTracking) { g_memoryAnalytics.m_isInitialized = false; }
+        if (m_ownsCallstacks) { CallstackSystemDeinit(); }
+    };
+
+private:
+    bool m_ownsTracking;
+    bool m_ownsCallstacks;
+};
+
+//-----------------------------------------------------------------------------------
+//Not static, so they keep their own names when the callsites are symbolized.
+char* MemorySnapshotTestAllocateFromFirstCallsite(size_t numBytes) { return new char[numBytes]; }
+char* MemorySnapshotTestAllocateFromSecondCallsite(size_t numBytes) { return new char[numBytes]; }
+//Called through these so neither gets inlined into the test.
+typedef char* (*AllocateFunction)(size_t numBytes);
+static AllocateFunction volatile g_allocateFromFirstCallsite = &MemorySnapshotTestAllocateFromFirstCallsite;
+static AllocateFunction volatile g_allocateFromSecondCallsite = &MemorySnapshotTestAllocateFromSecondCallsite;
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(MemorySnapshotCapturesGrowthPerCallsite)
+{
+#if !defined(TRACK_MEMORY)
+    SKIP_TEST("Needs TRACK_MEMORY in BuildConfig.hpp");
+#endif
+    ScopedMemoryTracking memoryTracking;
+    MemorySnapshot before;
+    before.Capture();
+
+    //Reserved up front so the vector's own allocation doesn't land in the audio tag.
+    std::vector<char*> allocations;
+    allocations.reserve(5);
+    {
+        MemoryTagScope audioScope(MEMTAG_AUDIO);
+        for (int i = 0; i < 4; ++i)
+        {
+            allocations.push_back(g_allocateFromFirstCallsite(1000));
+        }
+        allocations.push_back(g_allocateFromSecondCallsite(50));
+    }
+    MemorySnapshot after;
+    after.Capture();
+    for (char* allocation : allocations)
+    {
+        delete[] allocation;
+    }
+
+    //Both callsites show up as separate sites, with the bigger one first.
+    unsigned int numAudioSites = 0;
+    long long audioBytes = 0;
+    std::vector<MemorySnapshotDiffEntry> growth = MemorySnapshot::Diff(before, after);
+    for (const MemorySnapshotDiffEntry& entry : growth)
+    {
+        if (entry.m_tag == MEMTAG_AUDIO)
+        {
+            CHECK(numAudioSites != 0 || entry.m_byteDelta == 4000);
+            ++numAudioSites;
+            audioBytes += entry.m_byteDelta;
+        }
+    }
+    CHECK(numAudioSites == 2);
+    CHECK(audioBytes == 4050);
+}
@@ -0,0 +1,146 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/Memory/MemoryTags.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include <atomic>
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(MemoryTagScopesNestAndRestore)
+{
+    CHECK(GetCurrentMemoryTag() == MEMTAG_UNTAGGED);
+    {
+        MemoryTagScope audioScope(MEMTAG_AUDIO);
+        CHECK(GetCurrentMemoryTag() == MEMTAG_AUDIO);
+        {
+            MemoryTagScope uiScope(MEMTAG_UI);
+            CHECK(GetCurrentMemoryTag() == MEMTAG_UI);
+            {
+                MemoryTagScope sameTagScope(MEMTAG_UI);
+                CHECK(GetCurrentMemoryTag() == MEMTAG_UI);
+            }
+            CHECK(GetCurrentMemoryTag() == MEMTAG_UI);
+        }
+        CHECK(GetCurrentMemoryTag() == MEMTAG_AUDIO);
+    }
+    CHECK(GetCurrentMemoryTag() == MEMTAG_UNTAGGED);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(MemoryTagAllocationsGoToTheInnermostScope)
+{
+#if !defined(TRACK_MEMORY)
+    SKIP_TEST("Needs TRACK_MEMORY in BuildConfig.hpp");
+#endif
+    const size_t audioBytesBefore = GetMemoryTagStats(MEMTAG_AUDIO).numberOfBytes;
+    const size_t uiBytesBefore = GetMemoryTagStats(MEMTAG_UI).numberOfBytes;
+
+    char* audioAllocation = nullptr;
+    char* uiAllocation = nullptr;
+    {
+        MemoryTagScope audioScope(MEMTAG_AUDIO);
+        audioAllocation = new char[100];
+        {
+            MemoryTagScope uiScope(MEMTAG_UI);
+            uiAllocation = new char[300];
+        }
+    }
+    CHECK(GetMemoryTagStats(MEMTAG_AUDIO).numberOfBytes == audioBytesBefore + 100);
+    CHECK(GetMemoryTagStats(MEMTAG_UI).numberOfBytes == uiBytesBefore + 300);
+
+    //Frees go back to the tag the allocation was made under, not whatever's active now.
+    {
+        MemoryTagScope networkingScope(MEMTAG_NETWORKING);
+        delete[] uiAllocation;
+    }
+    delete[] audioAllocation;
+    CHECK(GetMemoryTagStats(MEMTAG_AUDIO).numberOfBytes == audioBytesBefore);
+    CHECK(GetMemoryTagStats(MEMTAG_UI).numberOfBytes == uiBytesBefore);
+}
+
+//-----------------------------------------------------------------------------------
+struct JobTagResult
+{
+    std::atomic<int> m_tagSeenByJob;
+    std::atomic<bool> m_isDone;
+};
+
+//-----------------------------------------------------------------------------------
+static void RecordJobMemoryTag(Job* job)
+{
+    JobTagResult* result = (JobTagResult*)job->data;
+    result->m_tagSeenByJob = (int)GetCurrentMemoryTag();
+    result->m_isDone = true;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(MemoryTagFollowsJobsToWhoeverRunsThem)
+{
+    JobSystem jobSystem(0);
+    JobSystem::instance = &jobSystem;
+
+    JobTagResult result;
+    result.m_tagSeenByJob = -1;
+    result.m_isDone = false;
+    {
+        MemoryTagScope particleScope(MEMTAG_PARTICLES);
+        jobSystem.CreateAndDispatchJob(GENERIC, &RecordJobMemoryTag, &result);
+    }
+
+    //Run it from here, outside of the scope it was created in. It should still see the creator's tag, and leave ours alone afterwards.
+    std::vector<JobType> types;
+    types.push_back(GENERIC);
+    JobConsumer consumer(types);
+    consumer.ConsumeAll();
+    CHECK(result.m_isDone);
+    CHECK(result.m_tagSeenByJob == MEMTAG_PARTICLES);
+    CHECK(GetCurrentMemoryTag() == MEMTAG_UNTAGGED);
+
+    //Same thing through a real worker thread.
+    result.m_tagSeenByJob = -1;
+    result.m_isDone = false;
+    jobSystem.Initialize();
+    {
+        MemoryTagScope audioScope(MEMTAG_AUDIO);
+        jobSystem.CreateAndDispatchJob(GENERIC, &RecordJobMemoryTag, &result);
+    }
+    jobSystem.Shutdown();
+    CHECK(result.m_isDone);
+    CHECK(result.m_tagSeenByJob == MEMTAG_AUDIO);
+
+    JobSystem::instance = nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(MemoryTagBudgetsReportOncePerCrossing)
+{
+#if !defined(TRACK_MEMORY)
+    SKIP_TEST("Needs TRACK_MEMORY in BuildConfig.hpp");
+#endif
+    const size_t bytesBefore = GetMemoryTagStats(MEMTAG_GAME).numberOfBytes;
+    SetMemoryTagBudget(MEMTAG_GAME, bytesBefore + 1000, bytesBefore + 2000);
+
+    MemoryTagScope gameScope(MEMTAG_GAME);
+    char* underBudget = new char[500];
+    CHECK(!GetMemoryTagStats(MEMTAG_GAME).isOverSoftBudget);
+
+    char* overSoftBudget = new char[1000];
+    CHECK(GetMemoryTagStats(MEMTAG_GAME).isOverSoftBudget);
+    CHECK(!GetMemoryTagStats(MEMTAG_GAME).isOverHardBudget);
+    CHECK(GetNumRecoverableWarnings() == 0);
+
+    char* overHardBudget = new char[1000];
+    CHECK(GetMemoryTagStats(MEMTAG_GAME).isOverHardBudget);
+    CHECK(GetNumRecoverableWarnings() == 1);
+
+    //Already over, so this one shouldn't warn again.
+    char* stillOverHardBudget = new char[10];
+    CHECK(GetNumRecoverableWarnings() == 1);
+
+    delete[] stillOverHardBudget;
+    delete[] overHardBudget;
+    delete[] overSoftBudget;
+    CHECK(!GetMemoryTagStats(MEMTAG_GAME).isOverSoftBudget);
+    CHECK(!GetMemoryTagStats(MEMTAG_GAME).isOverHardBudget);
+    delete[] underBudget;
+    SetMemoryTagBudget(MEMTAG_GAME, 0, 0);
+}
@@ -0,0 +1,198 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/Events/NamedProperties.hpp"
+#include <string>
+
+//-----------------------------------------------------------------------------------
+//Bigger than the inline storage, so it always lives on the heap.
+struct LargePropertyValue
+{
+    double m_values[4];
+};
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(NamedPropertiesReturnTheSameResultCodesAsBefore)
+{
+    NamedProperties properties;
+    int intValue = 0;
+    CHECK(properties.Get("Missing", intValue) == PGR_FAILED_NO_PROPERTIES);
+
+    CHECK(properties.Set("Health", 10) == PSR_SUCCESS);
+    CHECK(properties.Set("Health", 20) == PSR_SUCCESS_EXISTED);
+    CHECK(properties.Get("Health", intValue) == PGR_SUCCESS);
+    CHECK(intValue == 20);
+    CHECK(properties.Get("Missing", intValue) == PGR_FAILED_NO_SUCH_PROPERTY);
+
+    //Close isn't good enough, the type has to match exactly.
+    float floatValue = 0.0f;
+    unsigned int unsignedValue = 0;
+    CHECK(properties.Get("Health", floatValue) == PGR_FAILED_WRONG_TYPE);
+    CHECK(properties.Get("Health", unsignedValue) == PGR_FAILED_WRONG_TYPE);
+
+    //std::string and const char* names find the same property.
+    std::string name = "Health";
+    CHECK(properties.Get(name, intValue) == PGR_SUCCESS);
+    CHECK(properties.Get<int>(name) == 20);
+    //The convenience Get can't report a failure through its return value, so it warns instead.
+    CHECK(GetNumRecoverableWarnings() == 0);
+    properties.Get<int>("Missing");
+    CHECK(GetNumRecoverableWarnings() == 1);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(NamedPropertiesChangeTypeOnlyWhenAllowed)
+{
+    NamedProperties properties;
+    properties.Set("Value", 5);
+
+    //Changing type still reports that the property existed.
+    CHECK(properties.Set("Value", 2.5f) == PSR_SUCCESS_EXISTED);
+    float floatValue = 0.0f;
+    int intValue = 0;
+    CHECK(properties.Get("Value", floatValue) == PGR_SUCCESS);
+    CHECK(floatValue == 2.5f);
+    CHECK(properties.Get("Value", intValue) == PGR_FAILED_WRONG_TYPE);
+
+    //Not allowed for this call, or not allowed at all. Either way the old value survives and there's a warning.
+    CHECK(properties.Set("Value", 7, false) == PSR_FAILED_DIFF_TYPE);
+    CHECK(GetNumRecoverableWarnings() == 1);
+    properties.m_neverChangeTypeIfDifferent = true;
+    CHECK(properties.Set("Value", 7) == PSR_FAILED_DIFF_TYPE);
+    CHECK(GetNumRecoverableWarnings() == 2);
+    CHECK(properties.Get("Value", floatValue) == PGR_SUCCESS);
+    CHECK(floatValue == 2.5f);
+    CHECK(properties.Set("Value", 3.5f) == PSR_SUCCESS_EXISTED);
+
+    //Inline to heap and back again.
+    properties.m_neverChangeTypeIfDifferent = false;
+    LargePropertyValue largeValue = { { 1.0, 2.0, 3.0, 4.0 } };
+    CHECK(properties.Set("Value", largeValue) == PSR_SUCCESS_EXISTED);
+    LargePropertyValue largeResult = {};
+    CHECK(properties.Get("Value", largeResult) == PGR_SUCCESS);
+    CHECK(largeResult.m_values[3] == 4.0);
+    CHECK(properties.Set("Value", 'c') == PSR_SUCCESS_EXISTED);
+    char charValue = 0;
+    CHECK(properties.Get("Value", charValue) == PGR_SUCCESS);
+    CHECK(charValue == 'c');
+    CHECK(properties.GetNumProperties() == 1);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(NamedPropertiesStoreStringsAsStdString)
+{
+    //Literals have to go through <std::string> or the non-template overload, so nothing ever stores a dangling char pointer.
+    NamedProperties properties;
+    CHECK(properties.Set<std::string>("Name", "Widget") == PSR_SUCCESS);
+    CHECK(properties.Set("Description", std::string(200, 'd')) == PSR_SUCCESS);
+    std::string stringValue;
+    CHECK(properties.Get("Name", stringValue) == PGR_SUCCESS);
+    CHECK(stringValue == "Widget");
+    CHECK(properties.Get("Description", stringValue) == PGR_SUCCESS);
+    CHECK(stringValue == std::string(200, 'd'));
+    CHECK(properties.Get<std::string>("Name") == "Widget");
+
+    CHECK(properties.Set<std::string>("Name", "Button") == PSR_SUCCESS_EXISTED);
+    CHECK(properties.Get("Name", stringValue) == PGR_SUCCESS);
+    CHECK(stringValue == "Button");
+    const char* pointerValue = nullptr;
+    CHECK(properties.Get("Name", pointerValue) == PGR_FAILED_WRONG_TYPE);
+
+    //Copies are deep, so the original going away doesn't take the copy's strings with it.
+    NamedProperties* original = new NamedProperties();
+    original->Set<std::string>("Copied", "Still here");
+    NamedProperties copy = *original;
+    delete original;
+    CHECK(copy.Get("Copied", stringValue) == PGR_SUCCESS);
+    CHECK(stringValue == "Still here");
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(NamedPropertiesRemoveLeavesTheRestIntact)
+{
+    NamedProperties properties;
+    properties.Set("A", 1);
+    properties.Set<std::string>("B", "bee");
+    properties.Set("C", LargePropertyValue{ { 5.0, 6.0, 7.0, 8.0 } });
+    properties.Set("D", 4);
+
+    CHECK(!properties.Remove("Missing"));
+    CHECK(properties.Remove("B"));
+    CHECK(!properties.Remove("B"));
+    CHECK(properties.GetNumProperties() == 3);
+
+    //Whatever got moved into the hole still reads back fine.
+    int intValue = 0;
+    std::string stringValue;
+    LargePropertyValue largeValue = {};
+    CHECK(properties.Get("B", stringValue) == PGR_FAILED_NO_SUCH_PROPERTY);
+    CHECK(properties.Get("A", intValue) == PGR_SUCCESS && intValue == 1);
+    CHECK(properties.Get("D", intValue) == PGR_SUCCESS && intValue == 4);
+    CHECK(properties.Get("C", largeValue) == PGR_SUCCESS && largeValue.m_values[2] == 7.0);
+
+    CHECK(properties.Remove("A"));
+    CHECK(properties.Remove("C"));
+    CHECK(properties.Remove("D"));
+    CHECK(properties.Get("D", intValue) == PGR_FAILED_NO_PROPERTIES);
+    CHECK(properties.Set("D", 9) == PSR_SUCCESS);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(NamedPropertiesDontAllocateToUpdateAValue)
+{
+    NamedProperties properties;
+    properties.Set("Position", 1.0f);
+    properties.Set("Count", 1);
+    unsigned int numAllocationsBefore = GetNumAllocationsSoFar();
+    for (int i = 0; i < 100; ++i)
+    {
+        properties.Set("Position", (float)i);
+        properties.Set("Count", i);
+    }
+    CHECK(GetNumAllocationsSoFar() == numAllocationsBefore);
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(NamedPropertiesLookupAndInsert)
+{
+    //Sixteen entries is about as many as any event or widget carries.
+    const unsigned int NUM_PROPERTIES = 16;
+    const unsigned int NUM_ITERATIONS = 1000000;
+    std::string names[NUM_PROPERTIES];
+    for (unsigned int i = 0; i < NUM_PROPERTIES; ++i)
+    {
+        names[i] = Stringf("Property%u", i);
+    }
+
+    NamedProperties properties;
+    for (unsigned int i = 0; i < NUM_PROPERTIES; ++i)
+    {
+        properties.Set(names[i].c_str(), (int)i);
+    }
+    volatile int sum = 0;
+    {
+        BenchmarkTimer timer("Get, 16 properties", NUM_ITERATIONS);
+        for (unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            int value = 0;
+            properties.Get(names[i % NUM_PROPERTIES].c_str(), value);
+            sum = sum + value;
+        }
+    }
+    {
+        BenchmarkTimer timer("Set existing, 16 properties", NUM_ITERATIONS);
+        for (unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            properties.Set(names[i % NUM_PROPERTIES].c_str(), (int)i);
+        }
+    }
+    {
+        BenchmarkTimer timer("Insert into a fresh bag, per property", NUM_ITERATIONS);
+        for (unsigned int i = 0; i < NUM_ITERATIONS / NUM_PROPERTIES; ++i)
+        {
+            NamedProperties freshProperties;
+            for (unsigned int j = 0; j < NUM_PROPERTIES; ++j)
+            {
+                freshProperties.Set(names[j].c_str(), (int)j);
+            }
+        }
+    }
+}
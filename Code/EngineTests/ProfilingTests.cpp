@@ -0,0 +1,1258 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/ProfilingCounters.hpp"
+#include "Engine/Core/ProfilingUtils.h"
+#include "Engine/Core/StringUtils.hpp"
+#include <atomic>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Stands up a profiler for the length of a test, on the thread that runs the test.
+class ScopedProfilingSystem
+{
+public:
+    ScopedProfilingSystem() : m_previousInstance(ProfilingSystem::instance) { ProfilingSystem::instance = new ProfilingSystem(); };
+    ~ScopedProfilingSystem() { delete ProfilingSystem::instance; ProfilingSystem::instance = m_previousInstance; };
+
+private:
+    ProfilingSystem* m_previousInstance;
+};
+
+//-----------------------------------------------------------------------------------
+static unsigned int CountThreadContexts()
+{
+    unsigned int numContexts = 0;
+    for (ProfilingThreadContext* context = ProfilingSystem::instance->GetThreadContexts(); context != nullptr; context = context->m_nextContext)
+    {
+        ++numContexts;
+    }
+    return numContexts;
+}
+
+//-----------------------------------------------------------------------------------
+//Returns the number of samples in the tree, or -1 if any of the links are wrong.
+static int CountSampleTree(ProfileSample* sample, ProfileSample* expectedParent)
+{
+    if (sample->parent != expectedParent || sample->endCount < sample->startCount)
+    {
+        return -1;
+    }
+    int numSamples = 1;
+    ProfileSample* child = sample->children;
+    while (child)
+    {
+        if (child->next->prev != child)
+        {
+            return -1;
+        }
+        int numChildSamples = CountSampleTree(child, sample);
+        if (numChildSamples < 0)
+        {
+            return -1;
+        }
+        numSamples += numChildSamples;
+        child = child->next;
+        if (child == sample->children)
+        {
+            break;
+        }
+    }
+    return numSamples;
+}
+
+//-----------------------------------------------------------------------------------
+static void PushAndPopWorkerSamples(const std::atomic<bool>* keepRunning, const char* threadName)
+{
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    profiler->RegisterCurrentThread(threadName);
+    while (*keepRunning)
+    {
+        profiler->PushSample("worker");
+        for (int i = 0; i < 3; ++i)
+        {
+            profiler->PushSample("outer");
+            profiler->PushSample("inner");
+            profiler->PopSample("inner");
+            profiler->PopSample("outer");
+        }
+        profiler->PopSample("worker");
+        //Renaming while the main thread might be printing the name is allowed.
+        profiler->RegisterCurrentThread(threadName);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilerThreadsPushAndPopConcurrently)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    ScopedProfilingSystem profilingSystem;
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    profiler->MarkFrame();
+
+    std::atomic<bool> keepRunning(true);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 6; ++i)
+    {
+        workers.emplace_back(&PushAndPopWorkerSamples, &keepRunning, "Test Worker");
+    }
+
+    unsigned int numWorkerRoots = 0;
+    unsigned int numBrokenTrees = 0;
+    for (int frame = 0; frame < 500; ++frame)
+    {
+        profiler->PushSample("main");
+        profiler->PopSample("main");
+        profiler->MarkFrame();
+        for (ProfilingThreadContext* context = profiler->GetThreadContexts(); context != nullptr; context = context->m_nextContext)
+        {
+            CHECK(context->m_threadName.load() != nullptr);
+            for (ProfileSample* root = context->m_previousFrameSamples; root != nullptr && context != profiler->m_mainThreadContext; root = root->next)
+            {
+                //At most worker, 3 outers and 3 inners. Fewer if the worker's pool ran dry and it dropped some.
+                const int numSamples = CountSampleTree(root, nullptr);
+                if (numSamples < 1 || numSamples > 7)
+                {
+                    ++numBrokenTrees;
+                }
+                ++numWorkerRoots;
+            }
+        }
+        std::this_thread::yield();
+    }
+    keepRunning = false;
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    CHECK(numBrokenTrees == 0);
+    CHECK(numWorkerRoots > 0);
+    CHECK(CountThreadContexts() == 7);
+
+    //Exited threads hand their contexts back, after their last samples have had a frame to be seen.
+    profiler->MarkFrame();
+    profiler->MarkFrame();
+    CHECK(CountThreadContexts() == 1);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilerShortLivedThreadsDontLeakContexts)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    ScopedProfilingSystem profilingSystem;
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    profiler->MarkFrame();
+    for (int i = 0; i < 50; ++i)
+    {
+        std::thread shortLived([profiler]()
+        {
+            profiler->PushSample("short lived");
+            profiler->PopSample("short lived");
+        });
+        shortLived.join();
+        profiler->MarkFrame();
+    }
+    profiler->MarkFrame();
+    CHECK(CountThreadContexts() == 1);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilerThreadsOutliveTheProfiler)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    std::atomic<int> step(0);
+    std::thread worker;
+    {
+        ScopedProfilingSystem firstProfilingSystem;
+        ProfilingSystem::instance->MarkFrame();
+        worker = std::thread([&step]()
+        {
+            ProfilingSystem::instance->PushSample("first profiler");
+            ProfilingSystem::instance->PopSample("first profiler");
+            step = 1;
+            while (step != 2)
+            {
+                std::this_thread::yield();
+            }
+            //A different profiler now, so this thread needs a new context and has to let go of the orphaned one.
+            ProfilingSystem::instance->PushSample("second profiler");
+            ProfilingSystem::instance->PopSample("second profiler");
+            step = 3;
+        });
+        while (step != 1)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    ScopedProfilingSystem secondProfilingSystem;
+    ProfilingSystem::instance->MarkFrame();
+    step = 2;
+    worker.join();
+    CHECK(step == 3);
+    CHECK(CountThreadContexts() == 2);
+    ProfilingSystem::instance->MarkFrame();
+    ProfilingSystem::instance->MarkFrame();
+    CHECK(CountThreadContexts() == 1);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(TraceStringsKeepUTF8AndEscapeControlCharacters)
+{
+    char escaped[64];
+    EscapeTraceString("Caf\xC3\xA9 \xE2\x9C\x93", escaped, sizeof(escaped));
+    CHECK(strcmp(escaped, "Caf\xC3\xA9 \xE2\x9C\x93") == 0);
+
+    EscapeTraceString("a\"b\\c\nd\x01", escaped, sizeof(escaped));
+    CHECK(strcmp(escaped, "a\\\"b\\\\c\\u000ad\\u0001") == 0);
+
+    EscapeTraceString(nullptr, escaped, sizeof(escaped));
+    CHECK(escaped[0] == '\0');
+
+    //Too small for the whole check mark, so it's left off entirely rather than cut in half.
+    char small[7];
+    EscapeTraceString("abcd\xE2\x9C\x93", small, sizeof(small));
+    CHECK(strcmp(small, "abcd") == 0);
+
+    //Same for an escape that doesn't fit.
+    EscapeTraceString("ab\n", small, sizeof(small));
+    CHECK(strcmp(small, "ab") == 0);
+}
+
+//-----------------------------------------------------------------------------------
+static std::string ReadTraceFile(const char* filePath)
+{
+    std::string contents;
+    FILE* file = nullptr;
+    if (fopen_s(&file, filePath, "rb") != 0)
+    {
+        return contents;
+    }
+    int character = 0;
+    while ((character = fgetc(file)) != EOF)
+    {
+        contents += (char)character;
+    }
+    fclose(file);
+    return contents;
+}
+
+//-----------------------------------------------------------------------------------
+//Just enough of a JSON document to check a trace against: no duplicate key checks, numbers come back as doubles.
+struct TraceJsonValue
+{
+    enum Type
+    {
+        JSON_NULL,
+        JSON_BOOL,
+        JSON_NUMBER,
+        JSON_STRING,
+        JSON_ARRAY,
+        JSON_OBJECT
+    };
+
+    const TraceJsonValue* Find(const char* key, Type type) const
+    {
+        for (size_t i = 0; i < m_keys.size(); ++i)
+        {
+            if (m_keys[i] == key)
+            {
+                return m_values[i].m_type == type ? &m_values[i] : nullptr;
+            }
+        }
+        return nullptr;
+    };
+
+    Type m_type = JSON_NULL;
+    bool m_bool = false;
+    double m_number = 0.0;
+    std::string m_string;
+    std::vector<std::string> m_keys; //Only filled in for objects, lines up with m_values
+    std::vector<TraceJsonValue> m_values;
+};
+
+//-----------------------------------------------------------------------------------
+//Strict recursive descent over the whole file. Anything outside the JSON grammar, including trailing commas or junk after the closing brace, fails the parse.
+class TraceJsonParser
+{
+public:
+    TraceJsonParser(const std::string& text) : m_text(text), m_position(0) {};
+
+    bool ParseDocument(TraceJsonValue& outValue)
+    {
+        SkipWhitespace();
+        if (!ParseValue(outValue))
+        {
+            return false;
+        }
+        SkipWhitespace();
+        return m_position == m_text.size();
+    };
+
+private:
+    bool ParseValue(TraceJsonValue& outValue)
+    {
+        SkipWhitespace();
+        if (m_position >= m_text.size())
+        {
+            return false;
+        }
+        char next = m_text[m_position];
+        if (next == '{')
+        {
+            return ParseObject(outValue);
+        }
+        if (next == '[')
+        {
+            return ParseArray(outValue);
+        }
+        if (next == '"')
+        {
+            outValue.m_type = TraceJsonValue::JSON_STRING;
+            return ParseString(outValue.m_string);
+        }
+        if (ConsumeLiteral("true"))
+        {
+            outValue.m_type = TraceJsonValue::JSON_BOOL;
+            outValue.m_bool = true;
+            return true;
+        }
+        if (ConsumeLiteral("false"))
+        {
+            outValue.m_type = TraceJsonValue::JSON_BOOL;
+            return true;
+        }
+        if (ConsumeLiteral("null"))
+        {
+            outValue.m_type = TraceJsonValue::JSON_NULL;
+            return true;
+        }
+        return ParseNumber(outValue);
+    };
+
+    bool ParseObject(TraceJsonValue& outValue)
+    {
+        outValue.m_type = TraceJsonValue::JSON_OBJECT;
+        ++m_position;
+        SkipWhitespace();
+        if (Consume('}'))
+        {
+            return true;
+        }
+        do
+        {
+            SkipWhitespace();
+            std::string key;
+            if (m_position >= m_text.size() || m_text[m_position] != '"' || !ParseString(key))
+            {
+                return false;
+            }
+            SkipWhitespace();
+            if (!Consume(':'))
+            {
+                return false;
+            }
+            outValue.m_keys.push_back(key);
+            outValue.m_values.push_back(TraceJsonValue());
+            if (!ParseValue(outValue.m_values.back()))
+            {
+                return false;
+            }
+            SkipWhitespace();
+        } while (Consume(','));
+        return Consume('}');
+    };
+
+    bool ParseArray(TraceJsonValue& outValue)
+    {
+        outValue.m_type = TraceJsonValue::JSON_ARRAY;
+        ++m_position;
+        SkipWhitespace();
+        if (Consume(']'))
+        {
+            return true;
+        }
+        do
+        {
+            outValue.m_values.push_back(TraceJsonValue());
+            if (!ParseValue(outValue.m_values.back()))
+            {
+                return false;
+            }
+            SkipWhitespace();
+        } while (Consume(','));
+        return Consume(']');
+    };
+
+    bool ParseString(std::string& outString)
+    {
+        ++m_position;
+        while (m_position < m_text.size())
+        {
+            unsigned char character = (unsigned char)m_text[m_position++];
+            if (character == '"')
+            {
+                return true;
+            }
+            if (character < 0x20)
+            {
+                return false;
+            }
+            if (character != '\\')
+            {
+                outString += (char)character;
+                continue;
+            }
+            if (m_position >= m_text.size())
+            {
+                return false;
+            }
+            char escape = m_text[m_position++];
+            switch (escape)
+            {
+            case '"': outString += '"'; break;
+            case '\\': outString += '\\'; break;
+            case '/': outString += '/'; break;
+            case 'b': outString += '\b'; break;
+            case 'f': outString += '\f'; break;
+            case 'n': outString += '\n'; break;
+            case 'r': outString += '\r'; break;
+            case 't': outString += '\t'; break;
+            case 'u':
+            {
+                if (m_position + 4 > m_text.size())
+                {
+                    return false;
+                }
+                unsigned int codePoint = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    char digit = m_text[m_position++];
+                    codePoint <<= 4;
+                    if (digit >= '0' && digit <= '9') codePoint |= (unsigned int)(digit - '0');
+                    else if (digit >= 'a' && digit <= 'f') codePoint |= (unsigned int)(digit - 'a' + 10);
+                    else if (digit >= 'A' && digit <= 'F') codePoint |= (unsigned int)(digit - 'A' + 10);
+                    else return false;
+                }
+                //The writer only ever escapes control characters, so single byte code points are all we need to turn back into text.
+                if (codePoint >= 0x80)
+                {
+                    return false;
+                }
+                outString += (char)codePoint;
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return false;
+    };
+
+    bool ParseNumber(TraceJsonValue& outValue)
+    {
+        size_t start = m_position;
+        Consume('-');
+        //A leading zero can't have more digits after it.
+        if (!Consume('0') && !ConsumeDigits())
+        {
+            return false;
+        }
+        if (Consume('.') && !ConsumeDigits())
+        {
+            return false;
+        }
+        if (Consume('e') || Consume('E'))
+        {
+            if (!Consume('+'))
+            {
+                Consume('-');
+            }
+            if (!ConsumeDigits())
+            {
+                return false;
+            }
+        }
+        outValue.m_type = TraceJsonValue::JSON_NUMBER;
+        outValue.m_number = strtod(m_text.substr(start, m_position - start).c_str(), nullptr);
+        return true;
+    };
+
+    bool ConsumeDigits()
+    {
+        size_t start = m_position;
+        while (m_position < m_text.size() && m_text[m_position] >= '0' && m_text[m_position] <= '9')
+        {
+            ++m_position;
+        }
+        return m_position > start;
+    };
+
+    bool ConsumeLiteral(const char* literal)
+    {
+        size_t length = strlen(literal);
+        if (m_text.compare(m_position, length, literal) != 0)
+        {
+            return false;
+        }
+        m_position += length;
+        return true;
+    };
+
+    bool Consume(char character)
+    {
+        if (m_position < m_text.size() && m_text[m_position] == character)
+        {
+            ++m_position;
+            return true;
+        }
+        return false;
+    };
+
+    void SkipWhitespace()
+    {
+        while (m_position < m_text.size() && (m_text[m_position] == ' ' || m_text[m_position] == '\n' || m_text[m_position] == '\r' || m_text[m_position] == '\t'))
+        {
+            ++m_position;
+        }
+    };
+
+    const std::string& m_text;
+    size_t m_position;
+};
+
+//-----------------------------------------------------------------------------------
+//What the trace should say about each sample we build by hand. Parent is null for roots.
+struct ExpectedTraceSample
+{
+    const char* m_name;
+    const char* m_parentName;
+    bool m_isOnLateThread;
+    unsigned int m_numDrawCalls;
+    unsigned int m_numAllocs;
+    unsigned int m_sizeAllocs;
+    const char* m_allocationsByTag;
+};
+
+//-----------------------------------------------------------------------------------
+static const ExpectedTraceSample EXPECTED_TRACE_SAMPLES[] =
+{
+    { "update", "frame", false, 0, 1, 48, "game:48" },
+    { "physics", "update", false, 0, 2, 24, "particles:8 game:16" },
+    { "render", "frame", false, 3, 1, 32, "renderer:32" },
+    { "late work", nullptr, true, 1, 1, 4, "jobs:4" },
+};
+
+//-----------------------------------------------------------------------------------
+static const TraceJsonValue* FindTraceSampleEvent(const std::vector<const TraceJsonValue*>& sampleEvents, const char* name)
+{
+    for (const TraceJsonValue* sampleEvent : sampleEvents)
+    {
+        if (sampleEvent->Find("name", TraceJsonValue::JSON_STRING)->m_string == name)
+        {
+            return sampleEvent;
+        }
+    }
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+static bool IsTraceEventInside(const TraceJsonValue* inner, const TraceJsonValue* outer)
+{
+    //Both ends are rounded to the microsecond separately, so allow for that.
+    static const double ROUNDING_MICROSECONDS = 0.002;
+    double innerStart = inner->Find("ts", TraceJsonValue::JSON_NUMBER)->m_number;
+    double innerEnd = innerStart + inner->Find("dur", TraceJsonValue::JSON_NUMBER)->m_number;
+    double outerStart = outer->Find("ts", TraceJsonValue::JSON_NUMBER)->m_number;
+    double outerEnd = outerStart + outer->Find("dur", TraceJsonValue::JSON_NUMBER)->m_number;
+    return innerStart >= outerStart - ROUNDING_MICROSECONDS && innerEnd <= outerEnd + ROUNDING_MICROSECONDS;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(TraceCaptureWritesTheSampleTreeAsValidEvents)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    const char* filePath = "ProfilingTestTrace.json";
+    ScopedProfilingSystem profilingSystem;
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    profiler->MarkFrame();
+    REQUIRE(profiler->StartTraceCapture(filePath, 100));
+
+    //Counts are set by hand rather than by drawing and allocating, so real allocations can't creep into what we compare against.
+    profiler->PushSample("update");
+    profiler->GetActiveSample()->AddAllocation(48, MEMTAG_GAME);
+    profiler->PushSample("physics");
+    profiler->GetActiveSample()->AddAllocation(16, MEMTAG_GAME);
+    profiler->GetActiveSample()->AddAllocation(8, MEMTAG_PARTICLES);
+    profiler->PopSample("physics");
+    profiler->PopSample("update");
+    profiler->PushSample("render");
+    profiler->GetActiveSample()->numDrawCalls = 3;
+    profiler->GetActiveSample()->AddAllocation(32, MEMTAG_RENDERER);
+    profiler->PopSample("render");
+    profiler->MarkFrame();
+
+    std::thread lateStarter([profiler]()
+    {
+        profiler->RegisterCurrentThread("Late \xC3\x9Cmlaut\tWorker");
+        profiler->PushSample("late work");
+        profiler->GetActiveSample()->numDrawCalls = 1;
+        profiler->GetActiveSample()->AddAllocation(4, MEMTAG_JOBS);
+        profiler->PopSample("late work");
+    });
+    lateStarter.join();
+    profiler->MarkFrame();
+    profiler->StopTraceCapture();
+
+    std::string trace = ReadTraceFile(filePath);
+    remove(filePath);
+    TraceJsonValue document;
+    REQUIRE(TraceJsonParser(trace).ParseDocument(document));
+    REQUIRE(document.m_type == TraceJsonValue::JSON_OBJECT);
+    const TraceJsonValue* displayTimeUnit = document.Find("displayTimeUnit", TraceJsonValue::JSON_STRING);
+    CHECK(displayTimeUnit && displayTimeUnit->m_string == "ms");
+    const TraceJsonValue* traceEvents = document.Find("traceEvents", TraceJsonValue::JSON_ARRAY);
+    REQUIRE(traceEvents);
+
+    //Every event has to carry what its phase needs, or the viewer drops it.
+    double mainThreadId = -1.0;
+    double lateThreadId = -1.0;
+    unsigned int numFrames = 0;
+    bool allEventsWellFormed = true;
+    std::vector<const TraceJsonValue*> sampleEvents;
+    for (const TraceJsonValue& traceEvent : traceEvents->m_values)
+    {
+        const TraceJsonValue* phase = traceEvent.Find("ph", TraceJsonValue::JSON_STRING);
+        const TraceJsonValue* name = traceEvent.Find("name", TraceJsonValue::JSON_STRING);
+        const TraceJsonValue* tid = traceEvent.Find("tid", TraceJsonValue::JSON_NUMBER);
+        const TraceJsonValue* ts = traceEvent.Find("ts", TraceJsonValue::JSON_NUMBER);
+        const TraceJsonValue* args = traceEvent.Find("args", TraceJsonValue::JSON_OBJECT);
+        if (!phase || !name || !args || !traceEvent.Find("pid", TraceJsonValue::JSON_NUMBER))
+        {
+            allEventsWellFormed = false;
+        }
+        else if (phase->m_string == "X")
+        {
+            const TraceJsonValue* dur = traceEvent.Find("dur", TraceJsonValue::JSON_NUMBER);
+            allEventsWellFormed = allEventsWellFormed && tid && ts && dur && dur->m_number >= 0.0
+                && args->Find("draws", TraceJsonValue::JSON_NUMBER) && args->Find("allocs", TraceJsonValue::JSON_NUMBER)
+                && args->Find("allocBytes", TraceJsonValue::JSON_NUMBER) && args->Find("allocBytesByTag", TraceJsonValue::JSON_STRING);
+            if (name->m_string == "frame")
+            {
+                ++numFrames;
+            }
+            sampleEvents.push_back(&traceEvent);
+        }
+        else if (phase->m_string == "M")
+        {
+            const TraceJsonValue* threadName = args->Find("name", TraceJsonValue::JSON_STRING);
+            allEventsWellFormed = allEventsWellFormed && tid && threadName && name->m_string == "thread_name";
+            if (threadName && tid && threadName->m_string == Stringf("Main (%lu)", (unsigned long)tid->m_number))
+            {
+                mainThreadId = tid->m_number;
+            }
+            if (threadName && tid && threadName->m_string == Stringf("Late \xC3\x9Cmlaut\tWorker (%lu)", (unsigned long)tid->m_number))
+            {
+                lateThreadId = tid->m_number;
+            }
+        }
+        else if (phase->m_string == "C")
+        {
+            allEventsWellFormed = allEventsWellFormed && ts && args->Find("value", TraceJsonValue::JSON_NUMBER);
+        }
+        else
+        {
+            allEventsWellFormed = false;
+        }
+    }
+    CHECK(allEventsWellFormed);
+    CHECK(numFrames == 2);
+    REQUIRE(mainThreadId >= 0.0 && lateThreadId >= 0.0);
+
+    //Each hand built sample shows up once, on the right thread, inside its parent, with the counts we gave it.
+    for (const ExpectedTraceSample& expected : EXPECTED_TRACE_SAMPLES)
+    {
+        const TraceJsonValue* sampleEvent = FindTraceSampleEvent(sampleEvents, expected.m_name);
+        REQUIRE(sampleEvent);
+        const TraceJsonValue* args = sampleEvent->Find("args", TraceJsonValue::JSON_OBJECT);
+        CHECK(sampleEvent->Find("tid", TraceJsonValue::JSON_NUMBER)->m_number == (expected.m_isOnLateThread ? lateThreadId : mainThreadId));
+        CHECK(args->Find("draws", TraceJsonValue::JSON_NUMBER)->m_number == expected.m_numDrawCalls);
+        CHECK(args->Find("allocs", TraceJsonValue::JSON_NUMBER)->m_number == expected.m_numAllocs);
+        CHECK(args->Find("allocBytes", TraceJsonValue::JSON_NUMBER)->m_number == expected.m_sizeAllocs);
+        CHECK(args->Find("allocBytesByTag", TraceJsonValue::JSON_STRING)->m_string == expected.m_allocationsByTag);
+        if (expected.m_parentName)
+        {
+            const TraceJsonValue* parentEvent = FindTraceSampleEvent(sampleEvents, expected.m_parentName);
+            REQUIRE(parentEvent);
+            CHECK(IsTraceEventInside(sampleEvent, parentEvent));
+        }
+        unsigned int numWithThisName = 0;
+        for (const TraceJsonValue* otherEvent : sampleEvents)
+        {
+            numWithThisName += otherEvent->Find("name", TraceJsonValue::JSON_STRING)->m_string == expected.m_name ? 1 : 0;
+        }
+        CHECK(numWithThisName == 1);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//How reports were built before the hash table: strcmp against every node so far.
+static void BuildLinearSearchReport(ProfileSample* root, std::vector<ProfileReportNode>& report)
+{
+    ProfileSample* child = root->children;
+    while (child)
+    {
+        bool foundSameTag = false;
+        for (ProfileReportNode& node : report)
+        {
+            if (strcmp(node.m_id, child->id) == 0)
+            {
+                foundSameTag = true;
+                node.AddSample(child);
+                break;
+            }
+        }
+        if (!foundSameTag)
+        {
+            ProfileReportNode newNode;
+            newNode.m_id = child->id;
+            newNode.AddSample(child);
+            report.push_back(newNode);
+        }
+        BuildLinearSearchReport(child, report);
+        child = child->next;
+        if (child == root->children)
+        {
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Records one frame with numSamples samples spread over the given names, two deep so there's self time to work out.
+static void RecordReportFrame(ProfilingSystem* profiler, const std::vector<std::string>& names, unsigned int numSamples)
+{
+    for (unsigned int i = 0; i < numSamples; i += 2)
+    {
+        profiler->PushSample(names[i % names.size()].c_str());
+        profiler->PushSample(names[(i + 1) % names.size()].c_str());
+        profiler->PopSample();
+        profiler->PopSample();
+    }
+    profiler->MarkFrame();
+}
+
+//-----------------------------------------------------------------------------------
+static std::vector<std::string> MakeSampleNames(unsigned int numNames)
+{
+    std::vector<std::string> names;
+    for (unsigned int i = 0; i < numNames; ++i)
+    {
+        names.push_back(Stringf("System%u::Update", i));
+    }
+    return names;
+}
+
+//-----------------------------------------------------------------------------------
+//Pushes up to numSamplesLeft samples under whatever's active, with random names, nesting, draw calls and allocations.
+//Names come from either copy of the list, so the same name shows up at different addresses.
+static void RecordRandomSampleTree(ProfilingSystem* profiler, std::mt19937& generator, const std::vector<std::string>* nameCopies, unsigned int depth, unsigned int& numSamplesLeft)
+{
+    static const unsigned int MAX_DEPTH = 6;
+    unsigned int numChildren = depth == 0 ? numSamplesLeft : std::uniform_int_distribution<unsigned int>(0, depth < MAX_DEPTH ? 4 : 0)(generator);
+    for (unsigned int i = 0; i < numChildren && numSamplesLeft > 0; ++i)
+    {
+        --numSamplesLeft;
+        const std::vector<std::string>& names = nameCopies[generator() % 2];
+        const char* name = names[generator() % names.size()].c_str();
+        profiler->PushSample(name);
+        profiler->GetActiveSample()->numDrawCalls = generator() % 4;
+        if (generator() % 2 == 0)
+        {
+            profiler->GetActiveSample()->AddAllocation(generator() % 256, (MemoryTag)(generator() % NUM_MEMORY_TAGS));
+        }
+        RecordRandomSampleTree(profiler, generator, nameCopies, depth + 1, numSamplesLeft);
+        profiler->PopSample(name);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+static bool DoReportNodesMatch(const ProfileReportNode& node, const ProfileReportNode& expectedNode)
+{
+    return node.m_numSamples == expectedNode.m_numSamples
+        && node.m_totalTime == expectedNode.m_totalTime
+        && node.m_totalSelfTime == expectedNode.m_totalSelfTime
+        && node.m_minTime == expectedNode.m_minTime
+        && node.m_maxTime == expectedNode.m_maxTime
+        && node.m_numDrawCalls == expectedNode.m_numDrawCalls
+        && node.m_numAllocs == expectedNode.m_numAllocs
+        && node.m_sizeAllocs == expectedNode.m_sizeAllocs
+        && memcmp(node.m_sizeAllocsByTag, expectedNode.m_sizeAllocsByTag, sizeof(node.m_sizeAllocsByTag)) == 0;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilingReportMatchesLinearSearch)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    ScopedProfilingSystem profilingSystem;
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    profiler->MarkFrame();
+
+    //Fixed seeds, so a failure can be replayed.
+    const unsigned int SEEDS[] = { 1, 7, 42, 1234, 98765 };
+    std::vector<std::string> nameCopies[2] = { MakeSampleNames(300), MakeSampleNames(300) };
+    for (unsigned int seed : SEEDS)
+    {
+        std::mt19937 generator(seed);
+        unsigned int numSamplesLeft = 2000;
+        RecordRandomSampleTree(profiler, generator, nameCopies, 0, numSamplesLeft);
+        profiler->MarkFrame();
+
+        profiler->BuildProfilingReport();
+        std::vector<ProfileReportNode> expected;
+        BuildLinearSearchReport(profiler->GetLastFrame(), expected);
+        REQUIRE(g_profilingResults.size() == expected.size());
+        unsigned int numMatches = 0;
+        for (const ProfileReportNode& expectedNode : expected)
+        {
+            for (const ProfileReportNode& node : g_profilingResults)
+            {
+                if (strcmp(node.m_id, expectedNode.m_id) == 0)
+                {
+                    numMatches += DoReportNodesMatch(node, expectedNode) ? 1 : 0;
+                    break;
+                }
+            }
+        }
+        CHECK(numMatches == expected.size());
+    }
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(ProfilingReportHashTableVersusLinearSearch)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    ScopedProfilingSystem profilingSystem;
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    profiler->MarkFrame();
+
+    const unsigned int NUM_SAMPLES = 10000;
+    const unsigned int NUM_REPORTS = 50;
+    const unsigned int numNamesToTry[] = { 16, 256, 2000 };
+    for (unsigned int numNames : numNamesToTry)
+    {
+        std::vector<std::string> names = MakeSampleNames(numNames);
+        RecordReportFrame(profiler, names, NUM_SAMPLES);
+        std::string hashTableLabel = Stringf("Hash table report, %u unique names, per sample", numNames);
+        std::string linearSearchLabel = Stringf("Linear search report, %u unique names, per sample", numNames);
+        {
+            BenchmarkTimer timer(hashTableLabel.c_str(), NUM_SAMPLES * NUM_REPORTS);
+            for (unsigned int i = 0; i < NUM_REPORTS; ++i)
+            {
+                profiler->BuildProfilingReport();
+            }
+        }
+        {
+            BenchmarkTimer timer(linearSearchLabel.c_str(), NUM_SAMPLES * NUM_REPORTS);
+            std::vector<ProfileReportNode> report;
+            for (unsigned int i = 0; i < NUM_REPORTS; ++i)
+            {
+                report.clear();
+                BuildLinearSearchReport(profiler->GetLastFrame(), report);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilingPercentilesUseNearestRank)
+{
+    float values[100];
+    for (int i = 0; i < 100; ++i)
+    {
+        values[i] = (float)(100 - i);
+    }
+    ProfilePercentiles percentiles = ProfilingHistory::CalculatePercentiles(values, 100);
+    CHECK(percentiles.p50 == 50.0f);
+    CHECK(percentiles.p90 == 90.0f);
+    CHECK(percentiles.p99 == 99.0f);
+    CHECK(percentiles.maximum == 100.0f);
+    CHECK(percentiles.numSamples == 100);
+
+    //One slow frame in ten shows up at p99 but not p90.
+    float mostlyFast[10] = { 1.0f, 1.0f, 1.0f, 1.0f, 50.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    percentiles = ProfilingHistory::CalculatePercentiles(mostlyFast, 10);
+    CHECK(percentiles.p50 == 1.0f);
+    CHECK(percentiles.p90 == 1.0f);
+    CHECK(percentiles.p99 == 50.0f);
+
+    float single = 3.0f;
+    percentiles = ProfilingHistory::CalculatePercentiles(&single, 1);
+    CHECK(percentiles.p50 == 3.0f && percentiles.p99 == 3.0f && percentiles.maximum == 3.0f);
+
+    percentiles = ProfilingHistory::CalculatePercentiles(nullptr, 0);
+    CHECK(percentiles.numSamples == 0 && percentiles.maximum == 0.0f);
+}
+
+//-----------------------------------------------------------------------------------
+static uint64_t MillisecondsToPerformanceCount(double milliseconds)
+{
+    uint64_t oneMillionCounts = 1000000;
+    const double secondsPerCount = PerformanceCountToSeconds(oneMillionCounts) / 1000000.0;
+    return (uint64_t)((milliseconds / 1000.0) / secondsPerCount + 0.5);
+}
+
+//-----------------------------------------------------------------------------------
+//A frame with one child per id, each taking childMs.
+struct FakeFrame
+{
+    FakeFrame(double frameMs, const std::vector<std::string>& childIds, double childMs)
+        : m_children(childIds.size())
+    {
+        m_root.id = "frame";
+        m_root.endCount = MillisecondsToPerformanceCount(frameMs);
+        for (size_t i = 0; i < childIds.size(); ++i)
+        {
+            ProfileSample& child = m_children[i];
+            child.id = childIds[i].c_str();
+            child.endCount = MillisecondsToPerformanceCount(childMs);
+            child.parent = &m_root;
+            child.next = &m_children[(i + 1) % childIds.size()];
+            child.prev = &m_children[(i + childIds.size() - 1) % childIds.size()];
+        }
+        m_root.children = m_children.empty() ? nullptr : &m_children[0];
+    }
+
+    ProfileSample m_root;
+    std::vector<ProfileSample> m_children;
+};
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilingHistoryWrapsAndKeepsItsOwnNames)
+{
+    ProfilingHistory history(4);
+    history.m_hitchThresholdMs = 30.0f;
+    for (int frameNumber = 0; frameNumber < 6; ++frameNumber)
+    {
+        //Ids built fresh and thrown away every frame, the way sprite layer names are.
+        std::vector<std::string> childIds;
+        childIds.push_back("Layer: " + std::to_string(frameNumber % 2));
+        FakeFrame frame(frameNumber == 5 ? 40.0 : (double)(frameNumber + 1), childIds, 0.5);
+        history.RecordFrame(&frame.m_root, frameNumber);
+    }
+
+    //Only the last 4 frames are kept: 3, 4, 5 and the 40ms hitch.
+    ProfilePercentiles framePercentiles = history.GetFramePercentiles();
+    CHECK(history.GetNumFramesRecorded() == 4);
+    CHECK(framePercentiles.numSamples == 4);
+    CHECK(fabs(framePercentiles.p50 - 4.0f) < 0.01f);
+    CHECK(fabs(framePercentiles.maximum - 40.0f) < 0.01f);
+
+    ProfilePercentiles sectionPercentiles;
+    CHECK(history.GetSectionPercentiles("Layer: 0", sectionPercentiles));
+    CHECK(sectionPercentiles.numSamples == 3);
+    CHECK(history.GetSectionPercentiles("Layer: 1", sectionPercentiles));
+    CHECK(sectionPercentiles.numSamples == 3);
+    CHECK(!history.GetSectionPercentiles("Layer: 2", sectionPercentiles));
+
+    REQUIRE(history.GetNumHitches() == 1);
+    const HitchCapture& hitch = history.GetRecentHitch(0);
+    CHECK(hitch.m_frameNumber == 5);
+    REQUIRE(hitch.m_samples.size() == 2);
+    CHECK(strcmp(history.GetSectionName(hitch.m_samples[0].m_sectionIndex), "frame") == 0);
+    CHECK(strcmp(history.GetSectionName(hitch.m_samples[1].m_sectionIndex), "Layer: 1") == 0);
+    CHECK(hitch.m_samples[1].m_depth == 1);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilingHistoryEvictsTheLeastRecentlySeenSection)
+{
+    ProfilingHistory history(4);
+    history.m_hitchThresholdMs = 30.0f;
+    std::vector<std::string> hitchIds(1, "Hitched");
+    FakeFrame hitchFrame(40.0, hitchIds, 0.5);
+    history.RecordFrame(&hitchFrame.m_root, 0);
+
+    //A steady section alongside a flood of ids that each only run once.
+    const unsigned int NUM_FRAMES = 12;
+    const unsigned int NUM_RUNTIME_IDS = 200;
+    for (unsigned int frameNumber = 1; frameNumber <= NUM_FRAMES; ++frameNumber)
+    {
+        std::vector<std::string> childIds(1, "Steady");
+        for (unsigned int i = 0; i < NUM_RUNTIME_IDS; ++i)
+        {
+            childIds.push_back(Stringf("Runtime %u:%u", frameNumber, i));
+        }
+        FakeFrame frame(1.0, childIds, 0.001);
+        history.RecordFrame(&frame.m_root, (int)frameNumber);
+        CHECK(history.GetNumSections() <= ProfilingHistory::MAX_SECTIONS);
+    }
+
+    ProfilePercentiles sectionPercentiles;
+    CHECK(history.GetSectionPercentiles("Steady", sectionPercentiles));
+    CHECK(sectionPercentiles.numSamples == 4);
+    CHECK(!history.GetSectionPercentiles("Runtime 1:0", sectionPercentiles));
+    CHECK(history.GetSectionPercentiles(Stringf("Runtime %u:0", NUM_FRAMES).c_str(), sectionPercentiles));
+
+    //The hitch still points at its own name, even though nothing has seen that section since.
+    REQUIRE(history.GetNumHitches() == 1);
+    const HitchCapture& hitch = history.GetRecentHitch(0);
+    REQUIRE(hitch.m_samples.size() == 2);
+    CHECK(strcmp(history.GetSectionName(hitch.m_samples[1].m_sectionIndex), "Hitched") == 0);
+
+    //A single frame with more ids than the cap still gets all of them.
+    std::vector<std::string> manyIds;
+    for (unsigned int i = 0; i < ProfilingHistory::MAX_SECTIONS + 100; ++i)
+    {
+        manyIds.push_back(Stringf("Wide %u", i));
+    }
+    FakeFrame wideFrame(1.0, manyIds, 0.0001);
+    history.RecordFrame(&wideFrame.m_root, (int)NUM_FRAMES + 1);
+    CHECK(history.GetSectionPercentiles("Wide 0", sectionPercentiles));
+    CHECK(history.GetSectionPercentiles(manyIds.back().c_str(), sectionPercentiles));
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilingCountersResetPerFrameAndGaugesHold)
+{
+    //Whatever's been counted so far belongs to some earlier frame.
+    SampleProfilingCounters();
+    const int64_t gaugeBefore = GetProfilingCounterValue(COUNTER_PARTICLES_ALIVE);
+
+    const int NUM_THREADS = 4;
+    const int NUM_ADDS_PER_THREAD = 10000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        threads.emplace_back([NUM_ADDS_PER_THREAD]()
+        {
+            for (int addIndex = 0; addIndex < NUM_ADDS_PER_THREAD; ++addIndex)
+            {
+                AddToProfilingCounter(COUNTER_JOBS_EXECUTED, 1);
+                AddToProfilingCounter(COUNTER_PARTICLES_ALIVE, 2);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    AddToProfilingCounter(COUNTER_PARTICLES_ALIVE, -NUM_THREADS * NUM_ADDS_PER_THREAD);
+    SampleProfilingCounters();
+    CHECK(GetProfilingCounterValue(COUNTER_JOBS_EXECUTED) == NUM_THREADS * NUM_ADDS_PER_THREAD);
+    CHECK(GetProfilingCounterValue(COUNTER_PARTICLES_ALIVE) == gaugeBefore + NUM_THREADS * NUM_ADDS_PER_THREAD);
+
+    //Nothing happened this frame: the per frame counter drops back to 0, the gauge keeps its level.
+    SampleProfilingCounters();
+    CHECK(GetProfilingCounterValue(COUNTER_JOBS_EXECUTED) == 0);
+    CHECK(GetProfilingCounterValue(COUNTER_JOBS_EXECUTED, 1) == NUM_THREADS * NUM_ADDS_PER_THREAD);
+    CHECK(GetProfilingCounterValue(COUNTER_PARTICLES_ALIVE) == gaugeBefore + NUM_THREADS * NUM_ADDS_PER_THREAD);
+    CHECK(GetProfilingCounterValue(COUNTER_JOBS_EXECUTED, PROFILING_COUNTER_HISTORY_LENGTH) == 0);
+
+    AddToProfilingCounter(COUNTER_PARTICLES_ALIVE, -NUM_THREADS * NUM_ADDS_PER_THREAD);
+    SampleProfilingCounters();
+    CHECK(GetProfilingCounterValue(COUNTER_PARTICLES_ALIVE) == gaugeBefore);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ProfilingCountersAreSampledWithTheProfilerOff)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    ScopedProfilingSystem profilingSystem;
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    profiler->SetEnabled(false);
+    profiler->MarkFrame();
+    REQUIRE(profiler->IsDisabled());
+
+    PROFILE_COUNTER_ADD(COUNTER_BYTES_SENT, 1500);
+    profiler->MarkFrame();
+    CHECK(GetProfilingCounterValue(COUNTER_BYTES_SENT) == 1500);
+    profiler->MarkFrame();
+    CHECK(GetProfilingCounterValue(COUNTER_BYTES_SENT) == 0);
+}
+
+//-----------------------------------------------------------------------------------
+//Goes through the macro, so without PROFILING_ENABLED this times the empty loop it compiles down to.
+static void AddToCounterRepeatedly(ProfilingCounter counter, unsigned int numAdds)
+{
+    UNUSED(counter);
+    for (unsigned int i = 0; i < numAdds; ++i)
+    {
+        PROFILE_COUNTER_ADD(counter, 1);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//Every thread either piles onto the same counter or gets one to itself.
+static void AddToCountersFromThreads(unsigned int numThreads, unsigned int numAddsPerThread, bool shareOneCounter)
+{
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        ProfilingCounter counter = shareOneCounter ? COUNTER_JOBS_EXECUTED : (ProfilingCounter)(COUNTER_JOBS_EXECUTED + i);
+        threads.emplace_back(&AddToCounterRepeatedly, counter, numAddsPerThread);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(ProfilingCounterAddCost)
+{
+    const unsigned int NUM_ADDS = 10000000;
+    const unsigned int NUM_THREADS = 4;
+    static_assert(COUNTER_JOBS_EXECUTED + NUM_THREADS <= COUNTER_PARTICLES_ALIVE, "Each thread needs its own per frame counter.");
+    ScopedProfilingSystem profilingSystem;
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+
+    //Counters don't look at whether the profiler is on, so the two should match.
+    const bool PROFILER_STATES[] = { true, false };
+    for (bool isProfilerOn : PROFILER_STATES)
+    {
+        profiler->SetEnabled(isProfilerOn);
+        profiler->MarkFrame();
+        const char* profilerState = isProfilerOn ? "on" : "off";
+        {
+            std::string label = Stringf("Counter add, 1 thread, profiler %s", profilerState);
+            BenchmarkTimer timer(label.c_str(), NUM_ADDS);
+            AddToCounterRepeatedly(COUNTER_JOBS_EXECUTED, NUM_ADDS);
+        }
+        {
+            std::string label = Stringf("Counter add, %u threads on one counter, profiler %s", NUM_THREADS, profilerState);
+            BenchmarkTimer timer(label.c_str(), NUM_ADDS);
+            AddToCountersFromThreads(NUM_THREADS, NUM_ADDS / NUM_THREADS, true);
+        }
+        {
+            std::string label = Stringf("Counter add, %u threads on their own counters, profiler %s", NUM_THREADS, profilerState);
+            BenchmarkTimer timer(label.c_str(), NUM_ADDS);
+            AddToCountersFromThreads(NUM_THREADS, NUM_ADDS / NUM_THREADS, false);
+        }
+    }
+
+    //Samples the totals off, so they don't show up in whatever frame comes next.
+    profiler->MarkFrame();
+}
+
+//-----------------------------------------------------------------------------------
+static void CountFinishedJob(Job* job)
+{
+    ++*(std::atomic<int>*)job->data;
+}
+
+//-----------------------------------------------------------------------------------
+//Hands more work off from inside a job, without saying who it's for.
+static void DispatchNestedJob(Job* job)
+{
+    JobSystem::instance->CreateAndDispatchJob(GENERIC, &CountFinishedJob, job->data);
+    CountFinishedJob(job);
+}
+
+//-----------------------------------------------------------------------------------
+static const ProfileFlowAttribution* FindFlowAttribution(const char* sourceName)
+{
+    for (const ProfileFlowAttribution& attribution : g_profilingFlowAttribution)
+    {
+        if (strcmp(attribution.m_sourceName, sourceName) == 0)
+        {
+            return &attribution;
+        }
+    }
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(JobTimeIsCreditedToTheDispatchingSubsystem)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    ScopedProfilingSystem profilingSystem;
+    ProfilingSystem* profiler = ProfilingSystem::instance;
+    JobSystem* previousJobSystem = JobSystem::instance;
+    JobSystem::instance = new JobSystem(2);
+    JobSystem::instance->Initialize();
+    profiler->MarkFrame();
+
+    const int NUM_TAGGED_JOBS = 6;
+    const int NUM_UNTAGGED_JOBS = 4;
+    std::atomic<int> numFinishedJobs(0);
+    {
+        //The tag is built at runtime and gone before the jobs run, which is exactly what a stored pointer can't survive.
+        std::string* particlesTag = new std::string(Stringf("Particles %i", 2));
+        profiler->PushSample("Update");
+        profiler->PushSample("Emitter Helper");
+        for (int i = 0; i < NUM_TAGGED_JOBS; ++i)
+        {
+            JobSystem::instance->CreateAndDispatchJob(GENERIC, i == 0 ? &DispatchNestedJob : &CountFinishedJob, &numFinishedJobs, nullptr, particlesTag->c_str());
+        }
+        delete particlesTag;
+        profiler->PopSample("Emitter Helper");
+        profiler->PopSample("Update");
+    }
+    profiler->PushSample("AI");
+    profiler->PushSample("Pathfinding");
+    profiler->PushSample("Path Helper");
+    for (int i = 0; i < NUM_UNTAGGED_JOBS; ++i)
+    {
+        JobSystem::instance->CreateAndDispatchJob(GENERIC_SLOW, &CountFinishedJob, &numFinishedJobs);
+    }
+    profiler->PopSample("Path Helper");
+    profiler->PopSample("Pathfinding");
+    profiler->PopSample("AI");
+
+    //Shutting down joins the workers, so every job's sample has been committed by the time we mark the frame.
+    while (numFinishedJobs < NUM_TAGGED_JOBS + NUM_UNTAGGED_JOBS + 1)
+    {
+        std::this_thread::yield();
+    }
+    JobSystem::instance->Shutdown();
+    profiler->MarkFrame();
+    profiler->BuildFlowAttribution();
+
+    //The nested job goes to whoever dispatched the job it came from, and nothing's credited to the helpers that happened to make the call.
+    const ProfileFlowAttribution* particles = FindFlowAttribution("Particles 2");
+    const ProfileFlowAttribution* ai = FindFlowAttribution("AI");
+    REQUIRE(particles != nullptr);
+    REQUIRE(ai != nullptr);
+    CHECK(particles->m_numFlows == NUM_TAGGED_JOBS + 1);
+    CHECK(ai->m_numFlows == NUM_UNTAGGED_JOBS);
+    CHECK(g_profilingFlowAttribution.size() == 2);
+    CHECK(FindFlowAttribution("Emitter Helper") == nullptr);
+    CHECK(FindFlowAttribution("Path Helper") == nullptr);
+    CHECK(particles->m_maxTime <= particles->m_totalTime);
+    CHECK(particles->m_totalLatency >= 0.0);
+
+    //Sources stay put for the life of the program, however long the names are.
+    std::string longName(MAX_PROFILE_FLOW_SOURCE_NAME_LENGTH * 2, 'x');
+    unsigned int longNameIndex = FindOrAddProfileFlowSource(longName.c_str());
+    CHECK(longNameIndex != 0);
+    CHECK(FindOrAddProfileFlowSource(longName.c_str()) == longNameIndex);
+    CHECK(strlen(GetProfileFlowSourceName(longNameIndex)) == MAX_PROFILE_FLOW_SOURCE_NAME_LENGTH - 1);
+
+    delete JobSystem::instance;
+    JobSystem::instance = previousJobSystem;
+}
@@ -0,0 +1,202 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/ProfilingUtils.h"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Net/NetSystem.hpp"
+#include "Engine/Net/RemoteCommandService.hpp"
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern int g_frameNumber;
+
+//-----------------------------------------------------------------------------------
+//A host and one or more clients joined to it over loopback, torn down clients first so the host's port is free again right away.
+class LoopbackCommandServices
+{
+public:
+    LoopbackCommandServices(unsigned int numClients)
+    {
+        NetSystem::instance = &m_netSystem;
+        m_host.Host(NetSystem::GetLocalHostName());
+        for (unsigned int i = 0; i < numClients; ++i)
+        {
+            m_clients.push_back(new RemoteCommandService());
+            m_clients.back()->Join(NetSystem::GetLocalHostName());
+        }
+        PumpUntil([this, numClients]() { return m_host.m_connections.size() == numClients; });
+    };
+
+    ~LoopbackCommandServices()
+    {
+        for (RemoteCommandService* client : m_clients)
+        {
+            delete client;
+        }
+        m_clients.clear();
+        PumpUntil([this]() { return m_host.m_connections.empty(); });
+        m_host.StopHosting();
+        NetSystem::instance = nullptr;
+    };
+
+    //Updates everyone until the condition holds, or gives up after a few seconds.
+    bool PumpUntil(const std::function<bool()>& isDone)
+    {
+        std::chrono::steady_clock::time_point giveUpTime = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!isDone())
+        {
+            if (std::chrono::steady_clock::now() > giveUpTime)
+            {
+                return false;
+            }
+            Pump();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    };
+
+    void Pump()
+    {
+        m_host.Update();
+        for (RemoteCommandService* client : m_clients)
+        {
+            client->Update();
+        }
+    };
+
+    NetSystem m_netSystem;
+    RemoteCommandService m_host;
+    std::vector<RemoteCommandService*> m_clients;
+};
+
+//-----------------------------------------------------------------------------------
+struct ReceivedMessages
+{
+    void OnMessage(RemoteCommandServiceConnection*, const byte id, const char* message)
+    {
+        m_ids.push_back(id);
+        m_messages.push_back(message);
+    };
+
+    unsigned int CountWithId(byte id) const
+    {
+        unsigned int count = 0;
+        for (byte receivedId : m_ids)
+        {
+            count += receivedId == id ? 1 : 0;
+        }
+        return count;
+    };
+
+    std::vector<byte> m_ids;
+    std::vector<std::string> m_messages;
+};
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(RemoteCommandsArriveWholeWhenTheSocketIsFull)
+{
+    LoopbackCommandServices services(1);
+    REQUIRE(services.m_host.m_connections.size() == 1);
+    ReceivedMessages received;
+    services.m_host.m_onMessage.RegisterMethod(&received, &ReceivedMessages::OnMessage);
+
+    //Keep sending without the host reading until the socket buffers are full and the rest has to wait for later updates.
+    std::string bigMessage(1024 * 1024, ' ');
+    for (size_t i = 0; i < bigMessage.size(); ++i)
+    {
+        bigMessage[i] = (char)('a' + (i % 26));
+    }
+    RemoteCommandServiceConnection* clientConnection = services.m_clients[0]->m_connections[0];
+    unsigned int numBigMessages = 0;
+    while (clientConnection->m_pendingOutput.empty() && numBigMessages < 64)
+    {
+        clientConnection->Send(MSG_ECHO, bigMessage.c_str());
+        ++numBigMessages;
+    }
+    CHECK(!clientConnection->m_pendingOutput.empty());
+    CHECK(clientConnection->m_pendingOutput.size() < MAX_PENDING_OUTPUT_BYTES);
+    clientConnection->Send(MSG_ECHO, "after");
+
+    //Nothing that's waiting is allowed to be skipped past by something that can be dropped.
+    CHECK(!clientConnection->SendMessageIfPossible(MSG_ECHO, "droppable"));
+
+    CHECK(services.PumpUntil([&received, numBigMessages]() { return received.m_messages.size() >= numBigMessages + 1; }));
+    REQUIRE(received.m_messages.size() == numBigMessages + 1);
+    bool allBigMessagesMatch = true;
+    for (unsigned int i = 0; i < numBigMessages; ++i)
+    {
+        allBigMessagesMatch = allBigMessagesMatch && received.m_ids[i] == MSG_ECHO && received.m_messages[i] == bigMessage;
+    }
+    CHECK(allBigMessagesMatch);
+    CHECK(received.m_messages.back() == "after");
+    CHECK(clientConnection->m_pendingOutput.empty());
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(RemoteCommandServiceNoticesWhenTheOtherSideLeaves)
+{
+    LoopbackCommandServices services(2);
+    REQUIRE(services.m_host.m_connections.size() == 2);
+    delete services.m_clients[0];
+    services.m_clients.erase(services.m_clients.begin());
+    CHECK(services.PumpUntil([&services]() { return services.m_host.m_connections.size() == 1; }));
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(RemoteProfileStreamSendsEachFrameOnce)
+{
+#if !defined(PROFILING_ENABLED)
+    SKIP_TEST("Needs PROFILING_ENABLED in BuildConfig.hpp");
+#endif
+    ProfilingSystem* previousProfiler = ProfilingSystem::instance;
+    ProfilingSystem::instance = new ProfilingSystem();
+    ProfilingSystem::instance->MarkFrame();
+    ProfilingSystem::instance->MarkFrame();
+    {
+        LoopbackCommandServices services(2);
+        REQUIRE(services.m_host.m_connections.size() == 2);
+        ReceivedMessages received[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            services.m_clients[i]->m_onMessage.RegisterMethod(&received[i], &ReceivedMessages::OnMessage);
+            services.m_clients[i]->SendCommand(MSG_PROFILE_SUBSCRIBE, "1000");
+        }
+        services.PumpUntil([&services]()
+        {
+            return services.m_host.m_connections[0]->m_profileSummariesPerSecond > 0.0f && services.m_host.m_connections[1]->m_profileSummariesPerSecond > 0.0f;
+        });
+
+        //Plenty of updates, and plenty of time for the rate limit, but it's all still the same frame.
+        const int firstFrame = g_frameNumber;
+        for (int i = 0; i < 20; ++i)
+        {
+            services.Pump();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        services.PumpUntil([&received]() { return received[0].CountWithId(MSG_PROFILE_FRAME) >= 1 && received[1].CountWithId(MSG_PROFILE_FRAME) >= 1; });
+        CHECK(received[0].CountWithId(MSG_PROFILE_FRAME) == 1);
+        CHECK(received[1].CountWithId(MSG_PROFILE_FRAME) == 1);
+        REQUIRE(!received[0].m_messages.empty() && !received[1].m_messages.empty());
+        CHECK(received[0].m_messages.back() == received[1].m_messages.back());
+        CHECK(received[0].m_messages.back().find(Stringf("frame=%i;", firstFrame)) == 0);
+
+        //Stop one of them, then move on a frame.
+        services.m_clients[1]->SendCommand(MSG_PROFILE_SUBSCRIBE, "0");
+        services.PumpUntil([&services]() { return services.m_host.m_connections[1]->m_profileSummariesPerSecond == 0.0f; });
+        ++g_frameNumber;
+        ProfilingSystem::instance->MarkFrame();
+        services.PumpUntil([&received]() { return received[0].CountWithId(MSG_PROFILE_FRAME) >= 2; });
+        for (int i = 0; i < 10; ++i)
+        {
+            services.Pump();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        CHECK(received[0].CountWithId(MSG_PROFILE_FRAME) == 2);
+        CHECK(received[1].CountWithId(MSG_PROFILE_FRAME) == 1);
+        CHECK(received[0].m_messages.back().find(Stringf("frame=%i;", firstFrame + 1)) == 0);
+    }
+    delete ProfilingSystem::instance;
+    ProfilingSystem::instance = previousProfiler;
+}
@@ -0,0 +1,86 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/SamplingProfiler.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//extern "C" so that it symbolizes to the same plain name everywhere. Nothing in here calls out, so every hit is a self hit.
+extern "C" void SamplingTestsBusyLoop(std::atomic<bool>* isDone)
+{
+    volatile unsigned int counter = 0;
+    while (!isDone->load(std::memory_order_relaxed))
+    {
+        counter = counter * 1664525u + 1013904223u;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(SamplingFindsTheBusyThread)
+{
+    SamplingProfiler profiler;
+    std::atomic<bool> isDone(false);
+    std::thread busyThread([&isDone]()
+    {
+        SamplingProfiler::RegisterCurrentThread("Busy");
+        SamplingTestsBusyLoop(&isDone);
+    });
+
+    profiler.Start(1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    profiler.Stop();
+    isDone = true;
+    busyThread.join();
+
+    unsigned int selfHits = 0;
+    unsigned int inclusiveHits = profiler.GetFunctionHits("SamplingTestsBusyLoop", selfHits, "Busy");
+    unsigned int busySamples = profiler.GetNumSamples("Busy");
+    CHECK(profiler.GetNumSamples() > busySamples);
+    CHECK(selfHits <= inclusiveHits);
+    CHECK(inclusiveHits <= busySamples);
+
+    //The busy thread spends the whole time in the loop, so it should be caught there in the vast majority of its samples.
+    REQUIRE(busySamples > 0);
+    CHECK(selfHits * 2 > busySamples);
+
+    //None of the main thread's samples land in the busy loop.
+    unsigned int mainSelfHits = 0;
+    CHECK(profiler.GetFunctionHits("SamplingTestsBusyLoop", mainSelfHits, "Main") == 0);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(SamplingLetsGoOfThreadsThatExit)
+{
+    //Far more threads than there are slots, all started and finished while the sampler is hammering them.
+    SamplingProfiler profiler;
+    const unsigned int numThreadsBefore = SamplingProfiler::GetNumRegisteredThreads();
+    const unsigned int NUM_THREADS = 256;
+    const unsigned int NUM_THREADS_AT_ONCE = 8;
+    std::atomic<unsigned int> numRegistered(0);
+    profiler.Start(2000);
+    for (unsigned int batch = 0; batch < NUM_THREADS / NUM_THREADS_AT_ONCE; ++batch)
+    {
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < NUM_THREADS_AT_ONCE; ++i)
+        {
+            threads.emplace_back([&numRegistered, numThreadsBefore]()
+            {
+                SamplingProfiler::RegisterCurrentThread("Short Lived");
+                if (SamplingProfiler::GetNumRegisteredThreads() > numThreadsBefore)
+                {
+                    ++numRegistered;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    profiler.Stop();
+
+    CHECK(numRegistered == NUM_THREADS);
+    CHECK(SamplingProfiler::GetNumRegisteredThreads() == numThreadsBefore);
+}
@@ -0,0 +1,217 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/ScopeTimer.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+typedef std::vector<ScopeTreeNode, UntrackedAllocator<ScopeTreeNode>> ScopeTree;
+
+static const char* const FRAME_SCOPE_NAME = "ScopeTimerTests Frame";
+static const char* const UPDATE_SCOPE_NAME = "ScopeTimerTests Update";
+static const char* const RENDER_SCOPE_NAME = "ScopeTimerTests Render";
+static const char* const SLEEP_SCOPE_NAME = "ScopeTimerTests Sleep";
+static const char* const WRAP_SCOPE_NAME = "ScopeTimerTests Wrap";
+
+//-----------------------------------------------------------------------------------
+static void SleepInsideScope(int milliseconds)
+{
+    ScopeTimer sleepScope(SLEEP_SCOPE_NAME);
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+//-----------------------------------------------------------------------------------
+static int FindScopeNode(const ScopeTree& nodes, const char* name, int parentIndex)
+{
+    for (int i = 0; i < (int)nodes.size(); ++i)
+    {
+        if (nodes[i].m_name == name && nodes[i].m_parentIndex == parentIndex)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------------
+static double ScopeNodeMilliseconds(const ScopeTreeNode& node)
+{
+    return ScopeTimerTicksToNanoseconds(node.m_totalTicks) / 1000000.0;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ScopeTimerTreeMatchesKnownSleeps)
+{
+    const int NUM_FRAMES = 3;
+    const int SLEEP_MS = 2;
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        ScopeTimer frameScope(FRAME_SCOPE_NAME);
+        {
+            ScopeTimer updateScope(UPDATE_SCOPE_NAME);
+            SleepInsideScope(SLEEP_MS);
+            SleepInsideScope(SLEEP_MS);
+        }
+        {
+            ScopeTimer renderScope(RENDER_SCOPE_NAME);
+            SleepInsideScope(SLEEP_MS);
+        }
+    }
+
+    ScopeTree nodes;
+    BuildScopeTree(t_scopeTimerRing, nodes);
+    int frameIndex = FindScopeNode(nodes, FRAME_SCOPE_NAME, -1);
+    REQUIRE(frameIndex != -1);
+    int updateIndex = FindScopeNode(nodes, UPDATE_SCOPE_NAME, frameIndex);
+    int renderIndex = FindScopeNode(nodes, RENDER_SCOPE_NAME, frameIndex);
+    REQUIRE(updateIndex != -1);
+    REQUIRE(renderIndex != -1);
+    int updateSleepIndex = FindScopeNode(nodes, SLEEP_SCOPE_NAME, updateIndex);
+    int renderSleepIndex = FindScopeNode(nodes, SLEEP_SCOPE_NAME, renderIndex);
+    REQUIRE(updateSleepIndex != -1);
+    REQUIRE(renderSleepIndex != -1);
+
+    //Same name under different parents stays separate, and repeat calls merge.
+    CHECK(nodes[frameIndex].m_numCalls == NUM_FRAMES);
+    CHECK(nodes[updateSleepIndex].m_numCalls == 2 * NUM_FRAMES);
+    CHECK(nodes[renderSleepIndex].m_numCalls == NUM_FRAMES);
+    CHECK(nodes[updateSleepIndex].m_depth == 2);
+
+    //A sleep never comes back early, and anything wildly over means the tick conversion is off.
+    const double updateSleepMs = ScopeNodeMilliseconds(nodes[updateSleepIndex]);
+    const double renderSleepMs = ScopeNodeMilliseconds(nodes[renderSleepIndex]);
+    CHECK(updateSleepMs >= 2 * NUM_FRAMES * SLEEP_MS);
+    CHECK(updateSleepMs < 2 * NUM_FRAMES * SLEEP_MS * 10);
+    CHECK(renderSleepMs >= NUM_FRAMES * SLEEP_MS);
+    CHECK(ScopeNodeMilliseconds(nodes[updateIndex]) >= updateSleepMs);
+    CHECK(ScopeNodeMilliseconds(nodes[frameIndex]) >= ScopeNodeMilliseconds(nodes[updateIndex]) + ScopeNodeMilliseconds(nodes[renderIndex]));
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ScopeTimerReadersSkipScopesBeingOverwritten)
+{
+    //The writer wraps the ring many times over while we read, so anything torn would show up as a bad name or backwards times.
+    std::atomic<bool> isDone(false);
+    std::atomic<ScopeTimerRing*> writerRing(nullptr);
+    std::thread writer([&isDone, &writerRing]()
+    {
+        {
+            ScopeTimer firstScope(WRAP_SCOPE_NAME);
+        }
+        writerRing = t_scopeTimerRing;
+        while (!isDone)
+        {
+            ScopeTimer outerScope(WRAP_SCOPE_NAME);
+            ScopeTimer innerScope(WRAP_SCOPE_NAME);
+        }
+    });
+    while (writerRing == nullptr)
+    {
+        std::this_thread::yield();
+    }
+
+    ScopeTree nodes;
+    unsigned int numReads = 0;
+    bool allNodesValid = true;
+    while (numReads < 200 || writerRing.load()->m_numWritten - writerRing.load()->m_ownerFirstIndex < 4 * ScopeTimerRing::NUM_SCOPES)
+    {
+        BuildScopeTree(writerRing, nodes);
+        for (const ScopeTreeNode& node : nodes)
+        {
+            allNodesValid = allNodesValid && node.m_name == WRAP_SCOPE_NAME && node.m_numCalls > 0 && node.m_maxTicks <= node.m_totalTicks;
+        }
+        ++numReads;
+    }
+    isDone = true;
+    writer.join();
+    CHECK(allNodesValid);
+
+    //Once the owner's quiet, everything but the slot its next write would land on is readable again.
+    unsigned int numCalls = 0;
+    BuildScopeTree(writerRing, nodes);
+    for (const ScopeTreeNode& node : nodes)
+    {
+        numCalls += node.m_numCalls;
+    }
+    CHECK(numCalls == ScopeTimerRing::NUM_SCOPES - 1);
+}
+
+//-----------------------------------------------------------------------------------
+static unsigned int CountScopeTimerRings()
+{
+    unsigned int numRings = 0;
+    for (ScopeTimerRing* ring = GetScopeTimerRings(); ring != nullptr; ring = ring->m_nextRing)
+    {
+        ++numRings;
+    }
+    return numRings;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(ScopeTimerRingsAreReusedByLaterThreads)
+{
+    //One at a time, so each thread should pick up the ring the last one gave back.
+    const unsigned int NUM_THREADS = 20;
+    const unsigned int numRingsBefore = CountScopeTimerRings();
+    bool onlyOwnScopesSeen = true;
+    bool ringsGivenBack = true;
+    for (unsigned int i = 0; i < NUM_THREADS; ++i)
+    {
+        const char* scopeName = (i % 2 == 0) ? UPDATE_SCOPE_NAME : RENDER_SCOPE_NAME;
+        ScopeTimerRing* threadRing = nullptr;
+        std::thread shortLived([&threadRing, scopeName]()
+        {
+            ScopeTimer scope(scopeName);
+            threadRing = t_scopeTimerRing;
+        });
+        shortLived.join();
+        ringsGivenBack = ringsGivenBack && !threadRing->m_isOwned;
+
+        //Whatever the ring's last owner timed doesn't carry over to the next one.
+        ScopeTree nodes;
+        BuildScopeTree(threadRing, nodes);
+        onlyOwnScopesSeen = onlyOwnScopesSeen && nodes.size() == 1 && nodes[0].m_name == scopeName && nodes[0].m_numCalls == 1;
+    }
+    CHECK(ringsGivenBack);
+    CHECK(onlyOwnScopesSeen);
+    CHECK(CountScopeTimerRings() <= numRingsBefore + 1);
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(ScopeTimerOverhead)
+{
+    const unsigned int NUM_SCOPES = 10000000;
+    {
+        BenchmarkTimer timer("ReadScopeTimerTicks", NUM_SCOPES);
+        volatile uint64_t ticks = 0;
+        for (unsigned int i = 0; i < NUM_SCOPES; ++i)
+        {
+            ticks = ReadScopeTimerTicks();
+        }
+    }
+    {
+        BenchmarkTimer timer("ScopeTimer, flat", NUM_SCOPES);
+        for (unsigned int i = 0; i < NUM_SCOPES; ++i)
+        {
+            ScopeTimer scope(WRAP_SCOPE_NAME);
+        }
+    }
+    {
+        BenchmarkTimer timer("ScopeTimer, nested pair", NUM_SCOPES / 2);
+        for (unsigned int i = 0; i < NUM_SCOPES / 2; ++i)
+        {
+            ScopeTimer outerScope(WRAP_SCOPE_NAME);
+            ScopeTimer innerScope(WRAP_SCOPE_NAME);
+        }
+    }
+
+    ScopeTree nodes;
+    const unsigned int NUM_BUILDS = 100;
+    {
+        BenchmarkTimer timer("BuildScopeTree, full ring", NUM_BUILDS);
+        for (unsigned int i = 0; i < NUM_BUILDS; ++i)
+        {
+            BuildScopeTree(t_scopeTimerRing, nodes);
+        }
+    }
+}
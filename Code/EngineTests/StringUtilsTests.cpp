@@ -0,0 +1,275 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/StackString.hpp"
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Math/Dice.hpp"
+#include "Engine/Renderer/RGBA.hpp"
+#include <string>
+#include <vector>
+
+//2 byte e with an acute, 3 byte CJK character, 4 byte emoji.
+static const char* const MIXED_UTF8_TEXT = "caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80!";
+
+//-----------------------------------------------------------------------------------
+//True if the text is whole UTF-8 characters, with nothing cut off at the end.
+static bool IsWholeUtf8(const char* text, size_t length)
+{
+    size_t index = 0;
+    while (index < length)
+    {
+        unsigned char character = (unsigned char)text[index];
+        size_t characterLength = (character & 0x80) == 0 ? 1 : (character & 0xE0) == 0xC0 ? 2 : (character & 0xF0) == 0xE0 ? 3 : (character & 0xF8) == 0xF0 ? 4 : 0;
+        if (characterLength == 0 || index + characterLength > length)
+        {
+            return false;
+        }
+        for (size_t continuationIndex = index + 1; continuationIndex < index + characterLength; ++continuationIndex)
+        {
+            if (((unsigned char)text[continuationIndex] & 0xC0) != 0x80)
+            {
+                return false;
+            }
+        }
+        index += characterLength;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+static bool MatchesSplitString(const std::string& input, const std::string& delimiter)
+{
+    std::vector<std::string>* expected = SplitString(input, delimiter);
+    std::vector<std::string> tokens;
+    for (const StringView& token : StringTokenizer(input, delimiter))
+    {
+        tokens.push_back(token.ToString());
+    }
+    bool matches = tokens == *expected;
+    delete expected;
+    return matches;
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(FormatToTruncatesAndAlwaysTerminates)
+{
+    char buffer[8];
+    CHECK(FormatTo(buffer, "%d", 1234567) == 7);
+    CHECK(strcmp(buffer, "1234567") == 0);
+
+    CHECK(FormatTo(buffer, "%d", 12345678) == 7);
+    CHECK(strcmp(buffer, "1234567") == 0);
+    CHECK(FormatTo(buffer, sizeof(buffer), "%s and %s", "left", "right") == 7);
+    CHECK(strcmp(buffer, "left an") == 0);
+
+    //Nothing fits in one byte except the terminator, and nothing at all gets written into zero.
+    buffer[0] = 'x';
+    CHECK(FormatTo(buffer, 1, "%s", "anything") == 0);
+    CHECK(buffer[0] == '\0');
+    buffer[0] = 'x';
+    CHECK(FormatTo(buffer, 0, "%s", "anything") == 0);
+    CHECK(buffer[0] == 'x');
+
+    StackString<8> fits;
+    StackString<8> cut;
+    fits.Format("%s", "1234567");
+    cut.Format("%s", "12345678");
+    CHECK(!fits.IsTruncated());
+    CHECK(cut.IsTruncated());
+    CHECK(cut == "1234567");
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(FormatToNeverSplitsAUtf8Character)
+{
+    //Cut the text at every possible length. Each result has to be whole characters, and as much of the text as that allows.
+    const size_t textLength = strlen(MIXED_UTF8_TEXT);
+    bool allWhole = true;
+    bool allLongestPossible = true;
+    for (size_t bufferSize = 1; bufferSize <= textLength + 1; ++bufferSize)
+    {
+        char buffer[64];
+        size_t length = FormatTo(buffer, bufferSize, "%s", MIXED_UTF8_TEXT);
+        allWhole = allWhole && length == strlen(buffer) && IsWholeUtf8(buffer, length) && memcmp(buffer, MIXED_UTF8_TEXT, length) == 0;
+        allLongestPossible = allLongestPossible && (length == bufferSize - 1 || !IsWholeUtf8(MIXED_UTF8_TEXT, length + 1));
+    }
+    CHECK(allWhole);
+    CHECK(allLongestPossible);
+
+    //Same rule for StackString, whichever way the text gets in.
+    StackString<6> appended;
+    appended.Append("caf").Append("\xC3\xA9\xC3\xA9");
+    CHECK(appended == "caf\xC3\xA9");
+    CHECK(appended.IsTruncated());
+    StackString<8> appendFormatted("caf");
+    appendFormatted.AppendFormat("%s", "\xE6\x97\xA5\xE6\x9C\xAC");
+    CHECK(appendFormatted == "caf\xE6\x97\xA5");
+    CHECK(appendFormatted.IsTruncated());
+    appendFormatted.Clear();
+    CHECK(appendFormatted.IsEmpty() && !appendFormatted.IsTruncated());
+
+    //GetUtf8SafeLength on its own, with and without the text past the cut.
+    CHECK(GetUtf8SafeLength("\xF0\x9F\x98\x80", 4, 4) == 4);
+    CHECK(GetUtf8SafeLength("\xF0\x9F\x98\x80", 4, 3) == 0);
+    CHECK(GetUtf8SafeLength("a\xF0\x9F\x98", 4, 4) == 1);
+    CHECK(GetUtf8SafeLength("ab", 2, 10) == 2);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(StringTokenizerMatchesSplitString)
+{
+    CHECK(MatchesSplitString("a,b,c", ","));
+    CHECK(MatchesSplitString("a,,b,", ","));
+    CHECK(MatchesSplitString(",", ","));
+    CHECK(MatchesSplitString("", ","));
+    CHECK(MatchesSplitString("no delimiters here", ","));
+    CHECK(MatchesSplitString("one::two:::three::", "::"));
+    CHECK(MatchesSplitString("caf\xC3\xA9,\xE6\x97\xA5,\xF0\x9F\x98\x80", ","));
+
+    //Any of the characters splits, like SplitStringOnMultipleDelimiters.
+    StringTokenizer dicePieces("3d6-2", "d+-", true);
+    StringView piece;
+    std::vector<std::string> pieces;
+    while (dicePieces.Next(piece))
+    {
+        pieces.push_back(piece.ToString());
+    }
+    CHECK(pieces == std::vector<std::string>({ "3", "6", "2" }));
+
+    //A null string is just empty.
+    StringView nullView((const char*)nullptr);
+    CHECK(nullView.IsEmpty());
+    CHECK(nullView == "");
+    CHECK(MatchesSplitString(std::string(), ","));
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(StringViewParsesOnlyWholeNumbers)
+{
+    int intValue = 7;
+    CHECK(StringView("42").ParseInt(intValue) && intValue == 42);
+    CHECK(StringView(" -13 ").ParseInt(intValue) && intValue == -13);
+    CHECK(StringView("2147483647").ParseInt(intValue) && intValue == 2147483647);
+
+    //Every failure leaves the value where it was.
+    intValue = 7;
+    CHECK(!StringView("").ParseInt(intValue));
+    CHECK(!StringView("  ").ParseInt(intValue));
+    CHECK(!StringView("12abc").ParseInt(intValue));
+    CHECK(!StringView("abc").ParseInt(intValue));
+    CHECK(!StringView("1.5").ParseInt(intValue));
+    CHECK(!StringView("2147483648").ParseInt(intValue));
+    CHECK(!StringView(std::string(100, '1')).ParseInt(intValue));
+    CHECK(intValue == 7);
+
+    //The view stops where it says it does, even if the characters carry on.
+    CHECK(StringView("123456", 3).ParseInt(intValue) && intValue == 123);
+
+    float floatValue = 7.0f;
+    CHECK(StringView("2.5").ParseFloat(floatValue) && floatValue == 2.5f);
+    CHECK(StringView("-1e3 ").ParseFloat(floatValue) && floatValue == -1000.0f);
+    floatValue = 7.0f;
+    CHECK(!StringView("").ParseFloat(floatValue));
+    CHECK(!StringView("1.5x").ParseFloat(floatValue));
+    CHECK(!StringView("1e60").ParseFloat(floatValue));
+    CHECK(floatValue == 7.0f);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(MalformedVectorsColorsAndDiceWarn)
+{
+    Vector2 vector = Vector2::CreateFromString("1.5, -2");
+    CHECK(vector.x == 1.5f && vector.y == -2.0f);
+    RGBA color = RGBA::CreateFromString("255,0,51");
+    CHECK(color.red == 255 && color.green == 0 && color.blue == 51);
+    //One sided dice always roll the same, and the bonus goes on every die.
+    CHECK(Dice("3d1-2").Roll() == -3);
+    CHECK(Dice("2d1+4").Roll() == 10);
+    CHECK(GetNumRecoverableWarnings() == 0);
+
+    //These used to come out as zeros without a word.
+    CHECK(Vector2::CreateFromString("1.5") == Vector2::ZERO);
+    CHECK(Vector2::CreateFromString("x,y") == Vector2::ZERO);
+    CHECK(GetNumRecoverableWarnings() == 2);
+    CHECK(RGBA::CreateFromString("255,zero,51") == RGBA::WHITE);
+    CHECK(RGBA::CreateFromString("255,0") == RGBA::WHITE);
+    CHECK(GetNumRecoverableWarnings() == 4);
+    CHECK(Dice("3d").Roll() == 0);
+    CHECK(Dice("3d1+x").Roll() == 0);
+    CHECK(GetNumRecoverableWarnings() == 6);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(StringFormattingAndTokenizingDontAllocate)
+{
+    char buffer[64];
+    StackString<64> stackString;
+    unsigned int numAllocationsBefore = GetNumAllocationsSoFar();
+    for (int i = 0; i < 100; ++i)
+    {
+        FormatTo(buffer, "Entity %i at (%f, %f)", i, i * 0.5f, i * -0.5f);
+        stackString.Format("Entity %i", i).AppendFormat(" at (%f, %f)", i * 0.5f, i * -0.5f).Append(" in the overworld");
+        CStringf("Entity %i at (%f, %f)", i, i * 0.5f, i * -0.5f);
+        for (const StringView& token : StringTokenizer("position,rotation,scale,color,texture", ","))
+        {
+            (void)token;
+        }
+    }
+    CHECK(GetNumAllocationsSoFar() == numAllocationsBefore);
+
+    //CStringf hands back a ring of buffers, so recent results are still intact.
+    const char* first = CStringf("first %i", 1);
+    const char* second = CStringf("second %i", 2);
+    CHECK(strcmp(first, "first 1") == 0);
+    CHECK(strcmp(second, "second 2") == 0);
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(StringFormattingAndSplittingAllocations)
+{
+    //The allocs/iter column is the point here, the timings are a bonus.
+    const unsigned int NUM_ITERATIONS = 100000;
+    const std::string fields = "position,rotation,scale,color,texture,shader,material,mesh,collider,script";
+    volatile size_t totalLength = 0;
+    {
+        BenchmarkTimer timer("Stringf", NUM_ITERATIONS);
+        for (unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            totalLength = totalLength + Stringf("Entity %u moved to (%f, %f) in the overworld", i, i * 0.25f, i * -0.5f).size();
+        }
+    }
+    {
+        BenchmarkTimer timer("FormatTo, stack buffer", NUM_ITERATIONS);
+        for (unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            char buffer[128];
+            totalLength = totalLength + FormatTo(buffer, "Entity %u moved to (%f, %f) in the overworld", i, i * 0.25f, i * -0.5f);
+        }
+    }
+    {
+        BenchmarkTimer timer("StackString<128>::Format", NUM_ITERATIONS);
+        for (unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            StackString<128> stackString;
+            totalLength = totalLength + stackString.Format("Entity %u moved to (%f, %f) in the overworld", i, i * 0.25f, i * -0.5f).GetLength();
+        }
+    }
+    {
+        BenchmarkTimer timer("SplitString, 10 fields", NUM_ITERATIONS);
+        for (unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            std::vector<std::string>* pieces = SplitString(fields, ",");
+            totalLength = totalLength + pieces->size();
+            delete pieces;
+        }
+    }
+    {
+        BenchmarkTimer timer("StringTokenizer, 10 fields", NUM_ITERATIONS);
+        for (unsigned int i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            for (const StringView& token : StringTokenizer(fields, ","))
+            {
+                totalLength = totalLength + token.m_length;
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/Memory/MemoryTracking.hpp"
+#include "Engine/Time/Time.hpp"
+#include <vector>
+#include <atomic>
+#include <string>
+#include <cstring>
+#include <cstdio>
+
+//Allocated on first use, so tests can register from static constructors in any order.
+static std::vector<RegisteredTest>* g_registeredTests = nullptr;
+static unsigned int g_numFailedChecks = 0;
+static bool g_wasTestSkipped = false;
+static std::atomic<unsigned int> g_numRecoverableWarnings(0);
+
+//-----------------------------------------------------------------------------------
+RegisterTestHelper::RegisterTestHelper(const char* name, TestFunction* function, bool isBenchmark)
+{
+    if (!g_registeredTests)
+    {
+        g_registeredTests = new std::vector<RegisteredTest>();
+    }
+    RegisteredTest test;
+    test.m_name = name;
+    test.m_function = function;
+    test.m_isBenchmark = isBenchmark;
+    g_registeredTests->push_back(test);
+}
+
+//-----------------------------------------------------------------------------------
+BenchmarkTimer::BenchmarkTimer(const char* label, unsigned int numIterations)
+    : m_label(label)
+    , m_numIterations(numIterations)
+    , m_startNumAllocations(GetNumAllocationsSoFar())
+    , m_startSeconds(GetCurrentTimeSeconds())
+{
+}
+
+//-----------------------------------------------------------------------------------
+BenchmarkTimer::~BenchmarkTimer()
+{
+    double elapsedSeconds = GetCurrentTimeSeconds() - m_startSeconds;
+    unsigned int numAllocations = GetNumAllocationsSoFar() - m_startNumAllocations;
+    printf("    %-48s%12.1f ns/iter%12.3f allocs/iter  (%u iterations)\n", m_label, (elapsedSeconds * 1000000000.0) / m_numIterations, (double)numAllocations / m_numIterations, m_numIterations);
+}
+
+//-----------------------------------------------------------------------------------
+bool ReportCheck(bool passed, const char* conditionText, const char* filePath, int lineNum)
+{
+    if (!passed)
+    {
+        ++g_numFailedChecks;
+        printf("    %s(%d): CHECK(%s) failed\n", filePath, lineNum, conditionText);
+    }
+    return passed;
+}
+
+//-----------------------------------------------------------------------------------
+void ReportSkippedTest(const char* reason)
+{
+    g_wasTestSkipped = true;
+    printf("    skipped: %s\n", reason);
+}
+
+//-----------------------------------------------------------------------------------
+static void CountRecoverableWarning(const std::string& warningMessage)
+{
+    ++g_numRecoverableWarnings;
+    printf("    warning: %s\n", warningMessage.c_str());
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int GetNumRecoverableWarnings()
+{
+    return g_numRecoverableWarnings.load();
+}
+
+//-----------------------------------------------------------------------------------
+unsigned int GetNumAllocationsSoFar()
+{
+#if defined(TRACK_MEMORY)
+    return g_memoryAnalytics.m_lifetimeNumberOfAllocations;
+#else
+    return 0;
+#endif
+}
+
+//-----------------------------------------------------------------------------------
+int RunRegisteredTests(bool runBenchmarks, const char* nameFilter)
+{
+    if (!g_registeredTests)
+    {
+        printf("No tests registered.\n");
+        return 0;
+    }
+    SetRecoverableWarningHandler(&CountRecoverableWarning);
+
+    unsigned int numRun = 0;
+    unsigned int numFailed = 0;
+    unsigned int numSkipped = 0;
+    for (const RegisteredTest& test : *g_registeredTests)
+    {
+        if (test.m_isBenchmark != runBenchmarks || (nameFilter && !strstr(test.m_name, nameFilter)))
+        {
+            continue;
+        }
+        printf("%s %s\n", test.m_isBenchmark ? "[BENCH]" : "[ RUN ]", test.m_name);
+        g_numFailedChecks = 0;
+        g_wasTestSkipped = false;
+        g_numRecoverableWarnings = 0;
+        test.m_function();
+
+        ++numRun;
+        if (g_numFailedChecks > 0)
+        {
+            ++numFailed;
+            printf("[FAIL ] %s (%u failed checks)\n", test.m_name, g_numFailedChecks);
+        }
+        else if (g_wasTestSkipped)
+        {
+            ++numSkipped;
+        }
+    }
+
+    SetRecoverableWarningHandler(nullptr);
+    printf("\n%u run, %u failed, %u skipped.\n", numRun, numFailed, numSkipped);
+    return (int)numFailed;
+}
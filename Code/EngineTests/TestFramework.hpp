@@ -0,0 +1,57 @@
+#pragma once
+
+//-----------------------------------------------------------------------------------
+//Tests and benchmarks register themselves the same way console commands do, so adding one is just writing a TEST_CASE or BENCHMARK in any file in the project.
+//Tests run by default. Benchmarks only run when asked for with -bench, since their numbers only mean something in an optimized build.
+typedef void(TestFunction)();
+
+//-----------------------------------------------------------------------------------
+struct RegisteredTest
+{
+    const char* m_name;
+    TestFunction* m_function;
+    bool m_isBenchmark;
+};
+
+//-----------------------------------------------------------------------------------
+class RegisterTestHelper
+{
+public:
+    RegisterTestHelper(const char* name, TestFunction* function, bool isBenchmark);
+};
+
+//-----------------------------------------------------------------------------------
+//Times a loop, then reports the average time per iteration and how many tracked allocations it made.
+class BenchmarkTimer
+{
+public:
+    BenchmarkTimer(const char* label, unsigned int numIterations);
+    ~BenchmarkTimer();
+
+private:
+    const char* m_label;
+    unsigned int m_numIterations;
+    unsigned int m_startNumAllocations;
+    double m_startSeconds;
+};
+
+#define TEST_CASE(name) static void TestCase_##name(); \
+    static RegisterTestHelper TestRegistration_##name(#name, &TestCase_##name, false); \
+    static void TestCase_##name()
+
+#define BENCHMARK(name) static void Benchmark_##name(); \
+    static RegisterTestHelper BenchmarkRegistration_##name(#name, &Benchmark_##name, true); \
+    static void Benchmark_##name()
+
+#define CHECK(condition) ReportCheck(!!(condition), #condition, __FILE__, __LINE__)
+#define REQUIRE(condition) if (!CHECK(condition)) { return; }
+#define SKIP_TEST(reason) { ReportSkippedTest(reason); return; }
+
+//FUNCTIONS/////////////////////////////////////////////////////////////////////
+bool ReportCheck(bool passed, const char* conditionText, const char* filePath, int lineNum);
+void ReportSkippedTest(const char* reason);
+int RunRegisteredTests(bool runBenchmarks, const char* nameFilter);
+//Recoverable warnings go to the test runner instead of a dialogue. Counts since the current test started.
+unsigned int GetNumRecoverableWarnings();
+//Tracked allocations made on any thread since startup. Always 0 if TRACK_MEMORY is off.
+unsigned int GetNumAllocationsSoFar();
@@ -0,0 +1,296 @@
+#include "EngineTests/TestFramework.hpp"
+#include "Engine/Core/TimerWheel.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+//Nothing moves unless the test says so. The wheels run at one second a tick, so every delay used here is exact as a float.
+static double s_fakeTimerSeconds = 0.0;
+static double ReadFakeTimerClock()
+{
+    return s_fakeTimerSeconds;
+}
+
+//-----------------------------------------------------------------------------------
+struct TimerFiring
+{
+    int m_id;
+    uint64_t m_tick;
+};
+
+//-----------------------------------------------------------------------------------
+struct TimerRecorder
+{
+    TimerRecorder() : m_wheel(&ReadFakeTimerClock, 1.0) {};
+
+    TimerHandle Schedule(int id, float delaySeconds, float repeatSeconds = 0.0f)
+    {
+        TimerRecorder* recorder = this;
+        return m_wheel.Schedule([recorder, id]() { recorder->m_firings.push_back(TimerFiring{ id, recorder->m_wheel.GetCurrentTick() }); }, delaySeconds, repeatSeconds);
+    };
+
+    bool HasFiredInOrder(const std::vector<int>& expectedIds) const
+    {
+        if (m_firings.size() != expectedIds.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < expectedIds.size(); ++i)
+        {
+            if (m_firings[i].m_id != expectedIds[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    TimerWheel m_wheel;
+    std::vector<TimerFiring> m_firings;
+};
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(TimerWheelFiresSoonestFirstAndTiesInScheduleOrder)
+{
+    s_fakeTimerSeconds = 0.0;
+    TimerRecorder recorder;
+    recorder.Schedule(0, 5.0f);
+    recorder.Schedule(1, 2.0f);
+    recorder.Schedule(2, 5.0f);
+    recorder.Schedule(3, 1.0f);
+    //Far enough out to start a level up, then cascade down into the same tick as 5, which is scheduled straight into level 0 later on.
+    recorder.Schedule(4, 300.0f);
+
+    CHECK(recorder.m_wheel.AdvanceToTick(1) == 1);
+    CHECK(recorder.m_wheel.AdvanceToTick(4) == 1);
+    CHECK(recorder.m_wheel.AdvanceToTick(5) == 2);
+    CHECK(recorder.HasFiredInOrder({ 3, 1, 0, 2 }));
+
+    recorder.m_wheel.AdvanceToTick(200);
+    recorder.Schedule(5, 100.0f);
+    recorder.Schedule(6, 99.0f);
+    CHECK(recorder.m_wheel.AdvanceToTick(299) == 1);
+    CHECK(recorder.m_wheel.AdvanceToTick(300) == 2);
+    CHECK(recorder.HasFiredInOrder({ 3, 1, 0, 2, 6, 4, 5 }));
+    CHECK(recorder.m_firings.back().m_tick == 300);
+    CHECK(recorder.m_wheel.GetNumScheduledTimers() == 0);
+
+    //Delays count from the clock, not from the last tick the wheel processed.
+    s_fakeTimerSeconds = 1000.0;
+    recorder.Schedule(7, 3.0f);
+    CHECK(recorder.m_wheel.Update() == 0);
+    s_fakeTimerSeconds = 1003.0;
+    CHECK(recorder.m_wheel.Update() == 1);
+    CHECK(recorder.m_firings.back().m_tick == 1003);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(TimerWheelCancelsFromAnywhere)
+{
+    s_fakeTimerSeconds = 0.0;
+    TimerRecorder recorder;
+    TimerRecorder* recorderPointer = &recorder;
+    TimerHandle cancelledEarly = recorder.Schedule(0, 10.0f);
+    TimerHandle cancelledByCallback = recorder.Schedule(1, 20.0f);
+    TimerHandle cancelledOnItsTick;
+    //A callback on an earlier tick, and one ahead of it on the same tick, both take timers out before they fire.
+    recorder.m_wheel.Schedule([recorderPointer, &cancelledByCallback]() { recorderPointer->m_wheel.Cancel(cancelledByCallback); }, 15.0f);
+    recorder.m_wheel.Schedule([recorderPointer, &cancelledOnItsTick]() { recorderPointer->m_wheel.Cancel(cancelledOnItsTick); }, 20.0f);
+    cancelledOnItsTick = recorder.Schedule(2, 20.0f);
+    TimerHandle survivor = recorder.Schedule(3, 20.0f);
+
+    CHECK(recorder.m_wheel.IsScheduled(cancelledEarly));
+    CHECK(recorder.m_wheel.Cancel(cancelledEarly));
+    CHECK(!cancelledEarly.IsSet());
+    CHECK(!recorder.m_wheel.Cancel(cancelledEarly));
+    CHECK(recorder.m_wheel.GetNumScheduledTimers() == 5);
+
+    //Once it's fired its node goes back in the pool, so the handle has to go stale rather than cancel whoever gets the node next.
+    recorder.m_wheel.AdvanceToTick(25);
+    CHECK(recorder.HasFiredInOrder({ 3 }));
+    CHECK(!recorder.m_wheel.IsScheduled(survivor));
+    TimerHandle newcomer = recorder.Schedule(4, 5.0f);
+    CHECK(!recorder.m_wheel.Cancel(survivor));
+    CHECK(recorder.m_wheel.IsScheduled(newcomer));
+
+    //Repeating timers can cancel themselves from their own callback.
+    TimerHandle repeater;
+    unsigned int numRepeats = 0;
+    repeater = recorder.m_wheel.Schedule([recorderPointer, &repeater, &numRepeats]()
+    {
+        if (++numRepeats == 3)
+        {
+            CHECK(recorderPointer->m_wheel.Cancel(repeater));
+        }
+    }, 1.0f, 1.0f);
+    recorder.m_wheel.AdvanceToTick(26);
+    recorder.m_wheel.AdvanceToTick(27);
+    CHECK(recorder.m_wheel.IsScheduled(repeater));
+    recorder.m_wheel.AdvanceToTick(28);
+    recorder.m_wheel.AdvanceToTick(40);
+    CHECK(numRepeats == 3);
+    CHECK(!recorder.m_wheel.IsScheduled(repeater));
+    CHECK(recorder.HasFiredInOrder({ 3, 4 }));
+
+    recorder.Schedule(5, 1.0f);
+    recorder.Schedule(6, 100000.0f);
+    recorder.m_wheel.CancelAll();
+    CHECK(recorder.m_wheel.GetNumScheduledTimers() == 0);
+    CHECK(recorder.m_wheel.AdvanceToTick(200000) == 0);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(TimerWheelRepeatsOnItsCadence)
+{
+    s_fakeTimerSeconds = 0.0;
+    TimerRecorder recorder;
+    TimerHandle repeater = recorder.Schedule(0, 3.0f, 10.0f);
+    recorder.m_wheel.AdvanceToTick(3);
+    recorder.m_wheel.AdvanceToTick(13);
+    recorder.m_wheel.AdvanceToTick(22);
+    recorder.m_wheel.AdvanceToTick(23);
+    REQUIRE(recorder.m_firings.size() == 3);
+    CHECK(recorder.m_firings[1].m_tick == 13);
+    CHECK(recorder.m_firings[2].m_tick == 23);
+
+    //Falling way behind fires once, then picks the cadence back up instead of catching up on every missed one.
+    CHECK(recorder.m_wheel.AdvanceToTick(1000) == 1);
+    CHECK(recorder.m_wheel.AdvanceToTick(1002) == 0);
+    CHECK(recorder.m_wheel.AdvanceToTick(1003) == 1);
+    CHECK(recorder.m_wheel.Cancel(repeater));
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(TimerWheelCascadesLongDelaysToTheRightTick)
+{
+    //Every level boundary, and past the top level where timers have to park and cascade again. Started off a boundary so the slots don't line up.
+    s_fakeTimerSeconds = 1001.0;
+    TimerRecorder recorder;
+    const uint64_t startTick = recorder.m_wheel.GetCurrentTick();
+    const uint64_t delays[] = { 1, 255, 256, 257, 65535, 65536, 65537, (1 << 24) - 1, 1 << 24, 1ULL << 32, (1ULL << 32) + 512, 1ULL << 33, 3ULL << 32 };
+    const int numDelays = sizeof(delays) / sizeof(delays[0]);
+    for (int i = numDelays - 1; i >= 0; --i)
+    {
+        recorder.Schedule(i, (float)delays[i]);
+    }
+
+    //Stop one short of each, then land on it.
+    bool allOnTime = true;
+    for (int i = 0; i < numDelays; ++i)
+    {
+        bool isEarly = recorder.m_wheel.AdvanceToTick(startTick + delays[i] - 1) != 0;
+        bool isLate = recorder.m_wheel.AdvanceToTick(startTick + delays[i]) != 1;
+        allOnTime = allOnTime && !isEarly && !isLate && recorder.m_firings.back().m_id == i && recorder.m_firings.back().m_tick == startTick + delays[i];
+    }
+    CHECK(allOnTime);
+    CHECK(recorder.m_wheel.GetNumScheduledTimers() == 0);
+
+    //One big jump gets them all too, still in order.
+    s_fakeTimerSeconds = (double)recorder.m_wheel.GetCurrentTick();
+    const uint64_t restartTick = recorder.m_wheel.GetCurrentTick();
+    recorder.m_firings.clear();
+    for (int i = numDelays - 1; i >= 0; --i)
+    {
+        recorder.Schedule(i, (float)delays[i]);
+    }
+    CHECK(recorder.m_wheel.AdvanceToTick(restartTick + (3ULL << 32)) == (unsigned int)numDelays);
+    bool allInOrder = recorder.m_firings.size() == (size_t)numDelays;
+    for (int i = 0; allInOrder && i < numDelays; ++i)
+    {
+        allInOrder = recorder.m_firings[i].m_id == i && recorder.m_firings[i].m_tick == restartTick + delays[i];
+    }
+    CHECK(allInOrder);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(TimerWheelFlushRunsEverythingIncludingWhatItSchedules)
+{
+    s_fakeTimerSeconds = 0.0;
+    TimerRecorder recorder;
+    TimerRecorder* recorderPointer = &recorder;
+    recorder.Schedule(0, 50.0f);
+    recorder.Schedule(1, 70000.0f, 5.0f);
+    recorder.m_wheel.Schedule([recorderPointer]()
+    {
+        recorderPointer->m_firings.push_back(TimerFiring{ 2, 0 });
+        recorderPointer->Schedule(3, 1000.0f);
+    }, 10.0f);
+
+    //Repeaters only go once, and whatever the callbacks schedule comes after everything that was already waiting.
+    CHECK(recorder.m_wheel.FlushAll() == 4);
+    CHECK(recorder.HasFiredInOrder({ 2, 0, 1, 3 }));
+    CHECK(recorder.m_wheel.GetNumScheduledTimers() == 0);
+
+    //Timers can't drive the wheel they're firing from.
+    recorder.m_wheel.Schedule([recorderPointer]()
+    {
+        recorderPointer->m_wheel.FlushAll();
+        recorderPointer->m_wheel.AdvanceToTick(100);
+    }, 1.0f);
+    recorder.m_wheel.AdvanceToTick(1);
+    CHECK(GetNumRecoverableWarnings() == 2);
+}
+
+//-----------------------------------------------------------------------------------
+TEST_CASE(TimerWheelReusesItsNodes)
+{
+    s_fakeTimerSeconds = 0.0;
+    TimerRecorder recorder;
+    recorder.m_firings.reserve(1000);
+    recorder.Schedule(-1, 1.0f);
+    recorder.m_wheel.AdvanceToTick(1);
+
+    unsigned int numAllocationsBefore = GetNumAllocationsSoFar();
+    for (int i = 0; i < 500; ++i)
+    {
+        TimerHandle handle = recorder.Schedule(i, (float)(i % 300 + 1));
+        if (i % 2)
+        {
+            recorder.m_wheel.Cancel(handle);
+        }
+    }
+    recorder.m_wheel.AdvanceToTick(400);
+    CHECK(GetNumAllocationsSoFar() == numAllocationsBefore);
+    CHECK(recorder.m_firings.size() == 251);
+}
+
+//-----------------------------------------------------------------------------------
+static void CountTimerFiring(void* data)
+{
+    ++*static_cast<unsigned int*>(data);
+}
+
+//-----------------------------------------------------------------------------------
+BENCHMARK(TimerWheelScheduleAndDispatch)
+{
+    const unsigned int NUM_TIMERS = 10000;
+    const unsigned int NUM_FRAMES = 10000;
+    s_fakeTimerSeconds = 0.0;
+    TimerWheel wheel(&ReadFakeTimerClock, TimerWheel::DEFAULT_SECONDS_PER_TICK);
+    unsigned int numFired = 0;
+    std::vector<TimerHandle> handles(NUM_TIMERS);
+    {
+        BenchmarkTimer timer("Schedule, 10k pending", NUM_TIMERS);
+        for (unsigned int i = 0; i < NUM_TIMERS; ++i)
+        {
+            handles[i] = wheel.Schedule(&CountTimerFiring, &numFired, 1.0f + (float)(i % 600));
+        }
+    }
+    {
+        //A 60Hz frame's worth of ticks each, with almost all of the timers still far off.
+        BenchmarkTimer timer("Update per frame, 10k pending", NUM_FRAMES);
+        for (unsigned int frame = 1; frame <= NUM_FRAMES; ++frame)
+        {
+            s_fakeTimerSeconds = frame / 60.0;
+            wheel.Update();
+        }
+    }
+    {
+        BenchmarkTimer timer("Cancel, 10k pending", NUM_TIMERS);
+        for (TimerHandle& handle : handles)
+        {
+            wheel.Cancel(handle);
+        }
+    }
+}
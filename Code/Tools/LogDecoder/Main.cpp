@@ -0,0 +1,30 @@
+#include "Engine/Input/BinaryLogging.hpp"
+#include <stdio.h>
+#include <string>
+
+//Globals the engine expects the game to provide.
+bool g_isQuitting = false;
+const char* APP_NAME = "LogDecoder";
+int g_frameNumber = 0;
+
+//-----------------------------------------------------------------------------------
+//LogDecoder.exe <binary log file> [text output file]
+//Turns a file written with logbinarystart into plain text, without the game running. Returns 0 on success, 1 if the file can't be decoded.
+int main(int argc, char** argv)
+{
+    if (argc != 2 && argc != 3)
+    {
+        printf("Usage: LogDecoder <binary log file> [text output file]\n");
+        return 1;
+    }
+    const char* binaryLogPath = argv[1];
+    std::string textLogPath = argc == 3 ? argv[2] : std::string(binaryLogPath) + ".txt";
+
+    if (!DecodeBinaryLogFile(binaryLogPath, textLogPath.c_str()))
+    {
+        printf("Couldn't decode '%s', it's missing, truncated, or not a binary log.\n", binaryLogPath);
+        return 1;
+    }
+    printf("Decoded '%s' into '%s'.\n", binaryLogPath, textLogPath.c_str());
+    return 0;
+}
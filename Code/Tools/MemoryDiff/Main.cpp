@@ -0,0 +1,45 @@
+#include "Engine/Core/Memory/MemorySnapshot.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+//Globals the engine expects the game to provide.
+bool g_isQuitting = false;
+const char* APP_NAME = "MemoryDiff";
+int g_frameNumber = 0;
+
+//-----------------------------------------------------------------------------------
+//MemoryDiff.exe <before snapshot file> <after snapshot file> [number of sites to show]
+//Prints which callsites grew between two files saved with memorysnapshotsave. Returns 0 on success, 1 if either file can't be read.
+int main(int argc, char** argv)
+{
+    if (argc != 3 && argc != 4)
+    {
+        printf("Usage: MemoryDiff <before snapshot file> <after snapshot file> [number of sites to show]\n");
+        return 1;
+    }
+    const char* beforePath = argv[1];
+    const char* afterPath = argv[2];
+    unsigned int maxSitesToShow = argc == 4 ? (unsigned int)atoi(argv[3]) : 20;
+
+    MemorySnapshot before;
+    MemorySnapshot after;
+    if (!before.LoadFromFile(beforePath))
+    {
+        printf("Couldn't read a memory snapshot from '%s'.\n", beforePath);
+        return 1;
+    }
+    if (!after.LoadFromFile(afterPath))
+    {
+        printf("Couldn't read a memory snapshot from '%s'.\n", afterPath);
+        return 1;
+    }
+
+    std::vector<MemorySnapshotDiffEntry> growth = MemorySnapshot::Diff(before, after);
+    long long totalByteDelta = (long long)after.m_numberOfBytes - (long long)before.m_numberOfBytes;
+    printf("'%s' -> '%s': %lld bytes net, %u sites grew.\n", beforePath, afterPath, totalByteDelta, (unsigned int)growth.size());
+    for (unsigned int i = 0; i < growth.size() && i < maxSitesToShow; ++i)
+    {
+        printf("%s\n", MemorySnapshot::FormatDiffEntry(growth[i]).c_str());
+    }
+    return 0;
+}
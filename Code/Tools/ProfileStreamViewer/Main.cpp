@@ -0,0 +1,66 @@
+#include "Engine/Net/NetSystem.hpp"
+#include "Engine/Net/RemoteCommandService.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+//Globals the engine expects the game to provide.
+bool g_isQuitting = false;
+const char* APP_NAME = "ProfileStreamViewer";
+int g_frameNumber = 0;
+
+//-----------------------------------------------------------------------------------
+static void PrintProfileSummary(RemoteCommandServiceConnection*, const byte id, const char* message)
+{
+    if (id == MSG_PROFILE_FRAME)
+    {
+        printf("%s\n", message);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+//ProfileStreamViewer.exe <host> [summaries per second] [log file]
+//Joins a running game's remote command service and prints the profiling summaries it streams back, one line per summary, until the game goes away.
+//The log file gets the same lines appended, like profilestream does in game. Returns 0 once the host disconnects, 1 if it couldn't join.
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 4)
+    {
+        printf("Usage: ProfileStreamViewer <host> [summaries per second] [log file]\n");
+        return 1;
+    }
+    const char* hostName = argv[1];
+    std::string summariesPerSecond = argc >= 3 ? argv[2] : "10";
+    if (atof(summariesPerSecond.c_str()) <= 0.0)
+    {
+        printf("Summaries per second has to be more than 0.\n");
+        return 1;
+    }
+
+    NetSystem netSystem;
+    NetSystem::instance = &netSystem;
+    RemoteCommandService service;
+    if (argc == 4 && !service.StartProfileStreamLog(argv[3]))
+    {
+        printf("Couldn't open '%s' for writing.\n", argv[3]);
+        return 1;
+    }
+    if (!service.Join(hostName))
+    {
+        printf("Couldn't join a remote command service on '%s:%s'.\n", hostName, REMOTE_COMMAND_SERVICE_PORT_STRING);
+        return 1;
+    }
+    service.m_onMessage.RegisterFunction(&PrintProfileSummary);
+    service.SendCommand(MSG_PROFILE_SUBSCRIBE, summariesPerSecond.c_str());
+    printf("Joined '%s', asking for %s summaries per second.\n", hostName, summariesPerSecond.c_str());
+
+    while (!service.m_connections.empty())
+    {
+        service.Update();
+        fflush(stdout);
+        Sleep(5);
+    }
+    printf("The host went away.\n");
+    NetSystem::instance = nullptr;
+    return 0;
+}